@@ -0,0 +1,937 @@
+/**
+ * Nova402 C Library - benchmark suite
+ *
+ * Times the public API per primitive and reports ns/op, ops/s, cycles/op
+ * and library heap allocations per op, as a table or as JSON for tracking
+ * regressions across releases on fixed hardware.
+ *
+ * Every number is the median of --repeat runs, each at least --min-time
+ * long after calibrating the iteration count, so reruns on an idle machine
+ * agree to a few percent. Cycles come from the time-stamp counter on x86
+ * (reference cycles, not core cycles under frequency scaling) and are
+ * reported as 0 elsewhere.
+ *
+ * Usage: nova402_bench [--json] [--filter=SUBSTRING] [--min-time=MS]
+ *                      [--repeat=N] [--max-leaves=N]
+ *
+ * @file bench.c
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <nova402.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define BENCH_HAVE_TSC 1
+#endif
+
+#define MAX_REPEAT 31
+#define BATCH 64
+
+/* ============================================
+ * OPTIONS AND OUTPUT
+ * ============================================ */
+
+static struct {
+    int json;
+    const char *filter;
+    double min_time_ns;
+    int repeat;
+    size_t max_leaves;
+} g_opt = { 0, NULL, 200e6, 5, 1000000 };
+
+static int g_results;
+
+/* ============================================
+ * CLOCKS AND ALLOCATION COUNTING
+ * ============================================ */
+
+static double now_ns(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#endif
+}
+
+static unsigned long long cycles(void)
+{
+#if defined(BENCH_HAVE_TSC)
+    return (unsigned long long)__rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static size_t g_allocations;
+
+static void *counting_alloc(void *context, size_t size)
+{
+    (void)context;
+    g_allocations++;
+    return malloc(size);
+}
+
+static void counting_free(void *context, void *ptr)
+{
+    (void)context;
+    free(ptr);
+}
+
+/* ============================================
+ * MEASUREMENT
+ * ============================================ */
+
+/* Runs `iterations` calls; each call does `items` operations */
+typedef void (*bench_fn)(void *arg, size_t iterations);
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, size_t param, double ns, double cyc, double allocs)
+{
+    if (g_opt.json) {
+        printf("%s\n    {\"name\": \"%s\", \"param\": %lu, \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f, "
+               "\"cycles_per_op\": %.1f, \"allocs_per_op\": %.3f}",
+               g_results ? "," : "", name, (unsigned long)param, ns, 1e9 / ns, cyc, allocs);
+    } else {
+        printf("%-32s %10lu %14.2f %14.0f %12.1f %10.3f\n",
+               name, (unsigned long)param, ns, 1e9 / ns, cyc, allocs);
+    }
+    fflush(stdout);
+    g_results++;
+}
+
+static void measure(const char *name, size_t param, size_t items, bench_fn fn, void *arg)
+{
+    double ns[MAX_REPEAT], cyc[MAX_REPEAT], median_ns, median_cyc = 0;
+    size_t iterations = 1, allocations;
+    int r;
+
+    if (g_opt.filter && !strstr(name, g_opt.filter)) {
+        return;
+    }
+
+    /* Warm up and calibrate to min_time */
+    for (;;) {
+        double start = now_ns(), elapsed;
+
+        fn(arg, iterations);
+        elapsed = now_ns() - start;
+        if (elapsed >= g_opt.min_time_ns || iterations >= ((size_t)1 << 40)) {
+            break;
+        }
+        if (elapsed < g_opt.min_time_ns / 16) {
+            iterations *= 8;
+        } else {
+            iterations = (size_t)((double)iterations * g_opt.min_time_ns / elapsed) + 1;
+        }
+    }
+
+    g_allocations = 0;
+    for (r = 0; r < g_opt.repeat; r++) {
+        double start = now_ns();
+        unsigned long long c0 = cycles();
+
+        fn(arg, iterations);
+        cyc[r] = (double)(cycles() - c0);
+        ns[r] = now_ns() - start;
+    }
+    allocations = g_allocations;
+
+    qsort(ns, (size_t)g_opt.repeat, sizeof(ns[0]), compare_double);
+    qsort(cyc, (size_t)g_opt.repeat, sizeof(cyc[0]), compare_double);
+    median_ns = ns[g_opt.repeat / 2] / (double)(iterations * items);
+    median_cyc = cyc[g_opt.repeat / 2] / (double)(iterations * items);
+    report(name, param, median_ns, median_cyc,
+           (double)allocations / ((double)g_opt.repeat * (double)iterations * (double)items));
+}
+
+/* ============================================
+ * FIXTURES
+ * ============================================ */
+
+/*
+ * A base-sepolia X-PAYMENT authorization signed with a fixed test key;
+ * the signature verifies under the network's USDC domain.
+ */
+static const char PAYMENT_JSON[] =
+    "{\"x402Version\": 1, \"scheme\": \"exact\", \"network\": \"base-sepolia\", \"payload\": "
+    "{\"authorization\": {\"from\": \"0x1be31a94361a391bbafb2a4ccd704f57dc04d4bb\", "
+    "\"to\": \"0x742d35Cc6634C0532925a3b844Bc9e7595f0bEb0\", \"value\": \"100000\", "
+    "\"validAfter\": 1740672089, \"validBefore\": \"1740672389\", "
+    "\"nonce\": \"0xf3746613c2d920b5fdabc0856f2aeb2d4f88ee6037b8cc5d04a71a4462f13480\"}, "
+    "\"signature\": \"0xd90cd625ee87dd38656dd95cf79f65f60f7273b67d3096e68bd81e4f5342691f"
+    "21f4e7a2e980205349cfcb0593f87edf520927b93648eac984437c30705ce0591c\"}}";
+
+/* RFC 8032 section 7.1, test 1 (empty message) */
+static const char ED25519_PUBLIC_KEY[] = "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a";
+static const char ED25519_SIGNATURE[] =
+    "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b";
+
+static char g_header[1024];
+static size_t g_header_length;
+static nova402_payment_header_t g_payment;
+static nova402_eip712_domain_t g_domain;
+static nova402_hash_t g_digest;
+static nova402_ed25519_public_key_t g_ed_key;
+static nova402_ed25519_signature_t g_ed_signature;
+static uint8_t g_input[1 << 16];
+static volatile uint8_t g_sink;
+
+static void base64_encode(const uint8_t *in, size_t length, char *out)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i, o = 0;
+
+    for (i = 0; i + 2 < length; i += 3) {
+        unsigned v = ((unsigned)in[i] << 16) | ((unsigned)in[i + 1] << 8) | in[i + 2];
+        out[o++] = alphabet[(v >> 18) & 63];
+        out[o++] = alphabet[(v >> 12) & 63];
+        out[o++] = alphabet[(v >> 6) & 63];
+        out[o++] = alphabet[v & 63];
+    }
+    if (i < length) {
+        unsigned v = (unsigned)in[i] << 16;
+        if (i + 1 < length) {
+            v |= (unsigned)in[i + 1] << 8;
+        }
+        out[o++] = alphabet[(v >> 18) & 63];
+        out[o++] = alphabet[(v >> 12) & 63];
+        out[o++] = i + 1 < length ? alphabet[(v >> 6) & 63] : '=';
+        out[o++] = '=';
+    }
+    out[o] = '\0';
+}
+
+static int setup_fixtures(void)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(g_input); i++) {
+        g_input[i] = (uint8_t)(i * 131 + 7);
+    }
+
+    base64_encode((const uint8_t *)PAYMENT_JSON, sizeof(PAYMENT_JSON) - 1, g_header);
+    g_header_length = strlen(g_header);
+    if (nova402_parse_payment_header(g_header, g_header_length, &g_payment) != NOVA402_SUCCESS ||
+        nova402_eip712_domain_for_network(&g_domain, g_payment.network, NULL, NULL) != NOVA402_SUCCESS ||
+        nova402_eip712_hash_payment(&g_domain, &g_payment.payment, &g_digest) != NOVA402_SUCCESS ||
+        !nova402_verify_signature_ctx(&g_domain, &g_payment.payment, &g_payment.signature, &g_payment.payment.from)) {
+        fprintf(stderr, "nova402_bench: payment fixture does not verify\n");
+        return -1;
+    }
+
+    if (nova402_hex_to_bytes(ED25519_PUBLIC_KEY, g_ed_key.bytes, sizeof(g_ed_key.bytes)) != (int)sizeof(g_ed_key.bytes) ||
+        nova402_hex_to_bytes(ED25519_SIGNATURE, g_ed_signature.bytes, sizeof(g_ed_signature.bytes)) !=
+            (int)sizeof(g_ed_signature.bytes) ||
+        !nova402_ed25519_verify(NULL, 0, &g_ed_key, &g_ed_signature)) {
+        fprintf(stderr, "nova402_bench: Ed25519 fixture does not verify\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* ============================================
+ * HASHING
+ * ============================================ */
+
+static void run_keccak256(void *arg, size_t iterations)
+{
+    size_t length = *(const size_t *)arg, i;
+    nova402_hash_t hash;
+
+    for (i = 0; i < iterations; i++) {
+        nova402_keccak256(g_input, length, &hash);
+        g_sink ^= hash.bytes[0];
+    }
+}
+
+static void run_sha256(void *arg, size_t iterations)
+{
+    size_t length = *(const size_t *)arg, i;
+    nova402_hash_t hash;
+
+    for (i = 0; i < iterations; i++) {
+        nova402_sha256(g_input, length, &hash);
+        g_sink ^= hash.bytes[0];
+    }
+}
+
+static void run_sha256_stream(void *arg, size_t iterations)
+{
+    size_t length = *(const size_t *)arg, i;
+    nova402_sha256_ctx_t ctx;
+    nova402_hash_t hash;
+
+    for (i = 0; i < iterations; i++) {
+        nova402_sha256_init(&ctx);
+        nova402_sha256_update(&ctx, g_input, length);
+        nova402_sha256_final(&ctx, &hash);
+        g_sink ^= hash.bytes[0];
+    }
+}
+
+static const uint8_t *g_messages[BATCH];
+static size_t g_lengths[BATCH];
+
+static void run_keccak256_many(void *arg, size_t iterations)
+{
+    nova402_hash_t hashes[BATCH];
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_keccak256_many(g_messages, g_lengths, BATCH, hashes);
+        g_sink ^= hashes[0].bytes[0];
+    }
+}
+
+static void run_sha256_many(void *arg, size_t iterations)
+{
+    nova402_hash_t hashes[BATCH];
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_sha256_many(g_messages, g_lengths, BATCH, hashes);
+        g_sink ^= hashes[0].bytes[0];
+    }
+}
+
+static void bench_hashing(void)
+{
+    static const size_t sizes[] = { 32, 64, 136, 1024, 16384, 65536 };
+    static const size_t short_sizes[] = { 32, 64, 128 };
+    size_t i, j;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        measure("keccak256", sizes[i], 1, run_keccak256, (void *)&sizes[i]);
+    }
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        measure("sha256", sizes[i], 1, run_sha256, (void *)&sizes[i]);
+    }
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        measure("sha256_stream", sizes[i], 1, run_sha256_stream, (void *)&sizes[i]);
+    }
+    for (i = 0; i < sizeof(short_sizes) / sizeof(short_sizes[0]); i++) {
+        for (j = 0; j < BATCH; j++) {
+            g_messages[j] = g_input + j * short_sizes[i];
+            g_lengths[j] = short_sizes[i];
+        }
+        measure("keccak256_many", short_sizes[i], BATCH, run_keccak256_many, NULL);
+        measure("sha256_many", short_sizes[i], BATCH, run_sha256_many, NULL);
+    }
+}
+
+/* ============================================
+ * SIGNATURES
+ * ============================================ */
+
+static nova402_payment_data_t g_payments[BATCH];
+static nova402_signature_t g_signatures[BATCH];
+static nova402_address_t g_signers[BATCH];
+static nova402_hash_t g_digests[BATCH];
+static nova402_payment_header_t g_headers[BATCH];
+static uint8_t g_frame[NOVA402_PACKED_HEADER_SIZE + BATCH * NOVA402_PACKED_RECORD_SIZE];
+static const uint8_t *g_ed_messages[BATCH];
+static size_t g_ed_lengths[BATCH];
+static nova402_ed25519_public_key_t g_ed_keys[BATCH];
+static nova402_ed25519_signature_t g_ed_signatures[BATCH];
+
+static void run_verify(void *arg, size_t iterations)
+{
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        g_sink ^= (uint8_t)nova402_verify_signature_ctx(&g_domain, &g_payment.payment, &g_payment.signature,
+                                                        &g_payment.payment.from);
+    }
+}
+
+static void run_verify_batch(void *arg, size_t iterations)
+{
+    uint8_t results[BATCH / 8];
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_verify_signatures_batch_ctx(&g_domain, g_payments, g_signatures, g_signers, BATCH, results);
+        g_sink ^= results[0];
+    }
+}
+
+static void run_recover(void *arg, size_t iterations)
+{
+    nova402_address_t signer;
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_recover_signer(&g_digest, &g_payment.signature, &signer);
+        g_sink ^= signer.bytes[0];
+    }
+}
+
+static void run_recover_batch(void *arg, size_t iterations)
+{
+    nova402_address_t signers[BATCH];
+    uint8_t results[BATCH / 8];
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_recover_signers_batch(g_digests, g_signatures, BATCH, signers, results);
+        g_sink ^= results[0];
+    }
+}
+
+static void run_worker_verify(void *arg, size_t iterations)
+{
+    nova402_worker_t *worker = (nova402_worker_t *)arg;
+    uint8_t results[BATCH / 8];
+    size_t i;
+
+    for (i = 0; i < iterations; i++) {
+        nova402_worker_verify_payments(worker, g_headers, BATCH, results);
+        g_sink ^= results[0];
+    }
+}
+
+/* Arbitrary hot-wallet key for the signing benchmarks */
+static const uint8_t SIGNING_KEY[32] = {
+    0x4c, 0x08, 0x83, 0xa6, 0x91, 0x02, 0x93, 0x7d, 0x62, 0x31, 0x47, 0x1b, 0x5d, 0xbb, 0x62, 0x04,
+    0xfe, 0x51, 0x29, 0x61, 0x70, 0x82, 0x79, 0x2a, 0xe4, 0x68, 0xd0, 0x1a, 0x3f, 0x36, 0x23, 0x18
+};
+
+static void run_sign_payment(void *arg, size_t iterations)
+{
+    nova402_signature_t signature;
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_sign_payment(&g_payment.payment, SIGNING_KEY, &signature);
+        g_sink ^= signature.s[0];
+    }
+}
+
+static void run_signer_sign(void *arg, size_t iterations)
+{
+    const nova402_signer_t *signer = (const nova402_signer_t *)arg;
+    nova402_signature_t signature;
+    size_t i;
+
+    for (i = 0; i < iterations; i++) {
+        nova402_signer_sign_payment(signer, NULL, &g_payment.payment, &signature);
+        g_sink ^= signature.s[0];
+    }
+}
+
+static void run_sign_batch(void *arg, size_t iterations)
+{
+    const nova402_signer_t *signer = (const nova402_signer_t *)arg;
+    nova402_signature_t signatures[BATCH];
+    size_t i;
+
+    for (i = 0; i < iterations; i++) {
+        nova402_sign_payments_batch(signer, NULL, g_payments, BATCH, signatures);
+        g_sink ^= signatures[0].s[0];
+    }
+}
+
+static void run_worker_verify_packed(void *arg, size_t iterations)
+{
+    nova402_worker_t *worker = (nova402_worker_t *)arg;
+    const nova402_packed_record_t *records;
+    uint8_t results[BATCH / 8];
+    size_t i, count;
+
+    for (i = 0; i < iterations; i++) {
+        nova402_packed_frame_open(g_frame, sizeof(g_frame), &records, &count);
+        nova402_worker_verify_packed(worker, records, count, results);
+        g_sink ^= results[0];
+    }
+}
+
+static void run_payment_batch_screen(void *arg, size_t iterations)
+{
+    const nova402_payment_batch_t *batch = (const nova402_payment_batch_t *)arg;
+    nova402_payment_requirements_t requirements = { NOVA402_NETWORK_ID_BASE_SEPOLIA, NULL, { { 0 } }, 0 };
+    uint64_t now = (g_payment.payment.valid_after + g_payment.payment.valid_before) / 2;
+    uint8_t results[BATCH / 8];
+    size_t i;
+
+    requirements.pay_to = g_payment.payment.to;
+    requirements.max_amount_required = g_payment.payment.value;
+    for (i = 0; i < iterations; i++) {
+        nova402_payment_batch_screen(batch, &requirements, now, results);
+        g_sink ^= results[0];
+    }
+}
+
+static void run_ed25519(void *arg, size_t iterations)
+{
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        g_sink ^= (uint8_t)nova402_ed25519_verify(NULL, 0, &g_ed_key, &g_ed_signature);
+    }
+}
+
+static void run_ed25519_batch(void *arg, size_t iterations)
+{
+    uint8_t results[BATCH / 8];
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_ed25519_verify_batch(g_ed_messages, g_ed_lengths, g_ed_keys, g_ed_signatures, BATCH, results);
+        g_sink ^= results[0];
+    }
+}
+
+static void bench_signatures(void)
+{
+    const char *networks[] = { "base-sepolia" };
+    nova402_ctx_t *ctx;
+    nova402_worker_t *worker;
+    nova402_signer_t *signer;
+    nova402_payment_batch_t *batch;
+    size_t i, written;
+
+    for (i = 0; i < BATCH; i++) {
+        g_payments[i] = g_payment.payment;
+        g_signatures[i] = g_payment.signature;
+        g_signers[i] = g_payment.payment.from;
+        g_digests[i] = g_digest;
+        g_headers[i] = g_payment;
+        g_ed_messages[i] = NULL;
+        g_ed_lengths[i] = 0;
+        g_ed_keys[i] = g_ed_key;
+        g_ed_signatures[i] = g_ed_signature;
+    }
+
+    measure("verify_signature", 1, 1, run_verify, NULL);
+    measure("verify_signatures_batch", BATCH, BATCH, run_verify_batch, NULL);
+    measure("recover_signer", 1, 1, run_recover, NULL);
+    measure("recover_signers_batch", BATCH, BATCH, run_recover_batch, NULL);
+
+    ctx = nova402_ctx_create(networks, 1, NOVA402_SECP256K1_TABLE_64K);
+    worker = nova402_worker_create(ctx, 0);
+    if (worker) {
+        measure("worker_verify_payments", BATCH, BATCH, run_worker_verify, worker);
+        nova402_packed_encode(g_headers, BATCH, g_frame, sizeof(g_frame), &written);
+        measure("worker_verify_packed", BATCH, BATCH, run_worker_verify_packed, worker);
+    }
+    nova402_worker_destroy(worker);
+    nova402_ctx_destroy(ctx);
+
+    batch = nova402_payment_batch_create(BATCH);
+    if (batch) {
+        nova402_payment_batch_load_headers(batch, g_headers, BATCH);
+        measure("payment_batch_screen", BATCH, BATCH, run_payment_batch_screen, batch);
+    }
+    nova402_payment_batch_destroy(batch);
+
+    measure("sign_payment", 1, 1, run_sign_payment, NULL);
+    signer = nova402_signer_create(SIGNING_KEY, NULL);
+    if (signer) {
+        measure("signer_sign_payment", 1, 1, run_signer_sign, signer);
+        measure("sign_payments_batch", BATCH, BATCH, run_sign_batch, signer);
+    }
+    nova402_signer_destroy(signer);
+
+    measure("ed25519_verify", 1, 1, run_ed25519, NULL);
+    measure("ed25519_verify_batch", BATCH, BATCH, run_ed25519_batch, NULL);
+}
+
+/* ============================================
+ * MERKLE TREES
+ * ============================================ */
+
+typedef struct {
+    nova402_hash_t *leaves;
+    size_t count;
+    nova402_merkle_tree_t *tree;
+    nova402_hash_t root;
+    nova402_hash_t proof[NOVA402_MERKLE_MAX_DEPTH];
+    size_t proof_length;
+    size_t next;
+} merkle_state_t;
+
+static void run_merkle_root(void *arg, size_t iterations)
+{
+    merkle_state_t *m = (merkle_state_t *)arg;
+    nova402_hash_t root;
+    size_t i;
+
+    for (i = 0; i < iterations; i++) {
+        nova402_merkle_root(m->leaves, m->count, &root);
+        g_sink ^= root.bytes[0];
+    }
+}
+
+static void run_merkle_build(void *arg, size_t iterations)
+{
+    merkle_state_t *m = (merkle_state_t *)arg;
+    size_t i;
+
+    for (i = 0; i < iterations; i++) {
+        nova402_merkle_tree_destroy(nova402_merkle_tree_create(m->leaves, m->count));
+    }
+}
+
+static void run_merkle_proof(void *arg, size_t iterations)
+{
+    merkle_state_t *m = (merkle_state_t *)arg;
+    nova402_hash_t proof[NOVA402_MERKLE_MAX_DEPTH];
+    size_t i, length;
+
+    for (i = 0; i < iterations; i++) {
+        m->next = (m->next + 7919) % m->count;
+        nova402_merkle_proof(m->tree, m->next, proof, NOVA402_MERKLE_MAX_DEPTH, &length);
+        g_sink ^= proof[0].bytes[0];
+    }
+}
+
+static void run_merkle_verify(void *arg, size_t iterations)
+{
+    merkle_state_t *m = (merkle_state_t *)arg;
+    size_t i;
+
+    for (i = 0; i < iterations; i++) {
+        g_sink ^= (uint8_t)nova402_verify_merkle_proof(&m->leaves[0], m->proof, m->proof_length, &m->root, 0);
+    }
+}
+
+typedef struct {
+    nova402_sparse_merkle_t *tree;
+    const nova402_hash_t *keys;
+    size_t count;
+    nova402_hash_t values[BATCH];
+    nova402_hash_t root;
+    nova402_sparse_merkle_proof_t proof;
+    size_t next;
+} sparse_merkle_state_t;
+
+static void run_sparse_merkle_update(void *arg, size_t iterations)
+{
+    sparse_merkle_state_t *m = (sparse_merkle_state_t *)arg;
+    size_t i;
+
+    for (i = 0; i < iterations; i++) {
+        m->next = (m->next + BATCH) % (m->count - BATCH);
+        m->values[i % BATCH].bytes[1]++;
+        nova402_sparse_merkle_update(m->tree, (const uint8_t (*)[NOVA402_NONCE_SIZE])&m->keys[m->next],
+                                     m->values, BATCH, 1, NULL);
+    }
+}
+
+static void run_sparse_merkle_prove(void *arg, size_t iterations)
+{
+    sparse_merkle_state_t *m = (sparse_merkle_state_t *)arg;
+    size_t i;
+
+    for (i = 0; i < iterations; i++) {
+        m->next = (m->next + 7919) % m->count;
+        nova402_sparse_merkle_prove(m->tree, m->keys[m->next].bytes, &m->proof);
+        g_sink ^= (uint8_t)m->proof.sibling_count;
+    }
+}
+
+static void run_sparse_merkle_verify(void *arg, size_t iterations)
+{
+    sparse_merkle_state_t *m = (sparse_merkle_state_t *)arg;
+    size_t i;
+
+    for (i = 0; i < iterations; i++) {
+        g_sink ^= (uint8_t)nova402_sparse_merkle_verify(&m->root, m->keys[0].bytes, &m->keys[0], &m->proof);
+    }
+}
+
+static void bench_sparse_merkle(const nova402_hash_t *keys, size_t count)
+{
+    sparse_merkle_state_t m;
+    size_t i;
+
+    memset(&m, 0, sizeof(m));
+    m.keys = keys;
+    m.count = count;
+    m.tree = nova402_sparse_merkle_create(0);
+    if (!m.tree ||
+        nova402_sparse_merkle_update(m.tree, (const uint8_t (*)[NOVA402_NONCE_SIZE])keys, keys, count, 0, NULL) !=
+            NOVA402_SUCCESS) {
+        nova402_sparse_merkle_destroy(m.tree);
+        return;
+    }
+    for (i = 0; i < BATCH; i++) {
+        m.values[i] = keys[i];
+    }
+
+    measure("sparse_merkle_update", count, BATCH, run_sparse_merkle_update, &m);
+    measure("sparse_merkle_prove", count, 1, run_sparse_merkle_prove, &m);
+
+    /* Restore the first batch so keys[0] proves its original value */
+    nova402_sparse_merkle_update(m.tree, (const uint8_t (*)[NOVA402_NONCE_SIZE])keys, keys, BATCH, 1, NULL);
+    nova402_sparse_merkle_root(m.tree, &m.root);
+    nova402_sparse_merkle_prove(m.tree, keys[0].bytes, &m.proof);
+    measure("sparse_merkle_verify", count, 1, run_sparse_merkle_verify, &m);
+    nova402_sparse_merkle_destroy(m.tree);
+}
+
+static void bench_merkle(void)
+{
+    merkle_state_t m;
+    size_t count, i;
+
+    for (count = 1000; count <= g_opt.max_leaves; count *= 10) {
+        memset(&m, 0, sizeof(m));
+        m.count = count;
+        m.leaves = (nova402_hash_t *)malloc(count * sizeof(nova402_hash_t));
+        if (!m.leaves) {
+            fprintf(stderr, "nova402_bench: out of memory at %lu leaves\n", (unsigned long)count);
+            return;
+        }
+        for (i = 0; i < count; i++) {
+            nova402_keccak256((const uint8_t *)&i, sizeof(i), &m.leaves[i]);
+        }
+
+        measure("merkle_root", count, 1, run_merkle_root, &m);
+        measure("merkle_tree_create", count, 1, run_merkle_build, &m);
+
+        m.tree = nova402_merkle_tree_create(m.leaves, count);
+        if (m.tree) {
+            nova402_merkle_tree_root(m.tree, &m.root);
+            nova402_merkle_proof(m.tree, 0, m.proof, NOVA402_MERKLE_MAX_DEPTH, &m.proof_length);
+            measure("merkle_proof", count, 1, run_merkle_proof, &m);
+            measure("verify_merkle_proof", count, 1, run_merkle_verify, &m);
+            nova402_merkle_tree_destroy(m.tree);
+        }
+        bench_sparse_merkle(m.leaves, count);
+        free(m.leaves);
+    }
+}
+
+/* ============================================
+ * ENCODING AND PARSING
+ * ============================================ */
+
+static nova402_hash_t g_hashes[BATCH];
+static char g_hex[BATCH * (2 * NOVA402_HASH_SIZE + 1)];
+static const char *g_hex_strings[BATCH];
+
+static void run_bytes_to_hex(void *arg, size_t iterations)
+{
+    char hex[2 * 32 + 3];
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_bytes_to_hex(g_input, 32, hex, sizeof(hex));
+        g_sink ^= (uint8_t)hex[2];
+    }
+}
+
+static void run_hex_to_bytes(void *arg, size_t iterations)
+{
+    uint8_t bytes[32];
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_hex_to_bytes(g_hex, bytes, sizeof(bytes));
+        g_sink ^= bytes[0];
+    }
+}
+
+static void run_hashes_to_hex(void *arg, size_t iterations)
+{
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_hashes_to_hex(g_hashes, BATCH, g_hex);
+        g_sink ^= (uint8_t)g_hex[0];
+    }
+}
+
+static void run_hex_to_hashes(void *arg, size_t iterations)
+{
+    nova402_hash_t hashes[BATCH];
+    uint8_t results[BATCH / 8];
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_hex_to_hashes(g_hex_strings, BATCH, hashes, results);
+        g_sink ^= results[0];
+    }
+}
+
+static void run_parse_header(void *arg, size_t iterations)
+{
+    nova402_payment_header_t header;
+    size_t i;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_parse_payment_header(g_header, g_header_length, &header);
+        g_sink ^= header.payment.nonce[0];
+    }
+}
+
+static void run_packed_encode(void *arg, size_t iterations)
+{
+    size_t i, written;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_packed_encode(g_headers, BATCH, g_frame, sizeof(g_frame), &written);
+        g_sink ^= g_frame[written - 1];
+    }
+}
+
+static void run_packed_decode(void *arg, size_t iterations)
+{
+    const nova402_packed_record_t *records;
+    nova402_payment_header_t header;
+    size_t i, j, count;
+
+    (void)arg;
+    for (i = 0; i < iterations; i++) {
+        nova402_packed_frame_open(g_frame, sizeof(g_frame), &records, &count);
+        for (j = 0; j < count; j++) {
+            nova402_packed_read(&records[j], &header);
+            g_sink ^= header.payment.nonce[0];
+        }
+    }
+}
+
+static void bench_encoding(void)
+{
+    size_t i, written;
+
+    for (i = 0; i < BATCH; i++) {
+        memcpy(g_hashes[i].bytes, g_input + 32 * i, NOVA402_HASH_SIZE);
+    }
+    nova402_hashes_to_hex(g_hashes, BATCH, g_hex);
+    for (i = 0; i < BATCH; i++) {
+        g_hex_strings[i] = g_hex + i * (2 * NOVA402_HASH_SIZE + 1);
+    }
+
+    measure("bytes_to_hex", 32, 1, run_bytes_to_hex, NULL);
+    measure("hex_to_bytes", 32, 1, run_hex_to_bytes, NULL);
+    measure("hashes_to_hex", BATCH, BATCH, run_hashes_to_hex, NULL);
+    measure("hex_to_hashes", BATCH, BATCH, run_hex_to_hashes, NULL);
+    measure("parse_payment_header", g_header_length, 1, run_parse_header, NULL);
+
+    for (i = 0; i < BATCH; i++) {
+        g_headers[i] = g_payment;
+    }
+    nova402_packed_encode(g_headers, BATCH, g_frame, sizeof(g_frame), &written);
+    measure("packed_encode", BATCH, BATCH, run_packed_encode, NULL);
+    measure("packed_decode", BATCH, BATCH, run_packed_decode, NULL);
+}
+
+/* ============================================
+ * MAIN
+ * ============================================ */
+
+static int parse_options(int argc, char **argv)
+{
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        const char *a = argv[i];
+
+        if (strcmp(a, "--json") == 0) {
+            g_opt.json = 1;
+        } else if (strncmp(a, "--filter=", 9) == 0) {
+            g_opt.filter = a + 9;
+        } else if (strncmp(a, "--min-time=", 11) == 0) {
+            g_opt.min_time_ns = atof(a + 11) * 1e6;
+        } else if (strncmp(a, "--repeat=", 9) == 0) {
+            g_opt.repeat = atoi(a + 9);
+        } else if (strncmp(a, "--max-leaves=", 13) == 0) {
+            g_opt.max_leaves = (size_t)strtoul(a + 13, NULL, 10);
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--json] [--filter=SUBSTRING] [--min-time=MS] [--repeat=N] [--max-leaves=N]\n",
+                    argv[0]);
+            return -1;
+        }
+    }
+    if (g_opt.repeat < 1 || g_opt.repeat > MAX_REPEAT || g_opt.min_time_ns <= 0) {
+        fprintf(stderr, "%s: --repeat must be 1..%d and --min-time positive\n", argv[0], MAX_REPEAT);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    nova402_allocator_t counting = { counting_alloc, counting_free, NULL };
+
+    if (parse_options(argc, argv) != 0) {
+        return 2;
+    }
+    nova402_init();
+    nova402_set_allocator(&counting);
+    if (setup_fixtures() != 0) {
+        return 1;
+    }
+
+    if (g_opt.json) {
+        printf("{\n  \"version\": \"%s\",\n  \"dispatch\": \"%s\",\n  \"min_time_ms\": %.0f,\n"
+               "  \"repeat\": %d,\n  \"results\": [",
+               nova402_version(), nova402_cpu_dispatch_info(), g_opt.min_time_ns / 1e6, g_opt.repeat);
+    } else {
+        printf("nova402 %s (%s)\n\n", nova402_version(), nova402_cpu_dispatch_info());
+        printf("%-32s %10s %14s %14s %12s %10s\n", "benchmark", "param", "ns/op", "ops/s", "cycles/op",
+               "allocs/op");
+    }
+
+    bench_hashing();
+    bench_signatures();
+    bench_merkle();
+    bench_encoding();
+
+    if (g_opt.json) {
+        printf("\n  ]\n}\n");
+    }
+    return 0;
+}
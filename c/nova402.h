@@ -32,12 +32,49 @@ extern "C" {
 #define NOVA402_ADDRESS_SIZE 20
 #define NOVA402_SIGNATURE_SIZE 65
 #define NOVA402_NONCE_SIZE 32
+#define NOVA402_ED25519_PUBLIC_KEY_SIZE 32
+#define NOVA402_ED25519_SIGNATURE_SIZE 64
 
 #define NOVA402_SUCCESS 0
 #define NOVA402_ERROR_INVALID_INPUT -1
 #define NOVA402_ERROR_INVALID_SIGNATURE -2
 #define NOVA402_ERROR_BUFFER_TOO_SMALL -3
 #define NOVA402_ERROR_VERIFICATION_FAILED -4
+#define NOVA402_ERROR_NONCE_REUSED -5
+#define NOVA402_ERROR_EXPIRED -6
+#define NOVA402_ERROR_CAPACITY -7
+#define NOVA402_ERROR_BASE64 -8
+#define NOVA402_ERROR_JSON -9
+#define NOVA402_ERROR_MISSING_FIELD -10
+#define NOVA402_ERROR_INVALID_FIELD -11
+#define NOVA402_ERROR_UNSUPPORTED -12
+#define NOVA402_ERROR_IO -13
+
+/* Buffer sizes of "0x"-prefixed, NUL-terminated hex strings */
+#define NOVA402_HASH_HEX_SIZE (2 + 2 * NOVA402_HASH_SIZE + 1)
+#define NOVA402_ADDRESS_HEX_SIZE (2 + 2 * NOVA402_ADDRESS_SIZE + 1)
+
+/* Longest X-PAYMENT header accepted, in base64 characters */
+#define NOVA402_MAX_PAYMENT_HEADER 4096
+#define NOVA402_NETWORK_NAME_SIZE 64
+
+/* Longest possible proof: one sibling per layer of a 2^64-leaf tree */
+#define NOVA402_MERKLE_MAX_DEPTH 64
+
+/* Merkle tree file format written by nova402_merkle_tree_save() */
+#define NOVA402_MERKLE_FILE_VERSION 1
+
+/* Sparse Merkle tree: shards are 2^shard_bits key prefixes */
+#define NOVA402_SPARSE_MERKLE_DEFAULT_SHARD_BITS 6
+#define NOVA402_SPARSE_MERKLE_MAX_SHARD_BITS 16
+#define NOVA402_SPARSE_MERKLE_MAX_DEPTH 256
+
+/* Packed batch framing (nova402_packed_*): header, then fixed-size records */
+#define NOVA402_PACKED_VERSION 1
+#define NOVA402_PACKED_HEADER_SIZE 32
+#define NOVA402_PACKED_RECORD_SIZE 168
+
+#define NOVA402_SHA256_BLOCK_SIZE 64
 
 /* ============================================
  * TYPES
@@ -57,6 +94,27 @@ typedef struct {
     uint8_t bytes[NOVA402_HASH_SIZE];
 } nova402_hash_t;
 
+/**
+ * Incremental Keccak-256 state
+ *
+ * Plain data: copying it (or nova402_keccak256_clone()) forks the hash, so
+ * a shared prefix can be absorbed once and finished many ways.
+ */
+typedef struct {
+    uint64_t state[25];
+    size_t used;  /* bytes of the current rate block absorbed */
+} nova402_keccak256_ctx_t;
+
+/**
+ * Incremental SHA-256 state (plain data, like nova402_keccak256_ctx_t)
+ */
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;  /* bytes absorbed */
+    size_t used;      /* bytes waiting in buffer */
+    uint8_t buffer[NOVA402_SHA256_BLOCK_SIZE];
+} nova402_sha256_ctx_t;
+
 /**
  * ECDSA signature components
  */
@@ -66,6 +124,20 @@ typedef struct {
     uint8_t v;
 } nova402_signature_t;
 
+/**
+ * Ed25519 public key (RFC 8032 encoding)
+ */
+typedef struct {
+    uint8_t bytes[NOVA402_ED25519_PUBLIC_KEY_SIZE];
+} nova402_ed25519_public_key_t;
+
+/**
+ * Ed25519 signature: R || S
+ */
+typedef struct {
+    uint8_t bytes[NOVA402_ED25519_SIGNATURE_SIZE];
+} nova402_ed25519_signature_t;
+
 /**
  * Payment data for signing
  */
@@ -78,6 +150,234 @@ typedef struct {
     uint8_t nonce[NOVA402_NONCE_SIZE];
 } nova402_payment_data_t;
 
+/**
+ * Decoded X-PAYMENT header ("exact" scheme)
+ */
+typedef struct {
+    uint32_t x402_version;
+    char network[NOVA402_NETWORK_NAME_SIZE];  /* NUL-terminated */
+    nova402_payment_data_t payment;           /* payload.authorization */
+    nova402_signature_t signature;
+} nova402_payment_header_t;
+
+/**
+ * One payment in the packed wire format (NOVA402_PACKED_RECORD_SIZE bytes)
+ *
+ * Bytes only, so the type has no padding or alignment and a received
+ * frame is read in place as an array of records. Integers are
+ * little-endian; network is a nova402_network_id_t.
+ */
+typedef struct {
+    uint8_t nonce[NOVA402_NONCE_SIZE];
+    uint8_t r[32];
+    uint8_t s[32];
+    nova402_address_t from;
+    nova402_address_t to;
+    uint8_t value[8];
+    uint8_t valid_after[8];
+    uint8_t valid_before[8];
+    uint8_t v;
+    uint8_t network;
+    uint8_t x402_version;
+    uint8_t reserved[5];   /* zero */
+} nova402_packed_record_t;
+
+/**
+ * Payments in struct-of-arrays form
+ *
+ * Row i of every column is payment i. The cheap checks of
+ * nova402_payment_batch_screen() only read the integer and network
+ * columns, 25 bytes a row, instead of whole headers. Each column is
+ * cache-line aligned. Created by nova402_payment_batch_create() and
+ * filled by the nova402_payment_batch_load_*() functions; callers may
+ * also write rows directly, up to capacity, and set count.
+ */
+typedef struct {
+    uint64_t *value;
+    uint64_t *valid_after;
+    uint64_t *valid_before;
+    uint8_t *network;                      /* nova402_network_id_t */
+    nova402_address_t *from;
+    nova402_address_t *to;
+    uint8_t (*nonce)[NOVA402_NONCE_SIZE];
+    nova402_signature_t *signature;
+    size_t count;                          /* rows in use */
+    size_t capacity;
+    void *block;                           /* owned allocation, internal */
+} nova402_payment_batch_t;
+
+/**
+ * Precomputed EIP-712 domain for TransferWithAuthorization
+ *
+ * Built once per (network, asset) pair with nova402_eip712_domain_init() or
+ * nova402_eip712_domain_for_network(). It is read-only afterwards, so one
+ * instance can be shared between threads.
+ */
+typedef struct {
+    nova402_hash_t separator;   /* domainSeparator */
+    nova402_hash_t type_hash;   /* TransferWithAuthorization type hash */
+    uint64_t struct_state[25];  /* Keccak state with the type hash absorbed */
+    uint64_t digest_state[25];  /* Keccak state with 0x1901 || separator absorbed */
+} nova402_eip712_domain_t;
+
+/**
+ * One task of a parallel job: process item `index`
+ */
+typedef void (*nova402_task_fn)(void *arg, size_t index);
+
+/**
+ * Caller-supplied task executor, e.g. an existing thread pool
+ *
+ * run() must call task(arg, i) exactly once for every i in [0, count),
+ * from any threads and in any order, and return only after every call has
+ * finished.
+ */
+typedef struct {
+    void (*run)(void *context, nova402_task_fn task, void *arg, size_t count);
+    void *context;
+} nova402_executor_t;
+
+/**
+ * Heap allocator used for everything the library allocates
+ *
+ * alloc() returns memory aligned for any type, or NULL; free() is never
+ * called with NULL. See nova402_set_allocator().
+ */
+typedef struct {
+    void *(*alloc)(void *context, size_t size);
+    void (*free)(void *context, void *ptr);
+    void *context;
+} nova402_allocator_t;
+
+/**
+ * Caller-owned scratch memory for one thread
+ *
+ * Initialize over any buffer with nova402_arena_init(). Functions taking
+ * an arena carve their temporary buffers from it instead of the heap and
+ * release them before returning. Not thread-safe: use one arena per
+ * thread.
+ */
+typedef struct {
+    uint8_t *base;  /* cache-line aligned start of the buffer */
+    size_t size;    /* usable bytes */
+    size_t used;    /* bytes handed out */
+    size_t peak;    /* most bytes ever requested, including requests that did not fit */
+} nova402_arena_t;
+
+/**
+ * Append-only Merkle accumulator
+ *
+ * Holds one root per complete subtree of the leaves pushed so far (the
+ * frontier), so its size is fixed however many leaves go in. Initialize
+ * with nova402_merkle_stream_init(); plain copies are valid snapshots.
+ */
+typedef struct {
+    uint64_t count;                                    /* leaves pushed */
+    nova402_hash_t frontier[NOVA402_MERKLE_MAX_DEPTH]; /* subtree of 2^i leaves if bit i of count */
+} nova402_merkle_stream_t;
+
+/**
+ * Membership or non-membership proof from a sparse Merkle tree
+ *
+ * Describes the path of a key from the root down to the first leaf or
+ * empty subtree on it, depth levels below the root. Empty siblings are
+ * left out: bit d of present (most significant bit first, as for keys)
+ * says whether the sibling at depth d is listed, and siblings holds the
+ * listed ones from the deepest up. Plain data, so a proof can be copied
+ * or serialized as is.
+ */
+typedef struct {
+    uint32_t depth;
+    uint32_t sibling_count;
+    uint8_t present[NOVA402_SPARSE_MERKLE_MAX_DEPTH / 8];
+    bool has_leaf;                           /* the path ends at a leaf */
+    uint8_t leaf_key[NOVA402_NONCE_SIZE];    /* that leaf, if has_leaf */
+    nova402_hash_t leaf_value;
+    nova402_hash_t siblings[NOVA402_SPARSE_MERKLE_MAX_DEPTH];
+} nova402_sparse_merkle_proof_t;
+
+/**
+ * Precomputed secp256k1 generator tables (opaque)
+ *
+ * Created with nova402_secp256k1_ctx_create(). Read-only once built, so one
+ * context can be shared by any number of threads.
+ */
+typedef struct nova402_secp256k1_ctx nova402_secp256k1_ctx_t;
+
+/**
+ * Signing key with precomputed public key, address and blinding (opaque)
+ *
+ * Created once per key with nova402_signer_create(). Read-only afterwards,
+ * so one signer can be shared by any number of threads.
+ */
+typedef struct nova402_signer nova402_signer_t;
+
+/**
+ * Shared verification context (opaque)
+ *
+ * Created once with nova402_ctx_create(); holds secp256k1 tables and the
+ * EIP-712 domains and configurations of a fixed set of networks. Never
+ * modified after creation, so any number of threads may use one context
+ * concurrently.
+ */
+typedef struct nova402_ctx nova402_ctx_t;
+
+/**
+ * Per-thread verification state (opaque)
+ *
+ * Scratch space bound to a context. Owned by one thread at a time; workers
+ * occupy whole cache lines, so workers on different cores do not false-share.
+ */
+typedef struct nova402_worker nova402_worker_t;
+
+/**
+ * Asynchronous verification pipeline (opaque)
+ *
+ * Created with nova402_pipeline_create(). nova402_verify_submit() and
+ * nova402_verify_poll() never block on verification and may be called
+ * from any thread.
+ */
+typedef struct nova402_pipeline nova402_pipeline_t;
+
+/**
+ * Pipeline settings; zero fields take the defaults
+ */
+typedef struct {
+    size_t threads;            /* pool threads (0: one per CPU) */
+    size_t max_batch;          /* requests per batch (0: 64) */
+    uint32_t max_linger_us;    /* how long a partial batch may wait for more
+                                  requests (0: dispatch at once) */
+    size_t capacity;           /* outstanding requests (0: 4096) */
+    void (*notify)(void *context);  /* optional: called from a pool thread
+                                       after results are queued */
+    void *notify_context;
+} nova402_pipeline_config_t;
+
+/**
+ * Result of one submitted verification
+ */
+typedef struct {
+    uint64_t tag;    /* as passed to nova402_verify_submit() */
+    int32_t result;  /* NOVA402_SUCCESS or NOVA402_ERROR_VERIFICATION_FAILED */
+} nova402_verify_completion_t;
+
+/**
+ * Size of the precomputed generator tables
+ */
+typedef enum {
+    NOVA402_SECP256K1_TABLE_64K = 0,
+    NOVA402_SECP256K1_TABLE_1M = 1
+} nova402_secp256k1_table_t;
+
+/**
+ * Address check performed by nova402_validate_addresses()
+ */
+typedef enum {
+    NOVA402_ADDRESS_FORMAT = 0,          /* "0x" and 40 hex digits */
+    NOVA402_ADDRESS_CHECKSUM = 1,        /* plus EIP-55 when the digits are mixed case */
+    NOVA402_ADDRESS_CHECKSUM_STRICT = 2  /* plus EIP-55 always */
+} nova402_address_check_t;
+
 /**
  * Network type
  */
@@ -96,6 +396,223 @@ typedef struct {
     const char *rpc_url;
 } nova402_network_config_t;
 
+/**
+ * Interned network handle
+ *
+ * Resolved once from a name or CAIP-2 ID; the per-network data behind it
+ * is static and needs no further string handling. The values are the
+ * network byte of nova402_packed_record_t, so new networks are only ever
+ * appended.
+ */
+typedef enum {
+    NOVA402_NETWORK_ID_UNKNOWN = 0,
+    NOVA402_NETWORK_ID_BASE_MAINNET,
+    NOVA402_NETWORK_ID_BASE_SEPOLIA,
+    NOVA402_NETWORK_ID_SOLANA_MAINNET,
+    NOVA402_NETWORK_ID_SOLANA_DEVNET,
+    NOVA402_NETWORK_ID_POLYGON,
+    NOVA402_NETWORK_ID_BSC,
+    NOVA402_NETWORK_ID_SEI,
+    NOVA402_NETWORK_ID_PEAQ,
+    NOVA402_NETWORK_ID_COUNT
+} nova402_network_id_t;
+
+/**
+ * Static per-network data
+ */
+typedef struct {
+    const char *network;             /* name, e.g. "base-mainnet" */
+    const char *caip2;               /* CAIP-2 ID, e.g. "eip155:8453" */
+    nova402_network_config_t config;
+    const char *usdc;                /* USDC contract or mint as text, or NULL */
+} nova402_network_info_t;
+
+/**
+ * Payment requirements of a resource, resolved once for
+ * nova402_validate_payment()
+ */
+typedef struct {
+    nova402_network_id_t network;
+    const nova402_eip712_domain_t *domain;  /* asset domain on network */
+    nova402_address_t pay_to;
+    uint64_t max_amount_required;
+} nova402_payment_requirements_t;
+
+/**
+ * Outcome of nova402_validate_payment(), in the order the checks run
+ */
+typedef enum {
+    NOVA402_PAYMENT_VALID = 0,
+    NOVA402_PAYMENT_MALFORMED = 1,            /* missing argument or domain */
+    NOVA402_PAYMENT_NETWORK_MISMATCH = 2,     /* header network is not the required one */
+    NOVA402_PAYMENT_RECIPIENT_MISMATCH = 3,   /* authorization.to != payTo */
+    NOVA402_PAYMENT_AMOUNT_INSUFFICIENT = 4,  /* authorization.value < maxAmountRequired */
+    NOVA402_PAYMENT_NOT_YET_VALID = 5,        /* now < validAfter */
+    NOVA402_PAYMENT_EXPIRED = 6,              /* now >= validBefore */
+    NOVA402_PAYMENT_SIGNATURE_INVALID = 7     /* signer is not authorization.from */
+} nova402_payment_status_t;
+
+/**
+ * Instrumented entry points
+ *
+ * Each covers the listed functions; nested entry points are counted at
+ * every level, except that a cached verification counts only as a
+ * verification, not also as a recovery.
+ */
+typedef enum {
+    NOVA402_STAT_VERIFY_SIGNATURE = 0,      /* _verify_signature_ctx/_cached, _worker_verify_payment */
+    NOVA402_STAT_VERIFY_SIGNATURES_BATCH,   /* _verify_signatures_batch(_ctx), _worker_verify_payments/_packed/_batch */
+    NOVA402_STAT_RECOVER_SIGNER,            /* _recover_signer_ctx/_cached */
+    NOVA402_STAT_RECOVER_SIGNERS_BATCH,     /* _recover_signers_batch(_ctx) */
+    NOVA402_STAT_VALIDATE_PAYMENT,          /* _validate_payment */
+    NOVA402_STAT_PARSE_PAYMENT_HEADER,      /* _parse_payment_header */
+    NOVA402_STAT_ED25519_VERIFY,            /* _ed25519_verify */
+    NOVA402_STAT_ED25519_VERIFY_BATCH,      /* _ed25519_verify_batch(_arena) */
+    NOVA402_STAT_MERKLE_ROOT,               /* _merkle_root_parallel */
+    NOVA402_STAT_MERKLE_TREE_CREATE,        /* _merkle_tree_create */
+    NOVA402_STAT_SIGN,                      /* _signer_sign_digest/_payment */
+    NOVA402_STAT_SIGN_PAYMENTS_BATCH,       /* _sign_payments_batch */
+    NOVA402_STAT_SPARSE_MERKLE_UPDATE,      /* _sparse_merkle_update */
+    NOVA402_STAT_COUNT
+} nova402_stat_op_t;
+
+/**
+ * Event counters
+ */
+typedef enum {
+    NOVA402_COUNTER_SIGNER_CACHE_HITS = 0,
+    NOVA402_COUNTER_SIGNER_CACHE_MISSES,
+    NOVA402_COUNTER_NONCE_REPLAYS,          /* inserts rejected with NOVA402_ERROR_NONCE_REUSED */
+    NOVA402_COUNTER_COUNT
+} nova402_stat_counter_t;
+
+/*
+ * Latency histogram buckets: exact below 32 ns, then 16 log-linear
+ * buckets per power of two (at most 6.25% wide) up to 2^36 ns; the last
+ * bucket collects everything slower.
+ */
+#define NOVA402_STATS_BUCKETS 529
+
+/**
+ * Counters of one entry point, summed over all threads
+ */
+typedef struct {
+    uint64_t calls;
+    uint64_t errors;        /* calls that returned an error or false */
+    uint64_t items;         /* signatures, headers or leaves processed */
+    uint64_t timed;         /* calls sampled into the histogram */
+    uint64_t total_ns;      /* sum of the sampled latencies */
+    uint64_t max_ns;        /* slowest sampled call */
+    uint64_t histogram[NOVA402_STATS_BUCKETS];
+} nova402_op_stats_t;
+
+/**
+ * Process-wide instrumentation snapshot
+ */
+typedef struct {
+    nova402_op_stats_t ops[NOVA402_STAT_COUNT];
+    uint64_t counters[NOVA402_COUNTER_COUNT];
+    size_t threads;         /* per-thread slabs; exited threads pass theirs on */
+} nova402_stats_t;
+
+/* ============================================
+ * INITIALIZATION AND CPU FEATURES
+ * ============================================ */
+
+/* x86 extensions reported by nova402_cpu_features() */
+#define NOVA402_CPU_SSSE3 (1u << 0)
+#define NOVA402_CPU_SSE41 (1u << 1)
+#define NOVA402_CPU_AVX2 (1u << 2)
+#define NOVA402_CPU_AVX512F (1u << 3)
+#define NOVA402_CPU_AVX512VL (1u << 4)
+#define NOVA402_CPU_BMI2 (1u << 5)
+#define NOVA402_CPU_ADX (1u << 6)
+#define NOVA402_CPU_SHA (1u << 7)
+
+/* ARM extensions reported by nova402_cpu_features() */
+#define NOVA402_CPU_NEON (1u << 16)
+#define NOVA402_CPU_ARM_AES (1u << 17)
+#define NOVA402_CPU_ARM_SHA2 (1u << 18)
+#define NOVA402_CPU_ARM_SHA3 (1u << 19)
+
+/**
+ * Probe the CPU and select the hashing and field arithmetic kernels
+ *
+ * Optional: every entry point initializes the library on first use. Call
+ * it at startup to keep the one-time probe off the request path.
+ * Thread-safe and idempotent.
+ *
+ * @return NOVA402_SUCCESS
+ */
+int nova402_init(void);
+
+/**
+ * Get the instruction set extensions detected on the running CPU
+ *
+ * Only extensions that the operating system has enabled are reported.
+ *
+ * @return Bitmask of NOVA402_CPU_* flags
+ */
+uint32_t nova402_cpu_features(void);
+
+/**
+ * Describe the kernels selected by the runtime dispatcher
+ *
+ * @return Static string, e.g.
+ *         "keccak256=avx512x8 sha256=portable secp256k1=bmi2 codec=avx2
+ *         screen=avx512"
+ */
+const char *nova402_cpu_dispatch_info(void);
+
+/* ============================================
+ * MEMORY
+ * ============================================ */
+
+/*
+ * Allocation-free entry points: nova402_verify_signature_ctx(),
+ * nova402_eip712_hash_payment(), nova402_parse_payment_header(),
+ * nova402_nonce_set_insert() / nova402_nonce_set_contains(), the signer
+ * cache lookups, nova402_ed25519_verify(), nova402_merkle_proof(), the
+ * worker verify calls and the stream accumulator never touch the heap, so
+ * the single-request verify path allocates nothing once its objects
+ * exist. Batch and multiproof verification take a nova402_arena_t for
+ * their scratch buffers.
+ */
+
+/**
+ * Replace the heap allocator
+ *
+ * Affects every later allocation. Call it before creating any library
+ * object, and free each object under the allocator that created it. Not
+ * thread-safe with respect to other library calls.
+ *
+ * @param allocator Allocator to copy, or NULL to restore malloc() / free()
+ * @return NOVA402_SUCCESS on success, NOVA402_ERROR_INVALID_INPUT if a callback is NULL
+ */
+int nova402_set_allocator(const nova402_allocator_t *allocator);
+
+/**
+ * Initialize an arena over a caller-owned buffer
+ *
+ * The buffer must outlive the arena. Blocks are cache-line aligned, so an
+ * unaligned buffer loses up to 63 bytes at its start.
+ *
+ * @param arena Arena to initialize
+ * @param buffer Backing memory (may be NULL for an empty arena)
+ * @param size Buffer size in bytes
+ */
+void nova402_arena_init(nova402_arena_t *arena, void *buffer, size_t size);
+
+/**
+ * Release everything handed out by an arena (peak is kept)
+ *
+ * Only needed to recover after a caller-side error; library functions
+ * give their scratch space back on return.
+ *
+ * @param arena Arena
+ */
+void nova402_arena_reset(nova402_arena_t *arena);
+
 /* ============================================
  * HASHING FUNCTIONS
  * ============================================ */
@@ -121,61 +638,1275 @@ int nova402_keccak256(const uint8_t *data, size_t length, nova402_hash_t *hash);
 int nova402_sha256(const uint8_t *data, size_t length, nova402_hash_t *hash);
 
 /**
- * Compute double Keccak-256 hash
- * 
- * @param data Input data
- * @param length Data length
- * @param hash Output hash (32 bytes)
- * @return NOVA402_SUCCESS on success, error code otherwise
+ * Compute double Keccak-256 hash
+ * 
+ * @param data Input data
+ * @param length Data length
+ * @param hash Output hash (32 bytes)
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_double_keccak256(const uint8_t *data, size_t length, nova402_hash_t *hash);
+
+/**
+ * Compute Keccak-256 of many independent messages
+ *
+ * Messages are hashed in lock-step across SIMD lanes (8 with AVX-512,
+ * 4 with AVX2, 2 with NEON); the kernel is chosen at runtime. Batches of
+ * equal-length messages keep every lane busy.
+ *
+ * @param data Array of message pointers
+ * @param lengths Array of message lengths
+ * @param count Number of messages
+ * @param hashes Output hashes (count entries)
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_keccak256_many(
+    const uint8_t *const *data,
+    const size_t *lengths,
+    size_t count,
+    nova402_hash_t *hashes
+);
+
+/**
+ * Compute Keccak-256 of four equal-length messages
+ *
+ * @param data Four message pointers
+ * @param length Length of each message
+ * @param hashes Output hashes (4 entries)
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_keccak256_x4(const uint8_t *const data[4], size_t length, nova402_hash_t hashes[4]);
+
+/**
+ * Compute Keccak-256 of eight equal-length messages
+ *
+ * @param data Eight message pointers
+ * @param length Length of each message
+ * @param hashes Output hashes (8 entries)
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_keccak256_x8(const uint8_t *const data[8], size_t length, nova402_hash_t hashes[8]);
+
+/**
+ * Start an incremental Keccak-256 hash
+ *
+ * @param ctx State to initialize
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_keccak256_init(nova402_keccak256_ctx_t *ctx);
+
+/**
+ * Absorb more input; any split of the message gives the same digest
+ *
+ * @param ctx Hash state
+ * @param data Input data
+ * @param length Data length
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_keccak256_update(nova402_keccak256_ctx_t *ctx, const uint8_t *data, size_t length);
+
+/**
+ * Finish the hash
+ *
+ * ctx must be initialized again before reuse.
+ *
+ * @param ctx Hash state
+ * @param hash Output hash (32 bytes)
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_keccak256_final(nova402_keccak256_ctx_t *ctx, nova402_hash_t *hash);
+
+/**
+ * Copy a hash state, e.g. after absorbing a common prefix
+ *
+ * @param dst Destination state
+ * @param src Source state
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_keccak256_clone(nova402_keccak256_ctx_t *dst, const nova402_keccak256_ctx_t *src);
+
+/**
+ * Start an incremental SHA-256 hash
+ *
+ * @param ctx State to initialize
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_sha256_init(nova402_sha256_ctx_t *ctx);
+
+/**
+ * Absorb more input
+ *
+ * Whole blocks are compressed straight from data with the runtime-selected
+ * kernel; only a trailing partial block is buffered.
+ *
+ * @param ctx Hash state
+ * @param data Input data
+ * @param length Data length
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_sha256_update(nova402_sha256_ctx_t *ctx, const uint8_t *data, size_t length);
+
+/**
+ * Finish the hash
+ *
+ * ctx must be initialized again before reuse.
+ *
+ * @param ctx Hash state
+ * @param hash Output hash (32 bytes)
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_sha256_final(nova402_sha256_ctx_t *ctx, nova402_hash_t *hash);
+
+/**
+ * Copy a hash state
+ *
+ * @param dst Destination state
+ * @param src Source state
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_sha256_clone(nova402_sha256_ctx_t *dst, const nova402_sha256_ctx_t *src);
+
+/**
+ * Compute SHA-256 of many independent messages
+ *
+ * Messages are hashed in lock-step across eight AVX2 lanes on CPUs without
+ * SHA-NI; with SHA-NI or the ARMv8 SHA-2 instructions each message goes
+ * through the hardware kernel, which is faster still. Chosen at runtime.
+ *
+ * @param data Array of message pointers
+ * @param lengths Array of message lengths
+ * @param count Number of messages
+ * @param hashes Output hashes (count entries)
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_sha256_many(
+    const uint8_t *const *data,
+    const size_t *lengths,
+    size_t count,
+    nova402_hash_t *hashes
+);
+
+/* ============================================
+ * SIGNATURE FUNCTIONS
+ * ============================================ */
+
+/**
+ * Sign payment data with private key
+ * 
+ * @param payment Payment data to sign
+ * @param private_key Private key (32 bytes)
+ * @param signature Output signature
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_sign_payment(
+    const nova402_payment_data_t *payment,
+    const uint8_t *private_key,
+    nova402_signature_t *signature
+);
+
+/**
+ * Verify payment signature
+ * 
+ * @param payment Payment data
+ * @param signature Signature to verify
+ * @param expected_signer Expected signer address
+ * @return true if valid, false otherwise
+ */
+bool nova402_verify_signature(
+    const nova402_payment_data_t *payment,
+    const nova402_signature_t *signature,
+    const nova402_address_t *expected_signer
+);
+
+/**
+ * Recover signer address from signature
+ * 
+ * @param message Message hash
+ * @param signature Signature
+ * @param signer Output signer address
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_recover_signer(
+    const nova402_hash_t *message,
+    const nova402_signature_t *signature,
+    nova402_address_t *signer
+);
+
+/**
+ * Verify a batch of payment signatures
+ *
+ * Equivalent to calling nova402_verify_signature() on every item, but the
+ * modular inversions of the whole batch are shared (Montgomery's trick) and
+ * each recovery runs as one interleaved double-scalar multiplication.
+ *
+ * @param payments Array of payment data
+ * @param signatures Array of signatures
+ * @param expected_signers Array of expected signer addresses
+ * @param count Number of items in each array
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if item i is valid
+ * @return Number of valid signatures, or negative error code
+ */
+int nova402_verify_signatures_batch(
+    const nova402_payment_data_t *payments,
+    const nova402_signature_t *signatures,
+    const nova402_address_t *expected_signers,
+    size_t count,
+    uint8_t *results
+);
+
+/**
+ * Recover signer addresses for a batch of signatures
+ *
+ * @param messages Array of message hashes
+ * @param signatures Array of signatures
+ * @param count Number of items in each array
+ * @param signers Output signer addresses (valid where the result bit is set)
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if signer i was recovered
+ * @return Number of recovered signers, or negative error code
+ */
+int nova402_recover_signers_batch(
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *results
+);
+
+/**
+ * Create a precomputed secp256k1 context
+ *
+ * Builds wNAF tables of odd multiples of G and 2^128 G, so recovery
+ * needs fewer point additions than with the built-in table. The larger
+ * table saves more additions but costs more cache.
+ *
+ * @param size Table size (NOVA402_SECP256K1_TABLE_64K or NOVA402_SECP256K1_TABLE_1M)
+ * @return New context, or NULL on invalid size or allocation failure
+ */
+nova402_secp256k1_ctx_t *nova402_secp256k1_ctx_create(nova402_secp256k1_table_t size);
+
+/**
+ * Destroy a secp256k1 context
+ *
+ * @param ctx Context to free (may be NULL)
+ */
+void nova402_secp256k1_ctx_destroy(nova402_secp256k1_ctx_t *ctx);
+
+/**
+ * Recover signer address using a precomputed context
+ *
+ * @param ctx Precomputed context
+ * @param message Message hash
+ * @param signature Signature
+ * @param signer Output signer address
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_recover_signer_ctx(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *message,
+    const nova402_signature_t *signature,
+    nova402_address_t *signer
+);
+
+/**
+ * Recover signer addresses for a batch of signatures using a precomputed context
+ *
+ * @param ctx Precomputed context
+ * @param messages Array of message hashes
+ * @param signatures Array of signatures
+ * @param count Number of items in each array
+ * @param signers Output signer addresses (valid where the result bit is set)
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if signer i was recovered
+ * @return Number of recovered signers, or negative error code
+ */
+int nova402_recover_signers_batch_ctx(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *results
+);
+
+/**
+ * Build an EIP-712 domain context
+ *
+ * @param domain Output domain context
+ * @param name Token name (e.g., "USD Coin")
+ * @param version Token version (e.g., "2")
+ * @param chain_id Chain ID
+ * @param verifying_contract Token contract address
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_eip712_domain_init(
+    nova402_eip712_domain_t *domain,
+    const char *name,
+    const char *version,
+    uint64_t chain_id,
+    const nova402_address_t *verifying_contract
+);
+
+/**
+ * Build the EIP-712 domain context of a network's USDC contract
+ *
+ * Takes the chain ID and the decoded contract from the static network table.
+ *
+ * @param domain Output domain context
+ * @param network Network name (e.g., "base-mainnet"); must be an EVM network
+ * @param name Token name, or NULL for "USD Coin"
+ * @param version Token version, or NULL for "2"
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_eip712_domain_for_network(
+    nova402_eip712_domain_t *domain,
+    const char *network,
+    const char *name,
+    const char *version
+);
+
+/**
+ * Compute the EIP-712 digest of a payment in a domain
+ *
+ * @param domain Domain context
+ * @param payment Payment data
+ * @param digest Output digest (the hash that is signed)
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_eip712_hash_payment(
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    nova402_hash_t *digest
+);
+
+/**
+ * Verify payment signature in a precomputed domain
+ *
+ * Same as nova402_verify_signature() for an explicit domain; only the
+ * payment fields are hashed per call.
+ *
+ * @param domain Domain context
+ * @param payment Payment data
+ * @param signature Signature to verify
+ * @param expected_signer Expected signer address
+ * @return true if valid, false otherwise
+ */
+bool nova402_verify_signature_ctx(
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    const nova402_signature_t *signature,
+    const nova402_address_t *expected_signer
+);
+
+/**
+ * Verify a batch of payment signatures in a precomputed domain
+ *
+ * @param domain Domain context shared by every item
+ * @param payments Array of payment data
+ * @param signatures Array of signatures
+ * @param expected_signers Array of expected signer addresses
+ * @param count Number of items in each array
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if item i is valid
+ * @return Number of valid signatures, or negative error code
+ */
+int nova402_verify_signatures_batch_ctx(
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payments,
+    const nova402_signature_t *signatures,
+    const nova402_address_t *expected_signers,
+    size_t count,
+    uint8_t *results
+);
+
+/* ============================================
+ * SIGNING KEYS
+ * ============================================ */
+
+/**
+ * Create a signer for a private key
+ *
+ * Computes the public key and address once and draws a blinding scalar
+ * from seed. Signing through it never allocates: nonces follow RFC 6979
+ * (HMAC-SHA256), k G comes from a fixed-base comb that is scanned in full
+ * on every lookup, and no branch or memory access depends on the key or
+ * the nonce. Signatures are low-s with v in {27, 28}.
+ *
+ * @param private_key Private key (32 bytes, big-endian)
+ * @param seed 32 bytes of randomness for the blinding, or NULL to derive it from the key
+ * @return New signer, or NULL if the key is zero or not below the group order,
+ *         or on allocation failure
+ */
+nova402_signer_t *nova402_signer_create(const uint8_t *private_key, const uint8_t *seed);
+
+/**
+ * Destroy a signer, clearing the key material
+ *
+ * @param signer Signer to free (may be NULL)
+ */
+void nova402_signer_destroy(nova402_signer_t *signer);
+
+/**
+ * Address of a signer's key
+ *
+ * @param signer Signer
+ * @param address Output address
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_signer_address(const nova402_signer_t *signer, nova402_address_t *address);
+
+/**
+ * Uncompressed public key of a signer's key
+ *
+ * @param signer Signer
+ * @param public_key Output buffer for x || y (64 bytes)
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_signer_public_key(const nova402_signer_t *signer, uint8_t *public_key);
+
+/**
+ * Sign a 32-byte digest
+ *
+ * @param signer Signer
+ * @param digest Message hash
+ * @param signature Output signature
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_signer_sign_digest(
+    const nova402_signer_t *signer,
+    const nova402_hash_t *digest,
+    nova402_signature_t *signature
+);
+
+/**
+ * Sign payment data
+ *
+ * Same signature as nova402_sign_payment() with the signer's key when
+ * domain is NULL.
+ *
+ * @param signer Signer
+ * @param domain Domain context, or NULL for the default domain
+ * @param payment Payment data to sign
+ * @param signature Output signature
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_signer_sign_payment(
+    const nova402_signer_t *signer,
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    nova402_signature_t *signature
+);
+
+/**
+ * Sign a batch of payments with one key
+ *
+ * Gives the same signatures as nova402_signer_sign_payment() on every item.
+ * Digests go through the multi-buffer Keccak kernel, and each group of 16
+ * shares one field inversion for the nonce points and one scalar
+ * inversion for the nonces.
+ *
+ * @param signer Signer
+ * @param domain Domain context shared by every item, or NULL for the default domain
+ * @param payments Array of payment data
+ * @param count Number of items in each array
+ * @param signatures Output signatures
+ * @return Number of signed payments (count), or negative error code
+ */
+int nova402_sign_payments_batch(
+    const nova402_signer_t *signer,
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payments,
+    size_t count,
+    nova402_signature_t *signatures
+);
+
+/* ============================================
+ * ED25519 SIGNATURES
+ * ============================================ */
+
+/**
+ * Verify an Ed25519 signature (Solana payments)
+ *
+ * Uses the cofactored equation [8][S]B = [8]R + [8][k]A and rejects
+ * non-canonical point encodings, S >= L, and small-order A or R.
+ *
+ * @param message Signed message
+ * @param length Message length in bytes
+ * @param public_key Signer's public key
+ * @param signature Signature
+ * @return true if valid, false otherwise
+ */
+bool nova402_ed25519_verify(
+    const uint8_t *message,
+    size_t length,
+    const nova402_ed25519_public_key_t *public_key,
+    const nova402_ed25519_signature_t *signature
+);
+
+/**
+ * Verify a batch of Ed25519 signatures
+ *
+ * Gives the same result as nova402_ed25519_verify() on every item. Up to
+ * 64 signatures are checked at a time with one randomized linear
+ * combination of their equations, which shares the point doublings; a
+ * group that fails is re-checked one signature at a time.
+ *
+ * @param messages Array of messages
+ * @param lengths Array of message lengths
+ * @param public_keys Array of public keys
+ * @param signatures Array of signatures
+ * @param count Number of items in each array
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if item i is valid
+ * @return Number of valid signatures, or negative error code
+ */
+int nova402_ed25519_verify_batch(
+    const uint8_t *const *messages,
+    const size_t *lengths,
+    const nova402_ed25519_public_key_t *public_keys,
+    const nova402_ed25519_signature_t *signatures,
+    size_t count,
+    uint8_t *results
+);
+
+/**
+ * Verify a batch of Ed25519 signatures with scratch space from an arena
+ *
+ * Same as nova402_ed25519_verify_batch() without heap allocation. The
+ * batch tables need about 220 KB of arena; with less, every signature is
+ * verified individually (same results, no batch speedup) and arena->peak
+ * shows the size that was needed.
+ *
+ * @param messages Array of messages
+ * @param lengths Array of message lengths
+ * @param public_keys Array of public keys
+ * @param signatures Array of signatures
+ * @param count Number of items in each array
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if item i is valid
+ * @param arena Scratch arena (NULL for the heap)
+ * @return Number of valid signatures, or negative error code
+ */
+int nova402_ed25519_verify_batch_arena(
+    const uint8_t *const *messages,
+    const size_t *lengths,
+    const nova402_ed25519_public_key_t *public_keys,
+    const nova402_ed25519_signature_t *signatures,
+    size_t count,
+    uint8_t *results,
+    nova402_arena_t *arena
+);
+
+/* ============================================
+ * VERIFICATION CONTEXT
+ * ============================================ */
+
+/*
+ * Thread safety: a nova402_ctx_t is read-only after nova402_ctx_create()
+ * and may be shared freely; it must outlive its workers. A
+ * nova402_worker_t must not be used by two threads at once (create one
+ * per thread). Worker calls allocate nothing.
+ */
+
+/**
+ * Create a verification context
+ *
+ * Builds the secp256k1 tables and, for each network, looks up its
+ * configuration and precomputes the EIP-712 domain of its USDC contract
+ * (EVM networks only).
+ *
+ * @param networks Network names (e.g., "base-mainnet")
+ * @param network_count Number of networks
+ * @param table secp256k1 table size
+ * @return New context, or NULL on an unknown network, invalid table size
+ *         or allocation failure
+ */
+nova402_ctx_t *nova402_ctx_create(
+    const char *const *networks,
+    size_t network_count,
+    nova402_secp256k1_table_t table
+);
+
+/**
+ * Destroy a verification context
+ *
+ * @param ctx Context to free (may be NULL)
+ */
+void nova402_ctx_destroy(nova402_ctx_t *ctx);
+
+/**
+ * Get the heap memory used by a context, excluding its secp256k1 tables
+ *
+ * @param ctx Context
+ * @return Size in bytes
+ */
+size_t nova402_ctx_memory(const nova402_ctx_t *ctx);
+
+/**
+ * Look up a network of the context
+ *
+ * @param ctx Context
+ * @param network Network name
+ * @param config Output network configuration
+ * @return NOVA402_SUCCESS on success, NOVA402_ERROR_UNSUPPORTED if the
+ *         context was not created for the network
+ */
+int nova402_ctx_network_config(
+    const nova402_ctx_t *ctx,
+    const char *network,
+    nova402_network_config_t *config
+);
+
+/**
+ * Get the precomputed USDC domain of an EVM network
+ *
+ * @param ctx Context
+ * @param network Network name
+ * @return Domain owned by the context, or NULL for unknown or non-EVM networks
+ */
+const nova402_eip712_domain_t *nova402_ctx_domain(const nova402_ctx_t *ctx, const char *network);
+
+/**
+ * Get the context's secp256k1 tables, for the *_ctx recovery functions
+ *
+ * @param ctx Context
+ * @return Tables owned by the context
+ */
+const nova402_secp256k1_ctx_t *nova402_ctx_secp256k1(const nova402_ctx_t *ctx);
+
+/**
+ * Create a worker for a context
+ *
+ * @param ctx Context (must outlive the worker)
+ * @param scratch_size Bytes of scratch arena (0 for 256 KB, enough for
+ *                     Ed25519 batches)
+ * @return New worker, or NULL on allocation failure
+ */
+nova402_worker_t *nova402_worker_create(const nova402_ctx_t *ctx, size_t scratch_size);
+
+/**
+ * Destroy a worker
+ *
+ * @param worker Worker to free (may be NULL)
+ */
+void nova402_worker_destroy(nova402_worker_t *worker);
+
+/**
+ * Get a worker's scratch arena, for the *_arena functions
+ *
+ * @param worker Worker
+ * @return Arena owned by the worker
+ */
+nova402_arena_t *nova402_worker_arena(nova402_worker_t *worker);
+
+/**
+ * Verify the signature of a decoded X-PAYMENT header
+ *
+ * Uses the context's domain for header->network and checks that the
+ * signer is payment.from.
+ *
+ * @param worker Worker
+ * @param header Decoded header
+ * @return true if valid, false otherwise (including networks the context
+ *         does not know)
+ */
+bool nova402_worker_verify_payment(nova402_worker_t *worker, const nova402_payment_header_t *header);
+
+/**
+ * Verify the signatures of a batch of decoded X-PAYMENT headers
+ *
+ * Headers may mix networks; recovery is batched across all of them.
+ *
+ * @param worker Worker
+ * @param headers Array of decoded headers
+ * @param count Number of headers
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if header i is valid
+ * @return Number of valid signatures, or negative error code
+ */
+int nova402_worker_verify_payments(
+    nova402_worker_t *worker,
+    const nova402_payment_header_t *headers,
+    size_t count,
+    uint8_t *results
+);
+
+/**
+ * Verify the signatures of packed records in place
+ *
+ * Same result as nova402_worker_verify_payments() on the decoded headers,
+ * reading the records straight from a frame opened with
+ * nova402_packed_frame_open(). Records with an unknown, unconfigured or
+ * non-EVM network, or non-zero reserved bytes, are invalid.
+ *
+ * @param worker Worker
+ * @param records Array of packed records
+ * @param count Number of records
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if record i is valid
+ * @return Number of valid signatures, or negative error code
+ */
+int nova402_worker_verify_packed(
+    nova402_worker_t *worker,
+    const nova402_packed_record_t *records,
+    size_t count,
+    uint8_t *results
+);
+
+/**
+ * Verify the signatures of the rows of a payment batch
+ *
+ * Same result as nova402_worker_verify_payments() on the same payments,
+ * limited to the rows set in mask: pass the output of
+ * nova402_payment_batch_screen() so only payments that passed the cheap
+ * checks cost a recovery. Rows with an unconfigured or non-EVM network
+ * are invalid.
+ *
+ * @param worker Worker
+ * @param batch Payment batch
+ * @param mask Bitmap of (batch->count + 7) / 8 bytes selecting the rows to
+ *             verify, or NULL for every row
+ * @param results Output bitmap of (batch->count + 7) / 8 bytes; bit i is set if row i is valid
+ * @return Number of valid signatures, or negative error code
+ */
+int nova402_worker_verify_batch(
+    nova402_worker_t *worker,
+    const nova402_payment_batch_t *batch,
+    const uint8_t *mask,
+    uint8_t *results
+);
+
+/* ============================================
+ * ASYNCHRONOUS VERIFICATION
+ * ============================================ */
+
+/**
+ * Create a verification pipeline
+ *
+ * Starts the pool threads, each with its own worker on ctx. Requests are
+ * coalesced into batches for nova402_worker_verify_payments(): a batch
+ * leaves as soon as max_batch requests are waiting, or when its oldest
+ * request has waited max_linger_us, whichever comes first.
+ *
+ * @param ctx Context (must outlive the pipeline)
+ * @param config Settings, or NULL for the defaults (max_linger_us 200)
+ * @return New pipeline, or NULL on allocation or thread start failure
+ */
+nova402_pipeline_t *nova402_pipeline_create(
+    const nova402_ctx_t *ctx,
+    const nova402_pipeline_config_t *config
+);
+
+/**
+ * Stop and destroy a pipeline
+ *
+ * Waits for the requests already submitted to finish; their results that
+ * were not polled are discarded.
+ *
+ * @param pipeline Pipeline to free (may be NULL)
+ */
+void nova402_pipeline_destroy(nova402_pipeline_t *pipeline);
+
+/**
+ * Queue a decoded X-PAYMENT header for signature verification
+ *
+ * The header is copied. The result, tagged with tag, is picked up later
+ * with nova402_verify_poll(); it is the same as
+ * nova402_worker_verify_payment() on the pipeline's context.
+ *
+ * @param pipeline Pipeline
+ * @param header Decoded header
+ * @param tag Caller value returned with the result (e.g. a request id)
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_CAPACITY if capacity requests are outstanding
+ */
+int nova402_verify_submit(
+    nova402_pipeline_t *pipeline,
+    const nova402_payment_header_t *header,
+    uint64_t tag
+);
+
+/**
+ * Collect finished verifications without waiting
+ *
+ * Results come in completion order, not submission order.
+ *
+ * @param pipeline Pipeline
+ * @param completions Output array
+ * @param max_completions Capacity of completions
+ * @return Number of results written (0 if none are ready)
+ */
+size_t nova402_verify_poll(
+    nova402_pipeline_t *pipeline,
+    nova402_verify_completion_t *completions,
+    size_t max_completions
+);
+
+/**
+ * Get the number of requests submitted and not yet polled
+ *
+ * @param pipeline Pipeline
+ * @return Outstanding requests
+ */
+size_t nova402_pipeline_pending(nova402_pipeline_t *pipeline);
+
+/* ============================================
+ * SIGNER CACHE
+ * ============================================ */
+
+/**
+ * Fixed-capacity LRU cache of recovered signers (opaque)
+ *
+ * Keyed by (message hash, signature); failed recoveries are cached too.
+ * The cache is split into independently locked stripes and is safe to
+ * use from many threads.
+ */
+typedef struct nova402_signer_cache nova402_signer_cache_t;
+
+/**
+ * Signer cache counters
+ */
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t entries;       /* entries currently cached */
+    size_t capacity;      /* maximum number of entries */
+    size_t memory_bytes;  /* total memory owned by the cache */
+} nova402_signer_cache_stats_t;
+
+/**
+ * Create a signer cache
+ *
+ * All memory is allocated up front; the footprint never grows.
+ *
+ * @param capacity Maximum number of cached signers
+ * @param stripes Number of independently locked stripes (0 for the default)
+ * @return New cache, or NULL on invalid arguments or allocation failure
+ */
+nova402_signer_cache_t *nova402_signer_cache_create(size_t capacity, size_t stripes);
+
+/**
+ * Destroy a signer cache
+ *
+ * @param cache Cache to free (may be NULL)
+ */
+void nova402_signer_cache_destroy(nova402_signer_cache_t *cache);
+
+/**
+ * Drop every entry and reset the counters
+ *
+ * @param cache Signer cache
+ */
+void nova402_signer_cache_clear(nova402_signer_cache_t *cache);
+
+/**
+ * Read the cache counters
+ *
+ * @param cache Signer cache
+ * @param stats Output counters
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_signer_cache_stats(nova402_signer_cache_t *cache, nova402_signer_cache_stats_t *stats);
+
+/**
+ * Recover signer address through the cache
+ *
+ * Drop-in for nova402_recover_signer(). Misses are recovered under the
+ * rules of nova402_recover_signers_batch() (low-s, v in {0, 1, 27, 28}).
+ *
+ * @param cache Signer cache
+ * @param message Message hash
+ * @param signature Signature
+ * @param signer Output signer address
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_recover_signer_cached(
+    nova402_signer_cache_t *cache,
+    const nova402_hash_t *message,
+    const nova402_signature_t *signature,
+    nova402_address_t *signer
+);
+
+/**
+ * Verify payment signature through the cache
+ *
+ * Same result as nova402_verify_signature_ctx(); shares entries with
+ * nova402_recover_signer_cached().
+ *
+ * @param cache Signer cache
+ * @param domain Domain context, or NULL for the default domain
+ * @param payment Payment data
+ * @param signature Signature to verify
+ * @param expected_signer Expected signer address
+ * @return true if valid, false otherwise
+ */
+bool nova402_verify_signature_cached(
+    nova402_signer_cache_t *cache,
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    const nova402_signature_t *signature,
+    const nova402_address_t *expected_signer
+);
+
+/* ============================================
+ * PAYMENT HEADER
+ * ============================================ */
+
+/**
+ * Parse an X-PAYMENT header
+ *
+ * Decodes the base64 header straight into a nova402_payment_header_t
+ * without allocating. Only the fixed x402 schema is understood; other
+ * keys are skipped after being checked as JSON. The signature is read
+ * from payload.signature (65-byte hex) or from v, r and s inside
+ * payload.authorization. Integer fields may be JSON numbers or decimal
+ * strings; hex fields need the 0x prefix. Escape sequences are not
+ * accepted inside schema values.
+ *
+ * @param header Base64 header value (surrounding spaces are ignored)
+ * @param length Header length in bytes
+ * @param out Output header (zeroed first, even on error)
+ * @return NOVA402_SUCCESS on success, otherwise
+ *         NOVA402_ERROR_BUFFER_TOO_SMALL if longer than NOVA402_MAX_PAYMENT_HEADER,
+ *         NOVA402_ERROR_BASE64 for malformed base64,
+ *         NOVA402_ERROR_JSON for malformed JSON,
+ *         NOVA402_ERROR_MISSING_FIELD if a required field is absent,
+ *         NOVA402_ERROR_INVALID_FIELD for a wrongly typed, malformed,
+ *         out-of-range or repeated field,
+ *         NOVA402_ERROR_UNSUPPORTED for an x402Version other than 1 or a
+ *         scheme other than "exact"
+ */
+int nova402_parse_payment_header(
+    const char *header,
+    size_t length,
+    nova402_payment_header_t *out
+);
+
+/* ============================================
+ * PACKED WIRE FORMAT
+ * ============================================ */
+
+/*
+ * Fixed-layout binary batches for facilitator-to-facilitator traffic, an
+ * alternative to one base64 JSON header per payment. A frame is a
+ * NOVA402_PACKED_HEADER_SIZE-byte header (magic "NOVA402P", u32 version,
+ * u32 record size, u64 record count, zero padding) followed by the
+ * records: 168 bytes per payment instead of about 670 for a base64 JSON
+ * header. Frames are written and read in place; nothing is parsed per
+ * record. The layout is specified in specs/x402-protocol.md.
+ */
+
+/**
+ * Bytes needed for a frame of count records
+ *
+ * @param count Number of records
+ * @return Frame size, or 0 if it does not fit in size_t
+ */
+size_t nova402_packed_frame_size(size_t count);
+
+/**
+ * Write a frame header and hand out its records for writing
+ *
+ * @param frame Output buffer
+ * @param size Buffer size in bytes
+ * @param count Number of records the frame will hold
+ * @param records Output pointer to the count records after the header
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_BUFFER_TOO_SMALL if size < nova402_packed_frame_size(count),
+ *         NOVA402_ERROR_INVALID_INPUT otherwise
+ */
+int nova402_packed_frame_init(
+    uint8_t *frame,
+    size_t size,
+    size_t count,
+    nova402_packed_record_t **records
+);
+
+/**
+ * Check a frame header and point at its records
+ *
+ * Bytes past the end of the frame are ignored, so frames can be read back
+ * to back from a stream: the next one starts nova402_packed_frame_size(*count)
+ * bytes in.
+ *
+ * @param frame Received bytes
+ * @param length Number of bytes received
+ * @param records Output pointer to the records, inside frame
+ * @param count Output number of records
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_BUFFER_TOO_SMALL if the frame is not complete yet,
+ *         NOVA402_ERROR_UNSUPPORTED for another version or record size,
+ *         or non-zero reserved header bytes,
+ *         NOVA402_ERROR_INVALID_INPUT for a bad magic or arguments
+ */
+int nova402_packed_frame_open(
+    const uint8_t *frame,
+    size_t length,
+    const nova402_packed_record_t **records,
+    size_t *count
+);
+
+/**
+ * Pack a decoded header into a record
+ *
+ * @param record Output record
+ * @param header Decoded header
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_INVALID_FIELD for an unknown network or an
+ *         x402_version above 255, NOVA402_ERROR_INVALID_INPUT otherwise
+ */
+int nova402_packed_write(nova402_packed_record_t *record, const nova402_payment_header_t *header);
+
+/**
+ * Unpack a record into a decoded header
+ *
+ * @param record Packed record
+ * @param header Output header
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_INVALID_FIELD for an unknown network or non-zero
+ *         reserved bytes, NOVA402_ERROR_INVALID_INPUT otherwise
+ */
+int nova402_packed_read(const nova402_packed_record_t *record, nova402_payment_header_t *header);
+
+/**
+ * Pack decoded headers into one frame
+ *
+ * @param headers Array of decoded headers
+ * @param count Number of headers
+ * @param frame Output buffer
+ * @param size Buffer size in bytes
+ * @param written Output frame size in bytes; set to the required size
+ *                when the buffer is too small
+ * @return NOVA402_SUCCESS on success, error code of the first header that
+ *         nova402_packed_write() rejects, or as nova402_packed_frame_init()
+ */
+int nova402_packed_encode(
+    const nova402_payment_header_t *headers,
+    size_t count,
+    uint8_t *frame,
+    size_t size,
+    size_t *written
+);
+
+/* ============================================
+ * PAYMENT BATCHES
+ * ============================================ */
+
+/*
+ * First-stage filter for facilitator batches. Payments are loaded into
+ * columns, and nova402_payment_batch_screen() runs the checks of
+ * nova402_validate_payment() that need no signature over the whole batch
+ * with the widest vector kernel the CPU supports. Rows that pass are
+ * handed to nova402_worker_verify_batch(); junk never reaches the curve.
+ */
+
+/**
+ * Allocate an empty payment batch
+ *
+ * @param capacity Maximum number of rows (at most INT_MAX)
+ * @return New batch, or NULL on invalid capacity or allocation failure
+ */
+nova402_payment_batch_t *nova402_payment_batch_create(size_t capacity);
+
+/**
+ * Destroy a payment batch
+ *
+ * @param batch Batch to free (may be NULL)
+ */
+void nova402_payment_batch_destroy(nova402_payment_batch_t *batch);
+
+/**
+ * Replace the contents of a batch with decoded headers
+ *
+ * Headers naming an unknown network load with NOVA402_NETWORK_ID_UNKNOWN
+ * and never pass a screen.
+ *
+ * @param batch Payment batch
+ * @param headers Array of decoded headers
+ * @param count Number of headers
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_BUFFER_TOO_SMALL if count exceeds the capacity,
+ *         NOVA402_ERROR_INVALID_INPUT otherwise
+ */
+int nova402_payment_batch_load_headers(
+    nova402_payment_batch_t *batch,
+    const nova402_payment_header_t *headers,
+    size_t count
+);
+
+/**
+ * Replace the contents of a batch with payments on one network
+ *
+ * @param batch Payment batch
+ * @param network Network of every payment
+ * @param payments Array of payments
+ * @param signatures Array of signatures, or NULL to zero the column
+ * @param count Number of payments
+ * @return As nova402_payment_batch_load_headers()
+ */
+int nova402_payment_batch_load_payments(
+    nova402_payment_batch_t *batch,
+    nova402_network_id_t network,
+    const nova402_payment_data_t *payments,
+    const nova402_signature_t *signatures,
+    size_t count
+);
+
+/**
+ * Replace the contents of a batch with packed records
+ *
+ * Records that nova402_packed_read() rejects load with
+ * NOVA402_NETWORK_ID_UNKNOWN and never pass a screen.
+ *
+ * @param batch Payment batch
+ * @param records Array of packed records
+ * @param count Number of records
+ * @return As nova402_payment_batch_load_headers()
+ */
+int nova402_payment_batch_load_packed(
+    nova402_payment_batch_t *batch,
+    const nova402_packed_record_t *records,
+    size_t count
+);
+
+/**
+ * Copy one row of a batch back out
+ *
+ * @param batch Payment batch
+ * @param index Row index, below batch->count
+ * @param payment Output payment
+ * @param signature Output signature (may be NULL)
+ * @return NOVA402_SUCCESS on success, NOVA402_ERROR_INVALID_INPUT otherwise
+ */
+int nova402_payment_batch_get(
+    const nova402_payment_batch_t *batch,
+    size_t index,
+    nova402_payment_data_t *payment,
+    nova402_signature_t *signature
+);
+
+/**
+ * Run the cheap checks of nova402_validate_payment() over a batch
+ *
+ * A row passes when its network is the required one, it pays pay_to at
+ * least max_amount_required, and valid_after <= now < valid_before; the
+ * same rows for which nova402_validate_payment() gets as far as the
+ * signature. requirements->domain is not read.
+ *
+ * @param batch Payment batch
+ * @param requirements Resolved requirements
+ * @param now Current Unix time in seconds, read once by the caller
+ * @param results Output bitmap of (batch->count + 7) / 8 bytes; bit i is set if row i passes
+ * @return Number of rows that pass, or negative error code
+ */
+int nova402_payment_batch_screen(
+    const nova402_payment_batch_t *batch,
+    const nova402_payment_requirements_t *requirements,
+    uint64_t now,
+    uint8_t *results
+);
+
+/* ============================================
+ * REPLAY PROTECTION
+ * ============================================ */
+
+/**
+ * Concurrent set of seen payment nonces (opaque)
+ *
+ * Nonces are filed into time-bucketed generations by their valid_before
+ * and drop out once their generation has passed, so memory is fixed at
+ * creation. Inserts and lookups are lock-free.
+ */
+typedef struct nova402_nonce_set nova402_nonce_set_t;
+
+/**
+ * Create a nonce set
+ *
+ * The set accepts valid_before deadlines up to
+ * generations * generation_seconds in the future.
+ *
+ * @param capacity Maximum live nonces per generation (at most 2^32 - 1);
+ *        inserts into a full generation return NOVA402_ERROR_CAPACITY
+ * @param generation_seconds Time span of one generation (0 for 60)
+ * @param generations Number of generations (0 for 16)
+ * @return New set, or NULL on invalid arguments or allocation failure
+ */
+nova402_nonce_set_t *nova402_nonce_set_create(
+    size_t capacity,
+    uint64_t generation_seconds,
+    size_t generations
+);
+
+/**
+ * Destroy a nonce set
+ *
+ * @param set Set to free (may be NULL)
+ */
+void nova402_nonce_set_destroy(nova402_nonce_set_t *set);
+
+/**
+ * Record a nonce unless it was already seen
+ *
+ * The time window is checked first, at nova402_clock_now().
+ *
+ * @param set Nonce set
+ * @param nonce Nonce (NOVA402_NONCE_SIZE bytes)
+ * @param valid_after Validity start timestamp
+ * @param valid_before Validity end timestamp
+ * @return NOVA402_SUCCESS if the nonce is new,
+ *         NOVA402_ERROR_NONCE_REUSED if it was already recorded,
+ *         NOVA402_ERROR_EXPIRED if the time window is not current,
+ *         NOVA402_ERROR_CAPACITY if valid_before is beyond the set's
+ *         horizon or its generation is full
  */
-int nova402_double_keccak256(const uint8_t *data, size_t length, nova402_hash_t *hash);
-
-/* ============================================
- * SIGNATURE FUNCTIONS
- * ============================================ */
+int nova402_nonce_set_insert(
+    nova402_nonce_set_t *set,
+    const uint8_t *nonce,
+    uint64_t valid_after,
+    uint64_t valid_before
+);
 
 /**
- * Sign payment data with private key
- * 
- * @param payment Payment data to sign
- * @param private_key Private key (32 bytes)
- * @param signature Output signature
- * @return NOVA402_SUCCESS on success, error code otherwise
+ * Check whether a live nonce has been recorded
+ *
+ * @param set Nonce set
+ * @param nonce Nonce (NOVA402_NONCE_SIZE bytes)
+ * @param valid_before Validity end timestamp the nonce was recorded with
+ * @return true if recorded and not yet expired, false otherwise
  */
-int nova402_sign_payment(
-    const nova402_payment_data_t *payment,
-    const uint8_t *private_key,
-    nova402_signature_t *signature
+bool nova402_nonce_set_contains(
+    const nova402_nonce_set_t *set,
+    const uint8_t *nonce,
+    uint64_t valid_before
 );
 
 /**
- * Verify payment signature
- * 
- * @param payment Payment data
- * @param signature Signature to verify
- * @param expected_signer Expected signer address
- * @return true if valid, false otherwise
+ * nova402_nonce_set_insert() at a caller-supplied time
+ *
+ * @param now Current Unix time in seconds
  */
-bool nova402_verify_signature(
-    const nova402_payment_data_t *payment,
-    const nova402_signature_t *signature,
-    const nova402_address_t *expected_signer
+int nova402_nonce_set_insert_at(
+    nova402_nonce_set_t *set,
+    const uint8_t *nonce,
+    uint64_t valid_after,
+    uint64_t valid_before,
+    uint64_t now
 );
 
 /**
- * Recover signer address from signature
- * 
- * @param message Message hash
- * @param signature Signature
- * @param signer Output signer address
- * @return NOVA402_SUCCESS on success, error code otherwise
+ * nova402_nonce_set_contains() at a caller-supplied time
+ *
+ * @param now Current Unix time in seconds
  */
-int nova402_recover_signer(
-    const nova402_hash_t *message,
-    const nova402_signature_t *signature,
-    nova402_address_t *signer
+bool nova402_nonce_set_contains_at(
+    const nova402_nonce_set_t *set,
+    const uint8_t *nonce,
+    uint64_t valid_before,
+    uint64_t now
 );
 
+/**
+ * Memory owned by a nonce set
+ *
+ * @param set Nonce set
+ * @return Size in bytes (0 for NULL)
+ */
+size_t nova402_nonce_set_memory(const nova402_nonce_set_t *set);
+
 /* ============================================
  * VALIDATION FUNCTIONS
  * ============================================ */
@@ -213,6 +1944,75 @@ bool nova402_validate_not_expired(uint64_t valid_before);
  */
 bool nova402_validate_time_window(uint64_t valid_after, uint64_t valid_before);
 
+/**
+ * nova402_validate_not_expired() at a caller-supplied time
+ *
+ * For batches: read the clock once and check every item against it.
+ *
+ * @param valid_before Validity deadline timestamp
+ * @param now Current Unix time in seconds
+ * @return true if not expired, false if expired
+ */
+bool nova402_validate_not_expired_at(uint64_t valid_before, uint64_t now);
+
+/**
+ * nova402_validate_time_window() at a caller-supplied time
+ *
+ * @param valid_after Validity start timestamp
+ * @param valid_before Validity end timestamp
+ * @param now Current Unix time in seconds
+ * @return true if valid_after <= now < valid_before, false otherwise
+ */
+bool nova402_validate_time_window_at(uint64_t valid_after, uint64_t valid_before, uint64_t now);
+
+/**
+ * Validate Ethereum address format and EIP-55 checksum
+ *
+ * All-lowercase and all-uppercase addresses carry no checksum and pass
+ * on format alone.
+ *
+ * @param address Address string (hex with 0x prefix)
+ * @return true if valid, false otherwise
+ */
+bool nova402_validate_address_checksum(const char *address);
+
+/**
+ * Validate many addresses
+ *
+ * Checksums are hashed several at a time with the multi-buffer Keccak
+ * kernel.
+ *
+ * @param addresses Array of NUL-terminated address strings (NULL entries are invalid)
+ * @param count Number of addresses
+ * @param check Check to perform
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if address i is valid
+ * @return Number of valid addresses, or negative error code
+ */
+int nova402_validate_addresses(
+    const char *const *addresses,
+    size_t count,
+    nova402_address_check_t check,
+    uint8_t *results
+);
+
+/**
+ * Validate a decoded X-PAYMENT header against payment requirements
+ *
+ * Runs every check in one pass over the header, cheapest first: network,
+ * recipient, amount and time window are all compared before the signature
+ * is recovered, so a rejected header costs no elliptic-curve work.
+ *
+ * @param requirements Resolved requirements (domain must match network)
+ * @param header Decoded header
+ * @param now Current Unix time in seconds, read once by the caller
+ * @return NOVA402_PAYMENT_VALID, or the first check that failed
+ */
+nova402_payment_status_t nova402_validate_payment(
+    const nova402_payment_requirements_t *requirements,
+    const nova402_payment_header_t *header,
+    uint64_t now
+);
+
 /* ============================================
  * UTILITY FUNCTIONS
  * ============================================ */
@@ -253,6 +2053,108 @@ int nova402_generate_nonce(uint8_t *nonce);
  */
 uint64_t nova402_timestamp(void);
 
+/**
+ * Get the current Unix time for validation
+ *
+ * While a cached clock is active (nova402_clock_tick() or
+ * nova402_clock_start()) this is a single atomic load; otherwise it reads
+ * the coarse real-time clock.
+ *
+ * @return Current timestamp in seconds
+ */
+uint64_t nova402_clock_now(void);
+
+/**
+ * Refresh the cached clock from the system clock
+ *
+ * The first call switches nova402_clock_now() to the cached value; an
+ * event loop can call this once per iteration instead of starting the
+ * ticker. Safe to call from any thread.
+ */
+void nova402_clock_tick(void);
+
+/**
+ * Start a background thread that calls nova402_clock_tick()
+ *
+ * Not thread-safe against nova402_clock_stop(); call both from setup and
+ * teardown code. Does nothing if the ticker is already running.
+ *
+ * @param interval_ms Tick interval in milliseconds (0: 1000)
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_CAPACITY if the thread could not be started
+ */
+int nova402_clock_start(uint32_t interval_ms);
+
+/**
+ * Stop the ticker thread, if any, and turn the cached clock off
+ */
+void nova402_clock_stop(void);
+
+/**
+ * Convert hashes to hex
+ *
+ * @param hashes Array of hashes
+ * @param count Number of hashes
+ * @param hex Output of count * NOVA402_HASH_HEX_SIZE bytes; entry i is the
+ *            NUL-terminated "0x" string at hex + i * NOVA402_HASH_HEX_SIZE
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_hashes_to_hex(const nova402_hash_t *hashes, size_t count, char *hex);
+
+/**
+ * Convert addresses to hex
+ *
+ * @param addresses Array of addresses
+ * @param count Number of addresses
+ * @param checksum true for EIP-55 mixed case, false for lowercase
+ * @param hex Output of count * NOVA402_ADDRESS_HEX_SIZE bytes; entry i is the
+ *            NUL-terminated "0x" string at hex + i * NOVA402_ADDRESS_HEX_SIZE
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_addresses_to_hex(
+    const nova402_address_t *addresses,
+    size_t count,
+    bool checksum,
+    char *hex
+);
+
+/**
+ * Convert hex strings to hashes
+ *
+ * Each string must hold exactly 64 hex digits after an optional 0x prefix.
+ *
+ * @param hex Array of NUL-terminated hex strings
+ * @param count Number of strings
+ * @param hashes Output hashes (valid where the result bit is set)
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if string i converted
+ * @return Number of converted strings, or negative error code
+ */
+int nova402_hex_to_hashes(
+    const char *const *hex,
+    size_t count,
+    nova402_hash_t *hashes,
+    uint8_t *results
+);
+
+/**
+ * Convert hex strings to addresses
+ *
+ * Each string must hold exactly 40 hex digits after an optional 0x prefix;
+ * the checksum is not checked.
+ *
+ * @param hex Array of NUL-terminated hex strings
+ * @param count Number of strings
+ * @param addresses Output addresses (valid where the result bit is set)
+ * @param results Output bitmap of (count + 7) / 8 bytes; bit i is set if string i converted
+ * @return Number of converted strings, or negative error code
+ */
+int nova402_hex_to_addresses(
+    const char *const *hex,
+    size_t count,
+    nova402_address_t *addresses,
+    uint8_t *results
+);
+
 /* ============================================
  * NETWORK FUNCTIONS
  * ============================================ */
@@ -276,6 +2178,44 @@ int nova402_get_network_config(const char *network, nova402_network_config_t *co
  */
 int nova402_get_usdc_address(const char *network, char *address, size_t address_size);
 
+/**
+ * Resolve a network name to its interned ID
+ *
+ * One hash and one compare, with no allocation.
+ *
+ * @param network Network name (e.g., "base-mainnet"); need not be NUL-terminated
+ * @param length Length of network in bytes
+ * @return Network ID, or NOVA402_NETWORK_ID_UNKNOWN
+ */
+nova402_network_id_t nova402_network_lookup(const char *network, size_t length);
+
+/**
+ * Resolve a CAIP-2 chain ID to its interned network ID
+ *
+ * @param caip2 CAIP-2 ID (e.g., "eip155:8453", "solana:mainnet"); need not
+ *              be NUL-terminated
+ * @param length Length of caip2 in bytes
+ * @return Network ID, or NOVA402_NETWORK_ID_UNKNOWN
+ */
+nova402_network_id_t nova402_network_lookup_caip2(const char *caip2, size_t length);
+
+/**
+ * Get the static data for a network
+ *
+ * @param id Network ID
+ * @return Pointer to static data, or NULL for an unknown ID
+ */
+const nova402_network_info_t *nova402_network_info(nova402_network_id_t id);
+
+/**
+ * Get the decoded USDC contract address of an EVM network
+ *
+ * @param id Network ID
+ * @return Pointer to static address, or NULL if the network is not EVM or
+ *         has no USDC deployment
+ */
+const nova402_address_t *nova402_network_usdc(nova402_network_id_t id);
+
 /* ============================================
  * MERKLE TREE FUNCTIONS
  * ============================================ */
@@ -312,6 +2252,477 @@ bool nova402_verify_merkle_proof(
     size_t index
 );
 
+/**
+ * Merkle tree with every layer kept for proof extraction (opaque)
+ *
+ * Built with the same sorted-pair hashing as nova402_merkle_root(); all
+ * layers share one cache-aligned allocation. Immutable once created, so
+ * it may be read from many threads.
+ */
+typedef struct nova402_merkle_tree nova402_merkle_tree_t;
+
+/**
+ * Build a Merkle tree
+ *
+ * @param leaves Array of leaf hashes (copied)
+ * @param leaf_count Number of leaves (at least 1)
+ * @return New tree, or NULL on invalid arguments or allocation failure
+ */
+nova402_merkle_tree_t *nova402_merkle_tree_create(
+    const nova402_hash_t *leaves,
+    size_t leaf_count
+);
+
+/**
+ * Destroy a Merkle tree (built or mapped)
+ *
+ * @param tree Tree to free (may be NULL)
+ */
+void nova402_merkle_tree_destroy(nova402_merkle_tree_t *tree);
+
+/**
+ * Get the root of a tree
+ *
+ * @param tree Merkle tree
+ * @param root Output Merkle root
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_merkle_tree_root(const nova402_merkle_tree_t *tree, nova402_hash_t *root);
+
+/**
+ * Get the number of leaves in a tree
+ *
+ * @param tree Merkle tree
+ * @return Leaf count (0 for NULL)
+ */
+size_t nova402_merkle_tree_leaf_count(const nova402_merkle_tree_t *tree);
+
+/**
+ * Get the number of layers above the leaves, an upper bound on proof length
+ *
+ * @param tree Merkle tree
+ * @return Tree depth (0 for a single leaf or NULL)
+ */
+size_t nova402_merkle_tree_depth(const nova402_merkle_tree_t *tree);
+
+/**
+ * Get the memory owned by a tree
+ *
+ * @param tree Merkle tree
+ * @return Size in bytes (0 for NULL)
+ */
+size_t nova402_merkle_tree_memory(const nova402_merkle_tree_t *tree);
+
+/**
+ * Extract the proof for one leaf in O(log n)
+ *
+ * Siblings are listed from the leaf layer up; layers where the node was
+ * promoted without a sibling contribute nothing. The result verifies with
+ * nova402_verify_merkle_proof().
+ *
+ * @param tree Merkle tree
+ * @param index Leaf index
+ * @param proof Output sibling hashes
+ * @param proof_capacity Number of hashes proof can hold
+ *                       (nova402_merkle_tree_depth() always suffices)
+ * @param proof_length Output number of proof hashes; set to the required
+ *                     length when the buffer is too small
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_BUFFER_TOO_SMALL if proof_capacity is too small,
+ *         NOVA402_ERROR_INVALID_INPUT for a bad index or argument
+ */
+int nova402_merkle_proof(
+    const nova402_merkle_tree_t *tree,
+    size_t index,
+    nova402_hash_t *proof,
+    size_t proof_capacity,
+    size_t *proof_length
+);
+
+/**
+ * Write a tree to a file that nova402_merkle_tree_open_mmap() can map
+ *
+ * The file holds a one-page header followed by the layers, root first, so
+ * the upper layers every proof reads share a few pages.
+ *
+ * @param tree Merkle tree
+ * @param path File to create or replace
+ * @return NOVA402_SUCCESS on success, NOVA402_ERROR_IO if the file cannot
+ *         be written, error code otherwise
+ */
+int nova402_merkle_tree_save(const nova402_merkle_tree_t *tree, const char *path);
+
+/**
+ * Open a tree file written by nova402_merkle_tree_save() without loading it
+ *
+ * The file is mapped read-only and proofs are served from the mapping, so
+ * opening costs the same for any tree size and only the pages proofs touch
+ * are read. The file must not be modified while the tree is open. The
+ * result works with every nova402_merkle_tree_* and nova402_merkle_proof()
+ * call; nova402_merkle_tree_memory() counts the heap part only.
+ *
+ * @param path Tree file
+ * @return Tree, or NULL if the file cannot be mapped or is not a tree file
+ *         of this version
+ */
+nova402_merkle_tree_t *nova402_merkle_tree_open_mmap(const char *path);
+
+/**
+ * Extract one multiproof covering several leaves
+ *
+ * The proof lists the siblings the verifier cannot compute, layer by layer
+ * from the leaves up and left to right within each layer. Siblings shared
+ * between the leaves appear once; siblings that are leaves of the set (or
+ * their ancestors) are left out. Together with the leaf count and the
+ * indices it verifies with nova402_verify_merkle_multiproof().
+ *
+ * @param tree Merkle tree
+ * @param indices Leaf indices, strictly increasing
+ * @param count Number of indices (at least 1)
+ * @param proof Output sibling hashes
+ * @param proof_capacity Number of hashes proof can hold
+ *                       (count * nova402_merkle_tree_depth() always suffices)
+ * @param proof_length Output number of proof hashes; set to the required
+ *                     length when the buffer is too small
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_BUFFER_TOO_SMALL if proof_capacity is too small,
+ *         NOVA402_ERROR_INVALID_INPUT for bad indices or arguments
+ */
+int nova402_merkle_multiproof(
+    const nova402_merkle_tree_t *tree,
+    const size_t *indices,
+    size_t count,
+    nova402_hash_t *proof,
+    size_t proof_capacity,
+    size_t *proof_length
+);
+
+/**
+ * Verify a multiproof from nova402_merkle_multiproof()
+ *
+ * Every internal node on the paths to the root is hashed once, however many
+ * leaves share it.
+ *
+ * @param leaves Leaf hashes, in the order of indices
+ * @param indices Leaf indices, strictly increasing
+ * @param count Number of leaves (at least 1)
+ * @param leaf_count Number of leaves in the tree
+ * @param proof Array of proof hashes
+ * @param proof_length Number of proof hashes
+ * @param root Expected Merkle root
+ * @return true if valid, false otherwise (including allocation failure)
+ */
+bool nova402_verify_merkle_multiproof(
+    const nova402_hash_t *leaves,
+    const size_t *indices,
+    size_t count,
+    size_t leaf_count,
+    const nova402_hash_t *proof,
+    size_t proof_length,
+    const nova402_hash_t *root
+);
+
+/**
+ * Verify a multiproof with scratch space from an arena
+ *
+ * Same as nova402_verify_merkle_multiproof() without heap allocation.
+ * Needs count * (3 * NOVA402_HASH_SIZE + sizeof(size_t)) bytes of arena,
+ * plus 128 for alignment.
+ *
+ * @param leaves Leaf hashes, in the order of indices
+ * @param indices Leaf indices, strictly increasing
+ * @param count Number of leaves (at least 1)
+ * @param leaf_count Number of leaves in the tree
+ * @param proof Array of proof hashes
+ * @param proof_length Number of proof hashes
+ * @param root Expected Merkle root
+ * @param arena Scratch arena (NULL for the heap)
+ * @return true if valid, false otherwise (including an exhausted arena;
+ *         arena->peak then shows the size that was needed)
+ */
+bool nova402_verify_merkle_multiproof_arena(
+    const nova402_hash_t *leaves,
+    const size_t *indices,
+    size_t count,
+    size_t leaf_count,
+    const nova402_hash_t *proof,
+    size_t proof_length,
+    const nova402_hash_t *root,
+    nova402_arena_t *arena
+);
+
+/**
+ * Compute Merkle root on several cores
+ *
+ * The leaves are split into power-of-two subtrees that are hashed in
+ * parallel and joined at the top; the root is identical to
+ * nova402_merkle_root(). Small inputs are hashed on the calling thread.
+ *
+ * @param leaves Array of leaf hashes
+ * @param leaf_count Number of leaves
+ * @param threads Parallelism to split for (0 for one per CPU); without an
+ *                executor, the number of threads used
+ * @param executor Executor to run the subtrees on, or NULL to start threads
+ * @param root Output Merkle root
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_merkle_root_parallel(
+    const nova402_hash_t *leaves,
+    size_t leaf_count,
+    size_t threads,
+    const nova402_executor_t *executor,
+    nova402_hash_t *root
+);
+
+/**
+ * Initialize an empty Merkle accumulator
+ *
+ * @param stream Accumulator to initialize
+ */
+void nova402_merkle_stream_init(nova402_merkle_stream_t *stream);
+
+/**
+ * Append a leaf
+ *
+ * Costs amortized one pair hash per leaf.
+ *
+ * @param stream Merkle accumulator
+ * @param leaf Leaf hash
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_CAPACITY once 2^64 - 1 leaves have been pushed
+ */
+int nova402_merkle_stream_push(nova402_merkle_stream_t *stream, const nova402_hash_t *leaf);
+
+/**
+ * Root of the leaves pushed so far
+ *
+ * Identical to nova402_merkle_root() over the same leaf sequence; costs at
+ * most one pair hash per frontier entry. The accumulator is not modified.
+ *
+ * @param stream Merkle accumulator
+ * @param root Output Merkle root
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_INVALID_INPUT if no leaf has been pushed
+ */
+int nova402_merkle_stream_root(const nova402_merkle_stream_t *stream, nova402_hash_t *root);
+
+/**
+ * Copy the accumulator state so that both copies can be extended
+ * independently, e.g. to publish a root while pushing continues
+ *
+ * @param stream Merkle accumulator
+ * @param snapshot Output copy
+ */
+void nova402_merkle_stream_snapshot(const nova402_merkle_stream_t *stream,
+                                    nova402_merkle_stream_t *snapshot);
+
+/**
+ * Sparse Merkle tree keyed by 32-byte nonces (opaque)
+ *
+ * Maps keys to non-zero 32-byte values and proves both that a key holds a
+ * value and that it holds none. Subtrees with one key are stored as that
+ * key's leaf and empty subtrees hash to zero, so lookups, proofs and
+ * updates cost about log2(n) levels for n random keys:
+ *
+ *   empty     32 zero bytes
+ *   leaf      keccak256(0x00 || key || value)
+ *   internal  keccak256(0x01 || left || right)
+ *
+ * The key space is split by prefix into shards with their own node
+ * arenas, updated in parallel. A tree takes about 125 bytes per key;
+ * 10^8 keys fit in about 12.5 GB. Reads may run concurrently with each
+ * other but not with an update.
+ */
+typedef struct nova402_sparse_merkle nova402_sparse_merkle_t;
+
+/**
+ * Create an empty sparse Merkle tree
+ *
+ * The root of an empty tree is 32 zero bytes.
+ *
+ * @param shard_bits Key bits that select a shard, at most
+ *                   NOVA402_SPARSE_MERKLE_MAX_SHARD_BITS; 0 for
+ *                   NOVA402_SPARSE_MERKLE_DEFAULT_SHARD_BITS
+ * @return New tree, or NULL on invalid arguments or allocation failure
+ */
+nova402_sparse_merkle_t *nova402_sparse_merkle_create(unsigned shard_bits);
+
+/**
+ * Destroy a sparse Merkle tree
+ *
+ * @param tree Tree to free (may be NULL)
+ */
+void nova402_sparse_merkle_destroy(nova402_sparse_merkle_t *tree);
+
+/**
+ * Set the values of a batch of keys
+ *
+ * A zero value removes its key. When a key repeats, its last update wins.
+ * Paths shared by several keys are rebuilt and hashed once for the whole
+ * batch, each shard on its own thread, deepest level first with the
+ * multi-buffer Keccak kernel. Small batches run on the calling thread.
+ *
+ * @param tree Sparse Merkle tree
+ * @param keys Array of keys, e.g. nova402_payment_batch_t.nonce
+ * @param values Array of values
+ * @param count Number of updates
+ * @param threads Parallelism (0 for one per CPU); without an executor,
+ *                the number of threads used
+ * @param executor Executor to run the shards on, or NULL to start threads
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_CAPACITY if memory runs out or a shard would pass
+ *         2^31 nodes (the tree is then unchanged),
+ *         NOVA402_ERROR_INVALID_INPUT otherwise
+ */
+int nova402_sparse_merkle_update(
+    nova402_sparse_merkle_t *tree,
+    const uint8_t (*keys)[NOVA402_NONCE_SIZE],
+    const nova402_hash_t *values,
+    size_t count,
+    size_t threads,
+    const nova402_executor_t *executor
+);
+
+/**
+ * Get the root of a sparse Merkle tree
+ *
+ * @param tree Sparse Merkle tree
+ * @param root Output root
+ * @return NOVA402_SUCCESS on success, error code otherwise
+ */
+int nova402_sparse_merkle_root(const nova402_sparse_merkle_t *tree, nova402_hash_t *root);
+
+/**
+ * Get the number of keys in a sparse Merkle tree
+ *
+ * @param tree Sparse Merkle tree
+ * @return Key count (0 for NULL)
+ */
+size_t nova402_sparse_merkle_count(const nova402_sparse_merkle_t *tree);
+
+/**
+ * Get the memory owned by a sparse Merkle tree
+ *
+ * @param tree Sparse Merkle tree
+ * @return Size in bytes (0 for NULL)
+ */
+size_t nova402_sparse_merkle_memory(const nova402_sparse_merkle_t *tree);
+
+/**
+ * Look up the value of a key
+ *
+ * @param tree Sparse Merkle tree
+ * @param key 32-byte key
+ * @param value Output value (may be NULL)
+ * @return true if the key is in the tree
+ */
+bool nova402_sparse_merkle_get(const nova402_sparse_merkle_t *tree, const uint8_t *key, nova402_hash_t *value);
+
+/**
+ * Prove the value of a key, or its absence
+ *
+ * The same call serves both: the proof ends at the key's leaf when the
+ * key is present, and at an empty subtree or another key's leaf when it
+ * is not. Never allocates.
+ *
+ * @param tree Sparse Merkle tree
+ * @param key 32-byte key
+ * @param proof Output proof
+ * @return NOVA402_SUCCESS on success, NOVA402_ERROR_INVALID_INPUT otherwise
+ */
+int nova402_sparse_merkle_prove(
+    const nova402_sparse_merkle_t *tree,
+    const uint8_t *key,
+    nova402_sparse_merkle_proof_t *proof
+);
+
+/**
+ * Verify a proof from nova402_sparse_merkle_prove()
+ *
+ * @param root Expected root
+ * @param key 32-byte key
+ * @param value Value the key must hold, or NULL to verify that the key is
+ *              absent
+ * @param proof Proof
+ * @return true if the proof shows key holding value (or no value) under root
+ */
+bool nova402_sparse_merkle_verify(
+    const nova402_hash_t *root,
+    const uint8_t *key,
+    const nova402_hash_t *value,
+    const nova402_sparse_merkle_proof_t *proof
+);
+
+/* ============================================
+ * INSTRUMENTATION
+ * ============================================ */
+
+/*
+ * Built only with the ENABLE_STATS CMake option (NOVA402_ENABLE_STATS);
+ * otherwise the hooks compile to nothing and nova402_stats_snapshot()
+ * reports NOVA402_ERROR_UNSUPPORTED. Each thread records into its own
+ * counters, so the hot path takes no locks and shares no cache lines.
+ */
+
+/**
+ * Check whether the library was built with instrumentation
+ *
+ * @return true if entry points record statistics
+ */
+bool nova402_stats_enabled(void);
+
+/**
+ * Sum the counters and histograms of every thread
+ *
+ * Lock-free and safe to call while other threads are recording. Each
+ * value is exact as of its read; fields may be skewed against each other
+ * by calls in flight. Counters only grow, including across thread exits,
+ * so they can be exported as Prometheus counters. The struct is about
+ * 56 KB.
+ *
+ * @param stats Output snapshot
+ * @return NOVA402_SUCCESS on success,
+ *         NOVA402_ERROR_UNSUPPORTED if built without instrumentation
+ *         (stats is zeroed)
+ */
+int nova402_stats_snapshot(nova402_stats_t *stats);
+
+/**
+ * Get the metric name of an entry point, e.g. "verify_signature"
+ *
+ * @param op Entry point
+ * @return Static name, or NULL if op is out of range
+ */
+const char *nova402_stats_op_name(nova402_stat_op_t op);
+
+/**
+ * Get the metric name of an event counter, e.g. "signer_cache_hits"
+ *
+ * @param counter Counter
+ * @return Static name, or NULL if counter is out of range
+ */
+const char *nova402_stats_counter_name(nova402_stat_counter_t counter);
+
+/**
+ * Get the largest latency, in nanoseconds, that falls into a bucket
+ *
+ * Usable as the inclusive "le" bound of a Prometheus histogram.
+ *
+ * @param bucket Bucket index
+ * @return Upper bound, or UINT64_MAX for the last bucket
+ */
+uint64_t nova402_stats_bucket_upper_ns(size_t bucket);
+
+/**
+ * Estimate a latency quantile from a histogram
+ *
+ * @param op Entry point counters
+ * @param q Quantile in [0, 1], e.g. 0.99
+ * @return Upper bound of the bucket holding the quantile, or 0 if
+ *         nothing was timed
+ */
+uint64_t nova402_stats_quantile_ns(const nova402_op_stats_t *op, double q);
+
 /* ============================================
  * VERSION FUNCTIONS
  * ============================================ */
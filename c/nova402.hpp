@@ -0,0 +1,1097 @@
+/**
+ * Nova402 C Library - C++17 interface
+ *
+ * Header-only layer over nova402.h. Buffers are passed as spans, so any
+ * contiguous container goes straight to the C batch functions without a
+ * copy; library objects are move-only RAII handles; and the network table
+ * is constexpr, so a network named at compile time needs no lookup at run
+ * time. Errors are the C status codes: functions return NOVA402_SUCCESS,
+ * a count, or a negative NOVA402_ERROR_*, and handles are empty (false)
+ * when creation failed. Nothing here throws or allocates.
+ *
+ * @file nova402.hpp
+ * @version 1.0.0
+ * @license Apache-2.0
+ */
+
+#ifndef NOVA402_HPP
+#define NOVA402_HPP
+
+#include "nova402.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#define NOVA402_HAVE_STD_SPAN 1
+#endif
+#endif
+
+namespace nova402 {
+
+/* ============================================
+ * TYPES
+ * ============================================ */
+
+using hash_t = nova402_hash_t;
+using address_t = nova402_address_t;
+using signature_t = nova402_signature_t;
+using payment_data_t = nova402_payment_data_t;
+using payment_header_t = nova402_payment_header_t;
+using packed_record_t = nova402_packed_record_t;
+using payment_requirements_t = nova402_payment_requirements_t;
+using eip712_domain_t = nova402_eip712_domain_t;
+using ed25519_public_key_t = nova402_ed25519_public_key_t;
+using ed25519_signature_t = nova402_ed25519_signature_t;
+using sparse_merkle_proof_t = nova402_sparse_merkle_proof_t;
+using verify_completion_t = nova402_verify_completion_t;
+using network_id = nova402_network_id_t;
+
+/* Nonces and sparse Merkle keys */
+using nonce_t = std::array<uint8_t, NOVA402_NONCE_SIZE>;
+static_assert(sizeof(nonce_t) == NOVA402_NONCE_SIZE, "nonce_t must be plain bytes");
+
+/* Bytes of a results bitmap for count items */
+constexpr std::size_t bitmap_size(std::size_t count) noexcept
+{
+    return (count + 7) / 8;
+}
+
+/* ============================================
+ * SPANS
+ * ============================================ */
+
+#ifdef NOVA402_HAVE_STD_SPAN
+
+template <class T>
+using span = std::span<T>;
+
+#else
+
+/**
+ * Minimal std::span for C++17: a pointer and a length
+ *
+ * Converts implicitly from C arrays, std::array and any container with
+ * contiguous data() and size(), like the dynamic-extent std::span it
+ * stands in for.
+ */
+template <class T>
+class span {
+    template <class R>
+    using data_of = decltype(std::data(std::declval<R &>()));
+
+    template <class R, class = void>
+    struct is_compatible : std::false_type {};
+
+    template <class R>
+    struct is_compatible<R, std::void_t<data_of<R>, decltype(std::size(std::declval<R &>()))>>
+        : std::is_convertible<std::remove_pointer_t<data_of<R>> (*)[], T (*)[]> {};
+
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using pointer = T *;
+    using reference = T &;
+    using iterator = T *;
+
+    constexpr span() noexcept = default;
+    constexpr span(T *data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+    template <class R, class = std::enable_if_t<!std::is_same_v<std::remove_cv_t<std::remove_reference_t<R>>, span> &&
+                                                is_compatible<std::remove_reference_t<R>>::value>>
+    constexpr span(R &&range) noexcept : data_(std::data(range)), size_(std::size(range))
+    {
+    }
+
+    constexpr T *data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr std::size_t size_bytes() const noexcept { return size_ * sizeof(T); }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr T &operator[](std::size_t i) const noexcept { return data_[i]; }
+    constexpr T *begin() const noexcept { return data_; }
+    constexpr T *end() const noexcept { return data_ + size_; }
+
+    constexpr span subspan(std::size_t offset, std::size_t count) const noexcept
+    {
+        return span(data_ + offset, count);
+    }
+
+private:
+    T *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+#endif
+
+namespace detail {
+
+/* Rows handed to the C batch functions per call by the chunked entry points */
+constexpr std::size_t batch_chunk = 64;
+
+static_assert(batch_chunk % 8 == 0, "chunks must start on a bitmap byte");
+
+/* A non-NULL pointer for an empty byte range */
+inline const uint8_t *bytes_of(span<const uint8_t> data) noexcept
+{
+    static const uint8_t empty = 0;
+
+    return data.empty() ? &empty : data.data();
+}
+
+/* Bytes of one message in a range of byte containers */
+template <class Message>
+inline span<const uint8_t> message_bytes(const Message &message) noexcept
+{
+    using element = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(message))>>;
+
+    static_assert(sizeof(element) == 1, "messages must be contiguous ranges of bytes or chars");
+    return span<const uint8_t>(reinterpret_cast<const uint8_t *>(std::data(message)),
+                               std::size(message) * sizeof(element));
+}
+
+/* NUL-terminated string of one element of a range of strings */
+inline const char *c_str_of(const char *s) noexcept
+{
+    return s;
+}
+
+template <class String>
+inline auto c_str_of(const String &s) noexcept -> decltype(s.c_str())
+{
+    return s.c_str();
+}
+
+/* Accumulate one chunk's return value: counts add up, the first error wins */
+inline int accumulate(int total, int rc) noexcept
+{
+    return rc < 0 ? rc : total + rc;
+}
+
+template <class T, void (*Destroy)(T *)>
+class handle {
+public:
+    constexpr handle() noexcept = default;
+    explicit handle(T *ptr) noexcept : ptr_(ptr) {}
+    handle(handle &&other) noexcept : ptr_(other.release()) {}
+    handle(const handle &) = delete;
+    handle &operator=(const handle &) = delete;
+    ~handle() { reset(); }
+
+    handle &operator=(handle &&other) noexcept
+    {
+        reset(other.release());
+        return *this;
+    }
+
+    T *get() const noexcept { return ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    T *release() noexcept
+    {
+        return std::exchange(ptr_, nullptr);
+    }
+
+    void reset(T *ptr = nullptr) noexcept
+    {
+        T *old = std::exchange(ptr_, ptr);
+
+        if (old) {
+            Destroy(old);
+        }
+    }
+
+private:
+    T *ptr_ = nullptr;
+};
+
+} // namespace detail
+
+/* ============================================
+ * NETWORKS
+ * ============================================ */
+
+namespace detail {
+
+constexpr int hex_digit(char c) noexcept
+{
+    return c >= '0' && c <= '9' ? c - '0'
+         : c >= 'a' && c <= 'f' ? c - 'a' + 10
+         : c >= 'A' && c <= 'F' ? c - 'A' + 10
+         : -1;
+}
+
+/* "0x" and 40 hex digits to an address; zero for anything else */
+constexpr address_t parse_address(std::string_view hex) noexcept
+{
+    address_t address{};
+
+    if (hex.size() != 2 + 2 * NOVA402_ADDRESS_SIZE || hex[0] != '0' || (hex[1] != 'x' && hex[1] != 'X')) {
+        return address;
+    }
+    for (std::size_t i = 0; i < NOVA402_ADDRESS_SIZE; i++) {
+        int hi = hex_digit(hex[2 + 2 * i]), lo = hex_digit(hex[3 + 2 * i]);
+
+        if (hi < 0 || lo < 0) {
+            return address_t{};
+        }
+        address.bytes[i] = static_cast<uint8_t>(hi << 4 | lo);
+    }
+    return address;
+}
+
+} // namespace detail
+
+/**
+ * Static per-network data, usable in constant expressions
+ *
+ * The same entries as nova402_network_info() and nova402_network_usdc(),
+ * with the EVM USDC contract decoded at compile time.
+ */
+struct network {
+    network_id id;
+    std::string_view name;           /* e.g. "base-mainnet" */
+    std::string_view caip2;          /* e.g. "eip155:8453" */
+    nova402_network_config_t config;
+    std::string_view usdc;           /* USDC contract or mint as text; empty if none */
+    bool has_usdc_address;           /* usdc is an EVM contract */
+    address_t usdc_address;
+};
+
+namespace detail {
+
+constexpr network make_network(network_id id, std::string_view name, std::string_view caip2,
+                               nova402_network_config_t config, std::string_view usdc) noexcept
+{
+    bool evm = config.type == NOVA402_NETWORK_EVM && !usdc.empty();
+
+    return network{id, name, caip2, config, usdc, evm, evm ? parse_address(usdc) : address_t{}};
+}
+
+} // namespace detail
+
+/* Indexed by network_id; entry 0 is NOVA402_NETWORK_ID_UNKNOWN. Kept in step with src/network_table.c. */
+inline constexpr std::array<network, NOVA402_NETWORK_ID_COUNT> networks = {{
+    detail::make_network(NOVA402_NETWORK_ID_UNKNOWN, {}, {}, {0, nullptr, NOVA402_NETWORK_EVM, nullptr}, {}),
+    detail::make_network(NOVA402_NETWORK_ID_BASE_MAINNET, "base-mainnet", "eip155:8453",
+                         {8453, "Base Mainnet", NOVA402_NETWORK_EVM, "https://mainnet.base.org"},
+                         "0x833589fCD6eDb6E08f4c7C32D4f71b54bdA02913"),
+    detail::make_network(NOVA402_NETWORK_ID_BASE_SEPOLIA, "base-sepolia", "eip155:84532",
+                         {84532, "Base Sepolia", NOVA402_NETWORK_EVM, "https://sepolia.base.org"},
+                         "0x036CbD53842c5426634e7929541eC2318f3dCF7e"),
+    detail::make_network(NOVA402_NETWORK_ID_SOLANA_MAINNET, "solana-mainnet", "solana:mainnet",
+                         {0, "Solana Mainnet", NOVA402_NETWORK_SOLANA, "https://api.mainnet-beta.solana.com"},
+                         "EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v"),
+    detail::make_network(NOVA402_NETWORK_ID_SOLANA_DEVNET, "solana-devnet", "solana:devnet",
+                         {0, "Solana Devnet", NOVA402_NETWORK_SOLANA, "https://api.devnet.solana.com"},
+                         "4zMMC9srt5Ri5X14GAgXhaHii3GnPAEERYPJgZJDncDU"),
+    detail::make_network(NOVA402_NETWORK_ID_POLYGON, "polygon", "eip155:137",
+                         {137, "Polygon", NOVA402_NETWORK_EVM, "https://polygon-rpc.com"},
+                         "0x2791Bca1f2de4661ED88A30C99A7a9449Aa84174"),
+    detail::make_network(NOVA402_NETWORK_ID_BSC, "bsc", "eip155:56",
+                         {56, "BNB Smart Chain", NOVA402_NETWORK_EVM, "https://bsc-dataseed.binance.org"},
+                         "0x8AC76a51cc950d9822D68b83fE1Ad97B32Cd580d"),
+    detail::make_network(NOVA402_NETWORK_ID_SEI, "sei", "eip155:1329",
+                         {1329, "Sei Network", NOVA402_NETWORK_EVM, "https://evm-rpc.sei-apis.com"}, {}),
+    detail::make_network(NOVA402_NETWORK_ID_PEAQ, "peaq", "eip155:3338",
+                         {3338, "Peaq Network", NOVA402_NETWORK_EVM, "https://peaq.api.onfinality.io/public"}, {}),
+}};
+
+/**
+ * Resolve a network name, NOVA402_NETWORK_ID_UNKNOWN if unsupported
+ *
+ * Free when the result initializes a constexpr variable or template
+ * argument. At run time it is a linear scan of a handful of entries;
+ * nova402_network_lookup() hashes instead.
+ */
+constexpr network_id network_lookup(std::string_view name) noexcept
+{
+    for (const network &n : networks) {
+        if (n.id != NOVA402_NETWORK_ID_UNKNOWN && n.name == name) {
+            return n.id;
+        }
+    }
+    return NOVA402_NETWORK_ID_UNKNOWN;
+}
+
+/* The same for a CAIP-2 ID such as "eip155:8453" */
+constexpr network_id network_lookup_caip2(std::string_view caip2) noexcept
+{
+    for (const network &n : networks) {
+        if (n.id != NOVA402_NETWORK_ID_UNKNOWN && n.caip2 == caip2) {
+            return n.id;
+        }
+    }
+    return NOVA402_NETWORK_ID_UNKNOWN;
+}
+
+/* Table entry of a network; the empty entry for unknown IDs */
+constexpr const network &network_info(network_id id) noexcept
+{
+    return static_cast<std::size_t>(id) < networks.size() ? networks[id] : networks[NOVA402_NETWORK_ID_UNKNOWN];
+}
+
+/* Decoded USDC contract of an EVM network, or nullptr */
+constexpr const address_t *usdc_address(network_id id) noexcept
+{
+    return network_info(id).has_usdc_address ? &network_info(id).usdc_address : nullptr;
+}
+
+namespace detail {
+
+/* "eip155:" followed by the decimal chain ID */
+constexpr bool is_eip155(std::string_view caip2, uint64_t chain_id) noexcept
+{
+    constexpr std::string_view prefix = "eip155:";
+    std::size_t end = caip2.size();
+
+    if (caip2.substr(0, prefix.size()) != prefix || end == prefix.size()) {
+        return false;
+    }
+    for (; end > prefix.size(); end--, chain_id /= 10) {
+        if (caip2[end - 1] != static_cast<char>('0' + chain_id % 10)) {
+            return false;
+        }
+    }
+    return chain_id == 0;
+}
+
+/* Every entry sits at its ID, resolves back to it, and decodes its USDC contract */
+constexpr bool networks_consistent() noexcept
+{
+    for (std::size_t i = 0; i < networks.size(); i++) {
+        const network &n = networks[i];
+        bool decoded = false;
+
+        for (uint8_t byte : n.usdc_address.bytes) {
+            decoded = decoded || byte != 0;
+        }
+        if (static_cast<std::size_t>(n.id) != i) {
+            return false;
+        }
+        if (i == NOVA402_NETWORK_ID_UNKNOWN) {
+            continue;
+        }
+        if (network_lookup(n.name) != n.id || network_lookup_caip2(n.caip2) != n.id ||
+            (n.config.type == NOVA402_NETWORK_EVM && !is_eip155(n.caip2, n.config.chain_id)) ||
+            n.has_usdc_address != decoded) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The entry for id has these names and USDC contract */
+constexpr bool network_is(network_id id, std::string_view name, std::string_view caip2,
+                          std::string_view usdc) noexcept
+{
+    const network &n = network_info(id);
+
+    return n.id == id && n.name == name && n.caip2 == caip2 && n.usdc == usdc &&
+           network_lookup(name) == id && network_lookup_caip2(caip2) == id;
+}
+
+} // namespace detail
+
+static_assert(detail::networks_consistent(), "network table is out of order or a USDC contract did not decode");
+static_assert(detail::network_is(NOVA402_NETWORK_ID_BASE_MAINNET, "base-mainnet", "eip155:8453",
+                                 "0x833589fCD6eDb6E08f4c7C32D4f71b54bdA02913"), "base-mainnet entry");
+static_assert(detail::network_is(NOVA402_NETWORK_ID_BASE_SEPOLIA, "base-sepolia", "eip155:84532",
+                                 "0x036CbD53842c5426634e7929541eC2318f3dCF7e"), "base-sepolia entry");
+static_assert(detail::network_is(NOVA402_NETWORK_ID_SOLANA_MAINNET, "solana-mainnet", "solana:mainnet",
+                                 "EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v"), "solana-mainnet entry");
+static_assert(detail::network_is(NOVA402_NETWORK_ID_SOLANA_DEVNET, "solana-devnet", "solana:devnet",
+                                 "4zMMC9srt5Ri5X14GAgXhaHii3GnPAEERYPJgZJDncDU"), "solana-devnet entry");
+static_assert(detail::network_is(NOVA402_NETWORK_ID_POLYGON, "polygon", "eip155:137",
+                                 "0x2791Bca1f2de4661ED88A30C99A7a9449Aa84174"), "polygon entry");
+static_assert(detail::network_is(NOVA402_NETWORK_ID_BSC, "bsc", "eip155:56",
+                                 "0x8AC76a51cc950d9822D68b83fE1Ad97B32Cd580d"), "bsc entry");
+static_assert(detail::network_is(NOVA402_NETWORK_ID_SEI, "sei", "eip155:1329", {}), "sei entry");
+static_assert(detail::network_is(NOVA402_NETWORK_ID_PEAQ, "peaq", "eip155:3338", {}), "peaq entry");
+static_assert(NOVA402_NETWORK_ID_PEAQ + 1 == NOVA402_NETWORK_ID_COUNT, "a network has no entry assertion");
+static_assert(usdc_address(NOVA402_NETWORK_ID_BASE_MAINNET)->bytes[0] == 0x83 &&
+              usdc_address(NOVA402_NETWORK_ID_BSC)->bytes[19] == 0x0d, "USDC contract did not decode");
+
+/* ============================================
+ * HASHING
+ * ============================================ */
+
+inline int keccak256(span<const uint8_t> data, hash_t &hash) noexcept
+{
+    return nova402_keccak256(detail::bytes_of(data), data.size(), &hash);
+}
+
+inline int sha256(span<const uint8_t> data, hash_t &hash) noexcept
+{
+    return nova402_sha256(detail::bytes_of(data), data.size(), &hash);
+}
+
+/**
+ * Hash every message of a range with the multi-buffer kernel
+ *
+ * Messages may be any contiguous byte or char containers (std::string,
+ * std::vector<uint8_t>, spans); they are read in place.
+ *
+ * @param messages Range of messages
+ * @param hashes Output, one per message
+ * @return NOVA402_SUCCESS, or NOVA402_ERROR_BUFFER_TOO_SMALL if hashes is shorter
+ */
+template <class Messages>
+inline int keccak256_many(const Messages &messages, span<hash_t> hashes) noexcept
+{
+    const uint8_t *data[detail::batch_chunk];
+    std::size_t lengths[detail::batch_chunk];
+    std::size_t offset = 0, n = 0;
+    int rc;
+
+    if (hashes.size() < std::size(messages)) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+    for (const auto &message : messages) {
+        span<const uint8_t> bytes = detail::message_bytes(message);
+
+        data[n] = detail::bytes_of(bytes);
+        lengths[n] = bytes.size();
+        if (++n == detail::batch_chunk) {
+            if ((rc = nova402_keccak256_many(data, lengths, n, hashes.data() + offset)) != NOVA402_SUCCESS) {
+                return rc;
+            }
+            offset += n;
+            n = 0;
+        }
+    }
+    return nova402_keccak256_many(data, lengths, n, hashes.data() + offset);
+}
+
+/* The same with SHA-256 */
+template <class Messages>
+inline int sha256_many(const Messages &messages, span<hash_t> hashes) noexcept
+{
+    const uint8_t *data[detail::batch_chunk];
+    std::size_t lengths[detail::batch_chunk];
+    std::size_t offset = 0, n = 0;
+    int rc;
+
+    if (hashes.size() < std::size(messages)) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+    for (const auto &message : messages) {
+        span<const uint8_t> bytes = detail::message_bytes(message);
+
+        data[n] = detail::bytes_of(bytes);
+        lengths[n] = bytes.size();
+        if (++n == detail::batch_chunk) {
+            if ((rc = nova402_sha256_many(data, lengths, n, hashes.data() + offset)) != NOVA402_SUCCESS) {
+                return rc;
+            }
+            offset += n;
+            n = 0;
+        }
+    }
+    return nova402_sha256_many(data, lengths, n, hashes.data() + offset);
+}
+
+/* ============================================
+ * SIGNATURES
+ * ============================================ */
+
+/**
+ * Verify a batch of payments against their expected signers
+ *
+ * @return Number of valid signatures, or negative error code (also if the
+ *         spans disagree in length or results is shorter than bitmap_size())
+ */
+inline int verify_signatures_batch(const eip712_domain_t &domain, span<const payment_data_t> payments,
+                                   span<const signature_t> signatures, span<const address_t> expected_signers,
+                                   span<uint8_t> results) noexcept
+{
+    std::size_t count = payments.size();
+
+    if (signatures.size() != count || expected_signers.size() != count) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (results.size() < bitmap_size(count)) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+    return nova402_verify_signatures_batch_ctx(&domain, payments.data(), signatures.data(), expected_signers.data(),
+                                               count, results.data());
+}
+
+/**
+ * Verify Ed25519 signatures over a range of messages, read in place
+ *
+ * Runs in chunks of detail::batch_chunk signatures.
+ *
+ * @return Number of valid signatures, or negative error code
+ */
+template <class Messages>
+inline int ed25519_verify_batch(const Messages &messages, span<const ed25519_public_key_t> public_keys,
+                                span<const ed25519_signature_t> signatures, span<uint8_t> results,
+                                nova402_arena_t *arena = nullptr) noexcept
+{
+    const uint8_t *data[detail::batch_chunk];
+    std::size_t lengths[detail::batch_chunk];
+    std::size_t count = std::size(messages), offset = 0, n = 0;
+    int valid = 0;
+
+    if (public_keys.size() != count || signatures.size() != count) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (results.size() < bitmap_size(count)) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+    for (const auto &message : messages) {
+        span<const uint8_t> bytes = detail::message_bytes(message);
+
+        data[n] = detail::bytes_of(bytes);
+        lengths[n] = bytes.size();
+        if (++n == detail::batch_chunk || offset + n == count) {
+            valid = detail::accumulate(valid, nova402_ed25519_verify_batch_arena(
+                data, lengths, public_keys.data() + offset, signatures.data() + offset, n,
+                results.data() + offset / 8, arena));
+            if (valid < 0) {
+                return valid;
+            }
+            offset += n;
+            n = 0;
+        }
+    }
+    return valid;
+}
+
+/* ============================================
+ * VALIDATION AND ENCODING
+ * ============================================ */
+
+/**
+ * Validate a range of addresses (const char * or std::string elements)
+ *
+ * @return Number of valid addresses, or negative error code
+ */
+template <class Strings>
+inline int validate_addresses(const Strings &addresses, nova402_address_check_t check, span<uint8_t> results) noexcept
+{
+    const char *text[detail::batch_chunk];
+    std::size_t count = std::size(addresses), offset = 0, n = 0;
+    int valid = 0;
+
+    if (results.size() < bitmap_size(count)) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+    for (const auto &address : addresses) {
+        text[n] = detail::c_str_of(address);
+        if (++n == detail::batch_chunk || offset + n == count) {
+            valid = detail::accumulate(valid, nova402_validate_addresses(text, n, check, results.data() + offset / 8));
+            if (valid < 0) {
+                return valid;
+            }
+            offset += n;
+            n = 0;
+        }
+    }
+    return valid;
+}
+
+/**
+ * Decode a range of "0x"-prefixed hashes (const char * or std::string elements)
+ *
+ * @return Number of hashes decoded, or negative error code
+ */
+template <class Strings>
+inline int hex_to_hashes(const Strings &hex, span<hash_t> hashes, span<uint8_t> results) noexcept
+{
+    const char *text[detail::batch_chunk];
+    std::size_t count = std::size(hex), offset = 0, n = 0;
+    int valid = 0;
+
+    if (hashes.size() < count || results.size() < bitmap_size(count)) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+    for (const auto &h : hex) {
+        text[n] = detail::c_str_of(h);
+        if (++n == detail::batch_chunk || offset + n == count) {
+            valid = detail::accumulate(valid, nova402_hex_to_hashes(text, n, hashes.data() + offset,
+                                                                    results.data() + offset / 8));
+            if (valid < 0) {
+                return valid;
+            }
+            offset += n;
+            n = 0;
+        }
+    }
+    return valid;
+}
+
+/* The same for addresses */
+template <class Strings>
+inline int hex_to_addresses(const Strings &hex, span<address_t> addresses, span<uint8_t> results) noexcept
+{
+    const char *text[detail::batch_chunk];
+    std::size_t count = std::size(hex), offset = 0, n = 0;
+    int valid = 0;
+
+    if (addresses.size() < count || results.size() < bitmap_size(count)) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+    for (const auto &h : hex) {
+        text[n] = detail::c_str_of(h);
+        if (++n == detail::batch_chunk || offset + n == count) {
+            valid = detail::accumulate(valid, nova402_hex_to_addresses(text, n, addresses.data() + offset,
+                                                                       results.data() + offset / 8));
+            if (valid < 0) {
+                return valid;
+            }
+            offset += n;
+            n = 0;
+        }
+    }
+    return valid;
+}
+
+inline nova402_payment_status_t validate_payment(const payment_requirements_t &requirements,
+                                                 const payment_header_t &header, uint64_t now) noexcept
+{
+    return nova402_validate_payment(&requirements, &header, now);
+}
+
+inline int parse_payment_header(std::string_view header, payment_header_t &out) noexcept
+{
+    return nova402_parse_payment_header(header.data(), header.size(), &out);
+}
+
+/* ============================================
+ * MERKLE TREES
+ * ============================================ */
+
+inline int merkle_root(span<const hash_t> leaves, hash_t &root) noexcept
+{
+    return nova402_merkle_root(leaves.data(), leaves.size(), &root);
+}
+
+inline int merkle_root_parallel(span<const hash_t> leaves, hash_t &root, std::size_t threads = 0,
+                                const nova402_executor_t *executor = nullptr) noexcept
+{
+    return nova402_merkle_root_parallel(leaves.data(), leaves.size(), threads, executor, &root);
+}
+
+inline bool verify_merkle_proof(const hash_t &leaf, span<const hash_t> proof, const hash_t &root,
+                                std::size_t index) noexcept
+{
+    return nova402_verify_merkle_proof(&leaf, proof.data(), proof.size(), &root, index);
+}
+
+/* leaves[i] is the leaf at indices[i] */
+inline bool verify_merkle_multiproof(span<const hash_t> leaves, span<const std::size_t> indices,
+                                     std::size_t leaf_count, span<const hash_t> proof, const hash_t &root,
+                                     nova402_arena_t *arena = nullptr) noexcept
+{
+    return leaves.size() == indices.size() &&
+           nova402_verify_merkle_multiproof_arena(leaves.data(), indices.data(), indices.size(), leaf_count,
+                                                  proof.data(), proof.size(), &root, arena);
+}
+
+/**
+ * Merkle tree with all layers in one arena (nova402_merkle_tree_t)
+ */
+class merkle_tree : public detail::handle<nova402_merkle_tree_t, nova402_merkle_tree_destroy> {
+public:
+    using handle::handle;
+
+    static merkle_tree create(span<const hash_t> leaves) noexcept
+    {
+        return merkle_tree(nova402_merkle_tree_create(leaves.data(), leaves.size()));
+    }
+
+    static merkle_tree open_mmap(const char *path) noexcept
+    {
+        return merkle_tree(nova402_merkle_tree_open_mmap(path));
+    }
+
+    int root(hash_t &root) const noexcept { return nova402_merkle_tree_root(get(), &root); }
+    std::size_t leaf_count() const noexcept { return nova402_merkle_tree_leaf_count(get()); }
+    std::size_t depth() const noexcept { return nova402_merkle_tree_depth(get()); }
+    std::size_t memory() const noexcept { return nova402_merkle_tree_memory(get()); }
+    int save(const char *path) const noexcept { return nova402_merkle_tree_save(get(), path); }
+
+    /* proof_length is set to the hashes written, or needed on NOVA402_ERROR_BUFFER_TOO_SMALL */
+    int proof(std::size_t index, span<hash_t> proof, std::size_t &proof_length) const noexcept
+    {
+        return nova402_merkle_proof(get(), index, proof.data(), proof.size(), &proof_length);
+    }
+
+    int multiproof(span<const std::size_t> indices, span<hash_t> proof, std::size_t &proof_length) const noexcept
+    {
+        return nova402_merkle_multiproof(get(), indices.data(), indices.size(), proof.data(), proof.size(),
+                                         &proof_length);
+    }
+};
+
+/**
+ * Sharded sparse Merkle tree keyed by nonces (nova402_sparse_merkle_t)
+ */
+class sparse_merkle_tree : public detail::handle<nova402_sparse_merkle_t, nova402_sparse_merkle_destroy> {
+public:
+    using handle::handle;
+
+    static sparse_merkle_tree create(unsigned shard_bits = 0) noexcept
+    {
+        return sparse_merkle_tree(nova402_sparse_merkle_create(shard_bits));
+    }
+
+    /* values[i] is the new value of keys[i]; zero removes the key */
+    int update(span<const nonce_t> keys, span<const hash_t> values, std::size_t threads = 0,
+               const nova402_executor_t *executor = nullptr) noexcept
+    {
+        if (keys.size() != values.size()) {
+            return NOVA402_ERROR_INVALID_INPUT;
+        }
+        return nova402_sparse_merkle_update(get(), reinterpret_cast<const uint8_t (*)[NOVA402_NONCE_SIZE]>(keys.data()),
+                                            values.data(), keys.size(), threads, executor);
+    }
+
+    int root(hash_t &root) const noexcept { return nova402_sparse_merkle_root(get(), &root); }
+    std::size_t count() const noexcept { return nova402_sparse_merkle_count(get()); }
+    std::size_t memory() const noexcept { return nova402_sparse_merkle_memory(get()); }
+
+    bool find(const nonce_t &key, hash_t *value = nullptr) const noexcept
+    {
+        return nova402_sparse_merkle_get(get(), key.data(), value);
+    }
+
+    int prove(const nonce_t &key, sparse_merkle_proof_t &proof) const noexcept
+    {
+        return nova402_sparse_merkle_prove(get(), key.data(), &proof);
+    }
+
+    /* value nullptr checks that key is absent */
+    static bool verify(const hash_t &root, const nonce_t &key, const hash_t *value,
+                       const sparse_merkle_proof_t &proof) noexcept
+    {
+        return nova402_sparse_merkle_verify(&root, key.data(), value, &proof);
+    }
+};
+
+/* ============================================
+ * PAYMENT BATCHES
+ * ============================================ */
+
+/**
+ * Struct-of-arrays payment batch (nova402_payment_batch_t)
+ *
+ * Move-only; the columns are reached through get() or operator->.
+ */
+class payment_batch : public detail::handle<nova402_payment_batch_t, nova402_payment_batch_destroy> {
+public:
+    using handle::handle;
+
+    static payment_batch create(std::size_t capacity) noexcept
+    {
+        return payment_batch(nova402_payment_batch_create(capacity));
+    }
+
+    nova402_payment_batch_t *operator->() const noexcept { return get(); }
+    std::size_t size() const noexcept { return get()->count; }
+    std::size_t capacity() const noexcept { return get()->capacity; }
+
+    int load(span<const payment_header_t> headers) noexcept
+    {
+        return nova402_payment_batch_load_headers(get(), headers.data(), headers.size());
+    }
+
+    int load(span<const packed_record_t> records) noexcept
+    {
+        return nova402_payment_batch_load_packed(get(), records.data(), records.size());
+    }
+
+    /* signatures may be empty to leave the signature column unset */
+    int load(network_id network, span<const payment_data_t> payments, span<const signature_t> signatures) noexcept
+    {
+        if (!signatures.empty() && signatures.size() != payments.size()) {
+            return NOVA402_ERROR_INVALID_INPUT;
+        }
+        return nova402_payment_batch_load_payments(get(), network, payments.data(),
+                                                   signatures.empty() ? nullptr : signatures.data(),
+                                                   payments.size());
+    }
+
+    int row(std::size_t index, payment_data_t &payment, signature_t *signature = nullptr) const noexcept
+    {
+        return nova402_payment_batch_get(get(), index, &payment, signature);
+    }
+
+    /* @return Rows that pass, or negative error code */
+    int screen(const payment_requirements_t &requirements, uint64_t now, span<uint8_t> results) const noexcept
+    {
+        if (results.size() < bitmap_size(size())) {
+            return NOVA402_ERROR_BUFFER_TOO_SMALL;
+        }
+        return nova402_payment_batch_screen(get(), &requirements, now, results.data());
+    }
+};
+
+/* ============================================
+ * VERIFICATION CONTEXT
+ * ============================================ */
+
+/**
+ * Shared secp256k1 generator tables (nova402_secp256k1_ctx_t)
+ */
+class secp256k1_context : public detail::handle<nova402_secp256k1_ctx_t, nova402_secp256k1_ctx_destroy> {
+public:
+    using handle::handle;
+
+    static secp256k1_context create(nova402_secp256k1_table_t size = NOVA402_SECP256K1_TABLE_64K) noexcept
+    {
+        return secp256k1_context(nova402_secp256k1_ctx_create(size));
+    }
+
+    int recover_signer(const hash_t &message, const signature_t &signature, address_t &signer) const noexcept
+    {
+        return nova402_recover_signer_ctx(get(), &message, &signature, &signer);
+    }
+
+    /* @return Number of signers recovered, or negative error code */
+    int recover_signers(span<const hash_t> messages, span<const signature_t> signatures, span<address_t> signers,
+                        span<uint8_t> results) const noexcept
+    {
+        std::size_t count = messages.size();
+
+        if (signatures.size() != count) {
+            return NOVA402_ERROR_INVALID_INPUT;
+        }
+        if (signers.size() < count || results.size() < bitmap_size(count)) {
+            return NOVA402_ERROR_BUFFER_TOO_SMALL;
+        }
+        return nova402_recover_signers_batch_ctx(get(), messages.data(), signatures.data(), count, signers.data(),
+                                                 results.data());
+    }
+};
+
+/**
+ * Shared verification context (nova402_ctx_t)
+ */
+class context : public detail::handle<nova402_ctx_t, nova402_ctx_destroy> {
+public:
+    using handle::handle;
+
+    static context create(span<const char *const> names,
+                          nova402_secp256k1_table_t table = NOVA402_SECP256K1_TABLE_64K) noexcept
+    {
+        return context(nova402_ctx_create(names.data(), names.size(), table));
+    }
+
+    std::size_t memory() const noexcept { return nova402_ctx_memory(get()); }
+
+    const eip712_domain_t *domain(network_id network) const noexcept
+    {
+        return nova402_ctx_domain(get(), network_info(network).name.data());
+    }
+
+    const eip712_domain_t *domain(const char *network) const noexcept
+    {
+        return nova402_ctx_domain(get(), network);
+    }
+
+    int network_config(const char *network, nova402_network_config_t &config) const noexcept
+    {
+        return nova402_ctx_network_config(get(), network, &config);
+    }
+
+    const nova402_secp256k1_ctx_t *secp256k1() const noexcept { return nova402_ctx_secp256k1(get()); }
+};
+
+/**
+ * Per-thread verification state (nova402_worker_t)
+ */
+class worker : public detail::handle<nova402_worker_t, nova402_worker_destroy> {
+public:
+    using handle::handle;
+
+    static worker create(const context &ctx, std::size_t scratch_size = 0) noexcept
+    {
+        return worker(nova402_worker_create(ctx.get(), scratch_size));
+    }
+
+    nova402_arena_t *arena() const noexcept { return nova402_worker_arena(get()); }
+
+    bool verify(const payment_header_t &header) noexcept
+    {
+        return nova402_worker_verify_payment(get(), &header);
+    }
+
+    /* @return Number of valid payments, or negative error code */
+    int verify(span<const payment_header_t> headers, span<uint8_t> results) noexcept
+    {
+        if (results.size() < bitmap_size(headers.size())) {
+            return NOVA402_ERROR_BUFFER_TOO_SMALL;
+        }
+        return nova402_worker_verify_payments(get(), headers.data(), headers.size(), results.data());
+    }
+
+    int verify(span<const packed_record_t> records, span<uint8_t> results) noexcept
+    {
+        if (results.size() < bitmap_size(records.size())) {
+            return NOVA402_ERROR_BUFFER_TOO_SMALL;
+        }
+        return nova402_worker_verify_packed(get(), records.data(), records.size(), results.data());
+    }
+
+    /* mask is a screen() bitmap, or empty to verify every row */
+    int verify(const payment_batch &batch, span<const uint8_t> mask, span<uint8_t> results) noexcept
+    {
+        std::size_t bytes = bitmap_size(batch.size());
+
+        if ((!mask.empty() && mask.size() < bytes) || results.size() < bytes) {
+            return NOVA402_ERROR_BUFFER_TOO_SMALL;
+        }
+        return nova402_worker_verify_batch(get(), batch.get(), mask.empty() ? nullptr : mask.data(),
+                                           results.data());
+    }
+};
+
+/**
+ * Asynchronous verification pipeline (nova402_pipeline_t)
+ */
+class pipeline : public detail::handle<nova402_pipeline_t, nova402_pipeline_destroy> {
+public:
+    using handle::handle;
+
+    static pipeline create(const context &ctx, const nova402_pipeline_config_t *config = nullptr) noexcept
+    {
+        return pipeline(nova402_pipeline_create(ctx.get(), config));
+    }
+
+    int submit(const payment_header_t &header, uint64_t tag) noexcept
+    {
+        return nova402_verify_submit(get(), &header, tag);
+    }
+
+    std::size_t poll(span<verify_completion_t> completions) noexcept
+    {
+        return nova402_verify_poll(get(), completions.data(), completions.size());
+    }
+
+    std::size_t pending() const noexcept { return nova402_pipeline_pending(get()); }
+};
+
+/* ============================================
+ * SIGNING
+ * ============================================ */
+
+/**
+ * Signing key with precomputed tables (nova402_signer_t)
+ */
+class signer : public detail::handle<nova402_signer_t, nova402_signer_destroy> {
+public:
+    using handle::handle;
+
+    static signer create(const std::array<uint8_t, 32> &private_key,
+                         const std::array<uint8_t, 32> *seed = nullptr) noexcept
+    {
+        return signer(nova402_signer_create(private_key.data(), seed ? seed->data() : nullptr));
+    }
+
+    int address(address_t &address) const noexcept { return nova402_signer_address(get(), &address); }
+
+    int public_key(std::array<uint8_t, 64> &public_key) const noexcept
+    {
+        return nova402_signer_public_key(get(), public_key.data());
+    }
+
+    int sign(const hash_t &digest, signature_t &signature) const noexcept
+    {
+        return nova402_signer_sign_digest(get(), &digest, &signature);
+    }
+
+    int sign(const eip712_domain_t &domain, const payment_data_t &payment, signature_t &signature) const noexcept
+    {
+        return nova402_signer_sign_payment(get(), &domain, &payment, &signature);
+    }
+
+    /* @return Number of signed payments, or negative error code */
+    int sign(const eip712_domain_t &domain, span<const payment_data_t> payments,
+             span<signature_t> signatures) const noexcept
+    {
+        if (signatures.size() < payments.size()) {
+            return NOVA402_ERROR_BUFFER_TOO_SMALL;
+        }
+        return nova402_sign_payments_batch(get(), &domain, payments.data(), payments.size(), signatures.data());
+    }
+};
+
+/* ============================================
+ * SIGNER CACHE AND REPLAY PROTECTION
+ * ============================================ */
+
+/**
+ * Recovered-signer cache (nova402_signer_cache_t)
+ */
+class signer_cache : public detail::handle<nova402_signer_cache_t, nova402_signer_cache_destroy> {
+public:
+    using handle::handle;
+
+    static signer_cache create(std::size_t capacity, std::size_t stripes = 0) noexcept
+    {
+        return signer_cache(nova402_signer_cache_create(capacity, stripes));
+    }
+
+    void clear() noexcept { nova402_signer_cache_clear(get()); }
+
+    int stats(nova402_signer_cache_stats_t &stats) noexcept
+    {
+        return nova402_signer_cache_stats(get(), &stats);
+    }
+
+    int recover_signer(const hash_t &message, const signature_t &signature, address_t &signer) noexcept
+    {
+        return nova402_recover_signer_cached(get(), &message, &signature, &signer);
+    }
+
+    bool verify(const eip712_domain_t &domain, const payment_data_t &payment, const signature_t &signature,
+                const address_t &expected_signer) noexcept
+    {
+        return nova402_verify_signature_cached(get(), &domain, &payment, &signature, &expected_signer);
+    }
+};
+
+/**
+ * Lock-free nonce set with time-bucketed expiry (nova402_nonce_set_t)
+ */
+class nonce_set : public detail::handle<nova402_nonce_set_t, nova402_nonce_set_destroy> {
+public:
+    using handle::handle;
+
+    static nonce_set create(std::size_t capacity, uint64_t generation_seconds = 0,
+                            std::size_t generations = 0) noexcept
+    {
+        return nonce_set(nova402_nonce_set_create(capacity, generation_seconds, generations));
+    }
+
+    int insert(const uint8_t *nonce, uint64_t valid_after, uint64_t valid_before, uint64_t now) noexcept
+    {
+        return nova402_nonce_set_insert_at(get(), nonce, valid_after, valid_before, now);
+    }
+
+    int insert(const payment_data_t &payment, uint64_t now) noexcept
+    {
+        return insert(payment.nonce, payment.valid_after, payment.valid_before, now);
+    }
+
+    bool contains(const uint8_t *nonce, uint64_t valid_before, uint64_t now) const noexcept
+    {
+        return nova402_nonce_set_contains_at(get(), nonce, valid_before, now);
+    }
+
+    std::size_t memory() const noexcept { return nova402_nonce_set_memory(get()); }
+};
+
+} // namespace nova402
+
+#endif /* NOVA402_HPP */
@@ -0,0 +1,144 @@
+/**
+ * Nova402 C Library - allocator hooks and scratch arenas
+ *
+ * Every heap allocation in the library goes through nova402_malloc() and
+ * nova402_free(), so one nova402_set_allocator() call redirects all of
+ * them. Scratch buffers that only live for one call can come from a
+ * caller-owned nova402_arena_t instead; arena space is handed out and
+ * given back in stack order, so a call leaves the arena as it found it.
+ *
+ * @file alloc.c
+ */
+
+#include "internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static void *default_alloc(void *context, size_t size)
+{
+    (void)context;
+    return malloc(size);
+}
+
+static void default_free(void *context, void *ptr)
+{
+    (void)context;
+    free(ptr);
+}
+
+static nova402_allocator_t g_allocator = {default_alloc, default_free, NULL};
+
+int nova402_set_allocator(const nova402_allocator_t *allocator)
+{
+    if (!allocator) {
+        g_allocator.alloc = default_alloc;
+        g_allocator.free = default_free;
+        g_allocator.context = NULL;
+        return NOVA402_SUCCESS;
+    }
+    if (!allocator->alloc || !allocator->free) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    g_allocator = *allocator;
+    return NOVA402_SUCCESS;
+}
+
+void *nova402_malloc(size_t size)
+{
+    return g_allocator.alloc(g_allocator.context, size);
+}
+
+void *nova402_calloc(size_t count, size_t size)
+{
+    void *ptr;
+
+    if (size != 0 && count > (size_t)-1 / size) {
+        return NULL;
+    }
+    ptr = nova402_malloc(count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void nova402_free(void *ptr)
+{
+    if (ptr) {
+        g_allocator.free(g_allocator.context, ptr);
+    }
+}
+
+void nova402_memzero(void *ptr, size_t size)
+{
+    volatile uint8_t *p = (volatile uint8_t *)ptr;
+
+    while (size--) {
+        *p++ = 0;
+    }
+}
+
+void nova402_arena_init(nova402_arena_t *arena, void *buffer, size_t size)
+{
+    uintptr_t start = (uintptr_t)buffer;
+    uintptr_t aligned = (start + NOVA402_CACHE_LINE - 1) & ~(uintptr_t)(NOVA402_CACHE_LINE - 1);
+
+    if (!arena) {
+        return;
+    }
+    /* Start on a cache line; every block then stays line-aligned */
+    if (!buffer || size < (size_t)(aligned - start)) {
+        arena->base = NULL;
+        arena->size = 0;
+    } else {
+        arena->base = (uint8_t *)buffer + (aligned - start);
+        arena->size = (size - (size_t)(aligned - start)) & ~(size_t)(NOVA402_CACHE_LINE - 1);
+    }
+    arena->used = 0;
+    arena->peak = 0;
+}
+
+void nova402_arena_reset(nova402_arena_t *arena)
+{
+    if (arena) {
+        arena->used = 0;
+    }
+}
+
+void *nova402_scratch_alloc(nova402_arena_t *arena, size_t size)
+{
+    size_t rounded = (size + NOVA402_CACHE_LINE - 1) & ~(size_t)(NOVA402_CACHE_LINE - 1);
+    void *ptr;
+
+    if (!arena) {
+        return nova402_malloc(size);
+    }
+
+    /* peak records the demand even when it does not fit, to size the arena */
+    if (rounded < size || rounded > (size_t)-1 - arena->used) {
+        arena->peak = (size_t)-1;
+        return NULL;
+    }
+    if (arena->used + rounded > arena->peak) {
+        arena->peak = arena->used + rounded;
+    }
+    if (arena->used + rounded > arena->size) {
+        return NULL;
+    }
+    ptr = arena->base + arena->used;
+    arena->used += rounded;
+    return ptr;
+}
+
+void nova402_scratch_free(nova402_arena_t *arena, void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    if (!arena) {
+        nova402_free(ptr);
+        return;
+    }
+    arena->used = (size_t)((uint8_t *)ptr - arena->base);
+}
@@ -0,0 +1,124 @@
+/**
+ * Nova402 C Library - atomic operations
+ *
+ * 64-bit atomics over the GCC/Clang __atomic builtins or the MSVC
+ * Interlocked intrinsics. Not part of the public API.
+ *
+ * @file atomic.h
+ */
+
+#ifndef NOVA402_ATOMIC_H
+#define NOVA402_ATOMIC_H
+
+#include <stdint.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+static inline uint64_t nova402_atomic_load_u64(const volatile uint64_t *p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+    uint64_t v = *p;
+#if defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+#endif
+    _ReadWriteBarrier();
+    return v;
+#endif
+}
+
+static inline void nova402_atomic_store_u64(volatile uint64_t *p, uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#else
+    _InterlockedExchange64((volatile __int64 *)p, (__int64)v);
+#endif
+}
+
+/* Loads and stores of data guarded by a tag or sequence word */
+static inline uint64_t nova402_atomic_load_relaxed_u64(const volatile uint64_t *p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+#else
+    return *p;
+#endif
+}
+
+static inline void nova402_atomic_store_relaxed_u64(volatile uint64_t *p, uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(p, v, __ATOMIC_RELAXED);
+#else
+    *p = v;
+#endif
+}
+
+/* Order earlier loads before later loads and stores (seqlock read side) */
+static inline void nova402_atomic_fence_acquire(void)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#else
+#if defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISHLD);
+#endif
+    _ReadWriteBarrier();
+#endif
+}
+
+/* Replace *p with desired if it still holds expected; returns 1 on success */
+static inline int nova402_atomic_cas_u64(volatile uint64_t *p, uint64_t expected, uint64_t desired)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_compare_exchange_n(p, &expected, desired, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#else
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64 *)p, (__int64)desired,
+                                                   (__int64)expected) == expected;
+#endif
+}
+
+static inline uint64_t nova402_atomic_add_u64(volatile uint64_t *p, uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_add_fetch(p, v, __ATOMIC_RELAXED);
+#else
+    return (uint64_t)_InterlockedExchangeAdd64((volatile __int64 *)p, (__int64)v) + v;
+#endif
+}
+
+/*
+ * Add to a counter that only the calling thread writes. Cheaper than
+ * nova402_atomic_add_u64(): a plain load and store, which concurrent
+ * readers still see whole.
+ */
+static inline void nova402_atomic_bump_u64(volatile uint64_t *p, uint64_t v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(p, __atomic_load_n(p, __ATOMIC_RELAXED) + v, __ATOMIC_RELAXED);
+#else
+    /* Aligned 64-bit volatile accesses are single-copy atomic on x64 and ARM64 */
+    *p = *p + v;
+#endif
+}
+
+/* Hint to the core that the caller is spinning */
+static inline void nova402_cpu_relax(void)
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    __asm__ volatile("yield");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    __yield();
+#endif
+}
+
+#endif /* NOVA402_ATOMIC_H */
@@ -0,0 +1,210 @@
+/**
+ * Nova402 C Library - batch signature verification
+ *
+ * Digests for a chunk go through the multi-buffer Keccak kernel, then the
+ * whole chunk is recovered with shared inversions.
+ *
+ * @file batch.c
+ */
+
+#include "internal.h"
+#include "secp256k1.h"
+#include "stats.h"
+
+#include <limits.h>
+#include <string.h>
+
+/* Shared by the context and context-less entry points; ctx may be NULL */
+static int recover_signers(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *results)
+{
+    uint8_t ok[NOVA402_BATCH_CHUNK];
+    size_t offset, i;
+    int recovered = 0;
+
+    if (count == 0) {
+        return 0;
+    }
+    if (!messages || !signatures || !signers || !results || count > INT_MAX) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    memset(results, 0, (count + 7) / 8);
+
+    for (offset = 0; offset < count; offset += NOVA402_BATCH_CHUNK) {
+        size_t n = count - offset;
+        if (n > NOVA402_BATCH_CHUNK) {
+            n = NOVA402_BATCH_CHUNK;
+        }
+
+        recovered += (int)nova402_secp256k1_recover_batch(
+            ctx, messages + offset, signatures + offset, n, signers + offset, ok);
+
+        for (i = 0; i < n; i++) {
+            if (ok[i]) {
+                NOVA402_BITMAP_SET(results, offset + i);
+            }
+        }
+    }
+
+    return recovered;
+}
+
+int nova402_recover_signers_batch(
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *results)
+{
+    int recovered;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_RECOVER_SIGNERS_BATCH);
+
+    recovered = recover_signers(NULL, messages, signatures, count, signers, results);
+    NOVA402_STATS_END(count, recovered < 0);
+    return recovered;
+}
+
+int nova402_recover_signers_batch_ctx(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *results)
+{
+    int recovered;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_RECOVER_SIGNERS_BATCH);
+
+    recovered = ctx ? recover_signers(ctx, messages, signatures, count, signers, results)
+                    : NOVA402_ERROR_INVALID_INPUT;
+    NOVA402_STATS_END(count, recovered < 0);
+    return recovered;
+}
+
+static int recover_signer(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *message,
+    const nova402_signature_t *signature,
+    nova402_address_t *signer)
+{
+    uint8_t ok;
+
+    if (!ctx || !message || !signature || !signer) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    nova402_secp256k1_recover_batch(ctx, message, signature, 1, signer, &ok);
+    return ok ? NOVA402_SUCCESS : NOVA402_ERROR_INVALID_SIGNATURE;
+}
+
+int nova402_recover_signer_ctx(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *message,
+    const nova402_signature_t *signature,
+    nova402_address_t *signer)
+{
+    int rc;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_RECOVER_SIGNER);
+
+    rc = recover_signer(ctx, message, signature, signer);
+    NOVA402_STATS_END(1, rc != NOVA402_SUCCESS);
+    return rc;
+}
+
+int nova402_verify_signatures_batch(
+    const nova402_payment_data_t *payments,
+    const nova402_signature_t *signatures,
+    const nova402_address_t *expected_signers,
+    size_t count,
+    uint8_t *results)
+{
+    nova402_eip712_domain_t domain;
+
+    nova402_eip712_default_domain(&domain);
+    return nova402_verify_signatures_batch_ctx(&domain, payments, signatures, expected_signers,
+                                               count, results);
+}
+
+static int verify_signatures(
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payments,
+    const nova402_signature_t *signatures,
+    const nova402_address_t *expected_signers,
+    size_t count,
+    uint8_t *results)
+{
+    uint8_t encoded[NOVA402_BATCH_CHUNK][NOVA402_EIP712_STRUCT_SIZE];
+    const uint8_t *inputs[NOVA402_BATCH_CHUNK];
+    size_t lengths[NOVA402_BATCH_CHUNK];
+    nova402_hash_t struct_hashes[NOVA402_BATCH_CHUNK];
+    nova402_hash_t digests[NOVA402_BATCH_CHUNK];
+    nova402_address_t signers[NOVA402_BATCH_CHUNK];
+    uint8_t ok[NOVA402_BATCH_CHUNK];
+    size_t offset, i;
+    int valid = 0;
+
+    if (count == 0) {
+        return 0;
+    }
+    if (!domain || !payments || !signatures || !expected_signers || !results ||
+        count > INT_MAX) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    memset(results, 0, (count + 7) / 8);
+
+    for (offset = 0; offset < count; offset += NOVA402_BATCH_CHUNK) {
+        size_t n = count - offset;
+        if (n > NOVA402_BATCH_CHUNK) {
+            n = NOVA402_BATCH_CHUNK;
+        }
+
+        /* Struct hashes, then digests, through the multi-buffer kernel */
+        for (i = 0; i < n; i++) {
+            nova402_eip712_encode_struct(&payments[offset + i], encoded[i]);
+            inputs[i] = encoded[i];
+            lengths[i] = NOVA402_EIP712_STRUCT_SIZE;
+        }
+        nova402_keccak256_many(inputs, lengths, n, struct_hashes);
+
+        for (i = 0; i < n; i++) {
+            nova402_eip712_encode_digest(&domain->separator, &struct_hashes[i], encoded[i]);
+            lengths[i] = NOVA402_EIP712_DIGEST_INPUT_SIZE;
+        }
+        nova402_keccak256_many(inputs, lengths, n, digests);
+
+        nova402_secp256k1_recover_batch(NULL, digests, signatures + offset, n, signers, ok);
+
+        for (i = 0; i < n; i++) {
+            if (ok[i] && memcmp(signers[i].bytes, expected_signers[offset + i].bytes,
+                                NOVA402_ADDRESS_SIZE) == 0) {
+                NOVA402_BITMAP_SET(results, offset + i);
+                valid++;
+            }
+        }
+    }
+
+    return valid;
+}
+
+int nova402_verify_signatures_batch_ctx(
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payments,
+    const nova402_signature_t *signatures,
+    const nova402_address_t *expected_signers,
+    size_t count,
+    uint8_t *results)
+{
+    int valid;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_VERIFY_SIGNATURES_BATCH);
+
+    valid = verify_signatures(domain, payments, signatures, expected_signers, count, results);
+    NOVA402_STATS_END(count, valid < 0);
+    return valid;
+}
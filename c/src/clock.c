@@ -0,0 +1,131 @@
+/**
+ * Nova402 C Library - cached wall clock and explicit-time validation
+ *
+ * Validation only needs whole seconds, so a request path does not have to
+ * read the system clock at all: once nova402_clock_tick() has run, or the
+ * ticker thread from nova402_clock_start() is refreshing it, the current
+ * time is one atomic load of g_cached_seconds. Without a cached clock the
+ * time comes from the coarse real-time clock where there is one (served
+ * from the vDSO on Linux, no system call).
+ *
+ * @file clock.c
+ */
+
+/* clock_gettime() under strict C99 */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "internal.h"
+#include "atomic.h"
+#include "sync.h"
+
+#include <time.h>
+
+/* Unix seconds from the last tick; 0 while no cached clock is running */
+static volatile uint64_t g_cached_seconds;
+
+static struct {
+    nova402_mutex_t lock;
+    nova402_cond_t wake;
+    nova402_thread_t handle;
+    nova402_thread_start_t start;
+    uint32_t interval_ms;
+    int running;
+    int stopping;
+} g_ticker;
+
+static uint64_t wall_seconds(void)
+{
+#if defined(CLOCK_REALTIME_COARSE)
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) {
+        return (uint64_t)ts.tv_sec;
+    }
+#endif
+    return (uint64_t)time(NULL);
+}
+
+void nova402_clock_tick(void)
+{
+    nova402_atomic_store_u64(&g_cached_seconds, wall_seconds());
+}
+
+uint64_t nova402_clock_now(void)
+{
+    uint64_t now = nova402_atomic_load_u64(&g_cached_seconds);
+
+    return now ? now : wall_seconds();
+}
+
+static void ticker_run(void *arg)
+{
+    (void)arg;
+
+    nova402_mutex_lock(&g_ticker.lock);
+    while (!g_ticker.stopping) {
+        nova402_clock_tick();
+        nova402_cond_wait_until(&g_ticker.wake, &g_ticker.lock,
+                                nova402_clock_us() + (uint64_t)g_ticker.interval_ms * 1000u);
+    }
+    nova402_mutex_unlock(&g_ticker.lock);
+}
+
+int nova402_clock_start(uint32_t interval_ms)
+{
+    if (g_ticker.running) {
+        return NOVA402_SUCCESS;
+    }
+    if (interval_ms == 0) {
+        interval_ms = 1000;
+    }
+
+    if (nova402_mutex_init(&g_ticker.lock) != 0) {
+        return NOVA402_ERROR_CAPACITY;
+    }
+    if (nova402_cond_init(&g_ticker.wake) != 0) {
+        nova402_mutex_destroy(&g_ticker.lock);
+        return NOVA402_ERROR_CAPACITY;
+    }
+    g_ticker.interval_ms = interval_ms;
+    g_ticker.stopping = 0;
+    g_ticker.start.fn = ticker_run;
+    g_ticker.start.arg = NULL;
+
+    /* Valid before the thread is first scheduled */
+    nova402_clock_tick();
+    if (nova402_thread_create(&g_ticker.handle, &g_ticker.start) != 0) {
+        nova402_cond_destroy(&g_ticker.wake);
+        nova402_mutex_destroy(&g_ticker.lock);
+        nova402_atomic_store_u64(&g_cached_seconds, 0);
+        return NOVA402_ERROR_CAPACITY;
+    }
+    g_ticker.running = 1;
+    return NOVA402_SUCCESS;
+}
+
+void nova402_clock_stop(void)
+{
+    if (g_ticker.running) {
+        nova402_mutex_lock(&g_ticker.lock);
+        g_ticker.stopping = 1;
+        nova402_cond_signal(&g_ticker.wake);
+        nova402_mutex_unlock(&g_ticker.lock);
+        nova402_thread_join(g_ticker.handle);
+        nova402_cond_destroy(&g_ticker.wake);
+        nova402_mutex_destroy(&g_ticker.lock);
+        g_ticker.running = 0;
+    }
+    nova402_atomic_store_u64(&g_cached_seconds, 0);
+}
+
+bool nova402_validate_not_expired_at(uint64_t valid_before, uint64_t now)
+{
+    return now < valid_before;
+}
+
+bool nova402_validate_time_window_at(uint64_t valid_after, uint64_t valid_before, uint64_t now)
+{
+    return now >= valid_after && now < valid_before;
+}
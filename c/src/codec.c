@@ -0,0 +1,205 @@
+/**
+ * Nova402 C Library - base64 and hex conversion
+ *
+ * Length and padding handling around the block kernels of the runtime
+ * dispatch table, plus their portable fallbacks.
+ *
+ * @file codec.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+/* 6-bit value of each base64 character, 0xFF outside the alphabet */
+static const uint8_t BASE64_VALUE[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 62,   0xFF, 0xFF, 0xFF, 63,
+    52,   53,   54,   55,   56,   57,   58,   59,   60,   61,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0,    1,    2,    3,    4,    5,    6,    7,    8,    9,    10,   11,   12,   13,   14,
+    15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+    41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+/* Nibble value of each hex digit, 0xFF otherwise */
+static const uint8_t HEX_VALUE[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 10,   11,   12,   13,   14,   15,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 10,   11,   12,   13,   14,   15,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+static const char HEX_DIGITS[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+/* Decode one 4-character group; returns nonzero if any character is invalid */
+static uint32_t decode_quad(uint8_t *out, const uint8_t *in)
+{
+    uint32_t a = BASE64_VALUE[in[0]], b = BASE64_VALUE[in[1]];
+    uint32_t c = BASE64_VALUE[in[2]], d = BASE64_VALUE[in[3]];
+    uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+
+    out[0] = (uint8_t)(v >> 16);
+    out[1] = (uint8_t)(v >> 8);
+    out[2] = (uint8_t)v;
+    return (a | b | c | d) & 0x80;
+}
+
+size_t nova402_base64_decode_blocks_portable(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    size_t block;
+    int q;
+
+    for (block = 0; block < blocks; block++) {
+        uint32_t bad = 0;
+
+        for (q = 0; q < 8; q++) {
+            bad |= decode_quad(out + 3 * q, in + 4 * q);
+        }
+        if (bad) {
+            break;
+        }
+        in += NOVA402_BASE64_BLOCK_CHARS;
+        out += NOVA402_BASE64_BLOCK_BYTES;
+    }
+    return block;
+}
+
+size_t nova402_hex_decode_blocks_portable(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    size_t block;
+    int i;
+
+    for (block = 0; block < blocks; block++) {
+        uint32_t bad = 0;
+
+        for (i = 0; i < NOVA402_HEX_BLOCK_BYTES; i++) {
+            uint32_t hi = HEX_VALUE[in[2 * i]], lo = HEX_VALUE[in[2 * i + 1]];
+            out[i] = (uint8_t)((hi << 4) | (lo & 0x0F));
+            bad |= (hi | lo) & 0x80;
+        }
+        if (bad) {
+            break;
+        }
+        in += 2 * NOVA402_HEX_BLOCK_BYTES;
+        out += NOVA402_HEX_BLOCK_BYTES;
+    }
+    return block;
+}
+
+size_t nova402_hex_encode_blocks_portable(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    size_t i;
+
+    for (i = 0; i < blocks * NOVA402_HEX_BLOCK_BYTES; i++) {
+        out[2 * i] = (uint8_t)HEX_DIGITS[in[i] >> 4];
+        out[2 * i + 1] = (uint8_t)HEX_DIGITS[in[i] & 0x0F];
+    }
+    return blocks;
+}
+
+int nova402_base64_decode(const char *in, size_t length, uint8_t *out, size_t out_size,
+                          size_t *out_length)
+{
+    const uint8_t *src = (const uint8_t *)in;
+    size_t chars = length, bytes, blocks = 0, done, i;
+    uint8_t tail[3];
+
+    /* Drop up to two '=' that complete the final group */
+    if (chars > 0 && chars % 4 == 0 && src[chars - 1] == '=') {
+        chars -= (src[chars - 2] == '=') ? 2 : 1;
+    }
+    if (chars % 4 == 1) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    bytes = chars / 4 * 3 + (chars % 4 ? chars % 4 - 1 : 0);
+    if (bytes > out_size) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    if (out_size >= NOVA402_BASE64_BLOCK_CHARS) {
+        blocks = chars / NOVA402_BASE64_BLOCK_CHARS;
+        if (blocks > (out_size - 8) / NOVA402_BASE64_BLOCK_BYTES) {
+            blocks = (out_size - 8) / NOVA402_BASE64_BLOCK_BYTES;
+        }
+    }
+    done = nova402_dispatch()->base64_decode_blocks(out, src, blocks);
+
+    /* Rest (and any block the kernel rejected) a group at a time */
+    for (i = done * NOVA402_BASE64_BLOCK_CHARS; i + 4 <= chars; i += 4) {
+        if (decode_quad(out + i / 4 * 3, src + i)) {
+            return NOVA402_ERROR_INVALID_INPUT;
+        }
+    }
+
+    if (i < chars) {
+        uint8_t group[4] = { 'A', 'A', 'A', 'A' };
+        size_t rest = chars - i;
+
+        memcpy(group, src + i, rest);
+        if (decode_quad(tail, group)) {
+            return NOVA402_ERROR_INVALID_INPUT;
+        }
+        /* Non-canonical encodings leave bits set past the last byte */
+        if (tail[rest - 1] != 0) {
+            return NOVA402_ERROR_INVALID_INPUT;
+        }
+        memcpy(out + i / 4 * 3, tail, rest - 1);
+    }
+
+    *out_length = bytes;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_hex_decode(const char *hex, uint8_t *out, size_t length)
+{
+    const uint8_t *src = (const uint8_t *)hex;
+    size_t blocks = length / NOVA402_HEX_BLOCK_BYTES, i;
+    uint32_t bad = 0;
+
+    i = nova402_dispatch()->hex_decode_blocks(out, src, blocks) * NOVA402_HEX_BLOCK_BYTES;
+
+    for (; i < length; i++) {
+        uint32_t hi = HEX_VALUE[src[2 * i]], lo = HEX_VALUE[src[2 * i + 1]];
+        out[i] = (uint8_t)((hi << 4) | (lo & 0x0F));
+        bad |= (hi | lo) & 0x80;
+    }
+
+    return bad ? -1 : 0;
+}
+
+void nova402_hex_encode(const uint8_t *bytes, size_t length, char *hex)
+{
+    size_t blocks = length / NOVA402_HEX_BLOCK_BYTES, i;
+
+    nova402_dispatch()->hex_encode_blocks((uint8_t *)hex, bytes, blocks);
+
+    for (i = blocks * NOVA402_HEX_BLOCK_BYTES; i < length; i++) {
+        hex[2 * i] = HEX_DIGITS[bytes[i] >> 4];
+        hex[2 * i + 1] = HEX_DIGITS[bytes[i] & 0x0F];
+    }
+}
@@ -0,0 +1,120 @@
+/**
+ * Nova402 C Library - AVX2 base64 and hex conversion
+ *
+ * Base64 follows the nibble-lookup scheme of Muła and Lemire: two shuffles
+ * classify every character, a third maps it to its 6-bit value, and
+ * multiply-add instructions pack four values into three bytes. Built with
+ * AVX2 enabled for this file only; called through the runtime dispatcher.
+ *
+ * @file codec_avx2.c
+ */
+
+#include "internal.h"
+
+#include <immintrin.h>
+
+size_t nova402_base64_decode_blocks_avx2(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    const __m256i lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+    const __m256i pack = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i gather = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    size_t block;
+
+    for (block = 0; block < blocks; block++) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(const void *)in);
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(v, 4), mask_2f);
+        __m256i lo_nibbles = _mm256_and_si256(v, mask_2f);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        __m256i roll;
+
+        if (!_mm256_testz_si256(lo, hi)) {
+            break;
+        }
+
+        roll = _mm256_shuffle_epi8(lut_roll,
+                                   _mm256_add_epi8(_mm256_cmpeq_epi8(v, mask_2f), hi_nibbles));
+        v = _mm256_add_epi8(v, roll);
+
+        /* 4 x 6 bits -> 24 bits per dword, then 12 bytes per lane */
+        v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+        v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+        v = _mm256_shuffle_epi8(v, pack);
+        v = _mm256_permutevar8x32_epi32(v, gather);
+
+        _mm256_storeu_si256((__m256i *)(void *)out, v);
+        in += NOVA402_BASE64_BLOCK_CHARS;
+        out += NOVA402_BASE64_BLOCK_BYTES;
+    }
+    return block;
+}
+
+size_t nova402_hex_decode_blocks_avx2(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    const __m256i zero_char = _mm256_set1_epi8('0');
+    const __m256i a_char = _mm256_set1_epi8('a');
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i five = _mm256_set1_epi8(5);
+    const __m256i ten = _mm256_set1_epi8(10);
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    size_t block;
+
+    for (block = 0; block < blocks; block++) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(const void *)in);
+        __m256i digit = _mm256_sub_epi8(v, zero_char);
+        __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(v, lower), a_char);
+        __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, nine), digit);
+        __m256i is_alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, five), alpha);
+        __m256i nibbles;
+
+        if ((uint32_t)_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_alpha)) != 0xFFFFFFFFu) {
+            break;
+        }
+
+        nibbles = _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+                                  _mm256_and_si256(is_alpha, _mm256_add_epi8(alpha, ten)));
+
+        /* hi * 16 + lo per byte pair, narrowed to 8 bytes per lane */
+        v = _mm256_maddubs_epi16(nibbles, weights);
+        v = _mm256_packus_epi16(v, v);
+        v = _mm256_permute4x64_epi64(v, 0x08);
+
+        _mm_storeu_si128((__m128i *)(void *)out, _mm256_castsi256_si128(v));
+        in += 2 * NOVA402_HEX_BLOCK_BYTES;
+        out += NOVA402_HEX_BLOCK_BYTES;
+    }
+    return block;
+}
+
+size_t nova402_hex_encode_blocks_avx2(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    const __m256i digits = _mm256_setr_epi8(
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i low_nibble = _mm256_set1_epi16(0x0F);
+    size_t block;
+
+    for (block = 0; block < blocks; block++) {
+        /* One byte per 16-bit lane: high nibble to the low byte, low nibble above it */
+        __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(const void *)in));
+        __m256i nibbles = _mm256_or_si256(_mm256_srli_epi16(v, 4),
+                                          _mm256_slli_epi16(_mm256_and_si256(v, low_nibble), 8));
+
+        _mm256_storeu_si256((__m256i *)(void *)out, _mm256_shuffle_epi8(digits, nibbles));
+        in += NOVA402_HEX_BLOCK_BYTES;
+        out += 2 * NOVA402_HEX_BLOCK_BYTES;
+    }
+    return blocks;
+}
@@ -0,0 +1,66 @@
+/**
+ * Nova402 C Library - NEON hex conversion
+ *
+ * De-interleaving loads and interleaving stores split each digit pair
+ * into separate vectors, so one block needs no shuffles. NEON is part of
+ * the AArch64 baseline; called through the runtime dispatcher.
+ *
+ * @file codec_neon.c
+ */
+
+#include "internal.h"
+
+#include <arm_neon.h>
+
+/* Nibble values of 16 hex digits; *valid is cleared on any other character */
+static uint8x16_t hex_nibbles_16(uint8x16_t v, uint8x16_t *valid)
+{
+    uint8x16_t digit = vsubq_u8(v, vdupq_n_u8('0'));
+    uint8x16_t alpha = vsubq_u8(vorrq_u8(v, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t is_digit = vcleq_u8(digit, vdupq_n_u8(9));
+    uint8x16_t is_alpha = vcleq_u8(alpha, vdupq_n_u8(5));
+
+    *valid = vandq_u8(*valid, vorrq_u8(is_digit, is_alpha));
+    return vbslq_u8(is_digit, digit, vaddq_u8(alpha, vdupq_n_u8(10)));
+}
+
+size_t nova402_hex_decode_blocks_neon(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    size_t block;
+
+    for (block = 0; block < blocks; block++) {
+        uint8x16x2_t pairs = vld2q_u8(in);
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+        uint8x16_t hi = hex_nibbles_16(pairs.val[0], &valid);
+        uint8x16_t lo = hex_nibbles_16(pairs.val[1], &valid);
+
+        if (vminvq_u8(valid) != 0xFF) {
+            break;
+        }
+        vst1q_u8(out, vsliq_n_u8(lo, hi, 4));
+        in += 2 * NOVA402_HEX_BLOCK_BYTES;
+        out += NOVA402_HEX_BLOCK_BYTES;
+    }
+    return block;
+}
+
+size_t nova402_hex_encode_blocks_neon(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    static const uint8_t digits_table[16] = {
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+    };
+    const uint8x16_t digits = vld1q_u8(digits_table);
+    size_t block;
+
+    for (block = 0; block < blocks; block++) {
+        uint8x16_t v = vld1q_u8(in);
+        uint8x16x2_t chars;
+
+        chars.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(v, 4));
+        chars.val[1] = vqtbl1q_u8(digits, vandq_u8(v, vdupq_n_u8(0x0F)));
+        vst2q_u8(out, chars);
+        in += NOVA402_HEX_BLOCK_BYTES;
+        out += 2 * NOVA402_HEX_BLOCK_BYTES;
+    }
+    return blocks;
+}
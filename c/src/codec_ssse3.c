@@ -0,0 +1,116 @@
+/**
+ * Nova402 C Library - SSSE3 base64 and hex conversion
+ *
+ * 128-bit versions of the kernels in codec_avx2.c for x86 hosts without
+ * AVX2. Built with SSSE3 enabled for this file only; called through the
+ * runtime dispatcher.
+ *
+ * @file codec_ssse3.c
+ */
+
+#include "internal.h"
+
+#include <tmmintrin.h>
+
+/* Decode 16 base64 characters into 12 bytes (16 stored); returns 0 on a bad character */
+static int base64_decode_16(uint8_t *out, const uint8_t *in)
+{
+    const __m128i lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2F);
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    __m128i v = _mm_loadu_si128((const __m128i *)(const void *)in);
+    __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(v, 4), mask_2f);
+    __m128i lo_nibbles = _mm_and_si128(v, mask_2f);
+    __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    __m128i roll;
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF) {
+        return 0;
+    }
+
+    roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(v, mask_2f), hi_nibbles));
+    v = _mm_add_epi8(v, roll);
+    v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+    v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+    _mm_storeu_si128((__m128i *)(void *)out, _mm_shuffle_epi8(v, pack));
+    return 1;
+}
+
+size_t nova402_base64_decode_blocks_ssse3(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    size_t block;
+
+    for (block = 0; block < blocks; block++) {
+        if (!base64_decode_16(out, in) || !base64_decode_16(out + 12, in + 16)) {
+            break;
+        }
+        in += NOVA402_BASE64_BLOCK_CHARS;
+        out += NOVA402_BASE64_BLOCK_BYTES;
+    }
+    return block;
+}
+
+/* Nibble values of 16 hex digits; *valid is cleared on any other character */
+static __m128i hex_nibbles_16(const uint8_t *in, int *valid)
+{
+    __m128i v = _mm_loadu_si128((const __m128i *)(const void *)in);
+    __m128i digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    __m128i alpha = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF) {
+        *valid = 0;
+    }
+    return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                        _mm_and_si128(is_alpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+}
+
+size_t nova402_hex_decode_blocks_ssse3(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    size_t block;
+
+    for (block = 0; block < blocks; block++) {
+        int valid = 1;
+        __m128i a = hex_nibbles_16(in, &valid);
+        __m128i b = hex_nibbles_16(in + 16, &valid);
+
+        if (!valid) {
+            break;
+        }
+        a = _mm_maddubs_epi16(a, weights);
+        b = _mm_maddubs_epi16(b, weights);
+        _mm_storeu_si128((__m128i *)(void *)out, _mm_packus_epi16(a, b));
+        in += 2 * NOVA402_HEX_BLOCK_BYTES;
+        out += NOVA402_HEX_BLOCK_BYTES;
+    }
+    return block;
+}
+
+size_t nova402_hex_encode_blocks_ssse3(uint8_t *out, const uint8_t *in, size_t blocks)
+{
+    const __m128i digits = _mm_setr_epi8(
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i low_nibble = _mm_set1_epi8(0x0F);
+    size_t block;
+
+    for (block = 0; block < blocks; block++) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)in);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low_nibble);
+        __m128i lo = _mm_and_si128(v, low_nibble);
+
+        _mm_storeu_si128((__m128i *)(void *)out,
+                         _mm_shuffle_epi8(digits, _mm_unpacklo_epi8(hi, lo)));
+        _mm_storeu_si128((__m128i *)(void *)(out + 16),
+                         _mm_shuffle_epi8(digits, _mm_unpackhi_epi8(hi, lo)));
+        in += NOVA402_HEX_BLOCK_BYTES;
+        out += 2 * NOVA402_HEX_BLOCK_BYTES;
+    }
+    return blocks;
+}
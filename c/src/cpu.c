@@ -0,0 +1,175 @@
+/**
+ * Nova402 C Library - CPU feature detection
+ *
+ * CPUID/XGETBV on x86, HWCAP (or sysctl on Apple) on AArch64. The result
+ * is cached by the dispatcher; nova402_cpu_probe() itself is uncached.
+ *
+ * @file cpu.c
+ */
+
+#include "internal.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NOVA402_CPU_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define NOVA402_CPU_ARM64 1
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sys/auxv.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+#endif
+
+#if defined(NOVA402_CPU_X86)
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+{
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    regs[0] = (uint32_t)r[0];
+    regs[1] = (uint32_t)r[1];
+    regs[2] = (uint32_t)r[2];
+    regs[3] = (uint32_t)r[3];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/* XCR0: which register states the OS saves on context switch */
+static uint64_t xgetbv0(void)
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+#endif
+}
+
+static uint32_t detect(void)
+{
+    uint32_t regs[4], max_leaf, features = 0;
+    uint64_t xcr0 = 0;
+    int ymm, zmm;
+
+    cpuid(0, 0, regs);
+    max_leaf = regs[0];
+    if (max_leaf < 1) {
+        return 0;
+    }
+
+    cpuid(1, 0, regs);
+    if (regs[2] & (1u << 9)) {
+        features |= NOVA402_CPU_SSSE3;
+    }
+    if (regs[2] & (1u << 19)) {
+        features |= NOVA402_CPU_SSE41;
+    }
+    /*
+     * AVX kernels need the AVX bit, OSXSAVE (so XGETBV exists) and the OS
+     * saving XMM|YMM state, plus opmask|ZMM state for AVX-512; a VM or OS
+     * with AVX disabled clears one of these even when leaf 7 reports AVX2.
+     */
+    if ((regs[2] & (1u << 27)) && (regs[2] & (1u << 28))) {
+        xcr0 = xgetbv0();
+    }
+    ymm = (xcr0 & 0x6) == 0x6;
+    zmm = ymm && (xcr0 & 0xE6) == 0xE6;
+
+    if (max_leaf < 7) {
+        return features;
+    }
+
+    cpuid(7, 0, regs);
+    if (ymm && (regs[1] & (1u << 5))) {
+        features |= NOVA402_CPU_AVX2;
+    }
+    if (zmm && (regs[1] & (1u << 16))) {
+        features |= NOVA402_CPU_AVX512F;
+        if (regs[1] & (1u << 31)) {
+            features |= NOVA402_CPU_AVX512VL;
+        }
+    }
+    if (regs[1] & (1u << 8)) {
+        features |= NOVA402_CPU_BMI2;
+    }
+    if (regs[1] & (1u << 19)) {
+        features |= NOVA402_CPU_ADX;
+    }
+    if (regs[1] & (1u << 29)) {
+        features |= NOVA402_CPU_SHA;
+    }
+
+    return features;
+}
+
+#elif defined(NOVA402_CPU_ARM64)
+
+#if defined(__APPLE__)
+static int sysctl_flag(const char *name)
+{
+    int value = 0;
+    size_t size = sizeof(value);
+
+    if (sysctlbyname(name, &value, &size, NULL, 0) != 0) {
+        return 0;
+    }
+    return value != 0;
+}
+#endif
+
+static uint32_t detect(void)
+{
+    /* Advanced SIMD is mandatory on AArch64 */
+    uint32_t features = NOVA402_CPU_NEON;
+
+#if defined(__linux__) || defined(__ANDROID__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+
+    if (hwcap & (1ul << 3)) {  /* HWCAP_AES */
+        features |= NOVA402_CPU_ARM_AES;
+    }
+    if (hwcap & (1ul << 6)) {  /* HWCAP_SHA2 */
+        features |= NOVA402_CPU_ARM_SHA2;
+    }
+    if (hwcap & (1ul << 17)) { /* HWCAP_SHA3 */
+        features |= NOVA402_CPU_ARM_SHA3;
+    }
+#elif defined(__APPLE__)
+    /* Every Apple AArch64 core has AES and SHA-2 */
+    features |= NOVA402_CPU_ARM_AES | NOVA402_CPU_ARM_SHA2;
+    if (sysctl_flag("hw.optional.arm.FEAT_SHA3")) {
+        features |= NOVA402_CPU_ARM_SHA3;
+    }
+#elif defined(_WIN32)
+    if (IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE)) {
+        features |= NOVA402_CPU_ARM_AES | NOVA402_CPU_ARM_SHA2;
+    }
+#endif
+
+    return features;
+}
+
+#else
+
+static uint32_t detect(void)
+{
+    return 0;
+}
+
+#endif
+
+uint32_t nova402_cpu_probe(void)
+{
+    return detect();
+}
@@ -0,0 +1,438 @@
+/**
+ * Nova402 C Library - verification context and workers
+ *
+ * A context bundles everything that is derived once and then only read:
+ * the secp256k1 generator tables, and the configuration and USDC EIP-712
+ * domain of every network it was created for. Workers add the per-thread
+ * part, a scratch arena, in a block of whole cache lines so that workers
+ * used from different cores never share one.
+ *
+ * @file ctx.c
+ */
+
+#include "internal.h"
+#include "secp256k1.h"
+#include "stats.h"
+
+#include <limits.h>
+#include <string.h>
+
+/* Enough for one Ed25519 batch chunk and a few thousand multiproof leaves */
+#define DEFAULT_SCRATCH_SIZE (256 * 1024)
+
+typedef struct {
+    nova402_network_config_t config;
+    nova402_eip712_domain_t domain;  /* EVM networks only */
+} ctx_network_t;
+
+struct nova402_ctx {
+    nova402_secp256k1_ctx_t *secp256k1;
+    ctx_network_t *networks;
+    size_t network_count;
+    const ctx_network_t *by_id[NOVA402_NETWORK_ID_COUNT];  /* NULL: not configured */
+    size_t memory_bytes;
+};
+
+struct nova402_worker {
+    const nova402_ctx_t *ctx;
+    nova402_arena_t arena;
+    void *block;  /* allocation holding the worker and its scratch */
+};
+
+/* Worker header rounded up to whole cache lines */
+#define WORKER_SIZE \
+    ((sizeof(nova402_worker_t) + NOVA402_CACHE_LINE - 1) & ~(size_t)(NOVA402_CACHE_LINE - 1))
+
+nova402_ctx_t *nova402_ctx_create(
+    const char *const *networks,
+    size_t network_count,
+    nova402_secp256k1_table_t table)
+{
+    nova402_ctx_t *ctx;
+    size_t i;
+
+    if ((!networks && network_count > 0) || network_count > (size_t)-1 / sizeof(ctx_network_t)) {
+        return NULL;
+    }
+
+    ctx = nova402_calloc(1, sizeof(*ctx));
+    if (!ctx) {
+        return NULL;
+    }
+    ctx->secp256k1 = nova402_secp256k1_ctx_create(table);
+    ctx->networks = network_count ? nova402_calloc(network_count, sizeof(ctx_network_t)) : NULL;
+    if (!ctx->secp256k1 || (network_count && !ctx->networks)) {
+        nova402_ctx_destroy(ctx);
+        return NULL;
+    }
+    ctx->network_count = network_count;
+    ctx->memory_bytes = sizeof(*ctx) + network_count * sizeof(ctx_network_t);
+
+    for (i = 0; i < network_count; i++) {
+        ctx_network_t *entry = &ctx->networks[i];
+        nova402_network_id_t id = networks[i] ? nova402_network_lookup(networks[i], strlen(networks[i]))
+                                              : NOVA402_NETWORK_ID_UNKNOWN;
+        const nova402_network_info_t *info = nova402_network_info(id);
+
+        if (!info ||
+            (info->config.type == NOVA402_NETWORK_EVM &&
+             nova402_eip712_domain_for_network(&entry->domain, networks[i], NULL, NULL) != NOVA402_SUCCESS)) {
+            nova402_ctx_destroy(ctx);
+            return NULL;
+        }
+        entry->config = info->config;
+        ctx->by_id[id] = entry;
+    }
+
+    return ctx;
+}
+
+void nova402_ctx_destroy(nova402_ctx_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    nova402_secp256k1_ctx_destroy(ctx->secp256k1);
+    nova402_free(ctx->networks);
+    nova402_free(ctx);
+}
+
+size_t nova402_ctx_memory(const nova402_ctx_t *ctx)
+{
+    return ctx ? ctx->memory_bytes : 0;
+}
+
+static const ctx_network_t *find_network(const nova402_ctx_t *ctx, const char *network)
+{
+    return ctx->by_id[nova402_network_lookup(network, strlen(network))];
+}
+
+int nova402_ctx_network_config(
+    const nova402_ctx_t *ctx,
+    const char *network,
+    nova402_network_config_t *config)
+{
+    const ctx_network_t *entry;
+
+    if (!ctx || !network || !config) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    entry = find_network(ctx, network);
+    if (!entry) {
+        return NOVA402_ERROR_UNSUPPORTED;
+    }
+    *config = entry->config;
+    return NOVA402_SUCCESS;
+}
+
+const nova402_eip712_domain_t *nova402_ctx_domain(const nova402_ctx_t *ctx, const char *network)
+{
+    const ctx_network_t *entry;
+
+    if (!ctx || !network) {
+        return NULL;
+    }
+    entry = find_network(ctx, network);
+    return (entry && entry->config.type == NOVA402_NETWORK_EVM) ? &entry->domain : NULL;
+}
+
+const nova402_secp256k1_ctx_t *nova402_ctx_secp256k1(const nova402_ctx_t *ctx)
+{
+    return ctx ? ctx->secp256k1 : NULL;
+}
+
+nova402_worker_t *nova402_worker_create(const nova402_ctx_t *ctx, size_t scratch_size)
+{
+    nova402_worker_t *worker;
+    uintptr_t aligned;
+    void *block;
+
+    if (!ctx) {
+        return NULL;
+    }
+    if (scratch_size == 0) {
+        scratch_size = DEFAULT_SCRATCH_SIZE;
+    }
+    if (scratch_size > (size_t)-1 - WORKER_SIZE - NOVA402_CACHE_LINE) {
+        return NULL;
+    }
+
+    /* Whole cache lines from an aligned start: no other allocation shares them */
+    scratch_size = (scratch_size + NOVA402_CACHE_LINE - 1) & ~(size_t)(NOVA402_CACHE_LINE - 1);
+    block = nova402_malloc(WORKER_SIZE + scratch_size + NOVA402_CACHE_LINE - 1);
+    if (!block) {
+        return NULL;
+    }
+    aligned = ((uintptr_t)block + NOVA402_CACHE_LINE - 1) & ~(uintptr_t)(NOVA402_CACHE_LINE - 1);
+    worker = (nova402_worker_t *)aligned;
+    worker->ctx = ctx;
+    worker->block = block;
+    nova402_arena_init(&worker->arena, (uint8_t *)worker + WORKER_SIZE, scratch_size);
+    return worker;
+}
+
+void nova402_worker_destroy(nova402_worker_t *worker)
+{
+    if (worker) {
+        nova402_free(worker->block);
+    }
+}
+
+nova402_arena_t *nova402_worker_arena(nova402_worker_t *worker)
+{
+    return worker ? &worker->arena : NULL;
+}
+
+static bool worker_verify_payment(nova402_worker_t *worker, const nova402_payment_header_t *header)
+{
+    const nova402_eip712_domain_t *domain;
+    nova402_hash_t digest;
+    nova402_address_t signer;
+    uint8_t ok;
+
+    if (!worker || !header) {
+        return false;
+    }
+    domain = nova402_ctx_domain(worker->ctx, header->network);
+    if (!domain || nova402_eip712_hash_payment(domain, &header->payment, &digest) != NOVA402_SUCCESS) {
+        return false;
+    }
+
+    nova402_secp256k1_recover_batch(worker->ctx->secp256k1, &digest, &header->signature, 1, &signer, &ok);
+    return ok && memcmp(signer.bytes, header->payment.from.bytes, NOVA402_ADDRESS_SIZE) == 0;
+}
+
+bool nova402_worker_verify_payment(nova402_worker_t *worker, const nova402_payment_header_t *header)
+{
+    bool valid;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_VERIFY_SIGNATURE);
+
+    valid = worker_verify_payment(worker, header);
+    NOVA402_STATS_END(1, !valid);
+    return valid;
+}
+
+/*
+ * Loads item i of a batch for verify_chunked(): its EIP-712 struct
+ * encoding, signature, claimed signer and domain. Returns false to skip
+ * the item (unknown or non-EVM network, malformed record).
+ */
+typedef bool (*verify_item_fn)(const nova402_worker_t *worker, const void *items, size_t i,
+                               uint8_t *encoded, nova402_signature_t *signature,
+                               nova402_address_t *from, const nova402_eip712_domain_t **domain);
+
+/*
+ * Shared body of the batch verifiers. Skipped items do not take a slot,
+ * so chunks stay full; both EIP-712 hashes of a chunk go through the
+ * multi-buffer kernel before one batched recovery.
+ */
+static int verify_chunked(
+    nova402_worker_t *worker,
+    const void *items,
+    size_t count,
+    verify_item_fn load_item,
+    uint8_t *results)
+{
+    uint8_t encoded[NOVA402_BATCH_CHUNK][NOVA402_EIP712_STRUCT_SIZE];
+    const uint8_t *inputs[NOVA402_BATCH_CHUNK];
+    size_t lengths[NOVA402_BATCH_CHUNK];
+    const nova402_eip712_domain_t *domains[NOVA402_BATCH_CHUNK];
+    nova402_hash_t struct_hashes[NOVA402_BATCH_CHUNK];
+    nova402_hash_t digests[NOVA402_BATCH_CHUNK];
+    nova402_signature_t signatures[NOVA402_BATCH_CHUNK];
+    nova402_address_t from[NOVA402_BATCH_CHUNK];
+    nova402_address_t signers[NOVA402_BATCH_CHUNK];
+    size_t index[NOVA402_BATCH_CHUNK];
+    uint8_t ok[NOVA402_BATCH_CHUNK];
+    size_t i, j, n = 0;
+    int valid = 0;
+
+    if (count > INT_MAX) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    memset(results, 0, (count + 7) / 8);
+
+    for (i = 0; i < count; i++) {
+        if (load_item(worker, items, i, encoded[n], &signatures[n], &from[n], &domains[n])) {
+            inputs[n] = encoded[n];
+            lengths[n] = NOVA402_EIP712_STRUCT_SIZE;
+            index[n++] = i;
+        }
+        if (n == 0 || (n < NOVA402_BATCH_CHUNK && i + 1 < count)) {
+            continue;
+        }
+
+        nova402_keccak256_many(inputs, lengths, n, struct_hashes);
+        for (j = 0; j < n; j++) {
+            nova402_eip712_encode_digest(&domains[j]->separator, &struct_hashes[j], encoded[j]);
+            lengths[j] = NOVA402_EIP712_DIGEST_INPUT_SIZE;
+        }
+        nova402_keccak256_many(inputs, lengths, n, digests);
+
+        nova402_secp256k1_recover_batch(worker->ctx->secp256k1, digests, signatures, n, signers, ok);
+        for (j = 0; j < n; j++) {
+            if (ok[j] && memcmp(signers[j].bytes, from[j].bytes, NOVA402_ADDRESS_SIZE) == 0) {
+                NOVA402_BITMAP_SET(results, index[j]);
+                valid++;
+            }
+        }
+        n = 0;
+    }
+
+    return valid;
+}
+
+static bool load_payment(const nova402_worker_t *worker, const void *items, size_t i,
+                         uint8_t *encoded, nova402_signature_t *signature,
+                         nova402_address_t *from, const nova402_eip712_domain_t **domain)
+{
+    const nova402_payment_header_t *header = (const nova402_payment_header_t *)items + i;
+
+    *domain = nova402_ctx_domain(worker->ctx, header->network);
+    if (!*domain) {
+        return false;
+    }
+    nova402_eip712_encode_struct(&header->payment, encoded);
+    *signature = header->signature;
+    *from = header->payment.from;
+    return true;
+}
+
+static int worker_verify_payments(
+    nova402_worker_t *worker,
+    const nova402_payment_header_t *headers,
+    size_t count,
+    uint8_t *results)
+{
+    if (count == 0) {
+        return 0;
+    }
+    if (!worker || !headers || !results) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    return verify_chunked(worker, headers, count, load_payment, results);
+}
+
+int nova402_worker_verify_payments(
+    nova402_worker_t *worker,
+    const nova402_payment_header_t *headers,
+    size_t count,
+    uint8_t *results)
+{
+    int valid;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_VERIFY_SIGNATURES_BATCH);
+
+    valid = worker_verify_payments(worker, headers, count, results);
+    NOVA402_STATS_END(count, valid < 0);
+    return valid;
+}
+
+static bool load_packed(const nova402_worker_t *worker, const void *items, size_t i,
+                        uint8_t *encoded, nova402_signature_t *signature,
+                        nova402_address_t *from, const nova402_eip712_domain_t **domain)
+{
+    const nova402_packed_record_t *record = (const nova402_packed_record_t *)items + i;
+    nova402_network_id_t network;
+    nova402_payment_data_t payment;
+    const ctx_network_t *entry;
+
+    if (nova402_packed_load(record, &network, &payment, signature) != NOVA402_SUCCESS ||
+        (entry = worker->ctx->by_id[network]) == NULL || entry->config.type != NOVA402_NETWORK_EVM) {
+        return false;
+    }
+    nova402_eip712_encode_struct(&payment, encoded);
+    *from = record->from;
+    *domain = &entry->domain;
+    return true;
+}
+
+static int worker_verify_packed(
+    nova402_worker_t *worker,
+    const nova402_packed_record_t *records,
+    size_t count,
+    uint8_t *results)
+{
+    if (count == 0) {
+        return 0;
+    }
+    if (!worker || !records || !results) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    return verify_chunked(worker, records, count, load_packed, results);
+}
+
+int nova402_worker_verify_packed(
+    nova402_worker_t *worker,
+    const nova402_packed_record_t *records,
+    size_t count,
+    uint8_t *results)
+{
+    int valid;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_VERIFY_SIGNATURES_BATCH);
+
+    valid = worker_verify_packed(worker, records, count, results);
+    NOVA402_STATS_END(count, valid < 0);
+    return valid;
+}
+
+typedef struct {
+    const nova402_payment_batch_t *batch;
+    const uint8_t *mask;
+} masked_batch_t;
+
+static bool load_batch_row(const nova402_worker_t *worker, const void *items, size_t i,
+                           uint8_t *encoded, nova402_signature_t *signature,
+                           nova402_address_t *from, const nova402_eip712_domain_t **domain)
+{
+    const masked_batch_t *rows = (const masked_batch_t *)items;
+    const nova402_payment_batch_t *batch = rows->batch;
+    nova402_payment_data_t payment;
+    const ctx_network_t *entry;
+
+    /* Rows the mask leaves out are skipped */
+    if ((rows->mask && !(rows->mask[i >> 3] & (1u << (i & 7)))) ||
+        batch->network[i] >= NOVA402_NETWORK_ID_COUNT ||
+        (entry = worker->ctx->by_id[batch->network[i]]) == NULL ||
+        entry->config.type != NOVA402_NETWORK_EVM) {
+        return false;
+    }
+    nova402_payment_batch_get(batch, i, &payment, signature);
+    nova402_eip712_encode_struct(&payment, encoded);
+    *from = batch->from[i];
+    *domain = &entry->domain;
+    return true;
+}
+
+static int worker_verify_batch(
+    nova402_worker_t *worker,
+    const nova402_payment_batch_t *batch,
+    const uint8_t *mask,
+    uint8_t *results)
+{
+    masked_batch_t rows;
+
+    if (!worker || !batch || !results || batch->count > batch->capacity) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (batch->count == 0) {
+        return 0;
+    }
+    rows.batch = batch;
+    rows.mask = mask;
+    return verify_chunked(worker, &rows, batch->count, load_batch_row, results);
+}
+
+int nova402_worker_verify_batch(
+    nova402_worker_t *worker,
+    const nova402_payment_batch_t *batch,
+    const uint8_t *mask,
+    uint8_t *results)
+{
+    int valid;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_VERIFY_SIGNATURES_BATCH);
+
+    valid = worker_verify_batch(worker, batch, mask, results);
+    NOVA402_STATS_END(batch ? batch->count : 0, valid < 0);
+    return valid;
+}
@@ -0,0 +1,273 @@
+/**
+ * Nova402 C Library - runtime kernel dispatch
+ *
+ * Probes the CPU once and fills in the kernel table read by the hashing
+ * and signature code, so one binary runs on every host of an architecture
+ * and still takes the fastest path each host supports.
+ *
+ * @file dispatch.c
+ */
+
+#include "internal.h"
+#include "atomic.h"
+#include "secp256k1.h"
+
+#include <stdio.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Initialization states of the table below */
+#define DISPATCH_EMPTY 0
+#define DISPATCH_BUSY 1
+#define DISPATCH_READY 2
+
+static nova402_dispatch_t table;
+static char table_info[128];
+static volatile long table_state = DISPATCH_EMPTY;
+
+static long state_load(void)
+{
+#if defined(__GNUC__)
+    return __atomic_load_n(&table_state, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+    long state = table_state;
+#if defined(_M_ARM64)
+    __dmb(_ARM64_BARRIER_ISH);
+#endif
+    _ReadWriteBarrier();
+    return state;
+#else
+    return table_state;
+#endif
+}
+
+static void state_store(long state)
+{
+#if defined(__GNUC__)
+    __atomic_store_n(&table_state, state, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+    _InterlockedExchange(&table_state, state);
+#else
+    table_state = state;
+#endif
+}
+
+/* Claim the table for initialization; returns 1 for exactly one caller */
+static int state_claim(void)
+{
+#if defined(__GNUC__)
+    long expected = DISPATCH_EMPTY;
+    return __atomic_compare_exchange_n(&table_state, &expected, DISPATCH_BUSY, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+    return _InterlockedCompareExchange(&table_state, DISPATCH_BUSY, DISPATCH_EMPTY) ==
+           DISPATCH_EMPTY;
+#else
+    /* No atomics: racing initializers write identical values */
+    return 1;
+#endif
+}
+
+static const char *select_keccak(nova402_dispatch_t *d)
+{
+    uint32_t features = d->features;
+
+    (void)features;
+
+    d->keccak_f1600 = nova402_keccak_f1600;
+
+#if defined(NOVA402_HAVE_X86_KERNELS)
+    if (features & NOVA402_CPU_AVX512F) {
+        d->keccak_f1600_many = nova402_keccak_f1600_x8_avx512;
+        d->keccak_width = 8;
+        return "avx512x8";
+    }
+    if (features & NOVA402_CPU_AVX2) {
+        d->keccak_f1600_many = nova402_keccak_f1600_x4_avx2;
+        d->keccak_width = 4;
+        return "avx2x4";
+    }
+#endif
+
+#if defined(NOVA402_HAVE_SHA3_KERNELS)
+    if (features & NOVA402_CPU_ARM_SHA3) {
+        d->keccak_f1600_many = nova402_keccak_f1600_x2_sha3;
+        d->keccak_width = 2;
+        return "sha3x2";
+    }
+#endif
+
+#if defined(NOVA402_HAVE_NEON_KERNELS)
+    if (features & NOVA402_CPU_NEON) {
+        d->keccak_f1600_many = nova402_keccak_f1600_x2_neon;
+        d->keccak_width = 2;
+        return "neonx2";
+    }
+#endif
+
+    d->keccak_f1600_many = nova402_keccak_f1600;
+    d->keccak_width = 1;
+    return "portable";
+}
+
+static const char *select_sha256(nova402_dispatch_t *d)
+{
+    uint32_t features = d->features;
+    const char *name = "portable";
+
+    (void)features;
+
+    d->sha256_compress = nova402_sha256_compress_portable;
+    d->sha256_compress_many = NULL;
+    d->sha256_width = 1;
+
+#if defined(NOVA402_HAVE_X86_KERNELS)
+    if ((features & (NOVA402_CPU_SHA | NOVA402_CPU_SSE41)) == (NOVA402_CPU_SHA | NOVA402_CPU_SSE41)) {
+        d->sha256_compress = nova402_sha256_compress_shani;
+        name = "shani";
+    } else if (features & NOVA402_CPU_AVX2) {
+        /* Without SHA-NI, eight lanes beat one message at a time */
+        d->sha256_compress_many = nova402_sha256_compress_x8_avx2;
+        d->sha256_width = 8;
+        name = "avx2x8";
+    }
+#endif
+
+#if defined(NOVA402_HAVE_ARM_SHA2_KERNELS)
+    if (features & NOVA402_CPU_ARM_SHA2) {
+        d->sha256_compress = nova402_sha256_compress_armv8;
+        name = "armv8";
+    }
+#endif
+
+    return name;
+}
+
+static const char *select_secp256k1(nova402_dispatch_t *d)
+{
+#if defined(NOVA402_HAVE_X86_KERNELS)
+    const uint32_t mulx = NOVA402_CPU_BMI2 | NOVA402_CPU_ADX | NOVA402_CPU_AVX2;
+
+    if ((d->features & mulx) == mulx) {
+        d->recover_batch = nova402_secp256k1_recover_batch_bmi2;
+        d->sign_batch = nova402_secp256k1_sign_batch_bmi2;
+        return "bmi2";
+    }
+#endif
+
+    d->recover_batch = nova402_secp256k1_recover_batch_portable;
+    d->sign_batch = nova402_secp256k1_sign_batch_portable;
+    return "portable";
+}
+
+static const char *select_codec(nova402_dispatch_t *d)
+{
+    uint32_t features = d->features;
+
+    (void)features;
+
+#if defined(NOVA402_HAVE_X86_KERNELS)
+    if (features & NOVA402_CPU_AVX2) {
+        d->base64_decode_blocks = nova402_base64_decode_blocks_avx2;
+        d->hex_decode_blocks = nova402_hex_decode_blocks_avx2;
+        d->hex_encode_blocks = nova402_hex_encode_blocks_avx2;
+        return "avx2";
+    }
+    if (features & NOVA402_CPU_SSSE3) {
+        d->base64_decode_blocks = nova402_base64_decode_blocks_ssse3;
+        d->hex_decode_blocks = nova402_hex_decode_blocks_ssse3;
+        d->hex_encode_blocks = nova402_hex_encode_blocks_ssse3;
+        return "ssse3";
+    }
+#endif
+
+#if defined(NOVA402_HAVE_NEON_KERNELS)
+    if (features & NOVA402_CPU_NEON) {
+        d->base64_decode_blocks = nova402_base64_decode_blocks_portable;
+        d->hex_decode_blocks = nova402_hex_decode_blocks_neon;
+        d->hex_encode_blocks = nova402_hex_encode_blocks_neon;
+        return "neon";
+    }
+#endif
+
+    d->base64_decode_blocks = nova402_base64_decode_blocks_portable;
+    d->hex_decode_blocks = nova402_hex_decode_blocks_portable;
+    d->hex_encode_blocks = nova402_hex_encode_blocks_portable;
+    return "portable";
+}
+
+static const char *select_screen(nova402_dispatch_t *d)
+{
+    uint32_t features = d->features;
+
+    (void)features;
+
+#if defined(NOVA402_HAVE_X86_KERNELS)
+    if (features & NOVA402_CPU_AVX512F) {
+        d->screen_blocks = nova402_screen_blocks_avx512;
+        return "avx512";
+    }
+    if (features & NOVA402_CPU_AVX2) {
+        d->screen_blocks = nova402_screen_blocks_avx2;
+        return "avx2";
+    }
+#endif
+
+    d->screen_blocks = nova402_screen_blocks_portable;
+    return "portable";
+}
+
+static void build_table(nova402_dispatch_t *d)
+{
+    const char *keccak, *sha256, *secp256k1, *codec, *screen;
+
+    d->features = nova402_cpu_probe();
+    keccak = select_keccak(d);
+    sha256 = select_sha256(d);
+    secp256k1 = select_secp256k1(d);
+    codec = select_codec(d);
+    screen = select_screen(d);
+
+    snprintf(table_info, sizeof(table_info), "keccak256=%s sha256=%s secp256k1=%s codec=%s screen=%s",
+             keccak, sha256, secp256k1, codec, screen);
+    d->info = table_info;
+}
+
+const nova402_dispatch_t *nova402_dispatch(void)
+{
+    long state = state_load();
+
+    if (state == DISPATCH_READY) {
+        return &table;
+    }
+
+    if (state == DISPATCH_EMPTY && state_claim()) {
+        build_table(&table);
+        state_store(DISPATCH_READY);
+        return &table;
+    }
+
+    /* Another thread is probing; it only takes a few CPUID calls */
+    while (state_load() != DISPATCH_READY) {
+        nova402_cpu_relax();
+    }
+    return &table;
+}
+
+int nova402_init(void)
+{
+    (void)nova402_dispatch();
+    return NOVA402_SUCCESS;
+}
+
+uint32_t nova402_cpu_features(void)
+{
+    return nova402_dispatch()->features;
+}
+
+const char *nova402_cpu_dispatch_info(void)
+{
+    return nova402_dispatch()->info;
+}
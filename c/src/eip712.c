@@ -0,0 +1,251 @@
+/**
+ * Nova402 C Library - EIP-712 encoding
+ *
+ * Typed-data hashing for EIP-3009 TransferWithAuthorization. Type hashes
+ * are compile-time constants; per-domain state lives in
+ * nova402_eip712_domain_t so verification only hashes the payment fields.
+ *
+ * @file eip712.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+/*
+ * keccak256("EIP712Domain(string name,string version,uint256 chainId,"
+ *           "address verifyingContract)")
+ */
+static const uint8_t EIP712_DOMAIN_TYPEHASH[NOVA402_HASH_SIZE] = {
+    0x8b, 0x73, 0xc3, 0xc6, 0x9b, 0xb8, 0xfe, 0x3d, 0x51, 0x2e, 0xcc, 0x4c, 0xf7, 0x59, 0xcc, 0x79,
+    0x23, 0x9f, 0x7b, 0x17, 0x9b, 0x0f, 0xfa, 0xca, 0xa9, 0xa7, 0x5d, 0x52, 0x2b, 0x39, 0x40, 0x0f
+};
+
+/*
+ * keccak256("TransferWithAuthorization(address from,address to,uint256 value,"
+ *           "uint256 validAfter,uint256 validBefore,bytes32 nonce)")
+ */
+static const uint8_t TRANSFER_WITH_AUTHORIZATION_TYPEHASH[NOVA402_HASH_SIZE] = {
+    0x7c, 0x7c, 0x6c, 0xdb, 0x67, 0xa1, 0x87, 0x43, 0xf4, 0x9e, 0xc6, 0xfa, 0x9b, 0x35, 0xf5, 0x0d,
+    0x52, 0xed, 0x05, 0xcb, 0xed, 0x4c, 0xc5, 0x92, 0xe1, 0x3b, 0x44, 0x50, 0x1c, 0x1a, 0x22, 0x67
+};
+
+/*
+ * Separator of the default domain: USDC on Base mainnet
+ * ("USD Coin", "2", 8453, 0x833589fCD6eDb6E08f4c7C32D4f71b54bdA02913)
+ */
+static const uint8_t DEFAULT_SEPARATOR[NOVA402_HASH_SIZE] = {
+    0x02, 0xfa, 0x72, 0x65, 0xe7, 0xc5, 0xd8, 0x11, 0x18, 0x67, 0x37, 0x27, 0x95, 0x76, 0x99, 0xe4,
+    0xd6, 0x8f, 0x74, 0xcd, 0x74, 0xb7, 0xdb, 0x77, 0xda, 0x71, 0x0f, 0xe8, 0xa2, 0xc7, 0x83, 0x4f
+};
+
+/* Token name and version used when a caller does not supply one */
+#define DEFAULT_NAME "USD Coin"
+#define DEFAULT_VERSION "2"
+
+/* ABI-encode an address into a 32-byte word */
+static void encode_address(uint8_t *word, const nova402_address_t *address)
+{
+    memset(word, 0, 12);
+    memcpy(word + 12, address->bytes, NOVA402_ADDRESS_SIZE);
+}
+
+/* ABI-encode a uint64 into a 32-byte big-endian word */
+static void encode_uint(uint8_t *word, uint64_t value)
+{
+    int i;
+
+    memset(word, 0, 24);
+    for (i = 0; i < 8; i++) {
+        word[31 - i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static void hash_string(const char *s, uint8_t *out)
+{
+    nova402_hash_t hash;
+    nova402_keccak256((const uint8_t *)s, strlen(s), &hash);
+    memcpy(out, hash.bytes, NOVA402_HASH_SIZE);
+}
+
+/* XOR bytes into a single Keccak state at byte offset `offset` of the rate */
+static void xor_bytes(uint64_t state[25], size_t offset, const uint8_t *bytes, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        state[(offset + i) / 8] ^= (uint64_t)bytes[i] << (8 * ((offset + i) % 8));
+    }
+}
+
+static void pad_block(uint64_t state[25], size_t length)
+{
+    state[length / 8] ^= (uint64_t)0x01 << (8 * (length % 8));
+    state[(NOVA402_KECCAK_RATE - 1) / 8] ^= (uint64_t)0x80 << (8 * ((NOVA402_KECCAK_RATE - 1) % 8));
+}
+
+void nova402_eip712_domain_separator(
+    const char *name,
+    const char *version,
+    uint64_t chain_id,
+    const nova402_address_t *verifying_contract,
+    nova402_hash_t *separator)
+{
+    uint8_t buf[5 * 32];
+
+    memcpy(buf, EIP712_DOMAIN_TYPEHASH, NOVA402_HASH_SIZE);
+    hash_string(name, buf + 32);
+    hash_string(version, buf + 64);
+    encode_uint(buf + 96, chain_id);
+    encode_address(buf + 128, verifying_contract);
+
+    nova402_keccak256(buf, sizeof(buf), separator);
+}
+
+/* Fill in the type hash and the absorbed prefixes for a known separator */
+static void domain_set_separator(nova402_eip712_domain_t *domain, const nova402_hash_t *separator)
+{
+    static const uint8_t prefix[2] = { 0x19, 0x01 };
+
+    domain->separator = *separator;
+    memcpy(domain->type_hash.bytes, TRANSFER_WITH_AUTHORIZATION_TYPEHASH, NOVA402_HASH_SIZE);
+
+    /* hashStruct: the type hash opens the first block */
+    memset(domain->struct_state, 0, sizeof(domain->struct_state));
+    xor_bytes(domain->struct_state, 0, domain->type_hash.bytes, NOVA402_HASH_SIZE);
+
+    /* Digest: the whole 66-byte input fits one block, so its padding is fixed */
+    memset(domain->digest_state, 0, sizeof(domain->digest_state));
+    xor_bytes(domain->digest_state, 0, prefix, sizeof(prefix));
+    xor_bytes(domain->digest_state, 2, separator->bytes, NOVA402_HASH_SIZE);
+    pad_block(domain->digest_state, NOVA402_EIP712_DIGEST_INPUT_SIZE);
+}
+
+void nova402_eip712_default_domain(nova402_eip712_domain_t *domain)
+{
+    nova402_hash_t separator;
+
+    memcpy(separator.bytes, DEFAULT_SEPARATOR, NOVA402_HASH_SIZE);
+    domain_set_separator(domain, &separator);
+}
+
+int nova402_eip712_domain_init(
+    nova402_eip712_domain_t *domain,
+    const char *name,
+    const char *version,
+    uint64_t chain_id,
+    const nova402_address_t *verifying_contract)
+{
+    nova402_hash_t separator;
+
+    if (!domain || !name || !version || !verifying_contract) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    nova402_eip712_domain_separator(name, version, chain_id, verifying_contract, &separator);
+    domain_set_separator(domain, &separator);
+    return NOVA402_SUCCESS;
+}
+
+int nova402_eip712_domain_for_network(
+    nova402_eip712_domain_t *domain,
+    const char *network,
+    const char *name,
+    const char *version)
+{
+    const nova402_network_info_t *info;
+    const nova402_address_t *contract;
+    nova402_network_id_t id;
+
+    if (!domain || !network) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    id = nova402_network_lookup(network, strlen(network));
+    info = nova402_network_info(id);
+    contract = nova402_network_usdc(id);
+    if (!info || info->config.type != NOVA402_NETWORK_EVM || !contract) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    return nova402_eip712_domain_init(domain, name ? name : DEFAULT_NAME,
+                                      version ? version : DEFAULT_VERSION,
+                                      info->config.chain_id, contract);
+}
+
+int nova402_eip712_hash_payment(
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    nova402_hash_t *digest)
+{
+    const nova402_dispatch_t *kernel;
+    uint8_t buf[NOVA402_EIP712_STRUCT_SIZE];
+    uint64_t state[25];
+    nova402_hash_t struct_hash;
+
+    if (!domain || !payment || !digest) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    kernel = nova402_dispatch();
+    nova402_eip712_encode_struct(payment, buf);
+
+    /* hashStruct over two blocks, starting from the absorbed type hash */
+    memcpy(state, domain->struct_state, sizeof(state));
+    xor_bytes(state, NOVA402_HASH_SIZE, buf + NOVA402_HASH_SIZE,
+              NOVA402_KECCAK_RATE - NOVA402_HASH_SIZE);
+    kernel->keccak_f1600(state);
+    xor_bytes(state, 0, buf + NOVA402_KECCAK_RATE, sizeof(buf) - NOVA402_KECCAK_RATE);
+    pad_block(state, sizeof(buf) - NOVA402_KECCAK_RATE);
+    kernel->keccak_f1600(state);
+    nova402_keccak_squeeze(state, 1, 0, &struct_hash);
+
+    /* Digest: only the struct hash is missing from the prepared block */
+    memcpy(state, domain->digest_state, sizeof(state));
+    xor_bytes(state, 2 + NOVA402_HASH_SIZE, struct_hash.bytes, NOVA402_HASH_SIZE);
+    kernel->keccak_f1600(state);
+    nova402_keccak_squeeze(state, 1, 0, digest);
+
+    return NOVA402_SUCCESS;
+}
+
+void nova402_eip712_encode_struct(const nova402_payment_data_t *payment, uint8_t *buf)
+{
+    memcpy(buf, TRANSFER_WITH_AUTHORIZATION_TYPEHASH, NOVA402_HASH_SIZE);
+    encode_address(buf + 32, &payment->from);
+    encode_address(buf + 64, &payment->to);
+    encode_uint(buf + 96, payment->value);
+    encode_uint(buf + 128, payment->valid_after);
+    encode_uint(buf + 160, payment->valid_before);
+    memcpy(buf + 192, payment->nonce, NOVA402_NONCE_SIZE);
+}
+
+void nova402_eip712_encode_digest(
+    const nova402_hash_t *separator,
+    const nova402_hash_t *struct_hash,
+    uint8_t *buf)
+{
+    buf[0] = 0x19;
+    buf[1] = 0x01;
+    memcpy(buf + 2, separator->bytes, NOVA402_HASH_SIZE);
+    memcpy(buf + 34, struct_hash->bytes, NOVA402_HASH_SIZE);
+}
+
+void nova402_eip712_struct_hash(const nova402_payment_data_t *payment, nova402_hash_t *hash)
+{
+    uint8_t buf[NOVA402_EIP712_STRUCT_SIZE];
+
+    nova402_eip712_encode_struct(payment, buf);
+    nova402_keccak256(buf, sizeof(buf), hash);
+}
+
+void nova402_eip712_digest(
+    const nova402_hash_t *separator,
+    const nova402_hash_t *struct_hash,
+    nova402_hash_t *digest)
+{
+    uint8_t buf[NOVA402_EIP712_DIGEST_INPUT_SIZE];
+
+    nova402_eip712_encode_digest(separator, struct_hash, buf);
+    nova402_keccak256(buf, sizeof(buf), digest);
+}
@@ -0,0 +1,280 @@
+/**
+ * Nova402 C Library - batch hex conversion and address validation
+ *
+ * Array forms of hex encoding, decoding and address checks over the
+ * dispatched hex kernels. EIP-55 checksums are hashed in groups through
+ * nova402_keccak256_many(), so the multi-buffer Keccak kernel hashes
+ * several addresses per permutation.
+ *
+ * @file hex.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+#define ADDRESS_DIGITS (2 * NOVA402_ADDRESS_SIZE)
+#define HASH_DIGITS (2 * NOVA402_HASH_SIZE)
+
+/* Addresses hashed per nova402_keccak256_many() call */
+#define CHECKSUM_GROUP 32
+
+/* Skip an optional "0x" / "0X" prefix */
+static const char *skip_prefix(const char *hex)
+{
+    return (hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) ? hex + 2 : hex;
+}
+
+/* Exactly `digits` characters before the terminator */
+static int has_length(const char *s, size_t digits)
+{
+    size_t i;
+
+    for (i = 0; i < digits; i++) {
+        if (s[i] == '\0') {
+            return 0;
+        }
+    }
+    return s[digits] == '\0';
+}
+
+/*
+ * Apply EIP-55 to 40 hex digits: a letter is upper case when the matching
+ * nibble of keccak256(lowercase digits) is 8 or more.
+ */
+static void checksum_digits(char *digits, const nova402_hash_t *hash)
+{
+    int i;
+
+    for (i = 0; i < ADDRESS_DIGITS; i++) {
+        uint8_t nibble = (uint8_t)((i & 1) ? hash->bytes[i / 2] & 0x0F : hash->bytes[i / 2] >> 4);
+
+        if (digits[i] >= 'a' && nibble >= 8) {
+            digits[i] = (char)(digits[i] - 'a' + 'A');
+        }
+    }
+}
+
+int nova402_hashes_to_hex(const nova402_hash_t *hashes, size_t count, char *hex)
+{
+    size_t i;
+
+    if ((!hashes || !hex) && count > 0) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    for (i = 0; i < count; i++) {
+        char *out = hex + i * NOVA402_HASH_HEX_SIZE;
+
+        out[0] = '0';
+        out[1] = 'x';
+        nova402_hex_encode(hashes[i].bytes, NOVA402_HASH_SIZE, out + 2);
+        out[2 + HASH_DIGITS] = '\0';
+    }
+    return NOVA402_SUCCESS;
+}
+
+int nova402_addresses_to_hex(
+    const nova402_address_t *addresses,
+    size_t count,
+    bool checksum,
+    char *hex)
+{
+    const uint8_t *data[CHECKSUM_GROUP];
+    size_t lengths[CHECKSUM_GROUP];
+    nova402_hash_t hashes[CHECKSUM_GROUP];
+    size_t i, j, n;
+
+    if ((!addresses || !hex) && count > 0) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    for (i = 0; i < count; i++) {
+        char *out = hex + i * NOVA402_ADDRESS_HEX_SIZE;
+
+        out[0] = '0';
+        out[1] = 'x';
+        nova402_hex_encode(addresses[i].bytes, NOVA402_ADDRESS_SIZE, out + 2);
+        out[2 + ADDRESS_DIGITS] = '\0';
+    }
+    if (!checksum) {
+        return NOVA402_SUCCESS;
+    }
+
+    /* The encoded lowercase digits are exactly the EIP-55 hash input */
+    for (i = 0; i < count; i += n) {
+        n = (count - i < CHECKSUM_GROUP) ? count - i : CHECKSUM_GROUP;
+        for (j = 0; j < n; j++) {
+            data[j] = (const uint8_t *)(hex + (i + j) * NOVA402_ADDRESS_HEX_SIZE + 2);
+            lengths[j] = ADDRESS_DIGITS;
+        }
+        nova402_keccak256_many(data, lengths, n, hashes);
+        for (j = 0; j < n; j++) {
+            checksum_digits(hex + (i + j) * NOVA402_ADDRESS_HEX_SIZE + 2, &hashes[j]);
+        }
+    }
+    return NOVA402_SUCCESS;
+}
+
+int nova402_hex_to_hashes(
+    const char *const *hex,
+    size_t count,
+    nova402_hash_t *hashes,
+    uint8_t *results)
+{
+    size_t i;
+    int converted = 0;
+
+    if ((!hex || !hashes || !results) && count > 0) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    memset(results, 0, (count + 7) / 8);
+    for (i = 0; i < count; i++) {
+        const char *digits;
+
+        if (!hex[i]) {
+            continue;
+        }
+        digits = skip_prefix(hex[i]);
+        if (has_length(digits, HASH_DIGITS) &&
+            nova402_hex_decode(digits, hashes[i].bytes, NOVA402_HASH_SIZE) == 0) {
+            NOVA402_BITMAP_SET(results, i);
+            converted++;
+        }
+    }
+    return converted;
+}
+
+int nova402_hex_to_addresses(
+    const char *const *hex,
+    size_t count,
+    nova402_address_t *addresses,
+    uint8_t *results)
+{
+    size_t i;
+    int converted = 0;
+
+    if ((!hex || !addresses || !results) && count > 0) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    memset(results, 0, (count + 7) / 8);
+    for (i = 0; i < count; i++) {
+        const char *digits;
+
+        if (!hex[i]) {
+            continue;
+        }
+        digits = skip_prefix(hex[i]);
+        if (has_length(digits, ADDRESS_DIGITS) &&
+            nova402_hex_decode(digits, addresses[i].bytes, NOVA402_ADDRESS_SIZE) == 0) {
+            NOVA402_BITMAP_SET(results, i);
+            converted++;
+        }
+    }
+    return converted;
+}
+
+/* Addresses waiting for their EIP-55 checksum to be compared */
+typedef struct {
+    char lower[CHECKSUM_GROUP][ADDRESS_DIGITS];
+    size_t index[CHECKSUM_GROUP];
+    size_t count;
+} checksum_group_t;
+
+/* Hash the queued addresses together; returns how many match their checksum */
+static int checksum_flush(checksum_group_t *group, const char *const *addresses, uint8_t *results)
+{
+    const uint8_t *data[CHECKSUM_GROUP];
+    size_t lengths[CHECKSUM_GROUP];
+    nova402_hash_t hashes[CHECKSUM_GROUP];
+    size_t j;
+    int valid = 0;
+
+    for (j = 0; j < group->count; j++) {
+        data[j] = (const uint8_t *)group->lower[j];
+        lengths[j] = ADDRESS_DIGITS;
+    }
+    nova402_keccak256_many(data, lengths, group->count, hashes);
+
+    for (j = 0; j < group->count; j++) {
+        checksum_digits(group->lower[j], &hashes[j]);
+        if (memcmp(group->lower[j], addresses[group->index[j]] + 2, ADDRESS_DIGITS) == 0) {
+            NOVA402_BITMAP_SET(results, group->index[j]);
+            valid++;
+        }
+    }
+    group->count = 0;
+    return valid;
+}
+
+int nova402_validate_addresses(
+    const char *const *addresses,
+    size_t count,
+    nova402_address_check_t check,
+    uint8_t *results)
+{
+    checksum_group_t group;
+    nova402_address_t scratch;
+    size_t i, j;
+    int valid = 0;
+
+    if ((!addresses || !results) && count > 0) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (check != NOVA402_ADDRESS_FORMAT && check != NOVA402_ADDRESS_CHECKSUM &&
+        check != NOVA402_ADDRESS_CHECKSUM_STRICT) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    memset(results, 0, (count + 7) / 8);
+    group.count = 0;
+
+    for (i = 0; i < count; i++) {
+        const char *a = addresses[i];
+        char *lower = group.lower[group.count];
+        int upper = 0, lowercase = 0;
+
+        if (!a || a[0] != '0' || a[1] != 'x' || !has_length(a + 2, ADDRESS_DIGITS) ||
+            nova402_hex_decode(a + 2, scratch.bytes, NOVA402_ADDRESS_SIZE) != 0) {
+            continue;
+        }
+        if (check == NOVA402_ADDRESS_FORMAT) {
+            NOVA402_BITMAP_SET(results, i);
+            valid++;
+            continue;
+        }
+
+        for (j = 0; j < ADDRESS_DIGITS; j++) {
+            char c = a[2 + j];
+            upper |= (c >= 'A' && c <= 'F');
+            lowercase |= (c >= 'a' && c <= 'f');
+            lower[j] = (char)((c >= 'A') ? c | 0x20 : c);
+        }
+
+        /* Single-case addresses carry no checksum unless strict */
+        if (check == NOVA402_ADDRESS_CHECKSUM && !(upper && lowercase)) {
+            NOVA402_BITMAP_SET(results, i);
+            valid++;
+            continue;
+        }
+
+        group.index[group.count++] = i;
+        if (group.count == CHECKSUM_GROUP) {
+            valid += checksum_flush(&group, addresses, results);
+        }
+    }
+    if (group.count > 0) {
+        valid += checksum_flush(&group, addresses, results);
+    }
+
+    return valid;
+}
+
+bool nova402_validate_address_checksum(const char *address)
+{
+    uint8_t result;
+
+    return nova402_validate_addresses(&address, 1, NOVA402_ADDRESS_CHECKSUM, &result) == 1;
+}
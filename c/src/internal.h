@@ -0,0 +1,419 @@
+/**
+ * Nova402 C Library - internal declarations
+ *
+ * Helpers shared between translation units. Not part of the public API.
+ *
+ * @file internal.h
+ */
+
+#ifndef NOVA402_INTERNAL_H
+#define NOVA402_INTERNAL_H
+
+#include "nova402.h"
+
+/* Padding unit for independently written data; alignment of node arenas */
+#define NOVA402_CACHE_LINE 64
+
+/* ============================================
+ * RUNTIME DISPATCH
+ * ============================================ */
+
+typedef void (*nova402_keccak_permute_fn)(uint64_t *state);
+
+typedef void (*nova402_sha256_compress_fn)(uint32_t state[8], const uint8_t *blocks, size_t count);
+
+typedef void (*nova402_sha256_many_fn)(uint32_t *state, const uint8_t *const *blocks);
+
+/* Convert whole blocks: 32 base64 chars -> 24 bytes, 32 hex chars <-> 16 bytes */
+typedef size_t (*nova402_codec_blocks_fn)(uint8_t *out, const uint8_t *in, size_t blocks);
+
+typedef size_t (*nova402_recover_batch_fn)(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *ok
+);
+
+typedef size_t (*nova402_sign_batch_fn)(
+    const nova402_signer_t *signer,
+    const nova402_hash_t *digests,
+    const nova402_hash_t *nonces,
+    size_t count,
+    nova402_signature_t *signatures,
+    uint8_t *ok
+);
+
+/* Cheap checks over NOVA402_SCREEN_BLOCK-row blocks of a payment batch */
+typedef struct {
+    uint64_t min_value;
+    uint64_t now;
+    uint8_t network;
+} nova402_screen_t;
+
+typedef void (*nova402_screen_blocks_fn)(
+    uint8_t *out,
+    const uint64_t *value,
+    const uint64_t *valid_after,
+    const uint64_t *valid_before,
+    const uint8_t *network,
+    size_t blocks,
+    const nova402_screen_t *screen
+);
+
+/**
+ * Kernels selected for the running CPU. Filled in once, read-only after.
+ */
+typedef struct {
+    uint32_t features;                           /* NOVA402_CPU_* bits */
+    nova402_keccak_permute_fn keccak_f1600;      /* single state */
+    nova402_keccak_permute_fn keccak_f1600_many; /* keccak_width interleaved states */
+    size_t keccak_width;
+    nova402_sha256_compress_fn sha256_compress;
+    nova402_sha256_many_fn sha256_compress_many; /* sha256_width lanes, NULL if none */
+    size_t sha256_width;
+    nova402_recover_batch_fn recover_batch;
+    nova402_sign_batch_fn sign_batch;
+    nova402_codec_blocks_fn base64_decode_blocks;
+    nova402_codec_blocks_fn hex_decode_blocks;
+    nova402_codec_blocks_fn hex_encode_blocks;
+    nova402_screen_blocks_fn screen_blocks;
+    const char *info;                            /* nova402_cpu_dispatch_info() */
+} nova402_dispatch_t;
+
+/**
+ * Probe the running CPU (uncached)
+ */
+uint32_t nova402_cpu_probe(void);
+
+/**
+ * Active kernel table; initializes the library on first call
+ */
+const nova402_dispatch_t *nova402_dispatch(void);
+
+/* ============================================
+ * MEMORY
+ * ============================================ */
+
+/*
+ * Heap allocation through the nova402_set_allocator() hooks. Library code
+ * never calls malloc() or free() directly.
+ */
+void *nova402_malloc(size_t size);
+void *nova402_calloc(size_t count, size_t size);
+void nova402_free(void *ptr);
+
+/*
+ * Clear keys and nonces before their memory is reused; the stores are
+ * not optimized away.
+ */
+void nova402_memzero(void *ptr, size_t size);
+
+/*
+ * Scratch buffers for the duration of one call: from arena when given
+ * (NULL once it is exhausted), otherwise from the heap. Arena blocks are
+ * cache-line aligned and must be freed in reverse order of allocation.
+ */
+void *nova402_scratch_alloc(nova402_arena_t *arena, size_t size);
+void nova402_scratch_free(nova402_arena_t *arena, void *ptr);
+
+/* ============================================
+ * PARALLEL EXECUTION
+ * ============================================ */
+
+/**
+ * Number of online CPUs (at least 1)
+ */
+size_t nova402_cpu_count(void);
+
+/**
+ * Call task(arg, i) for every i in [0, count) and return once all calls
+ * have finished. Uses executor when given, otherwise up to `threads`
+ * threads including the caller (0 for one per CPU).
+ */
+void nova402_parallel_run(
+    const nova402_executor_t *executor,
+    size_t threads,
+    nova402_task_fn task,
+    void *arg,
+    size_t count
+);
+
+/* ============================================
+ * KECCAK-F[1600]
+ * ============================================ */
+
+/* Keccak-256 rate in bytes */
+#define NOVA402_KECCAK_RATE 136
+
+/* Widest multi-buffer kernel (AVX-512) */
+#define NOVA402_KECCAK_MAX_LANES 8
+
+/**
+ * Portable single-state permutation
+ */
+void nova402_keccak_f1600(uint64_t state[25]);
+
+/*
+ * Multi-buffer permutations over interleaved states: word i of state j is
+ * at state[i * width + j]. Only built for the matching architecture.
+ */
+void nova402_keccak_f1600_x2_neon(uint64_t *state);
+void nova402_keccak_f1600_x2_sha3(uint64_t *state);
+void nova402_keccak_f1600_x4_avx2(uint64_t *state);
+void nova402_keccak_f1600_x8_avx512(uint64_t *state);
+
+/**
+ * XOR one rate-sized block into lane `lane` of `width` interleaved states
+ */
+void nova402_keccak_absorb_block(uint64_t *state, size_t width, size_t lane, const uint8_t *block);
+
+/**
+ * Read the 32-byte digest of lane `lane` out of `width` interleaved states
+ */
+void nova402_keccak_squeeze(const uint64_t *state, size_t width, size_t lane, nova402_hash_t *hash);
+
+/* ============================================
+ * SHA-256
+ * ============================================ */
+
+#define NOVA402_SHA256_MAX_LANES 8
+
+/* Initial state and round constants, shared by every kernel */
+extern const uint32_t nova402_sha256_iv[8];
+extern const uint32_t nova402_sha256_k[64];
+
+/**
+ * Portable compression of `count` consecutive 64-byte blocks into state
+ */
+void nova402_sha256_compress_portable(uint32_t state[8], const uint8_t *blocks, size_t count);
+
+/* Same with the x86 SHA extensions or the ARMv8 SHA-2 instructions */
+void nova402_sha256_compress_shani(uint32_t state[8], const uint8_t *blocks, size_t count);
+void nova402_sha256_compress_armv8(uint32_t state[8], const uint8_t *blocks, size_t count);
+
+/*
+ * Multi-buffer compression of one block per lane into interleaved states:
+ * word i of lane j is at state[i * width + j].
+ */
+void nova402_sha256_compress_x8_avx2(uint32_t *state, const uint8_t *const blocks[8]);
+
+/* ============================================
+ * SHA-512
+ * ============================================ */
+
+#define NOVA402_SHA512_BLOCK_SIZE 128
+
+typedef struct {
+    uint64_t state[8];
+    uint64_t length;                           /* bytes absorbed */
+    size_t used;                               /* bytes waiting in buffer */
+    uint8_t buffer[NOVA402_SHA512_BLOCK_SIZE];
+} nova402_sha512_ctx_t;
+
+void nova402_sha512_init(nova402_sha512_ctx_t *ctx);
+void nova402_sha512_update(nova402_sha512_ctx_t *ctx, const uint8_t *data, size_t length);
+void nova402_sha512_final(nova402_sha512_ctx_t *ctx, uint8_t digest[64]);
+
+/* ============================================
+ * BASE64 AND HEX
+ * ============================================ */
+
+/*
+ * Block kernels behind the dispatch table. Decoders stop at the first
+ * block holding a character outside their alphabet and return the number
+ * of blocks decoded. Base64 kernels may store up to 8 bytes past the 24 of
+ * the last block; the callers below leave that slack. Hex encoders write
+ * lowercase digits and always convert every block.
+ */
+#define NOVA402_BASE64_BLOCK_CHARS 32
+#define NOVA402_BASE64_BLOCK_BYTES 24
+#define NOVA402_HEX_BLOCK_BYTES 16
+
+size_t nova402_base64_decode_blocks_portable(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_base64_decode_blocks_ssse3(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_base64_decode_blocks_avx2(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_hex_decode_blocks_portable(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_hex_decode_blocks_ssse3(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_hex_decode_blocks_avx2(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_hex_decode_blocks_neon(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_hex_encode_blocks_portable(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_hex_encode_blocks_ssse3(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_hex_encode_blocks_avx2(uint8_t *out, const uint8_t *in, size_t blocks);
+size_t nova402_hex_encode_blocks_neon(uint8_t *out, const uint8_t *in, size_t blocks);
+
+/**
+ * Decode standard base64 with optional '=' padding. Trailing bits must be
+ * zero. Returns NOVA402_SUCCESS, NOVA402_ERROR_INVALID_INPUT for malformed
+ * input or NOVA402_ERROR_BUFFER_TOO_SMALL.
+ */
+int nova402_base64_decode(const char *in, size_t length, uint8_t *out, size_t out_size,
+                          size_t *out_length);
+
+/**
+ * Decode exactly 2 * length hex digits (no prefix) into length bytes.
+ * Returns 0 on success, -1 on a non-hex digit.
+ */
+int nova402_hex_decode(const char *hex, uint8_t *out, size_t length);
+
+/**
+ * Write 2 * length lowercase hex digits (no prefix, no terminator)
+ */
+void nova402_hex_encode(const uint8_t *bytes, size_t length, char *hex);
+
+/* ============================================
+ * MERKLE TREE
+ * ============================================ */
+
+/**
+ * Hash one layer of `count` nodes into its (count + 1) / 2 parents:
+ * sorted pairs, odd last node promoted. Pairs are hashed keccak_width at
+ * a time. parents may equal nodes to reduce a layer in place.
+ */
+void nova402_merkle_hash_layer(const nova402_hash_t *nodes, size_t count, nova402_hash_t *parents);
+
+/**
+ * keccak256(min(a, b) || max(a, b)); parent may alias a or b
+ */
+void nova402_merkle_hash_pair(const nova402_hash_t *a, const nova402_hash_t *b, nova402_hash_t *parent);
+
+/*
+ * Layer i (0 = leaves) holds nova402_merkle_layer_width(leaf_count, i)
+ * nodes at nodes + offsets[i]; the layers may be stored in any order.
+ * Built trees own `block`, trees opened from a file own `mapping`.
+ */
+struct nova402_merkle_tree {
+    size_t leaf_count;
+    size_t depth;                                 /* layers - 1 */
+    size_t offsets[NOVA402_MERKLE_MAX_DEPTH + 1];
+    nova402_hash_t *nodes;                        /* read-only when mapped */
+    void *block;
+    void *mapping;
+    size_t mapping_size;
+    size_t memory_bytes;
+};
+
+/* Nodes in layer `level` of a tree with leaf_count leaves: ceil(leaf_count / 2^level) */
+static inline size_t nova402_merkle_layer_width(size_t leaf_count, size_t level)
+{
+    if (leaf_count == 0) {
+        return 0;
+    }
+    if (level >= sizeof(size_t) * 8) {
+        return 1;   /* a shift this wide is undefined */
+    }
+    return ((leaf_count - 1) >> level) + 1;
+}
+
+/**
+ * Release the file mapping of a tree opened by nova402_merkle_tree_open_mmap()
+ */
+void nova402_merkle_tree_unmap(nova402_merkle_tree_t *tree);
+
+/**
+ * Nodes of layer `level` (0 = leaves, up to nova402_merkle_tree_depth())
+ */
+const nova402_hash_t *nova402_merkle_tree_layer(const nova402_merkle_tree_t *tree, size_t level);
+
+/* ============================================
+ * EIP-712 (TransferWithAuthorization)
+ * ============================================ */
+
+/**
+ * Domain separator for (name, version, chainId, verifyingContract)
+ */
+void nova402_eip712_domain_separator(
+    const char *name,
+    const char *version,
+    uint64_t chain_id,
+    const nova402_address_t *verifying_contract,
+    nova402_hash_t *separator
+);
+
+/**
+ * Domain used by the domain-less entry points
+ * (nova402_sign_payment / nova402_verify_signature): USDC on Base mainnet.
+ * Built from a precomputed separator, so no hashing is involved.
+ */
+void nova402_eip712_default_domain(nova402_eip712_domain_t *domain);
+
+/* Sizes of the encoded struct and of the 0x1901-prefixed digest input */
+#define NOVA402_EIP712_STRUCT_SIZE (7 * 32)
+#define NOVA402_EIP712_DIGEST_INPUT_SIZE (2 + 2 * 32)
+
+/**
+ * encodeData(TransferWithAuthorization) with its type hash prefix
+ */
+void nova402_eip712_encode_struct(const nova402_payment_data_t *payment, uint8_t *buf);
+
+/**
+ * 0x19 0x01 || separator || struct_hash
+ */
+void nova402_eip712_encode_digest(
+    const nova402_hash_t *separator,
+    const nova402_hash_t *struct_hash,
+    uint8_t *buf
+);
+
+/**
+ * hashStruct(TransferWithAuthorization) for a payment
+ */
+void nova402_eip712_struct_hash(const nova402_payment_data_t *payment, nova402_hash_t *hash);
+
+/**
+ * keccak256(0x19 0x01 || separator || struct_hash)
+ */
+void nova402_eip712_digest(
+    const nova402_hash_t *separator,
+    const nova402_hash_t *struct_hash,
+    nova402_hash_t *digest
+);
+
+/* ============================================
+ * PACKED WIRE FORMAT
+ * ============================================ */
+
+/**
+ * Decode the fields of a packed record
+ *
+ * @return NOVA402_SUCCESS, or NOVA402_ERROR_INVALID_FIELD for an unknown
+ *         network or non-zero reserved bytes
+ */
+int nova402_packed_load(
+    const nova402_packed_record_t *record,
+    nova402_network_id_t *network,
+    nova402_payment_data_t *payment,
+    nova402_signature_t *signature
+);
+
+/* ============================================
+ * PAYMENT SCREENING
+ * ============================================ */
+
+/*
+ * Block kernels behind nova402_payment_batch_screen(). Each block of
+ * NOVA402_SCREEN_BLOCK rows yields one result byte whose bit j is set when
+ * row j has network == screen->network, value >= screen->min_value and
+ * valid_after <= screen->now < valid_before. The recipient is compared by
+ * the caller, on the rows that pass.
+ */
+#define NOVA402_SCREEN_BLOCK 8
+
+void nova402_screen_blocks_portable(uint8_t *out, const uint64_t *value, const uint64_t *valid_after,
+                                    const uint64_t *valid_before, const uint8_t *network, size_t blocks,
+                                    const nova402_screen_t *screen);
+void nova402_screen_blocks_avx2(uint8_t *out, const uint64_t *value, const uint64_t *valid_after,
+                                const uint64_t *valid_before, const uint8_t *network, size_t blocks,
+                                const nova402_screen_t *screen);
+void nova402_screen_blocks_avx512(uint8_t *out, const uint64_t *value, const uint64_t *valid_after,
+                                  const uint64_t *valid_before, const uint8_t *network, size_t blocks,
+                                  const nova402_screen_t *screen);
+
+/* ============================================
+ * RESULT BITMAPS
+ * ============================================ */
+
+#define NOVA402_BITMAP_SET(bitmap, i) ((bitmap)[(i) >> 3] |= (uint8_t)(1u << ((i) & 7)))
+
+#endif /* NOVA402_INTERNAL_H */
@@ -0,0 +1,134 @@
+/**
+ * Nova402 C Library - Keccak-f[1600] sponge primitives
+ *
+ * Portable permutation and block absorb/squeeze helpers used by the
+ * multi-buffer and incremental hashing code, and the incremental
+ * Keccak-256 API on top of them.
+ *
+ * @file keccak.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+#define K_LANE uint64_t
+#define K_WIDTH 1
+#define K_LOAD(p) (*(p))
+#define K_STORE(p, v) (*(p) = (v))
+#define K_SET1(w) (w)
+#define K_XOR(a, b) ((a) ^ (b))
+#define K_XOR5(a, b, c, d, e) ((a) ^ (b) ^ (c) ^ (d) ^ (e))
+#define K_ROL(a, n) (((a) << (n)) | ((a) >> (64 - (n))))
+#define K_CHI(a, b, c) ((a) ^ (~(b) & (c)))
+#define K_PERMUTE keccak_f1600_scalar
+
+#include "keccak_impl.h"
+
+void nova402_keccak_f1600(uint64_t state[25])
+{
+    keccak_f1600_scalar(state);
+}
+
+void nova402_keccak_absorb_block(uint64_t *state, size_t width, size_t lane, const uint8_t *block)
+{
+    size_t i;
+    int j;
+
+    for (i = 0; i < NOVA402_KECCAK_RATE / 8; i++) {
+        uint64_t w = 0;
+        for (j = 7; j >= 0; j--) {
+            w = (w << 8) | block[i * 8 + (size_t)j];
+        }
+        state[i * width + lane] ^= w;
+    }
+}
+
+void nova402_keccak_squeeze(const uint64_t *state, size_t width, size_t lane, nova402_hash_t *hash)
+{
+    size_t i;
+
+    for (i = 0; i < NOVA402_HASH_SIZE; i++) {
+        hash->bytes[i] = (uint8_t)(state[(i / 8) * width + lane] >> (8 * (i % 8)));
+    }
+}
+
+int nova402_keccak256_init(nova402_keccak256_ctx_t *ctx)
+{
+    if (!ctx) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    memset(ctx->state, 0, sizeof(ctx->state));
+    ctx->used = 0;
+    return NOVA402_SUCCESS;
+}
+
+/* Partial blocks are XORed into the state byte by byte: no buffer to copy */
+static void absorb_bytes(nova402_keccak256_ctx_t *ctx, const uint8_t *data, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++, ctx->used++) {
+        ctx->state[ctx->used / 8] ^= (uint64_t)data[i] << (8 * (ctx->used % 8));
+    }
+}
+
+int nova402_keccak256_update(nova402_keccak256_ctx_t *ctx, const uint8_t *data, size_t length)
+{
+    nova402_keccak_permute_fn permute;
+
+    if (!ctx || (!data && length > 0) || ctx->used >= NOVA402_KECCAK_RATE) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (length == 0) {
+        return NOVA402_SUCCESS;
+    }
+    permute = nova402_dispatch()->keccak_f1600;
+
+    if (ctx->used > 0) {
+        size_t take = NOVA402_KECCAK_RATE - ctx->used;
+
+        if (take > length) {
+            take = length;
+        }
+        absorb_bytes(ctx, data, take);
+        data += take;
+        length -= take;
+        if (ctx->used < NOVA402_KECCAK_RATE) {
+            return NOVA402_SUCCESS;
+        }
+        permute(ctx->state);
+        ctx->used = 0;
+    }
+
+    for (; length >= NOVA402_KECCAK_RATE; data += NOVA402_KECCAK_RATE, length -= NOVA402_KECCAK_RATE) {
+        nova402_keccak_absorb_block(ctx->state, 1, 0, data);
+        permute(ctx->state);
+    }
+    absorb_bytes(ctx, data, length);
+    return NOVA402_SUCCESS;
+}
+
+int nova402_keccak256_final(nova402_keccak256_ctx_t *ctx, nova402_hash_t *hash)
+{
+    if (!ctx || !hash || ctx->used >= NOVA402_KECCAK_RATE) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    /* Keccak padding (0x01 ... 0x80), not the SHA-3 domain byte */
+    ctx->state[ctx->used / 8] ^= (uint64_t)0x01 << (8 * (ctx->used % 8));
+    ctx->state[(NOVA402_KECCAK_RATE - 1) / 8] ^= (uint64_t)0x80 << (8 * ((NOVA402_KECCAK_RATE - 1) % 8));
+    nova402_dispatch()->keccak_f1600(ctx->state);
+    nova402_keccak_squeeze(ctx->state, 1, 0, hash);
+    ctx->used = NOVA402_KECCAK_RATE;  /* finalized */
+    return NOVA402_SUCCESS;
+}
+
+int nova402_keccak256_clone(nova402_keccak256_ctx_t *dst, const nova402_keccak256_ctx_t *src)
+{
+    if (!dst || !src) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    *dst = *src;
+    return NOVA402_SUCCESS;
+}
@@ -0,0 +1,30 @@
+/**
+ * Nova402 C Library - 4-way AVX2 Keccak-f[1600]
+ *
+ * Built with AVX2 enabled for this file only; called through the runtime
+ * dispatcher.
+ *
+ * @file keccak_avx2.c
+ */
+
+#include "internal.h"
+
+#include <immintrin.h>
+
+#define K_LANE __m256i
+#define K_WIDTH 4
+#define K_LOAD(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define K_STORE(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), (v))
+#define K_SET1(w) _mm256_set1_epi64x((long long)(w))
+#define K_XOR(a, b) _mm256_xor_si256((a), (b))
+#define K_XOR5(a, b, c, d, e) K_XOR(K_XOR(K_XOR((a), (b)), K_XOR((c), (d))), (e))
+#define K_ROL(a, n) _mm256_or_si256(_mm256_slli_epi64((a), (n)), _mm256_srli_epi64((a), 64 - (n)))
+#define K_CHI(a, b, c) _mm256_xor_si256((a), _mm256_andnot_si256((b), (c)))
+#define K_PERMUTE keccak_f1600_x4
+
+#include "keccak_impl.h"
+
+void nova402_keccak_f1600_x4_avx2(uint64_t *state)
+{
+    keccak_f1600_x4(state);
+}
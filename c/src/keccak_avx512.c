@@ -0,0 +1,32 @@
+/**
+ * Nova402 C Library - 8-way AVX-512 Keccak-f[1600]
+ *
+ * Built with AVX-512F enabled for this file only; called through the
+ * runtime dispatcher. Uses native 64-bit rotates and ternary logic for
+ * theta and chi.
+ *
+ * @file keccak_avx512.c
+ */
+
+#include "internal.h"
+
+#include <immintrin.h>
+
+#define K_LANE __m512i
+#define K_WIDTH 8
+#define K_LOAD(p) _mm512_loadu_si512((const void *)(p))
+#define K_STORE(p, v) _mm512_storeu_si512((void *)(p), (v))
+#define K_SET1(w) _mm512_set1_epi64((long long)(w))
+#define K_XOR(a, b) _mm512_xor_si512((a), (b))
+#define K_XOR5(a, b, c, d, e) \
+    _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64((a), (b), (c), 0x96), (d), (e), 0x96)
+#define K_ROL(a, n) _mm512_rol_epi64((a), (n))
+#define K_CHI(a, b, c) _mm512_ternarylogic_epi64((a), (b), (c), 0xD2)
+#define K_PERMUTE keccak_f1600_x8
+
+#include "keccak_impl.h"
+
+void nova402_keccak_f1600_x8_avx512(uint64_t *state)
+{
+    keccak_f1600_x8(state);
+}
@@ -0,0 +1,118 @@
+/**
+ * Nova402 C Library - Keccak-f[1600] permutation template
+ *
+ * Included by each Keccak kernel after it defines the lane type and lane
+ * operations, so the scalar and SIMD permutations share one round body:
+ *
+ *   K_LANE             lane type (one 64-bit word per message)
+ *   K_WIDTH            number of interleaved states
+ *   K_LOAD(p)          load K_WIDTH words from p
+ *   K_STORE(p, v)      store K_WIDTH words to p
+ *   K_SET1(w)          broadcast a 64-bit word
+ *   K_XOR(a, b)        a ^ b
+ *   K_XOR5(a, ..., e)  a ^ b ^ c ^ d ^ e
+ *   K_ROL(a, n)        rotate left by constant n (1..63)
+ *   K_CHI(a, b, c)     a ^ (~b & c)
+ *   K_PERMUTE          name of the generated function
+ *
+ * The generated function permutes K_WIDTH interleaved states, stored so
+ * that word i of state j lives at state[i * K_WIDTH + j].
+ *
+ * @file keccak_impl.h
+ */
+
+static const uint64_t KECCAK_ROUND_CONSTANTS[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL,
+    0x8000000080008000ULL, 0x000000000000808BULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008AULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800AULL, 0x800000008000000AULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static void K_PERMUTE(uint64_t *state)
+{
+    K_LANE a[25], b[25], c[5], d[5];
+    int i, round;
+
+    for (i = 0; i < 25; i++) {
+        a[i] = K_LOAD(state + i * K_WIDTH);
+    }
+
+    for (round = 0; round < 24; round++) {
+        /* Theta */
+        c[0] = K_XOR5(a[0], a[5], a[10], a[15], a[20]);
+        c[1] = K_XOR5(a[1], a[6], a[11], a[16], a[21]);
+        c[2] = K_XOR5(a[2], a[7], a[12], a[17], a[22]);
+        c[3] = K_XOR5(a[3], a[8], a[13], a[18], a[23]);
+        c[4] = K_XOR5(a[4], a[9], a[14], a[19], a[24]);
+        d[0] = K_XOR(c[4], K_ROL(c[1], 1));
+        d[1] = K_XOR(c[0], K_ROL(c[2], 1));
+        d[2] = K_XOR(c[1], K_ROL(c[3], 1));
+        d[3] = K_XOR(c[2], K_ROL(c[4], 1));
+        d[4] = K_XOR(c[3], K_ROL(c[0], 1));
+
+        /* Rho and pi */
+        b[0] = K_XOR(a[0], d[0]);
+        b[10] = K_ROL(K_XOR(a[1], d[1]), 1);
+        b[20] = K_ROL(K_XOR(a[2], d[2]), 62);
+        b[5] = K_ROL(K_XOR(a[3], d[3]), 28);
+        b[15] = K_ROL(K_XOR(a[4], d[4]), 27);
+        b[16] = K_ROL(K_XOR(a[5], d[0]), 36);
+        b[1] = K_ROL(K_XOR(a[6], d[1]), 44);
+        b[11] = K_ROL(K_XOR(a[7], d[2]), 6);
+        b[21] = K_ROL(K_XOR(a[8], d[3]), 55);
+        b[6] = K_ROL(K_XOR(a[9], d[4]), 20);
+        b[7] = K_ROL(K_XOR(a[10], d[0]), 3);
+        b[17] = K_ROL(K_XOR(a[11], d[1]), 10);
+        b[2] = K_ROL(K_XOR(a[12], d[2]), 43);
+        b[12] = K_ROL(K_XOR(a[13], d[3]), 25);
+        b[22] = K_ROL(K_XOR(a[14], d[4]), 39);
+        b[23] = K_ROL(K_XOR(a[15], d[0]), 41);
+        b[8] = K_ROL(K_XOR(a[16], d[1]), 45);
+        b[18] = K_ROL(K_XOR(a[17], d[2]), 15);
+        b[3] = K_ROL(K_XOR(a[18], d[3]), 21);
+        b[13] = K_ROL(K_XOR(a[19], d[4]), 8);
+        b[14] = K_ROL(K_XOR(a[20], d[0]), 18);
+        b[24] = K_ROL(K_XOR(a[21], d[1]), 2);
+        b[9] = K_ROL(K_XOR(a[22], d[2]), 61);
+        b[19] = K_ROL(K_XOR(a[23], d[3]), 56);
+        b[4] = K_ROL(K_XOR(a[24], d[4]), 14);
+
+        /* Chi */
+        a[0] = K_CHI(b[0], b[1], b[2]);
+        a[1] = K_CHI(b[1], b[2], b[3]);
+        a[2] = K_CHI(b[2], b[3], b[4]);
+        a[3] = K_CHI(b[3], b[4], b[0]);
+        a[4] = K_CHI(b[4], b[0], b[1]);
+        a[5] = K_CHI(b[5], b[6], b[7]);
+        a[6] = K_CHI(b[6], b[7], b[8]);
+        a[7] = K_CHI(b[7], b[8], b[9]);
+        a[8] = K_CHI(b[8], b[9], b[5]);
+        a[9] = K_CHI(b[9], b[5], b[6]);
+        a[10] = K_CHI(b[10], b[11], b[12]);
+        a[11] = K_CHI(b[11], b[12], b[13]);
+        a[12] = K_CHI(b[12], b[13], b[14]);
+        a[13] = K_CHI(b[13], b[14], b[10]);
+        a[14] = K_CHI(b[14], b[10], b[11]);
+        a[15] = K_CHI(b[15], b[16], b[17]);
+        a[16] = K_CHI(b[16], b[17], b[18]);
+        a[17] = K_CHI(b[17], b[18], b[19]);
+        a[18] = K_CHI(b[18], b[19], b[15]);
+        a[19] = K_CHI(b[19], b[15], b[16]);
+        a[20] = K_CHI(b[20], b[21], b[22]);
+        a[21] = K_CHI(b[21], b[22], b[23]);
+        a[22] = K_CHI(b[22], b[23], b[24]);
+        a[23] = K_CHI(b[23], b[24], b[20]);
+        a[24] = K_CHI(b[24], b[20], b[21]);
+
+        /* Iota */
+        a[0] = K_XOR(a[0], K_SET1(KECCAK_ROUND_CONSTANTS[round]));
+    }
+
+    for (i = 0; i < 25; i++) {
+        K_STORE(state + i * K_WIDTH, a[i]);
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * Nova402 C Library - multi-buffer Keccak-256
+ *
+ * Hashes independent messages in lock-step, one Keccak-f[1600] state per
+ * SIMD lane. The widest kernel the CPU supports is picked by the runtime
+ * dispatcher.
+ *
+ * @file keccak_many.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+/* Absorb block `index` of a message, applying the Keccak padding on the last one */
+static void absorb_message_block(uint64_t *state, size_t width, size_t lane,
+                                 const uint8_t *data, size_t length, size_t index)
+{
+    size_t offset = index * NOVA402_KECCAK_RATE;
+    uint8_t block[NOVA402_KECCAK_RATE];
+
+    if (offset + NOVA402_KECCAK_RATE <= length) {
+        nova402_keccak_absorb_block(state, width, lane, data + offset);
+        return;
+    }
+
+    memset(block, 0, sizeof(block));
+    if (length > offset) {
+        memcpy(block, data + offset, length - offset);
+    }
+    block[length - offset] = 0x01;
+    block[NOVA402_KECCAK_RATE - 1] |= 0x80;
+    nova402_keccak_absorb_block(state, width, lane, block);
+}
+
+/* Hash up to kernel->keccak_width messages together */
+static void hash_group(const nova402_dispatch_t *kernel, const uint8_t *const *data,
+                       const size_t *lengths, size_t n, nova402_hash_t *hashes)
+{
+    uint64_t state[25 * NOVA402_KECCAK_MAX_LANES];
+    size_t blocks[NOVA402_KECCAK_MAX_LANES];
+    size_t max_blocks = 0, b, lane;
+
+    memset(state, 0, 25 * kernel->keccak_width * sizeof(state[0]));
+
+    for (lane = 0; lane < n; lane++) {
+        blocks[lane] = lengths[lane] / NOVA402_KECCAK_RATE + 1;
+        if (blocks[lane] > max_blocks) {
+            max_blocks = blocks[lane];
+        }
+    }
+
+    for (b = 0; b < max_blocks; b++) {
+        for (lane = 0; lane < n; lane++) {
+            if (b < blocks[lane]) {
+                absorb_message_block(state, kernel->keccak_width, lane, data[lane],
+                                     lengths[lane], b);
+            }
+        }
+
+        kernel->keccak_f1600_many(state);
+
+        for (lane = 0; lane < n; lane++) {
+            if (b + 1 == blocks[lane]) {
+                nova402_keccak_squeeze(state, kernel->keccak_width, lane, &hashes[lane]);
+            }
+        }
+    }
+}
+
+int nova402_keccak256_many(
+    const uint8_t *const *data,
+    const size_t *lengths,
+    size_t count,
+    nova402_hash_t *hashes)
+{
+    const nova402_dispatch_t *kernel;
+    size_t offset, i;
+
+    if (count == 0) {
+        return NOVA402_SUCCESS;
+    }
+    if (!data || !lengths || !hashes) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    for (i = 0; i < count; i++) {
+        if (!data[i] && lengths[i] != 0) {
+            return NOVA402_ERROR_INVALID_INPUT;
+        }
+    }
+
+    kernel = nova402_dispatch();
+
+    for (offset = 0; offset < count; offset += kernel->keccak_width) {
+        size_t n = count - offset;
+        if (n > kernel->keccak_width) {
+            n = kernel->keccak_width;
+        }
+        hash_group(kernel, data + offset, lengths + offset, n, hashes + offset);
+    }
+
+    return NOVA402_SUCCESS;
+}
+
+int nova402_keccak256_x4(const uint8_t *const data[4], size_t length, nova402_hash_t hashes[4])
+{
+    size_t lengths[4] = { length, length, length, length };
+    return nova402_keccak256_many(data, lengths, 4, hashes);
+}
+
+int nova402_keccak256_x8(const uint8_t *const data[8], size_t length, nova402_hash_t hashes[8])
+{
+    size_t lengths[8] = { length, length, length, length, length, length, length, length };
+    return nova402_keccak256_many(data, lengths, 8, hashes);
+}
@@ -0,0 +1,30 @@
+/**
+ * Nova402 C Library - 2-way NEON Keccak-f[1600]
+ *
+ * NEON is part of the AArch64 baseline, so no extra build flags are
+ * needed; called through the runtime dispatcher.
+ *
+ * @file keccak_neon.c
+ */
+
+#include "internal.h"
+
+#include <arm_neon.h>
+
+#define K_LANE uint64x2_t
+#define K_WIDTH 2
+#define K_LOAD(p) vld1q_u64(p)
+#define K_STORE(p, v) vst1q_u64((p), (v))
+#define K_SET1(w) vdupq_n_u64(w)
+#define K_XOR(a, b) veorq_u64((a), (b))
+#define K_XOR5(a, b, c, d, e) K_XOR(K_XOR(K_XOR((a), (b)), K_XOR((c), (d))), (e))
+#define K_ROL(a, n) vsriq_n_u64(vshlq_n_u64((a), (n)), (a), 64 - (n))
+#define K_CHI(a, b, c) veorq_u64((a), vbicq_u64((c), (b)))
+#define K_PERMUTE keccak_f1600_x2
+
+#include "keccak_impl.h"
+
+void nova402_keccak_f1600_x2_neon(uint64_t *state)
+{
+    keccak_f1600_x2(state);
+}
@@ -0,0 +1,31 @@
+/**
+ * Nova402 C Library - 2-way ARMv8.2 SHA3 Keccak-f[1600]
+ *
+ * Built with the SHA3 extension enabled for this file only; called through
+ * the runtime dispatcher when HWCAP reports it. EOR3 folds the theta
+ * parities, BCAX does chi in one instruction.
+ *
+ * @file keccak_sha3.c
+ */
+
+#include "internal.h"
+
+#include <arm_neon.h>
+
+#define K_LANE uint64x2_t
+#define K_WIDTH 2
+#define K_LOAD(p) vld1q_u64(p)
+#define K_STORE(p, v) vst1q_u64((p), (v))
+#define K_SET1(w) vdupq_n_u64(w)
+#define K_XOR(a, b) veorq_u64((a), (b))
+#define K_XOR5(a, b, c, d, e) veor3q_u64(veor3q_u64((a), (b), (c)), (d), (e))
+#define K_ROL(a, n) vsriq_n_u64(vshlq_n_u64((a), (n)), (a), 64 - (n))
+#define K_CHI(a, b, c) vbcaxq_u64((a), (c), (b))
+#define K_PERMUTE keccak_f1600_x2_sha3
+
+#include "keccak_impl.h"
+
+void nova402_keccak_f1600_x2_sha3(uint64_t *state)
+{
+    keccak_f1600_x2_sha3(state);
+}
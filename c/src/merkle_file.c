@@ -0,0 +1,248 @@
+/**
+ * Nova402 C Library - on-disk Merkle trees
+ *
+ * File layout, all integers little-endian:
+ *
+ *   0     magic "NOVA402M"
+ *   8     u32 format version (NOVA402_MERKLE_FILE_VERSION)
+ *   12    u32 offset of the node data (one page, 4096)
+ *   16    u64 leaf count
+ *   24    u64 depth (layers - 1)
+ *   32    u64 node count over all layers
+ *   40    root hash (32 bytes), zero to the end of the page
+ *   4096  layers, root first and leaves last, each packed
+ *
+ * Keeping the root end first puts the upper layers, which every proof
+ * touches, on a few pages that stay resident, while leaf pages are only
+ * faulted in for the proofs that need them. A mapped tree is used in place:
+ * opening reads the header and nothing else.
+ *
+ * @file merkle_file.c
+ */
+
+/* mmap() and posix_madvise() under strict C99 */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "internal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define FILE_MAGIC "NOVA402M"
+#define HEADER_SIZE 4096
+
+static void store32_le(uint8_t *p, uint32_t v)
+{
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void store64_le(uint8_t *p, uint64_t v)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t load32_le(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t load64_le(const uint8_t *p)
+{
+    return (uint64_t)load32_le(p) | ((uint64_t)load32_le(p + 4) << 32);
+}
+
+int nova402_merkle_tree_save(const nova402_merkle_tree_t *tree, const char *path)
+{
+    uint8_t header[HEADER_SIZE];
+    uint64_t nodes = 0;
+    size_t layer;
+    FILE *f;
+    int ok;
+
+    if (!tree || !path) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    for (layer = 0; layer <= tree->depth; layer++) {
+        nodes += nova402_merkle_layer_width(tree->leaf_count, layer);
+    }
+
+    memset(header, 0, sizeof(header));
+    memcpy(header, FILE_MAGIC, 8);
+    store32_le(header + 8, NOVA402_MERKLE_FILE_VERSION);
+    store32_le(header + 12, HEADER_SIZE);
+    store64_le(header + 16, tree->leaf_count);
+    store64_le(header + 24, tree->depth);
+    store64_le(header + 32, nodes);
+    memcpy(header + 40, tree->nodes[tree->offsets[tree->depth]].bytes, NOVA402_HASH_SIZE);
+
+    f = fopen(path, "wb");
+    if (!f) {
+        return NOVA402_ERROR_IO;
+    }
+    ok = fwrite(header, 1, sizeof(header), f) == sizeof(header);
+    for (layer = tree->depth + 1; ok && layer-- > 0;) {
+        size_t width = nova402_merkle_layer_width(tree->leaf_count, layer);
+
+        ok = fwrite(tree->nodes + tree->offsets[layer], sizeof(nova402_hash_t), width, f) == width;
+    }
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok) {
+        remove(path);
+        return NOVA402_ERROR_IO;
+    }
+    return NOVA402_SUCCESS;
+}
+
+/* Map a whole file read-only; returns NULL on failure */
+static void *map_file(const char *path, size_t *size)
+{
+#if defined(_WIN32)
+    HANDLE file, mapping;
+    LARGE_INTEGER length;
+    void *base = NULL;
+
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                       FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    if (GetFileSizeEx(file, &length) && length.QuadPart >= HEADER_SIZE &&
+        (unsigned long long)length.QuadPart <= (size_t)-1) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        *size = (size_t)length.QuadPart;
+    }
+    CloseHandle(file);
+    return base;
+#else
+    struct stat st;
+    void *base = NULL;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &st) == 0 && st.st_size >= HEADER_SIZE &&
+        (unsigned long long)st.st_size <= (size_t)-1) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            base = NULL;
+        } else {
+            /* Proofs touch one node per layer: no read-ahead into leaf pages */
+            posix_madvise(base, (size_t)st.st_size, POSIX_MADV_RANDOM);
+            *size = (size_t)st.st_size;
+        }
+    }
+    close(fd);
+    return base;
+#endif
+}
+
+static void unmap_file(void *base, size_t size)
+{
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(base);
+#else
+    munmap(base, size);
+#endif
+}
+
+void nova402_merkle_tree_unmap(nova402_merkle_tree_t *tree)
+{
+    unmap_file(tree->mapping, tree->mapping_size);
+    tree->mapping = NULL;
+}
+
+nova402_merkle_tree_t *nova402_merkle_tree_open_mmap(const char *path)
+{
+    nova402_merkle_tree_t *tree;
+    const uint8_t *header;
+    uint64_t leaf_count, depth, nodes, offset = 0, width;
+    size_t size = 0, layer;
+    void *base;
+
+    if (!path) {
+        return NULL;
+    }
+    base = map_file(path, &size);
+    if (!base) {
+        return NULL;
+    }
+    header = (const uint8_t *)base;
+
+    leaf_count = load64_le(header + 16);
+    depth = load64_le(header + 24);
+    nodes = load64_le(header + 32);
+    /* Bound every header field by the file before deriving layer widths */
+    if (memcmp(header, FILE_MAGIC, 8) != 0 ||
+        load32_le(header + 8) != NOVA402_MERKLE_FILE_VERSION ||
+        load32_le(header + 12) != HEADER_SIZE ||
+        leaf_count == 0 || leaf_count > (size - HEADER_SIZE) / sizeof(nova402_hash_t) ||
+        depth >= NOVA402_MERKLE_MAX_DEPTH ||
+        nodes > (size - HEADER_SIZE) / sizeof(nova402_hash_t)) {
+        unmap_file(base, size);
+        return NULL;
+    }
+    for (layer = 0, width = leaf_count; width > 1; width = width / 2 + (width & 1)) {
+        layer++;
+    }
+    if (layer != depth) {
+        unmap_file(base, size);
+        return NULL;
+    }
+
+    tree = nova402_calloc(1, sizeof(*tree));
+    if (!tree) {
+        unmap_file(base, size);
+        return NULL;
+    }
+    tree->leaf_count = (size_t)leaf_count;
+    tree->depth = (size_t)depth;
+    tree->nodes = (nova402_hash_t *)(void *)((uint8_t *)base + HEADER_SIZE);
+    tree->mapping = base;
+    tree->mapping_size = size;
+    tree->memory_bytes = sizeof(*tree);
+
+    /* Root first; the running total may not pass the node count */
+    for (layer = tree->depth + 1; layer-- > 0;) {
+        width = nova402_merkle_layer_width(tree->leaf_count, layer);
+        if (width > nodes - offset) {
+            nova402_merkle_tree_destroy(tree);
+            return NULL;
+        }
+        tree->offsets[layer] = (size_t)offset;
+        offset += width;
+    }
+    if (offset != nodes || memcmp(tree->nodes[0].bytes, header + 40, NOVA402_HASH_SIZE) != 0) {
+        nova402_merkle_tree_destroy(tree);
+        return NULL;
+    }
+
+    return tree;
+}
@@ -0,0 +1,168 @@
+/**
+ * Nova402 C Library - Merkle multiproofs
+ *
+ * A multiproof for a sorted set of leaf indices lists, layer by layer from
+ * the leaves up and left to right within a layer, every sibling the
+ * verifier cannot compute itself. A sibling shared by several leaves is
+ * stored once, and siblings that are themselves proven are not stored at
+ * all. Layer widths follow from the leaf count, which tells the verifier
+ * where the odd last node is promoted.
+ *
+ * Verification carries the known nodes of one layer as (position, hash)
+ * lists. Every parent is hashed once, and all pairs of a layer go through
+ * nova402_merkle_hash_layer() together, so they share multi-buffer
+ * permutations. Only the last node of a layer can be promoted, which
+ * keeps the parents in position order.
+ *
+ * @file merkle_multiproof.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+static int indices_valid(const size_t *indices, size_t count, size_t leaf_count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        if (indices[i] >= leaf_count || (i > 0 && indices[i] <= indices[i - 1])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int nova402_merkle_multiproof(
+    const nova402_merkle_tree_t *tree,
+    const size_t *indices,
+    size_t count,
+    nova402_hash_t *proof,
+    size_t proof_capacity,
+    size_t *proof_length)
+{
+    size_t width, depth, level, length = 0;
+
+    if (!tree || !indices || count == 0 || !proof_length || (!proof && proof_capacity > 0)) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    width = nova402_merkle_tree_leaf_count(tree);
+    if (!indices_valid(indices, count, width)) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    /* The known nodes of layer `level` are the distinct indices[i] >> level */
+    depth = nova402_merkle_tree_depth(tree);
+    for (level = 0; level < depth; level++, width = (width + 1) / 2) {
+        const nova402_hash_t *layer = nova402_merkle_tree_layer(tree, level);
+        size_t i = 0;
+
+        while (i < count) {
+            size_t p = indices[i] >> level;
+            size_t sibling = p ^ 1;
+
+            while (i < count && indices[i] >> level == p) {
+                i++;
+            }
+            if (sibling >= width) {
+                continue;
+            }
+            if (i < count && indices[i] >> level == sibling) {
+                while (i < count && indices[i] >> level == sibling) {
+                    i++;
+                }
+                continue;
+            }
+            if (length < proof_capacity) {
+                proof[length] = layer[sibling];
+            }
+            length++;
+        }
+    }
+
+    *proof_length = length;
+    return length <= proof_capacity ? NOVA402_SUCCESS : NOVA402_ERROR_BUFFER_TOO_SMALL;
+}
+
+bool nova402_verify_merkle_multiproof(
+    const nova402_hash_t *leaves,
+    const size_t *indices,
+    size_t count,
+    size_t leaf_count,
+    const nova402_hash_t *proof,
+    size_t proof_length,
+    const nova402_hash_t *root)
+{
+    return nova402_verify_merkle_multiproof_arena(leaves, indices, count, leaf_count, proof,
+                                                  proof_length, root, NULL);
+}
+
+bool nova402_verify_merkle_multiproof_arena(
+    const nova402_hash_t *leaves,
+    const size_t *indices,
+    size_t count,
+    size_t leaf_count,
+    const nova402_hash_t *proof,
+    size_t proof_length,
+    const nova402_hash_t *root,
+    nova402_arena_t *arena)
+{
+    nova402_hash_t *nodes, *pairs;
+    size_t *positions;
+    size_t width, used = 0, n;
+    bool valid;
+
+    if (!leaves || !indices || count == 0 || !root || (!proof && proof_length > 0) ||
+        !indices_valid(indices, count, leaf_count)) {
+        return false;
+    }
+
+    nodes = nova402_scratch_alloc(arena, count * 3 * sizeof(nova402_hash_t));
+    positions = nodes ? nova402_scratch_alloc(arena, count * sizeof(size_t)) : NULL;
+    if (!positions) {
+        nova402_scratch_free(arena, nodes);
+        return false;
+    }
+    pairs = nodes + count;
+    memcpy(nodes, leaves, count * sizeof(nova402_hash_t));
+    memcpy(positions, indices, count * sizeof(size_t));
+
+    for (width = leaf_count, n = count; width > 1; width = (width + 1) / 2) {
+        size_t paired = 0, parents = 0, i;
+        int promoted = 0;
+
+        for (i = 0; i < n; i++) {
+            size_t p = positions[i];
+            size_t sibling = p ^ 1;
+
+            if (sibling >= width) {
+                promoted = 1;  /* last node of the layer, necessarily i == n - 1 */
+            } else if (i + 1 < n && positions[i + 1] == sibling) {
+                pairs[paired++] = nodes[i];
+                pairs[paired++] = nodes[++i];
+            } else if (used < proof_length) {
+                pairs[paired++] = nodes[i];
+                pairs[paired++] = proof[used++];
+            } else {
+                break;
+            }
+            positions[parents++] = p / 2;
+        }
+        if (i < n) {
+            break;
+        }
+
+        /* Pair outputs land below n - 1, so a promoted nodes[n - 1] survives */
+        nova402_merkle_hash_layer(pairs, paired, nodes);
+        if (promoted) {
+            nodes[paired / 2] = nodes[n - 1];
+        }
+        n = parents;
+    }
+
+    valid = width <= 1 && n == 1 && used == proof_length &&
+            memcmp(nodes[0].bytes, root->bytes, NOVA402_HASH_SIZE) == 0;
+    nova402_scratch_free(arena, positions);
+    nova402_scratch_free(arena, nodes);
+    return valid;
+}
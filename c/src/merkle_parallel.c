@@ -0,0 +1,137 @@
+/**
+ * Nova402 C Library - parallel Merkle root
+ *
+ * Pairing never crosses the boundary of an aligned power-of-two range of
+ * leaves, so such a range reduces to exactly the node the full tree holds
+ * for it, the last partial range included. The leaves are cut into equal
+ * power-of-two subtrees, one task each; every subtree is reduced in
+ * blocks small enough for a stack buffer, each block layer by layer with
+ * the multi-buffer kernel, and the block roots are joined through a
+ * nova402_merkle_stream_t. The subtree roots are joined the same way.
+ *
+ * @file merkle_parallel.c
+ */
+
+#include "internal.h"
+#include "stats.h"
+
+
+/* Leaves reduced per stack block; a power of two */
+#define BLOCK_LEAVES 512
+
+/* Smallest subtree worth a task of its own; a power of two */
+#define MIN_SUBTREE_LEAVES (1u << 14)
+
+/* Subtrees per unit of parallelism, to even out uneven progress */
+#define SUBTREES_PER_THREAD 4
+
+typedef struct {
+    const nova402_hash_t *leaves;
+    size_t leaf_count;
+    size_t subtree_leaves;
+    nova402_hash_t *roots;
+} job_t;
+
+/* Root of up to BLOCK_LEAVES leaves */
+static void block_root(const nova402_hash_t *leaves, size_t count, nova402_hash_t *root)
+{
+    nova402_hash_t scratch[BLOCK_LEAVES / 2];
+
+    if (count == 1) {
+        *root = leaves[0];
+        return;
+    }
+    nova402_merkle_hash_layer(leaves, count, scratch);
+    for (count = (count + 1) / 2; count > 1; count = (count + 1) / 2) {
+        nova402_merkle_hash_layer(scratch, count, scratch);
+    }
+    *root = scratch[0];
+}
+
+static void subtree_root(const nova402_hash_t *leaves, size_t count, nova402_hash_t *root)
+{
+    nova402_merkle_stream_t stream;
+    nova402_hash_t node;
+    size_t offset;
+
+    nova402_merkle_stream_init(&stream);
+    for (offset = 0; offset < count; offset += BLOCK_LEAVES) {
+        size_t n = (count - offset < BLOCK_LEAVES) ? count - offset : BLOCK_LEAVES;
+
+        block_root(leaves + offset, n, &node);
+        nova402_merkle_stream_push(&stream, &node);
+    }
+    nova402_merkle_stream_root(&stream, root);
+}
+
+static void subtree_task(void *arg, size_t index)
+{
+    job_t *job = (job_t *)arg;
+    size_t offset = index * job->subtree_leaves;
+    size_t n = job->leaf_count - offset;
+
+    if (n > job->subtree_leaves) {
+        n = job->subtree_leaves;
+    }
+    subtree_root(job->leaves + offset, n, &job->roots[index]);
+}
+
+static int merkle_root_parallel(
+    const nova402_hash_t *leaves,
+    size_t leaf_count,
+    size_t threads,
+    const nova402_executor_t *executor,
+    nova402_hash_t *root)
+{
+    nova402_merkle_stream_t stream;
+    job_t job;
+    size_t subtrees, target, i;
+
+    if (!leaves || leaf_count == 0 || !root) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    if (threads == 0) {
+        threads = nova402_cpu_count();
+    }
+    target = threads * SUBTREES_PER_THREAD;
+
+    job.subtree_leaves = MIN_SUBTREE_LEAVES;
+    while (job.subtree_leaves < leaf_count / target && job.subtree_leaves <= (size_t)-1 / 4) {
+        job.subtree_leaves *= 2;
+    }
+    subtrees = (leaf_count - 1) / job.subtree_leaves + 1;
+
+    job.roots = (threads > 1 && subtrees > 1) ? nova402_malloc(subtrees * sizeof(nova402_hash_t)) : NULL;
+    if (!job.roots) {
+        subtree_root(leaves, leaf_count, root);
+        return NOVA402_SUCCESS;
+    }
+    job.leaves = leaves;
+    job.leaf_count = leaf_count;
+
+    nova402_parallel_run(executor, threads, subtree_task, &job, subtrees);
+
+    nova402_merkle_stream_init(&stream);
+    for (i = 0; i < subtrees; i++) {
+        nova402_merkle_stream_push(&stream, &job.roots[i]);
+    }
+    nova402_merkle_stream_root(&stream, root);
+    nova402_free(job.roots);
+    return NOVA402_SUCCESS;
+}
+
+int nova402_merkle_root_parallel(
+    const nova402_hash_t *leaves,
+    size_t leaf_count,
+    size_t threads,
+    const nova402_executor_t *executor,
+    nova402_hash_t *root)
+{
+    int rc;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_MERKLE_ROOT);
+
+    rc = merkle_root_parallel(leaves, leaf_count, threads, executor, root);
+    NOVA402_STATS_END(leaf_count, rc != NOVA402_SUCCESS);
+    return rc;
+}
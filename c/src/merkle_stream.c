@@ -0,0 +1,83 @@
+/**
+ * Nova402 C Library - append-only Merkle accumulator
+ *
+ * Pairwise reduction with odd-node promotion splits n leaves into perfect
+ * subtrees, one per set bit of n, largest first. The accumulator keeps the
+ * root of each: pushing a leaf carries it up like a binary increment, and
+ * the root folds the frontier from the smallest subtree upwards, which is
+ * exactly where the promoted node meets its left neighbour in the full
+ * tree. Pairs are sorted before hashing, so argument order never matters.
+ *
+ * @file merkle_stream.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+void nova402_merkle_stream_init(nova402_merkle_stream_t *stream)
+{
+    stream->count = 0;
+}
+
+int nova402_merkle_stream_push(nova402_merkle_stream_t *stream, const nova402_hash_t *leaf)
+{
+    nova402_hash_t node;
+    size_t level = 0;
+
+    if (!stream || !leaf) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (stream->count == UINT64_MAX) {
+        return NOVA402_ERROR_CAPACITY;
+    }
+
+    node = *leaf;
+    while (stream->count & ((uint64_t)1 << level)) {
+        nova402_merkle_hash_pair(&stream->frontier[level], &node, &node);
+        level++;
+    }
+    stream->frontier[level] = node;
+    stream->count++;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_merkle_stream_root(const nova402_merkle_stream_t *stream, nova402_hash_t *root)
+{
+    nova402_hash_t node;
+    uint64_t count;
+    size_t level = 0;
+
+    if (!stream || !root || stream->count == 0) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    count = stream->count;
+    while (!(count & 1)) {
+        count >>= 1;
+        level++;
+    }
+    node = stream->frontier[level];
+    for (count >>= 1, level++; count; count >>= 1, level++) {
+        if (count & 1) {
+            nova402_merkle_hash_pair(&stream->frontier[level], &node, &node);
+        }
+    }
+
+    *root = node;
+    return NOVA402_SUCCESS;
+}
+
+void nova402_merkle_stream_snapshot(const nova402_merkle_stream_t *stream,
+                                    nova402_merkle_stream_t *snapshot)
+{
+    /* Entries above the highest set bit of count are never read */
+    size_t used = 0;
+    uint64_t count;
+
+    snapshot->count = stream->count;
+    for (count = stream->count; count; count >>= 1) {
+        used++;
+    }
+    memcpy(snapshot->frontier, stream->frontier, used * sizeof(nova402_hash_t));
+}
@@ -0,0 +1,220 @@
+/**
+ * Nova402 C Library - Merkle tree
+ *
+ * All layers of a built tree live back to back in one cache-aligned
+ * arena, leaves first and the root last (trees mapped from a file, see
+ * merkle_file.c, store them root first). Pairs are hashed sorted, as in the Rust
+ * implementation: keccak256(min(a, b) || max(a, b)), with an odd last node
+ * promoted unchanged. A 64-byte pair fits one Keccak block, so a layer is
+ * hashed keccak_width pairs per permutation with the padding written
+ * straight into the interleaved states.
+ *
+ * @file merkle_tree.c
+ */
+
+#include "internal.h"
+#include "stats.h"
+
+#include <string.h>
+
+static uint64_t load64_le(const uint8_t *p)
+{
+    uint64_t w = 0;
+    int j;
+
+    for (j = 7; j >= 0; j--) {
+        w = (w << 8) | p[j];
+    }
+    return w;
+}
+
+/* Place the sorted pair (a, b) and the Keccak padding into a zeroed lane */
+static void load_pair(uint64_t *state, size_t width, size_t lane,
+                      const nova402_hash_t *a, const nova402_hash_t *b)
+{
+    const nova402_hash_t *first = a, *second = b;
+    size_t i;
+
+    if (memcmp(a->bytes, b->bytes, NOVA402_HASH_SIZE) > 0) {
+        first = b;
+        second = a;
+    }
+    for (i = 0; i < 4; i++) {
+        state[i * width + lane] = load64_le(first->bytes + 8 * i);
+        state[(i + 4) * width + lane] = load64_le(second->bytes + 8 * i);
+    }
+    /* 0x01 after the 64 message bytes, 0x80 in the last byte of the rate */
+    state[8 * width + lane] = 0x01;
+    state[(NOVA402_KECCAK_RATE / 8 - 1) * width + lane] = 0x8000000000000000ULL;
+}
+
+void nova402_merkle_hash_pair(const nova402_hash_t *a, const nova402_hash_t *b, nova402_hash_t *parent)
+{
+    uint64_t state[25];
+
+    memset(state, 0, sizeof(state));
+    load_pair(state, 1, 0, a, b);
+    nova402_dispatch()->keccak_f1600(state);
+    nova402_keccak_squeeze(state, 1, 0, parent);
+}
+
+void nova402_merkle_hash_layer(const nova402_hash_t *nodes, size_t count, nova402_hash_t *parents)
+{
+    const nova402_dispatch_t *kernel = nova402_dispatch();
+    size_t width = kernel->keccak_width;
+    size_t pairs = count / 2;
+    size_t p, lane;
+
+    for (p = 0; p < pairs; p += width) {
+        uint64_t state[25 * NOVA402_KECCAK_MAX_LANES];
+        size_t n = (pairs - p < width) ? pairs - p : width;
+
+        if (n == 1) {
+            nova402_merkle_hash_pair(&nodes[2 * p], &nodes[2 * p + 1], &parents[p]);
+            continue;
+        }
+
+        memset(state, 0, 25 * width * sizeof(state[0]));
+        for (lane = 0; lane < n; lane++) {
+            load_pair(state, width, lane, &nodes[2 * (p + lane)], &nodes[2 * (p + lane) + 1]);
+        }
+        kernel->keccak_f1600_many(state);
+        for (lane = 0; lane < n; lane++) {
+            nova402_keccak_squeeze(state, width, lane, &parents[p + lane]);
+        }
+    }
+
+    if (count & 1) {
+        parents[pairs] = nodes[count - 1];
+    }
+}
+
+static nova402_merkle_tree_t *merkle_tree_create(const nova402_hash_t *leaves, size_t leaf_count)
+{
+    nova402_merkle_tree_t *tree;
+    size_t total = 0, n, layer;
+    uintptr_t aligned;
+
+    if (!leaves || leaf_count == 0) {
+        return NULL;
+    }
+
+    tree = nova402_calloc(1, sizeof(*tree));
+    if (!tree) {
+        return NULL;
+    }
+
+    for (n = leaf_count, layer = 0;; n = (n + 1) / 2, layer++) {
+        tree->offsets[layer] = total;
+        total += n;
+        if (n == 1) {
+            break;
+        }
+    }
+    tree->depth = layer;
+    tree->leaf_count = leaf_count;
+
+    if (total > ((size_t)-1 - NOVA402_CACHE_LINE) / sizeof(nova402_hash_t)) {
+        nova402_free(tree);
+        return NULL;
+    }
+    tree->block = nova402_malloc(total * sizeof(nova402_hash_t) + NOVA402_CACHE_LINE - 1);
+    if (!tree->block) {
+        nova402_free(tree);
+        return NULL;
+    }
+    aligned = ((uintptr_t)tree->block + NOVA402_CACHE_LINE - 1) & ~(uintptr_t)(NOVA402_CACHE_LINE - 1);
+    tree->nodes = (nova402_hash_t *)aligned;
+    tree->memory_bytes = sizeof(*tree) + total * sizeof(nova402_hash_t) + NOVA402_CACHE_LINE - 1;
+
+    memcpy(tree->nodes, leaves, leaf_count * sizeof(nova402_hash_t));
+    for (layer = 0; layer < tree->depth; layer++) {
+        nova402_merkle_hash_layer(tree->nodes + tree->offsets[layer],
+                                  nova402_merkle_layer_width(leaf_count, layer),
+                                  tree->nodes + tree->offsets[layer + 1]);
+    }
+
+    return tree;
+}
+
+nova402_merkle_tree_t *nova402_merkle_tree_create(const nova402_hash_t *leaves, size_t leaf_count)
+{
+    nova402_merkle_tree_t *tree;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_MERKLE_TREE_CREATE);
+
+    tree = merkle_tree_create(leaves, leaf_count);
+    NOVA402_STATS_END(leaf_count, !tree);
+    return tree;
+}
+
+void nova402_merkle_tree_destroy(nova402_merkle_tree_t *tree)
+{
+    if (!tree) {
+        return;
+    }
+    if (tree->mapping) {
+        nova402_merkle_tree_unmap(tree);
+    }
+    nova402_free(tree->block);
+    nova402_free(tree);
+}
+
+int nova402_merkle_tree_root(const nova402_merkle_tree_t *tree, nova402_hash_t *root)
+{
+    if (!tree || !root) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    *root = tree->nodes[tree->offsets[tree->depth]];
+    return NOVA402_SUCCESS;
+}
+
+size_t nova402_merkle_tree_leaf_count(const nova402_merkle_tree_t *tree)
+{
+    return tree ? tree->leaf_count : 0;
+}
+
+size_t nova402_merkle_tree_depth(const nova402_merkle_tree_t *tree)
+{
+    return tree ? tree->depth : 0;
+}
+
+const nova402_hash_t *nova402_merkle_tree_layer(const nova402_merkle_tree_t *tree, size_t level)
+{
+    return tree->nodes + tree->offsets[level];
+}
+
+size_t nova402_merkle_tree_memory(const nova402_merkle_tree_t *tree)
+{
+    return tree ? tree->memory_bytes : 0;
+}
+
+int nova402_merkle_proof(
+    const nova402_merkle_tree_t *tree,
+    size_t index,
+    nova402_hash_t *proof,
+    size_t proof_capacity,
+    size_t *proof_length)
+{
+    size_t layer, length = 0;
+
+    if (!tree || !proof_length || index >= tree->leaf_count || (!proof && proof_capacity > 0)) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    for (layer = 0; layer < tree->depth; layer++) {
+        size_t width = nova402_merkle_layer_width(tree->leaf_count, layer);
+        size_t sibling = index ^ 1;
+
+        /* A promoted node has no sibling and contributes nothing */
+        if (sibling < width) {
+            if (length < proof_capacity) {
+                proof[length] = tree->nodes[tree->offsets[layer] + sibling];
+            }
+            length++;
+        }
+        index /= 2;
+    }
+
+    *proof_length = length;
+    return length <= proof_capacity ? NOVA402_SUCCESS : NOVA402_ERROR_BUFFER_TOO_SMALL;
+}
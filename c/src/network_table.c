@@ -0,0 +1,147 @@
+/**
+ * Nova402 C Library - interned network table
+ *
+ * Every supported network has a fixed nova402_network_id_t and a static
+ * entry holding its configuration and its USDC contract, already decoded
+ * for EVM networks. Names and CAIP-2 IDs resolve to an ID through two
+ * perfect hash tables: NETWORK_HASH_SEED was chosen offline so that no two
+ * keys of either table share a slot, so a lookup is one hash and at most
+ * one compare. When a network is added, search a new seed (any value for
+ * which both tables stay collision-free), refill the slot tables and add
+ * the entry to the constexpr table in nova402.hpp.
+ *
+ * @file network_table.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+#define NETWORK_HASH_SEED 0xb8188d64u
+#define NETWORK_HASH_SLOTS 16
+
+typedef struct {
+    nova402_network_info_t info;
+    bool has_usdc_address;
+    nova402_address_t usdc_address;
+} network_entry_t;
+
+static const network_entry_t g_networks[NOVA402_NETWORK_ID_COUNT] = {
+    {{NULL, NULL, {0, NULL, NOVA402_NETWORK_EVM, NULL}, NULL}, false, {{0}}},
+    {{"base-mainnet", "eip155:8453",
+      {8453, "Base Mainnet", NOVA402_NETWORK_EVM, "https://mainnet.base.org"},
+      "0x833589fCD6eDb6E08f4c7C32D4f71b54bdA02913"},
+     true, {{0x83, 0x35, 0x89, 0xfc, 0xd6, 0xed, 0xb6, 0xe0, 0x8f, 0x4c,
+             0x7c, 0x32, 0xd4, 0xf7, 0x1b, 0x54, 0xbd, 0xa0, 0x29, 0x13}}},
+    {{"base-sepolia", "eip155:84532",
+      {84532, "Base Sepolia", NOVA402_NETWORK_EVM, "https://sepolia.base.org"},
+      "0x036CbD53842c5426634e7929541eC2318f3dCF7e"},
+     true, {{0x03, 0x6c, 0xbd, 0x53, 0x84, 0x2c, 0x54, 0x26, 0x63, 0x4e,
+             0x79, 0x29, 0x54, 0x1e, 0xc2, 0x31, 0x8f, 0x3d, 0xcf, 0x7e}}},
+    {{"solana-mainnet", "solana:mainnet",
+      {0, "Solana Mainnet", NOVA402_NETWORK_SOLANA, "https://api.mainnet-beta.solana.com"},
+      "EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v"},
+     false, {{0}}},
+    {{"solana-devnet", "solana:devnet",
+      {0, "Solana Devnet", NOVA402_NETWORK_SOLANA, "https://api.devnet.solana.com"},
+      "4zMMC9srt5Ri5X14GAgXhaHii3GnPAEERYPJgZJDncDU"},
+     false, {{0}}},
+    {{"polygon", "eip155:137",
+      {137, "Polygon", NOVA402_NETWORK_EVM, "https://polygon-rpc.com"},
+      "0x2791Bca1f2de4661ED88A30C99A7a9449Aa84174"},
+     true, {{0x27, 0x91, 0xbc, 0xa1, 0xf2, 0xde, 0x46, 0x61, 0xed, 0x88,
+             0xa3, 0x0c, 0x99, 0xa7, 0xa9, 0x44, 0x9a, 0xa8, 0x41, 0x74}}},
+    {{"bsc", "eip155:56",
+      {56, "BNB Smart Chain", NOVA402_NETWORK_EVM, "https://bsc-dataseed.binance.org"},
+      "0x8AC76a51cc950d9822D68b83fE1Ad97B32Cd580d"},
+     true, {{0x8a, 0xc7, 0x6a, 0x51, 0xcc, 0x95, 0x0d, 0x98, 0x22, 0xd6,
+             0x8b, 0x83, 0xfe, 0x1a, 0xd9, 0x7b, 0x32, 0xcd, 0x58, 0x0d}}},
+    {{"sei", "eip155:1329",
+      {1329, "Sei Network", NOVA402_NETWORK_EVM, "https://evm-rpc.sei-apis.com"},
+      NULL},
+     false, {{0}}},
+    {{"peaq", "eip155:3338",
+      {3338, "Peaq Network", NOVA402_NETWORK_EVM, "https://peaq.api.onfinality.io/public"},
+      NULL},
+     false, {{0}}},
+};
+
+/* Slot -> ID, 0 for an empty slot */
+static const uint8_t g_network_slots[NETWORK_HASH_SLOTS] = {
+    NOVA402_NETWORK_ID_SOLANA_MAINNET, 0,
+    NOVA402_NETWORK_ID_BASE_MAINNET, NOVA402_NETWORK_ID_BASE_SEPOLIA,
+    0, 0, 0, 0, 0,
+    NOVA402_NETWORK_ID_BSC, NOVA402_NETWORK_ID_POLYGON, NOVA402_NETWORK_ID_SOLANA_DEVNET,
+    0, NOVA402_NETWORK_ID_PEAQ, 0, NOVA402_NETWORK_ID_SEI,
+};
+
+static const uint8_t g_caip2_slots[NETWORK_HASH_SLOTS] = {
+    NOVA402_NETWORK_ID_BSC, NOVA402_NETWORK_ID_POLYGON, NOVA402_NETWORK_ID_SEI,
+    0, 0, 0,
+    NOVA402_NETWORK_ID_SOLANA_MAINNET, NOVA402_NETWORK_ID_PEAQ,
+    0, 0,
+    NOVA402_NETWORK_ID_BASE_SEPOLIA, NOVA402_NETWORK_ID_BASE_MAINNET,
+    0, NOVA402_NETWORK_ID_SOLANA_DEVNET, 0, 0,
+};
+
+/* Seeded FNV-1a, folded to a slot */
+static unsigned network_slot(const char *key, size_t length)
+{
+    uint32_t h = NETWORK_HASH_SEED;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        h = (h ^ (uint8_t)key[i]) * 0x01000193u;
+    }
+    return (h ^ (h >> 16)) & (NETWORK_HASH_SLOTS - 1);
+}
+
+nova402_network_id_t nova402_network_lookup(const char *network, size_t length)
+{
+    const network_entry_t *entry;
+    unsigned id;
+
+    if (!network) {
+        return NOVA402_NETWORK_ID_UNKNOWN;
+    }
+    id = g_network_slots[network_slot(network, length)];
+    entry = &g_networks[id];
+    if (id == 0 || strlen(entry->info.network) != length ||
+        memcmp(entry->info.network, network, length) != 0) {
+        return NOVA402_NETWORK_ID_UNKNOWN;
+    }
+    return (nova402_network_id_t)id;
+}
+
+nova402_network_id_t nova402_network_lookup_caip2(const char *caip2, size_t length)
+{
+    const network_entry_t *entry;
+    unsigned id;
+
+    if (!caip2) {
+        return NOVA402_NETWORK_ID_UNKNOWN;
+    }
+    id = g_caip2_slots[network_slot(caip2, length)];
+    entry = &g_networks[id];
+    if (id == 0 || strlen(entry->info.caip2) != length ||
+        memcmp(entry->info.caip2, caip2, length) != 0) {
+        return NOVA402_NETWORK_ID_UNKNOWN;
+    }
+    return (nova402_network_id_t)id;
+}
+
+const nova402_network_info_t *nova402_network_info(nova402_network_id_t id)
+{
+    if ((unsigned)id == 0 || (unsigned)id >= NOVA402_NETWORK_ID_COUNT) {
+        return NULL;
+    }
+    return &g_networks[id].info;
+}
+
+const nova402_address_t *nova402_network_usdc(nova402_network_id_t id)
+{
+    if ((unsigned)id == 0 || (unsigned)id >= NOVA402_NETWORK_ID_COUNT || !g_networks[id].has_usdc_address) {
+        return NULL;
+    }
+    return &g_networks[id].usdc_address;
+}
@@ -0,0 +1,377 @@
+/**
+ * Nova402 C Library - nonce replay filter
+ *
+ * Lock-free open-addressing set of 32-byte nonces. A nonce is filed into
+ * the generation of its valid_before bucket (valid_before divided by the
+ * generation span); the generations form a ring, one per bucket of the
+ * accepted horizon.
+ *
+ * Every slot carries a 64-bit tag holding the bucket it was written for,
+ * so an expired generation never needs clearing: slots tagged with an
+ * older bucket read as empty and are reclaimed in place by CAS. A slot's
+ * bucket only ever grows, which keeps each probe chain intact for the
+ * life of its bucket.
+ *
+ * A slot is written like a seqlock: the claiming CAS publishes the tag
+ * without READY, the key words are stored, then READY is released.
+ * Readers load the key words, fence, and accept them only if the tag is
+ * unchanged. Each generation also counts its live nonces against the
+ * capacity, in a word tagged with its bucket like the slots.
+ *
+ * @file nonce_set.c
+ */
+
+#include "internal.h"
+#include "atomic.h"
+#include "stats.h"
+
+#include <string.h>
+
+#define DEFAULT_GENERATION_SECONDS 60
+#define DEFAULT_GENERATIONS 16
+#define MAX_PROBES 128
+
+/* Tag layout: bucket (high 32 bits) | hash bits | READY | USED */
+#define TAG_USED 1ULL
+#define TAG_READY 2ULL
+#define TAG_HASH_MASK 0xFFFFFFFCULL
+
+typedef struct {
+    uint64_t tag;
+    uint64_t key[4];
+} nonce_slot_t;
+
+/* Live nonces of one generation: bucket (high 32 bits) | count, padded to a line */
+typedef struct {
+    uint64_t word;
+    char pad[NOVA402_CACHE_LINE - sizeof(uint64_t)];
+} nonce_count_t;
+
+struct nova402_nonce_set {
+    uint64_t seed;
+    uint64_t span;
+    uint64_t generations;
+    uint64_t mask;        /* slots per generation - 1 */
+    uint64_t capacity;    /* live nonces per generation */
+    size_t memory_bytes;
+    nonce_slot_t *slots;  /* generations * (mask + 1) */
+    nonce_count_t *counts; /* one per generation */
+};
+
+static uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ULL;
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ULL;
+    x ^= x >> 32;
+    return x;
+}
+
+/* Seeded so that chosen nonces cannot build one long probe chain */
+static uint64_t nonce_hash(uint64_t seed, const uint64_t key[4])
+{
+    uint64_t h = seed;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        h = mix64(h ^ key[i]);
+    }
+    return h;
+}
+
+static int tag_is_free(uint64_t tag, uint32_t bucket)
+{
+    /* Wrap-safe "written for an older bucket" */
+    return tag == 0 || (int32_t)((uint32_t)(tag >> 32) - bucket) < 0;
+}
+
+/* Seqlock read: the key words count only if the slot still holds tag afterwards */
+static int key_matches(const nonce_slot_t *slot, const uint64_t key[4], uint64_t tag)
+{
+    uint64_t diff = 0;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        diff |= nova402_atomic_load_relaxed_u64(&slot->key[i]) ^ key[i];
+    }
+    nova402_atomic_fence_acquire();
+    return diff == 0 && nova402_atomic_load_relaxed_u64(&slot->tag) == tag;
+}
+
+/* Take one nonce of the generation's capacity for bucket; 0 if it is full */
+static int count_take(const nova402_nonce_set_t *set, nonce_count_t *count, uint32_t bucket)
+{
+    for (;;) {
+        uint64_t word = nova402_atomic_load_u64(&count->word), next;
+
+        if (tag_is_free(word, bucket)) {
+            next = ((uint64_t)bucket << 32) | 1;     /* first nonce since the bucket expired */
+        } else if ((uint32_t)(word >> 32) != bucket || (word & 0xFFFFFFFFULL) >= set->capacity) {
+            return 0;
+        } else {
+            next = word + 1;
+        }
+        if (nova402_atomic_cas_u64(&count->word, word, next)) {
+            return 1;
+        }
+    }
+}
+
+/* Give back a nonce taken by count_take() that was not inserted */
+static void count_give(nonce_count_t *count, uint32_t bucket)
+{
+    for (;;) {
+        uint64_t word = nova402_atomic_load_u64(&count->word);
+
+        if ((uint32_t)(word >> 32) != bucket || (word & 0xFFFFFFFFULL) == 0) {
+            return;   /* the generation moved on meanwhile */
+        }
+        if (nova402_atomic_cas_u64(&count->word, word, word - 1)) {
+            return;
+        }
+    }
+}
+
+/* Returns the ring index for valid_before, or -1 outside [now, horizon) */
+static int64_t generation_for(const nova402_nonce_set_t *set, uint64_t valid_before,
+                              uint64_t now, uint32_t *bucket, int *rc)
+{
+    uint64_t b = valid_before / set->span;
+    uint64_t current = now / set->span;
+
+    if (b < current) {
+        *rc = NOVA402_ERROR_EXPIRED;
+        return -1;
+    }
+    if (b - current >= set->generations) {
+        *rc = NOVA402_ERROR_CAPACITY;
+        return -1;
+    }
+    *bucket = (uint32_t)b;
+    return (int64_t)(b % set->generations);
+}
+
+static int probe_insert(nonce_slot_t *gen, uint64_t mask, uint64_t seed, const uint8_t *nonce,
+                        uint32_t bucket)
+{
+    uint64_t key[4], h, want, idx;
+    int probes = 0, i;
+
+    memcpy(key, nonce, NOVA402_NONCE_SIZE);
+    h = nonce_hash(seed, key);
+    want = ((uint64_t)bucket << 32) | ((h >> 32) & TAG_HASH_MASK) | TAG_USED;
+    idx = h & mask;
+
+    while (probes < MAX_PROBES) {
+        nonce_slot_t *slot = &gen[idx];
+        uint64_t tag = nova402_atomic_load_u64(&slot->tag);
+
+        if (tag_is_free(tag, bucket)) {
+            if (nova402_atomic_cas_u64(&slot->tag, tag, want)) {
+                for (i = 0; i < 4; i++) {
+                    nova402_atomic_store_relaxed_u64(&slot->key[i], key[i]);
+                }
+                nova402_atomic_store_u64(&slot->tag, want | TAG_READY);
+                return NOVA402_SUCCESS;
+            }
+            continue; /* lost the slot; look at it again */
+        }
+
+        if ((tag & ~TAG_READY) == want) {
+            if (!(tag & TAG_READY)) {
+                nova402_cpu_relax(); /* same hash being written */
+                continue;
+            }
+            if (key_matches(slot, key, tag)) {
+                return NOVA402_ERROR_NONCE_REUSED;
+            }
+        }
+
+        probes++;
+        idx = (idx + 1) & mask;
+    }
+
+    return NOVA402_ERROR_CAPACITY;
+}
+
+static bool probe_contains(const nonce_slot_t *gen, uint64_t mask, uint64_t seed,
+                           const uint8_t *nonce, uint32_t bucket)
+{
+    uint64_t key[4], h, want, idx;
+    int probes;
+
+    memcpy(key, nonce, NOVA402_NONCE_SIZE);
+    h = nonce_hash(seed, key);
+    want = ((uint64_t)bucket << 32) | ((h >> 32) & TAG_HASH_MASK) | TAG_USED | TAG_READY;
+    idx = h & mask;
+
+    for (probes = 0; probes < MAX_PROBES; probes++) {
+        const nonce_slot_t *slot = &gen[idx];
+        uint64_t tag = nova402_atomic_load_u64(&slot->tag);
+
+        if (tag_is_free(tag, bucket)) {
+            return false;
+        }
+        /* A slot still being written is reported once it is published */
+        if (tag == want && key_matches(slot, key, tag)) {
+            return true;
+        }
+        idx = (idx + 1) & mask;
+    }
+
+    return false;
+}
+
+static int set_insert(nova402_nonce_set_t *set, const uint8_t *nonce,
+                      uint64_t valid_before, uint64_t now)
+{
+    nonce_slot_t *slots;
+    int64_t gen;
+    uint32_t bucket;
+    int rc = NOVA402_SUCCESS;
+
+    gen = generation_for(set, valid_before, now, &bucket, &rc);
+    if (gen < 0) {
+        return rc;
+    }
+    slots = set->slots + (uint64_t)gen * (set->mask + 1);
+    if (!count_take(set, &set->counts[gen], bucket)) {
+        /* A full generation still reports replays as replays */
+        return probe_contains(slots, set->mask, set->seed, nonce, bucket) ?
+               NOVA402_ERROR_NONCE_REUSED : NOVA402_ERROR_CAPACITY;
+    }
+    rc = probe_insert(slots, set->mask, set->seed, nonce, bucket);
+    if (rc != NOVA402_SUCCESS) {
+        count_give(&set->counts[gen], bucket);
+    }
+    return rc;
+}
+
+nova402_nonce_set_t *nova402_nonce_set_create(
+    size_t capacity,
+    uint64_t generation_seconds,
+    size_t generations)
+{
+    nova402_nonce_set_t *set;
+    uint8_t seed[NOVA402_NONCE_SIZE];
+    uint64_t slots, total;
+
+    if (generation_seconds == 0) {
+        generation_seconds = DEFAULT_GENERATION_SECONDS;
+    }
+    if (generations == 0) {
+        generations = DEFAULT_GENERATIONS;
+    }
+    if (capacity == 0 || (uint64_t)capacity > 0xFFFFFFFFULL || generations > 0xFFFF) {
+        return NULL;
+    }
+
+    /* Keep the load factor at or below 3/4 */
+    for (slots = 16; slots * 3 < (uint64_t)capacity * 4; slots <<= 1) {
+    }
+    total = slots * generations;
+    if (total > SIZE_MAX / sizeof(nonce_slot_t)) {
+        return NULL;
+    }
+
+    set = nova402_calloc(1, sizeof(*set));
+    if (!set) {
+        return NULL;
+    }
+    set->slots = nova402_calloc((size_t)total, sizeof(nonce_slot_t));
+    set->counts = nova402_calloc(generations, sizeof(nonce_count_t));
+    if (!set->slots || !set->counts) {
+        nova402_nonce_set_destroy(set);
+        return NULL;
+    }
+    set->span = generation_seconds;
+    set->generations = generations;
+    set->mask = slots - 1;
+    set->capacity = capacity;
+    set->memory_bytes = sizeof(*set) + (size_t)total * sizeof(nonce_slot_t) +
+                        generations * sizeof(nonce_count_t);
+
+    if (nova402_generate_nonce(seed) == NOVA402_SUCCESS) {
+        memcpy(&set->seed, seed, sizeof(set->seed));
+    } else {
+        set->seed = mix64((uint64_t)(uintptr_t)set ^ nova402_timestamp());
+    }
+
+    return set;
+}
+
+void nova402_nonce_set_destroy(nova402_nonce_set_t *set)
+{
+    if (!set) {
+        return;
+    }
+    nova402_free(set->slots);
+    nova402_free(set->counts);
+    nova402_free(set);
+}
+
+int nova402_nonce_set_insert(
+    nova402_nonce_set_t *set,
+    const uint8_t *nonce,
+    uint64_t valid_after,
+    uint64_t valid_before)
+{
+    return nova402_nonce_set_insert_at(set, nonce, valid_after, valid_before, nova402_clock_now());
+}
+
+int nova402_nonce_set_insert_at(
+    nova402_nonce_set_t *set,
+    const uint8_t *nonce,
+    uint64_t valid_after,
+    uint64_t valid_before,
+    uint64_t now)
+{
+    int rc;
+
+    if (!set || !nonce) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (!nova402_validate_time_window_at(valid_after, valid_before, now)) {
+        return NOVA402_ERROR_EXPIRED;
+    }
+    rc = set_insert(set, nonce, valid_before, now);
+    if (rc == NOVA402_ERROR_NONCE_REUSED) {
+        NOVA402_STATS_COUNT(NOVA402_COUNTER_NONCE_REPLAYS, 1);
+    }
+    return rc;
+}
+
+bool nova402_nonce_set_contains(
+    const nova402_nonce_set_t *set,
+    const uint8_t *nonce,
+    uint64_t valid_before)
+{
+    return nova402_nonce_set_contains_at(set, nonce, valid_before, nova402_clock_now());
+}
+
+bool nova402_nonce_set_contains_at(
+    const nova402_nonce_set_t *set,
+    const uint8_t *nonce,
+    uint64_t valid_before,
+    uint64_t now)
+{
+    uint32_t bucket;
+    int64_t ring;
+    int rc;
+
+    if (!set || !nonce || !nova402_validate_not_expired_at(valid_before, now)) {
+        return false;
+    }
+    ring = generation_for(set, valid_before, now, &bucket, &rc);
+    if (ring < 0) {
+        return false;
+    }
+    return probe_contains(set->slots + (uint64_t)ring * (set->mask + 1), set->mask, set->seed,
+                          nonce, bucket);
+}
+
+size_t nova402_nonce_set_memory(const nova402_nonce_set_t *set)
+{
+    return set ? set->memory_bytes : 0;
+}
@@ -0,0 +1,251 @@
+/**
+ * Nova402 C Library - packed wire format
+ *
+ * Frame layout, all integers little-endian:
+ *
+ *   0     magic "NOVA402P"
+ *   8     u32 format version (NOVA402_PACKED_VERSION)
+ *   12    u32 record size (NOVA402_PACKED_RECORD_SIZE)
+ *   16    u64 record count
+ *   24    zero
+ *   32    records, back to back
+ *
+ * Record layout (nova402_packed_record_t):
+ *
+ *   0     nonce (32 bytes)
+ *   32    r (32 bytes)
+ *   64    s (32 bytes)
+ *   96    from (20 bytes)
+ *   116   to (20 bytes)
+ *   136   u64 value
+ *   144   u64 valid_after
+ *   152   u64 valid_before
+ *   160   v
+ *   161   network (nova402_network_id_t)
+ *   162   x402 version
+ *   163   zero (5 bytes)
+ *
+ * The header and the record size are multiples of 8, so in a frame that
+ * starts 8-byte aligned every integer field is aligned as well.
+ *
+ * @file packed.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+#define FRAME_MAGIC "NOVA402P"
+
+/* Records are cast straight out of the frame, so the struct must match the wire size */
+typedef char packed_record_size_check[sizeof(nova402_packed_record_t) == NOVA402_PACKED_RECORD_SIZE ? 1 : -1];
+
+static void store32_le(uint8_t *p, uint32_t v)
+{
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void store64_le(uint8_t *p, uint64_t v)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t load32_le(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t load64_le(const uint8_t *p)
+{
+    return (uint64_t)load32_le(p) | ((uint64_t)load32_le(p + 4) << 32);
+}
+
+size_t nova402_packed_frame_size(size_t count)
+{
+    if (count > ((size_t)-1 - NOVA402_PACKED_HEADER_SIZE) / NOVA402_PACKED_RECORD_SIZE) {
+        return 0;
+    }
+    return NOVA402_PACKED_HEADER_SIZE + count * NOVA402_PACKED_RECORD_SIZE;
+}
+
+int nova402_packed_frame_init(
+    uint8_t *frame,
+    size_t size,
+    size_t count,
+    nova402_packed_record_t **records)
+{
+    size_t needed = nova402_packed_frame_size(count);
+
+    if (!frame || !records || needed == 0) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (size < needed) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    memcpy(frame, FRAME_MAGIC, 8);
+    store32_le(frame + 8, NOVA402_PACKED_VERSION);
+    store32_le(frame + 12, NOVA402_PACKED_RECORD_SIZE);
+    store64_le(frame + 16, (uint64_t)count);
+    memset(frame + 24, 0, NOVA402_PACKED_HEADER_SIZE - 24);
+
+    *records = (nova402_packed_record_t *)(frame + NOVA402_PACKED_HEADER_SIZE);
+    return NOVA402_SUCCESS;
+}
+
+int nova402_packed_frame_open(
+    const uint8_t *frame,
+    size_t length,
+    const nova402_packed_record_t **records,
+    size_t *count)
+{
+    uint64_t n;
+
+    if (!frame || !records || !count) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (length < NOVA402_PACKED_HEADER_SIZE) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+    if (memcmp(frame, FRAME_MAGIC, 8) != 0) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (load32_le(frame + 8) != NOVA402_PACKED_VERSION ||
+        load32_le(frame + 12) != NOVA402_PACKED_RECORD_SIZE) {
+        return NOVA402_ERROR_UNSUPPORTED;
+    }
+
+    if (load64_le(frame + 24) != 0) {
+        return NOVA402_ERROR_UNSUPPORTED;   /* reserved for later versions */
+    }
+
+    n = load64_le(frame + 16);
+    if (n > ((size_t)-1 - NOVA402_PACKED_HEADER_SIZE) / NOVA402_PACKED_RECORD_SIZE) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (length < nova402_packed_frame_size((size_t)n)) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    *records = (const nova402_packed_record_t *)(frame + NOVA402_PACKED_HEADER_SIZE);
+    *count = (size_t)n;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_packed_load(
+    const nova402_packed_record_t *record,
+    nova402_network_id_t *network,
+    nova402_payment_data_t *payment,
+    nova402_signature_t *signature)
+{
+    uint8_t reserved = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(record->reserved); i++) {
+        reserved |= record->reserved[i];
+    }
+    if (reserved != 0 || record->network == NOVA402_NETWORK_ID_UNKNOWN ||
+        record->network >= NOVA402_NETWORK_ID_COUNT) {
+        return NOVA402_ERROR_INVALID_FIELD;
+    }
+
+    *network = (nova402_network_id_t)record->network;
+    payment->from = record->from;
+    payment->to = record->to;
+    payment->value = load64_le(record->value);
+    payment->valid_after = load64_le(record->valid_after);
+    payment->valid_before = load64_le(record->valid_before);
+    memcpy(payment->nonce, record->nonce, NOVA402_NONCE_SIZE);
+    memcpy(signature->r, record->r, 32);
+    memcpy(signature->s, record->s, 32);
+    signature->v = record->v;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_packed_write(nova402_packed_record_t *record, const nova402_payment_header_t *header)
+{
+    const nova402_payment_data_t *payment;
+    nova402_network_id_t network;
+
+    if (!record || !header) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    network = nova402_network_lookup(header->network, strlen(header->network));
+    if (network == NOVA402_NETWORK_ID_UNKNOWN || header->x402_version > UINT8_MAX) {
+        return NOVA402_ERROR_INVALID_FIELD;
+    }
+
+    payment = &header->payment;
+    memcpy(record->nonce, payment->nonce, NOVA402_NONCE_SIZE);
+    memcpy(record->r, header->signature.r, 32);
+    memcpy(record->s, header->signature.s, 32);
+    record->from = payment->from;
+    record->to = payment->to;
+    store64_le(record->value, payment->value);
+    store64_le(record->valid_after, payment->valid_after);
+    store64_le(record->valid_before, payment->valid_before);
+    record->v = header->signature.v;
+    record->network = (uint8_t)network;
+    record->x402_version = (uint8_t)header->x402_version;
+    memset(record->reserved, 0, sizeof(record->reserved));
+    return NOVA402_SUCCESS;
+}
+
+int nova402_packed_read(const nova402_packed_record_t *record, nova402_payment_header_t *header)
+{
+    nova402_network_id_t network;
+    const char *name;
+    int rc;
+
+    if (!record || !header) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    rc = nova402_packed_load(record, &network, &header->payment, &header->signature);
+    if (rc != NOVA402_SUCCESS) {
+        return rc;
+    }
+    header->x402_version = record->x402_version;
+    name = nova402_network_info(network)->network;
+    memset(header->network, 0, sizeof(header->network));
+    memcpy(header->network, name, strlen(name));
+    return NOVA402_SUCCESS;
+}
+
+int nova402_packed_encode(
+    const nova402_payment_header_t *headers,
+    size_t count,
+    uint8_t *frame,
+    size_t size,
+    size_t *written)
+{
+    nova402_packed_record_t *records;
+    size_t i;
+    int rc;
+
+    if ((!headers && count > 0) || !written) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    *written = nova402_packed_frame_size(count);
+    rc = nova402_packed_frame_init(frame, size, count, &records);
+    if (rc != NOVA402_SUCCESS) {
+        return rc;
+    }
+    for (i = 0; i < count; i++) {
+        rc = nova402_packed_write(&records[i], &headers[i]);
+        if (rc != NOVA402_SUCCESS) {
+            return rc;
+        }
+    }
+    return NOVA402_SUCCESS;
+}
@@ -0,0 +1,103 @@
+/**
+ * Nova402 C Library - parallel task execution
+ *
+ * Runs the tasks of a job either on a caller-supplied executor or on
+ * short-lived threads that pull task indices from a shared counter. The
+ * calling thread works too; if a thread cannot be started, the remaining
+ * threads simply pick up its share.
+ *
+ * @file parallel.c
+ */
+
+#include "internal.h"
+#include "atomic.h"
+#include "sync.h"
+
+#include <stdlib.h>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+/* Threads started by one nova402_parallel_run() call, caller included */
+#define MAX_THREADS 256
+
+typedef struct {
+    nova402_task_fn task;
+    void *arg;
+    uint64_t count;
+    volatile uint64_t next;
+} job_t;
+
+static void run_tasks(void *p)
+{
+    job_t *job = (job_t *)p;
+    uint64_t index;
+
+    while ((index = nova402_atomic_add_u64(&job->next, 1) - 1) < job->count) {
+        job->task(job->arg, (size_t)index);
+    }
+}
+
+size_t nova402_cpu_count(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (size_t)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return n > 0 ? (size_t)n : 1;
+#endif
+}
+
+void nova402_parallel_run(
+    const nova402_executor_t *executor,
+    size_t threads,
+    nova402_task_fn task,
+    void *arg,
+    size_t count)
+{
+    nova402_thread_t handles[MAX_THREADS - 1];
+    nova402_thread_start_t start;
+    job_t job;
+    size_t started = 0, i;
+
+    if (count == 0) {
+        return;
+    }
+    if (executor && executor->run) {
+        executor->run(executor->context, task, arg, count);
+        return;
+    }
+
+    if (threads == 0) {
+        threads = nova402_cpu_count();
+    }
+    if (threads > count) {
+        threads = count;
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    job.task = task;
+    job.arg = arg;
+    job.count = count;
+    job.next = 0;
+    start.fn = run_tasks;
+    start.arg = &job;
+
+    for (i = 1; i < threads; i++) {
+        if (nova402_thread_create(&handles[started], &start) != 0) {
+            break;
+        }
+        started++;
+    }
+    run_tasks(&job);
+    for (i = 0; i < started; i++) {
+        nova402_thread_join(handles[i]);
+    }
+}
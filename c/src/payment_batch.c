@@ -0,0 +1,278 @@
+/**
+ * Nova402 C Library - struct-of-arrays payment batches
+ *
+ * A batch is one allocation holding a column per payment field. The
+ * screen walks the integer and network columns in blocks of
+ * NOVA402_SCREEN_BLOCK rows through the dispatched kernel, then compares
+ * recipients only on the rows that are still set.
+ *
+ * @file payment_batch.c
+ */
+
+#include "internal.h"
+
+#include <limits.h>
+#include <string.h>
+
+#define ROUND_UP(n) (((n) + NOVA402_CACHE_LINE - 1) & ~(size_t)(NOVA402_CACHE_LINE - 1))
+
+void nova402_screen_blocks_portable(uint8_t *out, const uint64_t *value, const uint64_t *valid_after,
+                                    const uint64_t *valid_before, const uint8_t *network, size_t blocks,
+                                    const nova402_screen_t *screen)
+{
+    size_t block;
+    unsigned j;
+
+    for (block = 0; block < blocks; block++) {
+        unsigned bits = 0;
+
+        for (j = 0; j < NOVA402_SCREEN_BLOCK; j++) {
+            unsigned pass = (network[j] == screen->network) & (value[j] >= screen->min_value) &
+                            (valid_after[j] <= screen->now) & (screen->now < valid_before[j]);
+            bits |= pass << j;
+        }
+        out[block] = (uint8_t)bits;
+        value += NOVA402_SCREEN_BLOCK;
+        valid_after += NOVA402_SCREEN_BLOCK;
+        valid_before += NOVA402_SCREEN_BLOCK;
+        network += NOVA402_SCREEN_BLOCK;
+    }
+}
+
+nova402_payment_batch_t *nova402_payment_batch_create(size_t capacity)
+{
+    nova402_payment_batch_t *batch;
+    size_t words, bytes, addresses, nonces, signatures;
+    uint8_t *p;
+
+    if (capacity == 0 || capacity > INT_MAX) {
+        return NULL;
+    }
+
+    words = ROUND_UP(capacity * sizeof(uint64_t));
+    bytes = ROUND_UP(capacity);
+    addresses = ROUND_UP(capacity * sizeof(nova402_address_t));
+    nonces = ROUND_UP(capacity * NOVA402_NONCE_SIZE);
+    signatures = ROUND_UP(capacity * sizeof(nova402_signature_t));
+
+    batch = nova402_calloc(1, sizeof(*batch));
+    if (!batch) {
+        return NULL;
+    }
+    batch->block = nova402_malloc(3 * words + bytes + 2 * addresses + nonces + signatures +
+                                  NOVA402_CACHE_LINE - 1);
+    if (!batch->block) {
+        nova402_free(batch);
+        return NULL;
+    }
+
+    p = (uint8_t *)(((uintptr_t)batch->block + NOVA402_CACHE_LINE - 1) &
+                    ~(uintptr_t)(NOVA402_CACHE_LINE - 1));
+    batch->value = (uint64_t *)(void *)p;
+    p += words;
+    batch->valid_after = (uint64_t *)(void *)p;
+    p += words;
+    batch->valid_before = (uint64_t *)(void *)p;
+    p += words;
+    batch->network = p;
+    p += bytes;
+    batch->from = (nova402_address_t *)(void *)p;
+    p += addresses;
+    batch->to = (nova402_address_t *)(void *)p;
+    p += addresses;
+    batch->nonce = (uint8_t (*)[NOVA402_NONCE_SIZE])(void *)p;
+    p += nonces;
+    batch->signature = (nova402_signature_t *)(void *)p;
+    batch->capacity = capacity;
+    return batch;
+}
+
+void nova402_payment_batch_destroy(nova402_payment_batch_t *batch)
+{
+    if (batch) {
+        nova402_free(batch->block);
+        nova402_free(batch);
+    }
+}
+
+static void store_row(
+    nova402_payment_batch_t *batch,
+    size_t i,
+    nova402_network_id_t network,
+    const nova402_payment_data_t *payment,
+    const nova402_signature_t *signature)
+{
+    batch->value[i] = payment->value;
+    batch->valid_after[i] = payment->valid_after;
+    batch->valid_before[i] = payment->valid_before;
+    batch->network[i] = (uint8_t)network;
+    batch->from[i] = payment->from;
+    batch->to[i] = payment->to;
+    memcpy(batch->nonce[i], payment->nonce, NOVA402_NONCE_SIZE);
+    if (signature) {
+        batch->signature[i] = *signature;
+    } else {
+        memset(&batch->signature[i], 0, sizeof(batch->signature[i]));
+    }
+}
+
+static int check_load(const nova402_payment_batch_t *batch, const void *items, size_t count)
+{
+    if (!batch || (!items && count > 0)) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    return count > batch->capacity ? NOVA402_ERROR_BUFFER_TOO_SMALL : NOVA402_SUCCESS;
+}
+
+int nova402_payment_batch_load_headers(
+    nova402_payment_batch_t *batch,
+    const nova402_payment_header_t *headers,
+    size_t count)
+{
+    size_t i;
+    int rc = check_load(batch, headers, count);
+
+    if (rc != NOVA402_SUCCESS) {
+        return rc;
+    }
+    for (i = 0; i < count; i++) {
+        const nova402_payment_header_t *header = &headers[i];
+
+        store_row(batch, i, nova402_network_lookup(header->network, strlen(header->network)),
+                  &header->payment, &header->signature);
+    }
+    batch->count = count;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_payment_batch_load_payments(
+    nova402_payment_batch_t *batch,
+    nova402_network_id_t network,
+    const nova402_payment_data_t *payments,
+    const nova402_signature_t *signatures,
+    size_t count)
+{
+    size_t i;
+    int rc = check_load(batch, payments, count);
+
+    if (rc != NOVA402_SUCCESS) {
+        return rc;
+    }
+    if ((unsigned)network >= NOVA402_NETWORK_ID_COUNT) {
+        network = NOVA402_NETWORK_ID_UNKNOWN;
+    }
+    for (i = 0; i < count; i++) {
+        store_row(batch, i, network, &payments[i], signatures ? &signatures[i] : NULL);
+    }
+    batch->count = count;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_payment_batch_load_packed(
+    nova402_payment_batch_t *batch,
+    const nova402_packed_record_t *records,
+    size_t count)
+{
+    size_t i;
+    int rc = check_load(batch, records, count);
+
+    if (rc != NOVA402_SUCCESS) {
+        return rc;
+    }
+    for (i = 0; i < count; i++) {
+        nova402_network_id_t network;
+        nova402_payment_data_t payment;
+        nova402_signature_t signature;
+
+        if (nova402_packed_load(&records[i], &network, &payment, &signature) != NOVA402_SUCCESS) {
+            network = NOVA402_NETWORK_ID_UNKNOWN;
+        }
+        store_row(batch, i, network, &payment, &signature);
+    }
+    batch->count = count;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_payment_batch_get(
+    const nova402_payment_batch_t *batch,
+    size_t index,
+    nova402_payment_data_t *payment,
+    nova402_signature_t *signature)
+{
+    if (!batch || !payment || index >= batch->count) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    payment->from = batch->from[index];
+    payment->to = batch->to[index];
+    payment->value = batch->value[index];
+    payment->valid_after = batch->valid_after[index];
+    payment->valid_before = batch->valid_before[index];
+    memcpy(payment->nonce, batch->nonce[index], NOVA402_NONCE_SIZE);
+    if (signature) {
+        *signature = batch->signature[index];
+    }
+    return NOVA402_SUCCESS;
+}
+
+int nova402_payment_batch_screen(
+    const nova402_payment_batch_t *batch,
+    const nova402_payment_requirements_t *requirements,
+    uint64_t now,
+    uint8_t *results)
+{
+    nova402_screen_t screen;
+    size_t count, blocks, tail, i;
+    int passed = 0;
+
+    if (!batch || !requirements || !results || batch->count > batch->capacity) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    count = batch->count;
+    if (count == 0) {
+        return 0;
+    }
+    if (requirements->network == NOVA402_NETWORK_ID_UNKNOWN) {
+        memset(results, 0, (count + 7) / 8);
+        return 0;
+    }
+
+    screen.min_value = requirements->max_amount_required;
+    screen.now = now;
+    screen.network = (uint8_t)requirements->network;
+
+    blocks = count / NOVA402_SCREEN_BLOCK;
+    nova402_dispatch()->screen_blocks(results, batch->value, batch->valid_after, batch->valid_before,
+                                      batch->network, blocks, &screen);
+
+    /* Run the last partial block on copies; the padding rows never pass */
+    tail = count - blocks * NOVA402_SCREEN_BLOCK;
+    if (tail > 0) {
+        uint64_t value[NOVA402_SCREEN_BLOCK] = { 0 };
+        uint64_t valid_after[NOVA402_SCREEN_BLOCK] = { 0 };
+        uint64_t valid_before[NOVA402_SCREEN_BLOCK] = { 0 };
+        uint8_t network[NOVA402_SCREEN_BLOCK] = { 0 };
+        size_t first = blocks * NOVA402_SCREEN_BLOCK;
+
+        memcpy(value, batch->value + first, tail * sizeof(uint64_t));
+        memcpy(valid_after, batch->valid_after + first, tail * sizeof(uint64_t));
+        memcpy(valid_before, batch->valid_before + first, tail * sizeof(uint64_t));
+        memcpy(network, batch->network + first, tail);
+        nova402_screen_blocks_portable(&results[blocks], value, valid_after, valid_before, network, 1,
+                                       &screen);
+    }
+
+    for (i = 0; i < count; i++) {
+        uint8_t bit = (uint8_t)(1u << (i & 7));
+
+        if (!(results[i >> 3] & bit)) {
+            continue;
+        }
+        if (memcmp(batch->to[i].bytes, requirements->pay_to.bytes, NOVA402_ADDRESS_SIZE) == 0) {
+            passed++;
+        } else {
+            results[i >> 3] &= (uint8_t)~bit;
+        }
+    }
+    return passed;
+}
@@ -0,0 +1,663 @@
+/**
+ * Nova402 C Library - X-PAYMENT header parser
+ *
+ * Decodes the base64 header into a stack buffer and walks the JSON once,
+ * filling the output struct as each known key is met. Hex and base64 go
+ * through the dispatched block decoders; nothing is allocated.
+ *
+ * @file payment_header.c
+ */
+
+#include "internal.h"
+#include "stats.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HAVE_SSE2_SCAN 1
+#endif
+
+#define MAX_DEPTH 32
+#define JSON_BUFFER_SIZE (NOVA402_MAX_PAYMENT_HEADER / 4 * 3 + 8)
+
+/* Fields seen so far, for duplicate and missing-field checks */
+#define F_VERSION (1u << 0)
+#define F_SCHEME (1u << 1)
+#define F_NETWORK (1u << 2)
+#define F_PAYLOAD (1u << 3)
+#define F_AUTHORIZATION (1u << 4)
+#define F_SIGNATURE (1u << 5)
+#define F_FROM (1u << 6)
+#define F_TO (1u << 7)
+#define F_VALUE (1u << 8)
+#define F_VALID_AFTER (1u << 9)
+#define F_VALID_BEFORE (1u << 10)
+#define F_NONCE (1u << 11)
+#define F_V (1u << 12)
+#define F_R (1u << 13)
+#define F_S (1u << 14)
+
+#define F_REQUIRED (F_VERSION | F_SCHEME | F_NETWORK | F_PAYLOAD | F_AUTHORIZATION | F_FROM | \
+                    F_TO | F_VALUE | F_VALID_AFTER | F_VALID_BEFORE | F_NONCE)
+#define F_VRS (F_V | F_R | F_S)
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+} cursor_t;
+
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+    int escaped;
+} span_t;
+
+static void skip_ws(cursor_t *c)
+{
+    while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r')) {
+        c->p++;
+    }
+}
+
+static int expect(cursor_t *c, uint8_t ch)
+{
+    skip_ws(c);
+    if (c->p >= c->end || *c->p != ch) {
+        return NOVA402_ERROR_JSON;
+    }
+    c->p++;
+    return NOVA402_SUCCESS;
+}
+
+static int is_hex_digit(uint8_t ch)
+{
+    return (ch >= '0' && ch <= '9') || ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'f');
+}
+
+/* Advance over string bytes that need no attention: not '"', '\\' or a control */
+static const uint8_t *scan_plain(const uint8_t *p, const uint8_t *end)
+{
+#if defined(HAVE_SSE2_SCAN)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(const void *)p);
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        unsigned mask = (unsigned)_mm_movemask_epi8(special);
+
+        if (mask) {
+            while (!(mask & 1)) {
+                mask >>= 1;
+                p++;
+            }
+            return p;
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\' && *p >= 0x20) {
+        p++;
+    }
+    return p;
+}
+
+static int parse_string(cursor_t *c, span_t *s)
+{
+    int rc = expect(c, '"');
+
+    if (rc != NOVA402_SUCCESS) {
+        return rc;
+    }
+    s->data = c->p;
+    s->escaped = 0;
+
+    while ((c->p = scan_plain(c->p, c->end)) < c->end) {
+        uint8_t ch = *c->p;
+
+        if (ch == '"') {
+            s->length = (size_t)(c->p - s->data);
+            c->p++;
+            return NOVA402_SUCCESS;
+        }
+        if (ch < 0x20) {
+            return NOVA402_ERROR_JSON;
+        }
+        if (ch == '\\') {
+            s->escaped = 1;
+            if (++c->p >= c->end) {
+                return NOVA402_ERROR_JSON;
+            }
+            ch = *c->p;
+            if (ch == 'u') {
+                int i;
+                if (c->end - c->p < 5) {
+                    return NOVA402_ERROR_JSON;
+                }
+                for (i = 1; i <= 4; i++) {
+                    if (!is_hex_digit(c->p[i])) {
+                        return NOVA402_ERROR_JSON;
+                    }
+                }
+                c->p += 4;
+            } else if (!strchr("\"\\/bfnrt", ch)) {
+                return NOVA402_ERROR_JSON;
+            }
+        }
+        c->p++;
+    }
+    return NOVA402_ERROR_JSON;
+}
+
+/* Scan a JSON number; *value is set when it is a plain non-negative integer */
+static int parse_number(cursor_t *c, uint64_t *value, int *integer)
+{
+    uint64_t v = 0;
+    int overflow = 0;
+
+    skip_ws(c);
+    *integer = 1;
+
+    if (c->p < c->end && *c->p == '-') {
+        *integer = 0;
+        c->p++;
+    }
+    if (c->p >= c->end || *c->p < '0' || *c->p > '9') {
+        return NOVA402_ERROR_JSON;
+    }
+    if (*c->p == '0') {
+        c->p++;
+    } else {
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+            uint64_t digit = (uint64_t)(*c->p - '0');
+            if (v > (UINT64_MAX - digit) / 10) {
+                overflow = 1;
+            }
+            v = v * 10 + digit;
+            c->p++;
+        }
+    }
+    if (c->p < c->end && *c->p == '.') {
+        *integer = 0;
+        c->p++;
+        if (c->p >= c->end || *c->p < '0' || *c->p > '9') {
+            return NOVA402_ERROR_JSON;
+        }
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+            c->p++;
+        }
+    }
+    if (c->p < c->end && (*c->p == 'e' || *c->p == 'E')) {
+        *integer = 0;
+        c->p++;
+        if (c->p < c->end && (*c->p == '+' || *c->p == '-')) {
+            c->p++;
+        }
+        if (c->p >= c->end || *c->p < '0' || *c->p > '9') {
+            return NOVA402_ERROR_JSON;
+        }
+        while (c->p < c->end && *c->p >= '0' && *c->p <= '9') {
+            c->p++;
+        }
+    }
+
+    if (overflow) {
+        *integer = 0;
+    }
+    *value = v;
+    return NOVA402_SUCCESS;
+}
+
+static int skip_literal(cursor_t *c, const char *word)
+{
+    size_t n = strlen(word);
+
+    if ((size_t)(c->end - c->p) < n || memcmp(c->p, word, n) != 0) {
+        return NOVA402_ERROR_JSON;
+    }
+    c->p += n;
+    return NOVA402_SUCCESS;
+}
+
+static int skip_value(cursor_t *c, int depth)
+{
+    span_t s;
+    uint64_t v;
+    int integer, rc;
+
+    skip_ws(c);
+    if (c->p >= c->end) {
+        return NOVA402_ERROR_JSON;
+    }
+
+    switch (*c->p) {
+    case '"':
+        return parse_string(c, &s);
+    case 't':
+        return skip_literal(c, "true");
+    case 'f':
+        return skip_literal(c, "false");
+    case 'n':
+        return skip_literal(c, "null");
+    case '{':
+    case '[': {
+        uint8_t close = (*c->p == '{') ? '}' : ']';
+        int object = (close == '}');
+
+        if (depth >= MAX_DEPTH) {
+            return NOVA402_ERROR_JSON;
+        }
+        c->p++;
+        skip_ws(c);
+        if (c->p < c->end && *c->p == close) {
+            c->p++;
+            return NOVA402_SUCCESS;
+        }
+        for (;;) {
+            if (object) {
+                if ((rc = parse_string(c, &s)) != NOVA402_SUCCESS ||
+                    (rc = expect(c, ':')) != NOVA402_SUCCESS) {
+                    return rc;
+                }
+            }
+            if ((rc = skip_value(c, depth + 1)) != NOVA402_SUCCESS) {
+                return rc;
+            }
+            skip_ws(c);
+            if (c->p >= c->end) {
+                return NOVA402_ERROR_JSON;
+            }
+            if (*c->p == close) {
+                c->p++;
+                return NOVA402_SUCCESS;
+            }
+            if (*c->p != ',') {
+                return NOVA402_ERROR_JSON;
+            }
+            c->p++;
+        }
+    }
+    default:
+        return parse_number(c, &v, &integer);
+    }
+}
+
+/* A known key holds the wrong kind of value: JSON error if it is not even valid */
+static int wrong_type(cursor_t *c, int depth)
+{
+    int rc = skip_value(c, depth);
+    return rc == NOVA402_SUCCESS ? NOVA402_ERROR_INVALID_FIELD : rc;
+}
+
+static int peek(cursor_t *c)
+{
+    skip_ws(c);
+    return c->p < c->end ? *c->p : -1;
+}
+
+/* Iterate an object: returns 1 with the next key, 0 at '}', or an error */
+static int next_key(cursor_t *c, int *first, span_t *key)
+{
+    int rc;
+
+    skip_ws(c);
+    if (c->p < c->end && *c->p == '}') {
+        c->p++;
+        return 0;
+    }
+    if (!*first) {
+        if ((rc = expect(c, ',')) != NOVA402_SUCCESS) {
+            return rc;
+        }
+    }
+    *first = 0;
+    if ((rc = parse_string(c, key)) != NOVA402_SUCCESS || (rc = expect(c, ':')) != NOVA402_SUCCESS) {
+        return rc;
+    }
+    return 1;
+}
+
+typedef struct {
+    const char *name;
+    uint32_t field;
+} schema_key_t;
+
+static const schema_key_t DOCUMENT_KEYS[] = {
+    { "x402Version", F_VERSION },
+    { "scheme", F_SCHEME },
+    { "network", F_NETWORK },
+    { "payload", F_PAYLOAD },
+    { NULL, 0 }
+};
+
+static const schema_key_t PAYLOAD_KEYS[] = {
+    { "authorization", F_AUTHORIZATION },
+    { "signature", F_SIGNATURE },
+    { NULL, 0 }
+};
+
+static const schema_key_t AUTHORIZATION_KEYS[] = {
+    { "from", F_FROM },
+    { "to", F_TO },
+    { "value", F_VALUE },
+    { "validAfter", F_VALID_AFTER },
+    { "validBefore", F_VALID_BEFORE },
+    { "nonce", F_NONCE },
+    { "v", F_V },
+    { "r", F_R },
+    { "s", F_S },
+    { NULL, 0 }
+};
+
+/* Set *field to the bit of a schema key (0 outside the schema); repeats are rejected */
+static int claim_field(const schema_key_t *keys, const span_t *key, uint32_t *seen,
+                       uint32_t *field)
+{
+    *field = 0;
+    if (key->escaped) {
+        return NOVA402_SUCCESS;
+    }
+    for (; keys->name; keys++) {
+        if (strlen(keys->name) == key->length && memcmp(keys->name, key->data, key->length) == 0) {
+            if (*seen & keys->field) {
+                return NOVA402_ERROR_INVALID_FIELD;
+            }
+            *seen |= keys->field;
+            *field = keys->field;
+            break;
+        }
+    }
+    return NOVA402_SUCCESS;
+}
+
+/* Integer as a JSON number or a decimal string */
+static int read_uint(cursor_t *c, int depth, uint64_t max, uint64_t *out)
+{
+    uint64_t v = 0;
+    int integer, rc;
+
+    if (peek(c) == '"') {
+        span_t s;
+        size_t i;
+
+        if ((rc = parse_string(c, &s)) != NOVA402_SUCCESS) {
+            return rc;
+        }
+        if (s.length == 0 || s.length > 20) {
+            return NOVA402_ERROR_INVALID_FIELD;
+        }
+        for (i = 0; i < s.length; i++) {
+            uint64_t digit = (uint64_t)(s.data[i] - '0');
+            if (s.data[i] < '0' || s.data[i] > '9' || v > (UINT64_MAX - digit) / 10) {
+                return NOVA402_ERROR_INVALID_FIELD;
+            }
+            v = v * 10 + digit;
+        }
+    } else if (peek(c) == '-' || (peek(c) >= '0' && peek(c) <= '9')) {
+        if ((rc = parse_number(c, &v, &integer)) != NOVA402_SUCCESS) {
+            return rc;
+        }
+        if (!integer) {
+            return NOVA402_ERROR_INVALID_FIELD;
+        }
+    } else {
+        return wrong_type(c, depth);
+    }
+
+    if (v > max) {
+        return NOVA402_ERROR_INVALID_FIELD;
+    }
+    *out = v;
+    return NOVA402_SUCCESS;
+}
+
+/* "0x" followed by exactly 2 * length hex digits */
+static int read_hex(cursor_t *c, int depth, uint8_t *out, size_t length)
+{
+    span_t s;
+    int rc;
+
+    if (peek(c) != '"') {
+        return wrong_type(c, depth);
+    }
+    if ((rc = parse_string(c, &s)) != NOVA402_SUCCESS) {
+        return rc;
+    }
+    if (s.length != 2 + 2 * length || s.data[0] != '0' || (s.data[1] | 0x20) != 'x' ||
+        nova402_hex_decode((const char *)s.data + 2, out, length) != 0) {
+        return NOVA402_ERROR_INVALID_FIELD;
+    }
+    return NOVA402_SUCCESS;
+}
+
+static int read_string(cursor_t *c, int depth, span_t *s)
+{
+    int rc;
+
+    if (peek(c) != '"') {
+        return wrong_type(c, depth);
+    }
+    if ((rc = parse_string(c, s)) != NOVA402_SUCCESS) {
+        return rc;
+    }
+    return s->escaped ? NOVA402_ERROR_INVALID_FIELD : NOVA402_SUCCESS;
+}
+
+static int parse_authorization(cursor_t *c, uint32_t *seen, nova402_payment_header_t *out)
+{
+    nova402_payment_data_t *pay = &out->payment;
+    uint32_t field;
+    uint64_t v = 0;
+    span_t key;
+    int first = 1, rc;
+
+    if (peek(c) != '{') {
+        return wrong_type(c, 2);
+    }
+    c->p++;
+
+    while ((rc = next_key(c, &first, &key)) == 1) {
+        if ((rc = claim_field(AUTHORIZATION_KEYS, &key, seen, &field)) != NOVA402_SUCCESS) {
+            return rc;
+        }
+        switch (field) {
+        case F_FROM:
+            rc = read_hex(c, 3, pay->from.bytes, NOVA402_ADDRESS_SIZE);
+            break;
+        case F_TO:
+            rc = read_hex(c, 3, pay->to.bytes, NOVA402_ADDRESS_SIZE);
+            break;
+        case F_VALUE:
+            rc = read_uint(c, 3, UINT64_MAX, &pay->value);
+            break;
+        case F_VALID_AFTER:
+            rc = read_uint(c, 3, UINT64_MAX, &pay->valid_after);
+            break;
+        case F_VALID_BEFORE:
+            rc = read_uint(c, 3, UINT64_MAX, &pay->valid_before);
+            break;
+        case F_NONCE:
+            rc = read_hex(c, 3, pay->nonce, NOVA402_NONCE_SIZE);
+            break;
+        case F_V:
+            rc = read_uint(c, 3, UINT8_MAX, &v);
+            out->signature.v = (uint8_t)v;
+            break;
+        case F_R:
+            rc = read_hex(c, 3, out->signature.r, 32);
+            break;
+        case F_S:
+            rc = read_hex(c, 3, out->signature.s, 32);
+            break;
+        default:
+            rc = skip_value(c, 3);
+            break;
+        }
+        if (rc != NOVA402_SUCCESS) {
+            return rc;
+        }
+    }
+    return rc;
+}
+
+static int parse_payload(cursor_t *c, uint32_t *seen, nova402_payment_header_t *out)
+{
+    uint8_t sig[NOVA402_SIGNATURE_SIZE];
+    uint32_t field;
+    span_t key;
+    int first = 1, rc;
+
+    if (peek(c) != '{') {
+        return wrong_type(c, 1);
+    }
+    c->p++;
+
+    while ((rc = next_key(c, &first, &key)) == 1) {
+        if ((rc = claim_field(PAYLOAD_KEYS, &key, seen, &field)) != NOVA402_SUCCESS) {
+            return rc;
+        }
+        switch (field) {
+        case F_AUTHORIZATION:
+            rc = parse_authorization(c, seen, out);
+            break;
+        case F_SIGNATURE:
+            rc = read_hex(c, 2, sig, sizeof(sig));
+            if (rc == NOVA402_SUCCESS) {
+                memcpy(out->signature.r, sig, 32);
+                memcpy(out->signature.s, sig + 32, 32);
+                out->signature.v = sig[64];
+            }
+            break;
+        default:
+            rc = skip_value(c, 2);
+            break;
+        }
+        if (rc != NOVA402_SUCCESS) {
+            return rc;
+        }
+    }
+    return rc;
+}
+
+static int parse_document(cursor_t *c, nova402_payment_header_t *out)
+{
+    uint32_t seen = 0, field;
+    uint64_t v = 0;
+    span_t key, s;
+    int first = 1, rc;
+
+    if ((rc = expect(c, '{')) != NOVA402_SUCCESS) {
+        return rc;
+    }
+
+    while ((rc = next_key(c, &first, &key)) == 1) {
+        if ((rc = claim_field(DOCUMENT_KEYS, &key, &seen, &field)) != NOVA402_SUCCESS) {
+            return rc;
+        }
+        switch (field) {
+        case F_VERSION:
+            rc = read_uint(c, 1, UINT32_MAX, &v);
+            if (rc == NOVA402_SUCCESS && v != 1) {
+                rc = NOVA402_ERROR_UNSUPPORTED;
+            }
+            out->x402_version = (uint32_t)v;
+            break;
+        case F_SCHEME:
+            rc = read_string(c, 1, &s);
+            if (rc == NOVA402_SUCCESS && !(s.length == 5 && memcmp(s.data, "exact", 5) == 0)) {
+                rc = NOVA402_ERROR_UNSUPPORTED;
+            }
+            break;
+        case F_NETWORK:
+            rc = read_string(c, 1, &s);
+            if (rc == NOVA402_SUCCESS && (s.length == 0 || s.length >= sizeof(out->network))) {
+                rc = NOVA402_ERROR_INVALID_FIELD;
+            }
+            if (rc == NOVA402_SUCCESS) {
+                memcpy(out->network, s.data, s.length);
+                out->network[s.length] = '\0';
+            }
+            break;
+        case F_PAYLOAD:
+            rc = parse_payload(c, &seen, out);
+            break;
+        default:
+            rc = skip_value(c, 1);
+            break;
+        }
+        if (rc != NOVA402_SUCCESS) {
+            return rc;
+        }
+    }
+    if (rc != NOVA402_SUCCESS) {
+        return rc;
+    }
+
+    skip_ws(c);
+    if (c->p != c->end) {
+        return NOVA402_ERROR_JSON;
+    }
+    if ((seen & F_REQUIRED) != F_REQUIRED) {
+        return NOVA402_ERROR_MISSING_FIELD;
+    }
+
+    /* Exactly one of payload.signature and authorization {v, r, s} */
+    if (seen & F_SIGNATURE) {
+        return (seen & F_VRS) ? NOVA402_ERROR_INVALID_FIELD : NOVA402_SUCCESS;
+    }
+    return (seen & F_VRS) == F_VRS ? NOVA402_SUCCESS : NOVA402_ERROR_MISSING_FIELD;
+}
+
+static int parse_payment_header(
+    const char *header,
+    size_t length,
+    nova402_payment_header_t *out)
+{
+    uint8_t json[JSON_BUFFER_SIZE];
+    size_t json_length;
+    cursor_t c;
+    int rc;
+
+    if (!header || !out) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    memset(out, 0, sizeof(*out));
+
+    /* Optional whitespace around an HTTP header value */
+    while (length > 0 && (header[0] == ' ' || header[0] == '\t')) {
+        header++;
+        length--;
+    }
+    while (length > 0 && (header[length - 1] == ' ' || header[length - 1] == '\t')) {
+        length--;
+    }
+    if (length > NOVA402_MAX_PAYMENT_HEADER) {
+        return NOVA402_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    rc = nova402_base64_decode(header, length, json, sizeof(json), &json_length);
+    if (rc != NOVA402_SUCCESS) {
+        return NOVA402_ERROR_BASE64;
+    }
+
+    c.p = json;
+    c.end = json + json_length;
+    return parse_document(&c, out);
+}
+
+int nova402_parse_payment_header(
+    const char *header,
+    size_t length,
+    nova402_payment_header_t *out)
+{
+    int rc;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_PARSE_PAYMENT_HEADER);
+
+    rc = parse_payment_header(header, length, out);
+    NOVA402_STATS_END(1, rc != NOVA402_SUCCESS);
+    return rc;
+}
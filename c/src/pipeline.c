@@ -0,0 +1,310 @@
+/**
+ * Nova402 C Library - asynchronous verification pipeline
+ *
+ * Submissions are copied into a bounded ring. Pool threads, each with its
+ * own nova402_worker_t, take up to max_batch requests at a time from the
+ * head of the ring: at once when a full batch is waiting, otherwise when
+ * the oldest request has waited max_linger_us. Whichever thread is idle
+ * takes the next batch, so a slow batch on one core never holds up the
+ * queue. Results go to a second ring that nova402_verify_poll() drains
+ * without blocking.
+ *
+ * Both rings hold `capacity` entries and submissions are refused while
+ * `capacity` requests are outstanding (submitted but not yet polled), so
+ * neither ring can overflow.
+ *
+ * @file pipeline.c
+ */
+
+#include "internal.h"
+#include "sync.h"
+
+#include <string.h>
+
+#define DEFAULT_MAX_BATCH 64
+#define DEFAULT_LINGER_US 200
+#define DEFAULT_CAPACITY 4096
+#define MAX_THREADS 256
+
+typedef struct {
+    nova402_payment_header_t header;
+    uint64_t tag;
+    uint64_t submitted_us;
+} pipeline_request_t;
+
+typedef struct {
+    nova402_pipeline_t *pipeline;
+    nova402_worker_t *worker;
+    nova402_thread_t handle;
+    nova402_thread_start_t start;
+    int started;
+    nova402_payment_header_t *headers;  /* max_batch */
+    uint64_t *tags;                     /* max_batch */
+    uint8_t *results;                   /* (max_batch + 7) / 8 */
+} pipeline_thread_t;
+
+struct nova402_pipeline {
+    nova402_mutex_t lock;
+    nova402_cond_t work;                /* requests queued, or stopping */
+    pipeline_request_t *requests;
+    nova402_verify_completion_t *completions;
+    uint64_t request_head, request_tail;
+    uint64_t completion_head, completion_tail;
+    size_t outstanding;
+    size_t capacity;
+    size_t max_batch;
+    uint64_t linger_us;
+    int stopping;
+    void (*notify)(void *context);
+    void *notify_context;
+    pipeline_thread_t *threads;
+    size_t thread_count;
+};
+
+/* Pool thread: wait for a batch, verify it, publish the results */
+static void pipeline_run(void *arg)
+{
+    pipeline_thread_t *self = (pipeline_thread_t *)arg;
+    nova402_pipeline_t *p = self->pipeline;
+
+    nova402_mutex_lock(&p->lock);
+    for (;;) {
+        uint64_t queued = p->request_tail - p->request_head;
+        size_t n, i;
+
+        if (queued == 0) {
+            if (p->stopping) {
+                break;
+            }
+            nova402_cond_wait(&p->work, &p->lock);
+            continue;
+        }
+        if (queued < p->max_batch && !p->stopping) {
+            uint64_t deadline = p->requests[p->request_head % p->capacity].submitted_us + p->linger_us;
+
+            if (nova402_clock_us() < deadline) {
+                nova402_cond_wait_until(&p->work, &p->lock, deadline);
+                continue;
+            }
+        }
+
+        n = queued < p->max_batch ? (size_t)queued : p->max_batch;
+        for (i = 0; i < n; i++) {
+            const pipeline_request_t *r = &p->requests[(p->request_head + i) % p->capacity];
+
+            self->headers[i] = r->header;
+            self->tags[i] = r->tag;
+        }
+        p->request_head += n;
+        if (p->request_tail != p->request_head) {
+            nova402_cond_signal(&p->work);  /* more for another thread */
+        }
+        nova402_mutex_unlock(&p->lock);
+
+        nova402_worker_verify_payments(self->worker, self->headers, n, self->results);
+
+        nova402_mutex_lock(&p->lock);
+        for (i = 0; i < n; i++) {
+            nova402_verify_completion_t *c = &p->completions[p->completion_tail++ % p->capacity];
+
+            c->tag = self->tags[i];
+            c->result = ((self->results[i >> 3] >> (i & 7)) & 1) ? NOVA402_SUCCESS
+                                                                 : NOVA402_ERROR_VERIFICATION_FAILED;
+        }
+        if (p->notify) {
+            nova402_mutex_unlock(&p->lock);
+            p->notify(p->notify_context);
+            nova402_mutex_lock(&p->lock);
+        }
+    }
+    nova402_mutex_unlock(&p->lock);
+}
+
+static void pipeline_free(nova402_pipeline_t *p)
+{
+    size_t i;
+
+    for (i = 0; i < p->thread_count; i++) {
+        pipeline_thread_t *t = &p->threads[i];
+
+        nova402_worker_destroy(t->worker);
+        nova402_free(t->headers);
+        nova402_free(t->tags);
+        nova402_free(t->results);
+    }
+    nova402_free(p->threads);
+    nova402_free(p->requests);
+    nova402_free(p->completions);
+    nova402_free(p);
+}
+
+nova402_pipeline_t *nova402_pipeline_create(
+    const nova402_ctx_t *ctx,
+    const nova402_pipeline_config_t *config)
+{
+    nova402_pipeline_t *p;
+    size_t threads = 0, started = 0, i;
+
+    if (!ctx) {
+        return NULL;
+    }
+
+    p = nova402_calloc(1, sizeof(*p));
+    if (!p) {
+        return NULL;
+    }
+    p->capacity = (config && config->capacity) ? config->capacity : DEFAULT_CAPACITY;
+    p->max_batch = (config && config->max_batch) ? config->max_batch : DEFAULT_MAX_BATCH;
+    p->linger_us = config ? config->max_linger_us : DEFAULT_LINGER_US;
+    if (config) {
+        threads = config->threads;
+        p->notify = config->notify;
+        p->notify_context = config->notify_context;
+    }
+    if (threads == 0) {
+        threads = nova402_cpu_count();
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+    if (p->max_batch > p->capacity) {
+        p->max_batch = p->capacity;
+    }
+
+    p->requests = nova402_calloc(p->capacity, sizeof(*p->requests));
+    p->completions = nova402_calloc(p->capacity, sizeof(*p->completions));
+    p->threads = nova402_calloc(threads, sizeof(*p->threads));
+    if (!p->requests || !p->completions || !p->threads) {
+        pipeline_free(p);
+        return NULL;
+    }
+    p->thread_count = threads;
+    for (i = 0; i < threads; i++) {
+        pipeline_thread_t *t = &p->threads[i];
+
+        t->pipeline = p;
+        t->worker = nova402_worker_create(ctx, NOVA402_CACHE_LINE);
+        t->headers = nova402_calloc(p->max_batch, sizeof(*t->headers));
+        t->tags = nova402_calloc(p->max_batch, sizeof(*t->tags));
+        t->results = nova402_calloc((p->max_batch + 7) / 8, 1);
+        if (!t->worker || !t->headers || !t->tags || !t->results) {
+            pipeline_free(p);
+            return NULL;
+        }
+    }
+
+    if (nova402_mutex_init(&p->lock) != 0) {
+        pipeline_free(p);
+        return NULL;
+    }
+    if (nova402_cond_init(&p->work) != 0) {
+        nova402_mutex_destroy(&p->lock);
+        pipeline_free(p);
+        return NULL;
+    }
+
+    for (i = 0; i < threads; i++) {
+        pipeline_thread_t *t = &p->threads[i];
+
+        t->start.fn = pipeline_run;
+        t->start.arg = t;
+        if (nova402_thread_create(&t->handle, &t->start) == 0) {
+            t->started = 1;
+            started++;
+        }
+    }
+    if (started == 0) {
+        nova402_pipeline_destroy(p);
+        return NULL;
+    }
+    return p;
+}
+
+void nova402_pipeline_destroy(nova402_pipeline_t *pipeline)
+{
+    size_t i;
+
+    if (!pipeline) {
+        return;
+    }
+
+    /* Queued requests are still verified; their results are dropped */
+    nova402_mutex_lock(&pipeline->lock);
+    pipeline->stopping = 1;
+    nova402_cond_broadcast(&pipeline->work);
+    nova402_mutex_unlock(&pipeline->lock);
+
+    for (i = 0; i < pipeline->thread_count; i++) {
+        if (pipeline->threads[i].started) {
+            nova402_thread_join(pipeline->threads[i].handle);
+        }
+    }
+    nova402_cond_destroy(&pipeline->work);
+    nova402_mutex_destroy(&pipeline->lock);
+    pipeline_free(pipeline);
+}
+
+int nova402_verify_submit(
+    nova402_pipeline_t *pipeline,
+    const nova402_payment_header_t *header,
+    uint64_t tag)
+{
+    pipeline_request_t *r;
+    uint64_t queued;
+
+    if (!pipeline || !header) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    nova402_mutex_lock(&pipeline->lock);
+    if (pipeline->outstanding >= pipeline->capacity) {
+        nova402_mutex_unlock(&pipeline->lock);
+        return NOVA402_ERROR_CAPACITY;
+    }
+    r = &pipeline->requests[pipeline->request_tail++ % pipeline->capacity];
+    r->header = *header;
+    r->tag = tag;
+    r->submitted_us = nova402_clock_us();
+    pipeline->outstanding++;
+
+    /* Wake a thread to start the linger clock, and again for a full batch */
+    queued = pipeline->request_tail - pipeline->request_head;
+    if (queued == 1 || queued % pipeline->max_batch == 0) {
+        nova402_cond_signal(&pipeline->work);
+    }
+    nova402_mutex_unlock(&pipeline->lock);
+    return NOVA402_SUCCESS;
+}
+
+size_t nova402_verify_poll(
+    nova402_pipeline_t *pipeline,
+    nova402_verify_completion_t *completions,
+    size_t max_completions)
+{
+    size_t n = 0;
+
+    if (!pipeline || !completions) {
+        return 0;
+    }
+
+    nova402_mutex_lock(&pipeline->lock);
+    while (n < max_completions && pipeline->completion_head != pipeline->completion_tail) {
+        completions[n++] = pipeline->completions[pipeline->completion_head++ % pipeline->capacity];
+    }
+    pipeline->outstanding -= n;
+    nova402_mutex_unlock(&pipeline->lock);
+    return n;
+}
+
+size_t nova402_pipeline_pending(nova402_pipeline_t *pipeline)
+{
+    size_t n;
+
+    if (!pipeline) {
+        return 0;
+    }
+    nova402_mutex_lock(&pipeline->lock);
+    n = pipeline->outstanding;
+    nova402_mutex_unlock(&pipeline->lock);
+    return n;
+}
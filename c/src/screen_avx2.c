@@ -0,0 +1,50 @@
+/**
+ * Nova402 C Library - AVX2 payment screening
+ *
+ * AVX2 only compares 64-bit lanes as signed, so both sides are biased by
+ * 2^63 first. Two 4-lane passes and one byte compare of the network
+ * column fill each result byte. Built with AVX2 enabled for this file
+ * only; called through the runtime dispatcher.
+ *
+ * @file screen_avx2.c
+ */
+
+#include "internal.h"
+
+#include <immintrin.h>
+
+void nova402_screen_blocks_avx2(uint8_t *out, const uint64_t *value, const uint64_t *valid_after,
+                                const uint64_t *valid_before, const uint8_t *network, size_t blocks,
+                                const nova402_screen_t *screen)
+{
+    const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i min_value = _mm256_xor_si256(_mm256_set1_epi64x((long long)screen->min_value), bias);
+    const __m256i now = _mm256_xor_si256(_mm256_set1_epi64x((long long)screen->now), bias);
+    const __m128i id = _mm_set1_epi8((char)screen->network);
+    size_t block;
+    int half;
+
+    for (block = 0; block < blocks; block++) {
+        unsigned bits = 0;
+
+        for (half = 0; half < 2; half++) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(const void *)value), bias);
+            __m256i a = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(const void *)valid_after), bias);
+            __m256i b = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(const void *)valid_before), bias);
+
+            /* value >= min, valid_after <= now, now < valid_before */
+            __m256i fail = _mm256_or_si256(_mm256_cmpgt_epi64(min_value, v), _mm256_cmpgt_epi64(a, now));
+            __m256i pass = _mm256_andnot_si256(fail, _mm256_cmpgt_epi64(b, now));
+
+            bits |= (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(pass)) << (4 * half);
+            value += 4;
+            valid_after += 4;
+            valid_before += 4;
+        }
+
+        bits &= (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i *)(const void *)network), id));
+        out[block] = (uint8_t)bits;
+        network += NOVA402_SCREEN_BLOCK;
+    }
+}
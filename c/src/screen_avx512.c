@@ -0,0 +1,38 @@
+/**
+ * Nova402 C Library - AVX-512 payment screening
+ *
+ * AVX-512F compares unsigned 64-bit lanes straight into mask registers,
+ * so one 8-lane pass per column gives a whole result byte. Built with
+ * AVX-512F enabled for this file only; called through the runtime
+ * dispatcher.
+ *
+ * @file screen_avx512.c
+ */
+
+#include "internal.h"
+
+#include <immintrin.h>
+
+void nova402_screen_blocks_avx512(uint8_t *out, const uint64_t *value, const uint64_t *valid_after,
+                                  const uint64_t *valid_before, const uint8_t *network, size_t blocks,
+                                  const nova402_screen_t *screen)
+{
+    const __m512i min_value = _mm512_set1_epi64((long long)screen->min_value);
+    const __m512i now = _mm512_set1_epi64((long long)screen->now);
+    const __m128i id = _mm_set1_epi8((char)screen->network);
+    size_t block;
+
+    for (block = 0; block < blocks; block++) {
+        __mmask8 pass = _mm512_cmpge_epu64_mask(_mm512_loadu_si512((const void *)value), min_value);
+
+        pass = _mm512_mask_cmple_epu64_mask(pass, _mm512_loadu_si512((const void *)valid_after), now);
+        pass = _mm512_mask_cmpgt_epu64_mask(pass, _mm512_loadu_si512((const void *)valid_before), now);
+
+        out[block] = (uint8_t)(pass & (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i *)(const void *)network), id)));
+        value += NOVA402_SCREEN_BLOCK;
+        valid_after += NOVA402_SCREEN_BLOCK;
+        valid_before += NOVA402_SCREEN_BLOCK;
+        network += NOVA402_SCREEN_BLOCK;
+    }
+}
@@ -0,0 +1,407 @@
+/**
+ * Nova402 C Library - secp256k1 arithmetic
+ *
+ * Baseline build of the field/scalar/group code in secp256k1_impl.h, the
+ * precomputed generator contexts, the exported wrappers and the
+ * runtime-dispatched entry points of the batched public key recovery kernel
+ * used by nova402_recover_signers_batch() and nova402_verify_signatures_batch()
+ * and of the signing kernel behind nova402_signer_t.
+ *
+ * @file secp256k1.c
+ */
+
+#include "internal.h"
+
+#include "atomic.h"
+
+#define NOVA402_SECP256K1_RECOVER nova402_secp256k1_recover_batch_portable
+#define NOVA402_SECP256K1_SIGN nova402_secp256k1_sign_batch_portable
+#include "secp256k1_impl.h"
+
+/* ============================================
+ * PRECOMPUTED CONTEXT
+ * ============================================ */
+
+/* table[i] = (2i + 1) p in affine form, with one shared inversion */
+static int build_odd_multiples(nova402_ge_storage_t *table, size_t n, const nova402_gej_t *p)
+{
+    nova402_gej_t *jac = nova402_malloc(n * sizeof(*jac));
+    nova402_fe_t *zs = nova402_malloc(n * sizeof(*zs));
+    nova402_fe_t *zinv = nova402_malloc(n * sizeof(*zinv));
+    nova402_gej_t d;
+    size_t i;
+
+    if (!jac || !zs || !zinv) {
+        nova402_free(jac);
+        nova402_free(zs);
+        nova402_free(zinv);
+        return 0;
+    }
+
+    jac[0] = *p;
+    gej_double(&d, p);
+    for (i = 1; i < n; i++) {
+        gej_add(&jac[i], &jac[i - 1], &d);
+    }
+    for (i = 0; i < n; i++) {
+        zs[i] = jac[i].z;
+    }
+
+    fe_inv_batch(zinv, zs, n);
+
+    for (i = 0; i < n; i++) {
+        nova402_fe_t zi2, zi3;
+        fe_sqr(&zi2, &zinv[i]);
+        fe_mul(&zi3, &zi2, &zinv[i]);
+        fe_mul(&table[i].x, &jac[i].x, &zi2);
+        fe_mul(&table[i].y, &jac[i].y, &zi3);
+    }
+
+    nova402_free(jac);
+    nova402_free(zs);
+    nova402_free(zinv);
+    return 1;
+}
+
+nova402_secp256k1_ctx_t *nova402_secp256k1_ctx_create(nova402_secp256k1_table_t size)
+{
+    nova402_secp256k1_ctx_t *ctx;
+    nova402_ge_t g;
+    nova402_gej_t p;
+    size_t n;
+    int i;
+
+    if (size != NOVA402_SECP256K1_TABLE_64K && size != NOVA402_SECP256K1_TABLE_1M) {
+        return NULL;
+    }
+
+    ctx = nova402_malloc(sizeof(*ctx));
+    if (!ctx) {
+        return NULL;
+    }
+
+    ctx->window = size == NOVA402_SECP256K1_TABLE_1M ? NOVA402_SECP256K1_WINDOW_1M
+                                                     : NOVA402_SECP256K1_WINDOW_64K;
+    n = (size_t)TABLE_SIZE(ctx->window);
+    ctx->g = nova402_malloc(2 * n * sizeof(*ctx->g));
+    if (!ctx->g) {
+        nova402_free(ctx);
+        return NULL;
+    }
+    ctx->g128 = ctx->g + n;
+
+    g.x = g_odd_multiples[0].x;
+    g.y = g_odd_multiples[0].y;
+    g.infinity = 0;
+    gej_set_ge(&p, &g);
+    if (!build_odd_multiples(ctx->g, n, &p)) {
+        nova402_secp256k1_ctx_destroy(ctx);
+        return NULL;
+    }
+
+    for (i = 0; i < 128; i++) {
+        gej_double(&p, &p);
+    }
+    if (!build_odd_multiples(ctx->g128, n, &p)) {
+        nova402_secp256k1_ctx_destroy(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+void nova402_secp256k1_ctx_destroy(nova402_secp256k1_ctx_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    nova402_free(ctx->g);
+    nova402_free(ctx);
+}
+
+size_t nova402_secp256k1_recover_batch(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *ok)
+{
+    return nova402_dispatch()->recover_batch(ctx, messages, signatures, count, signers, ok);
+}
+
+/* ============================================
+ * COMB TABLE
+ * ============================================ */
+
+/* Initialization states of the comb table */
+#define COMB_EMPTY 0
+#define COMB_BUSY 1
+#define COMB_READY 2
+
+#define COMB_ENTRIES (NOVA402_COMB_BLOCKS * NOVA402_COMB_POINTS)
+
+nova402_ge_storage_t nova402_secp256k1_comb[NOVA402_COMB_BLOCKS][NOVA402_COMB_POINTS];
+
+static volatile uint64_t g_comb_state = COMB_EMPTY;
+
+static int build_comb(void)
+{
+    nova402_gej_t teeth[NOVA402_COMB_BLOCKS * NOVA402_COMB_TEETH];
+    nova402_gej_t *jac = nova402_malloc(COMB_ENTRIES * sizeof(*jac));
+    nova402_fe_t *zs = nova402_malloc(COMB_ENTRIES * sizeof(*zs));
+    nova402_fe_t *zinv = nova402_malloc(COMB_ENTRIES * sizeof(*zinv));
+    nova402_ge_t g;
+    nova402_gej_t p;
+    int i, t, b, idx, ok = 1;
+
+    if (!jac || !zs || !zinv) {
+        nova402_free(jac);
+        nova402_free(zs);
+        nova402_free(zinv);
+        return 0;
+    }
+
+    /* teeth[j] = 2^(j SPACING) G */
+    g.x = g_odd_multiples[0].x;
+    g.y = g_odd_multiples[0].y;
+    g.infinity = 0;
+    gej_set_ge(&p, &g);
+    for (i = 0; i < NOVA402_COMB_BLOCKS * NOVA402_COMB_TEETH; i++) {
+        teeth[i] = p;
+        for (t = 0; t < NOVA402_COMB_SPACING; t++) {
+            gej_double(&p, &p);
+        }
+    }
+
+    for (b = 0; b < NOVA402_COMB_BLOCKS; b++) {
+        const nova402_gej_t *bt = &teeth[b * NOVA402_COMB_TEETH];
+        nova402_gej_t *entry = &jac[b * NOVA402_COMB_POINTS];
+
+        /* Entry 0: top tooth minus all others; setting bit t adds 2 tooth t */
+        entry[0] = bt[NOVA402_COMB_TEETH - 1];
+        for (t = 0; t < NOVA402_COMB_TEETH - 1; t++) {
+            nova402_gej_t neg = bt[t];
+            fe_neg(&neg.y, &neg.y);
+            gej_add(&entry[0], &entry[0], &neg);
+        }
+        for (idx = 1; idx < NOVA402_COMB_POINTS; idx++) {
+            nova402_gej_t twice;
+
+            t = NOVA402_COMB_TEETH - 2;
+            while (!(idx & (1 << t))) {
+                t--;
+            }
+            gej_double(&twice, &bt[t]);
+            gej_add(&entry[idx], &entry[idx ^ (1 << t)], &twice);
+        }
+    }
+
+    for (i = 0; i < COMB_ENTRIES; i++) {
+        ok &= !jac[i].infinity;
+        zs[i] = jac[i].z;
+    }
+
+    if (ok) {
+        fe_inv_batch(zinv, zs, COMB_ENTRIES);
+        for (i = 0; i < COMB_ENTRIES; i++) {
+            nova402_ge_storage_t *out = &nova402_secp256k1_comb[0][0] + i;
+            nova402_fe_t zi2, zi3;
+            fe_sqr(&zi2, &zinv[i]);
+            fe_mul(&zi3, &zi2, &zinv[i]);
+            fe_mul(&out->x, &jac[i].x, &zi2);
+            fe_mul(&out->y, &jac[i].y, &zi3);
+        }
+    }
+
+    nova402_free(jac);
+    nova402_free(zs);
+    nova402_free(zinv);
+    return ok;
+}
+
+int nova402_secp256k1_comb_init(void)
+{
+    uint64_t state = nova402_atomic_load_u64(&g_comb_state);
+
+    while (state != COMB_READY) {
+        if (state == COMB_EMPTY && nova402_atomic_cas_u64(&g_comb_state, COMB_EMPTY, COMB_BUSY)) {
+            /* A failed build leaves the table to the next caller */
+            if (!build_comb()) {
+                nova402_atomic_store_u64(&g_comb_state, COMB_EMPTY);
+                return 0;
+            }
+            nova402_atomic_store_u64(&g_comb_state, COMB_READY);
+            return 1;
+        }
+        nova402_cpu_relax();
+        state = nova402_atomic_load_u64(&g_comb_state);
+    }
+    return 1;
+}
+
+size_t nova402_secp256k1_sign_batch(
+    const nova402_signer_t *signer,
+    const nova402_hash_t *digests,
+    const nova402_hash_t *nonces,
+    size_t count,
+    nova402_signature_t *signatures,
+    uint8_t *ok)
+{
+    return nova402_dispatch()->sign_batch(signer, digests, nonces, count, signatures, ok);
+}
+
+/* ============================================
+ * EXPORTED WRAPPERS
+ * ============================================ */
+
+int nova402_fe_set_b32(nova402_fe_t *r, const uint8_t *bytes)
+{
+    return fe_set_b32(r, bytes);
+}
+
+void nova402_fe_get_b32(uint8_t *bytes, const nova402_fe_t *a)
+{
+    fe_get_b32(bytes, a);
+}
+
+void nova402_fe_set_int(nova402_fe_t *r, uint64_t v)
+{
+    fe_set_int(r, v);
+}
+
+int nova402_fe_is_zero(const nova402_fe_t *a)
+{
+    return fe_is_zero(a);
+}
+
+int nova402_fe_is_odd(const nova402_fe_t *a)
+{
+    return fe_is_odd(a);
+}
+
+int nova402_fe_equal(const nova402_fe_t *a, const nova402_fe_t *b)
+{
+    return fe_equal(a, b);
+}
+
+void nova402_fe_add(nova402_fe_t *r, const nova402_fe_t *a, const nova402_fe_t *b)
+{
+    fe_add(r, a, b);
+}
+
+void nova402_fe_sub(nova402_fe_t *r, const nova402_fe_t *a, const nova402_fe_t *b)
+{
+    fe_sub(r, a, b);
+}
+
+void nova402_fe_neg(nova402_fe_t *r, const nova402_fe_t *a)
+{
+    fe_neg(r, a);
+}
+
+void nova402_fe_mul(nova402_fe_t *r, const nova402_fe_t *a, const nova402_fe_t *b)
+{
+    fe_mul(r, a, b);
+}
+
+void nova402_fe_sqr(nova402_fe_t *r, const nova402_fe_t *a)
+{
+    fe_sqr(r, a);
+}
+
+void nova402_fe_inv(nova402_fe_t *r, const nova402_fe_t *a)
+{
+    fe_inv(r, a);
+}
+
+int nova402_fe_sqrt(nova402_fe_t *r, const nova402_fe_t *a)
+{
+    return fe_sqrt(r, a);
+}
+
+void nova402_fe_inv_batch(nova402_fe_t *r, const nova402_fe_t *a, size_t n)
+{
+    fe_inv_batch(r, a, n);
+}
+
+int nova402_scalar_set_b32(nova402_scalar_t *r, const uint8_t *bytes)
+{
+    return scalar_set_b32(r, bytes);
+}
+
+void nova402_scalar_get_b32(uint8_t *bytes, const nova402_scalar_t *a)
+{
+    scalar_get_b32(bytes, a);
+}
+
+void nova402_scalar_set_int(nova402_scalar_t *r, uint64_t v)
+{
+    scalar_set_int(r, v);
+}
+
+int nova402_scalar_is_zero(const nova402_scalar_t *a)
+{
+    return scalar_is_zero(a);
+}
+
+int nova402_scalar_is_high(const nova402_scalar_t *a)
+{
+    return scalar_is_high(a);
+}
+
+void nova402_scalar_add(nova402_scalar_t *r, const nova402_scalar_t *a, const nova402_scalar_t *b)
+{
+    scalar_add(r, a, b);
+}
+
+void nova402_scalar_neg(nova402_scalar_t *r, const nova402_scalar_t *a)
+{
+    scalar_neg(r, a);
+}
+
+void nova402_scalar_mul(nova402_scalar_t *r, const nova402_scalar_t *a, const nova402_scalar_t *b)
+{
+    scalar_mul(r, a, b);
+}
+
+void nova402_scalar_inv(nova402_scalar_t *r, const nova402_scalar_t *a)
+{
+    scalar_inv(r, a);
+}
+
+void nova402_scalar_inv_batch(nova402_scalar_t *r, const nova402_scalar_t *a, size_t n)
+{
+    scalar_inv_batch(r, a, n);
+}
+
+void nova402_gej_set_ge(nova402_gej_t *r, const nova402_ge_t *a)
+{
+    gej_set_ge(r, a);
+}
+
+void nova402_gej_double(nova402_gej_t *r, const nova402_gej_t *a)
+{
+    gej_double(r, a);
+}
+
+void nova402_gej_add(nova402_gej_t *r, const nova402_gej_t *a, const nova402_gej_t *b)
+{
+    gej_add(r, a, b);
+}
+
+void nova402_gej_add_ge(nova402_gej_t *r, const nova402_gej_t *a, const nova402_ge_t *b)
+{
+    gej_add_ge(r, a, b);
+}
+
+int nova402_ge_set_xo(nova402_ge_t *r, const nova402_fe_t *x, int odd)
+{
+    return ge_set_xo(r, x, odd);
+}
+
+void nova402_ecmult_gen(nova402_gej_t *r, const nova402_scalar_t *k, const nova402_scalar_t *blind,
+                        const nova402_ge_storage_t *blind_point)
+{
+    ecmult_gen(r, k, blind, blind_point);
+}
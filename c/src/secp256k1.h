@@ -0,0 +1,245 @@
+/**
+ * Nova402 C Library - secp256k1 internals
+ *
+ * Field, scalar and group arithmetic shared by the signature code.
+ * Not part of the public API.
+ *
+ * @file secp256k1.h
+ */
+
+#ifndef NOVA402_SECP256K1_H
+#define NOVA402_SECP256K1_H
+
+#include "nova402.h"
+
+/**
+ * Field element mod p, four little-endian 64-bit limbs, always fully reduced
+ */
+typedef struct {
+    uint64_t n[4];
+} nova402_fe_t;
+
+/**
+ * Scalar mod n, four little-endian 64-bit limbs, always fully reduced
+ */
+typedef struct {
+    uint64_t n[4];
+} nova402_scalar_t;
+
+/**
+ * Affine group element
+ */
+typedef struct {
+    nova402_fe_t x;
+    nova402_fe_t y;
+    int infinity;
+} nova402_ge_t;
+
+/**
+ * Affine group element without the infinity flag, as stored in tables
+ */
+typedef struct {
+    nova402_fe_t x;
+    nova402_fe_t y;
+} nova402_ge_storage_t;
+
+/**
+ * Jacobian group element (x = X/Z^2, y = Y/Z^3)
+ */
+typedef struct {
+    nova402_fe_t x;
+    nova402_fe_t y;
+    nova402_fe_t z;
+    int infinity;
+} nova402_gej_t;
+
+/**
+ * Number of signatures processed together by the batch recovery kernel.
+ * Scratch space for one chunk lives on the stack (~20 KB).
+ */
+#ifndef NOVA402_BATCH_CHUNK
+#define NOVA402_BATCH_CHUNK 16
+#endif
+
+/* wNAF windows of the context's generator tables */
+#define NOVA402_SECP256K1_WINDOW_64K 11
+#define NOVA402_SECP256K1_WINDOW_1M 15
+
+/**
+ * Precomputed generator tables, read-only once built. Each table holds the
+ * 2^(window - 2) odd multiples 1P, 3P, ..., (2^(window - 1) - 1)P.
+ */
+struct nova402_secp256k1_ctx {
+    int window;
+    nova402_ge_storage_t *g;    /* multiples of G */
+    nova402_ge_storage_t *g128; /* multiples of 2^128 G */
+};
+
+/*
+ * Signed-digit comb for k G: NOVA402_COMB_BLOCKS blocks of
+ * NOVA402_COMB_TEETH teeth NOVA402_COMB_SPACING bits apart cover
+ * COMB_BITS = 264 >= 256 bits, so k G costs 3 doublings and 44 additions.
+ * Block b holds sum_t (+/-1) 2^((b TEETH + t) SPACING) G for every sign
+ * pattern of the lower teeth, with the top tooth +1.
+ */
+#define NOVA402_COMB_BLOCKS 11
+#define NOVA402_COMB_TEETH 6
+#define NOVA402_COMB_SPACING 4
+#define NOVA402_COMB_POINTS (1 << (NOVA402_COMB_TEETH - 1))
+
+extern nova402_ge_storage_t nova402_secp256k1_comb[NOVA402_COMB_BLOCKS][NOVA402_COMB_POINTS];
+
+/**
+ * Build the comb table on first use; later calls only read a flag.
+ *
+ * @return 1 once the table is ready, 0 on allocation failure
+ */
+int nova402_secp256k1_comb_init(void);
+
+/**
+ * Signing key with its precomputed public data. The comb computes
+ * (k - blind) G and adds blind_point, so the table lookups and additions
+ * never see the nonce itself.
+ */
+struct nova402_signer {
+    nova402_scalar_t key;               /* private key, in [1, n) */
+    nova402_scalar_t blind;
+    nova402_ge_storage_t blind_point;   /* blind G */
+    uint8_t public_key[64];             /* x || y, big-endian */
+    nova402_address_t address;
+};
+
+/*
+ * Field arithmetic. set_b32 functions reduce their input and return 1 if
+ * it was already below the modulus.
+ */
+int nova402_fe_set_b32(nova402_fe_t *r, const uint8_t *bytes);
+void nova402_fe_get_b32(uint8_t *bytes, const nova402_fe_t *a);
+void nova402_fe_set_int(nova402_fe_t *r, uint64_t v);
+int nova402_fe_is_zero(const nova402_fe_t *a);
+int nova402_fe_is_odd(const nova402_fe_t *a);
+int nova402_fe_equal(const nova402_fe_t *a, const nova402_fe_t *b);
+void nova402_fe_add(nova402_fe_t *r, const nova402_fe_t *a, const nova402_fe_t *b);
+void nova402_fe_sub(nova402_fe_t *r, const nova402_fe_t *a, const nova402_fe_t *b);
+void nova402_fe_neg(nova402_fe_t *r, const nova402_fe_t *a);
+void nova402_fe_mul(nova402_fe_t *r, const nova402_fe_t *a, const nova402_fe_t *b);
+void nova402_fe_sqr(nova402_fe_t *r, const nova402_fe_t *a);
+void nova402_fe_inv(nova402_fe_t *r, const nova402_fe_t *a);
+int nova402_fe_sqrt(nova402_fe_t *r, const nova402_fe_t *a);
+
+/**
+ * Invert n field elements with a single inversion (Montgomery's trick).
+ * All inputs must be non-zero; r and a must not overlap.
+ */
+void nova402_fe_inv_batch(nova402_fe_t *r, const nova402_fe_t *a, size_t n);
+
+/* Scalar arithmetic */
+int nova402_scalar_set_b32(nova402_scalar_t *r, const uint8_t *bytes);
+void nova402_scalar_get_b32(uint8_t *bytes, const nova402_scalar_t *a);
+void nova402_scalar_set_int(nova402_scalar_t *r, uint64_t v);
+int nova402_scalar_is_zero(const nova402_scalar_t *a);
+int nova402_scalar_is_high(const nova402_scalar_t *a);
+void nova402_scalar_add(nova402_scalar_t *r, const nova402_scalar_t *a, const nova402_scalar_t *b);
+void nova402_scalar_neg(nova402_scalar_t *r, const nova402_scalar_t *a);
+void nova402_scalar_mul(nova402_scalar_t *r, const nova402_scalar_t *a, const nova402_scalar_t *b);
+void nova402_scalar_inv(nova402_scalar_t *r, const nova402_scalar_t *a);
+
+/**
+ * Invert n scalars with a single inversion (Montgomery's trick).
+ * All inputs must be non-zero; r and a must not overlap.
+ */
+void nova402_scalar_inv_batch(nova402_scalar_t *r, const nova402_scalar_t *a, size_t n);
+
+/* Group arithmetic */
+void nova402_gej_set_ge(nova402_gej_t *r, const nova402_ge_t *a);
+void nova402_gej_double(nova402_gej_t *r, const nova402_gej_t *a);
+void nova402_gej_add(nova402_gej_t *r, const nova402_gej_t *a, const nova402_gej_t *b);
+void nova402_gej_add_ge(nova402_gej_t *r, const nova402_gej_t *a, const nova402_ge_t *b);
+int nova402_ge_set_xo(nova402_ge_t *r, const nova402_fe_t *x, int odd);
+
+/**
+ * Constant-time r = k G through the comb table, which must be initialized.
+ * When blind is given, computes (k - blind) G + blind_point.
+ */
+void nova402_ecmult_gen(nova402_gej_t *r, const nova402_scalar_t *k, const nova402_scalar_t *blind,
+                        const nova402_ge_storage_t *blind_point);
+
+/**
+ * Recover Ethereum addresses for a batch of (digest, signature) pairs.
+ *
+ * Signatures must use low-s form (EIP-2) and v in {0, 1, 27, 28}.
+ * ok[i] is set to 1 if signer i was recovered, 0 otherwise. ctx may be
+ * NULL to use the built-in generator table.
+ *
+ * @return Number of recovered signers
+ */
+size_t nova402_secp256k1_recover_batch(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *ok
+);
+
+/*
+ * Build variants of the recovery kernel, selected by the dispatcher.
+ * The BMI2/ADX variant only exists in x86-64 builds.
+ */
+size_t nova402_secp256k1_recover_batch_portable(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *ok
+);
+
+size_t nova402_secp256k1_recover_batch_bmi2(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *ok
+);
+
+/**
+ * Sign a batch of digests with one key and caller-supplied nonces.
+ *
+ * nonces[i] must be a scalar in [1, n). Produces low-s signatures with
+ * v in {27, 28}; ok[i] is 0 in the rare case (r or s zero, or x(R) >= n)
+ * where the caller must retry item i with the next nonce. signer->key
+ * and the nonces are only handled in constant time.
+ *
+ * @return Number of items signed
+ */
+size_t nova402_secp256k1_sign_batch(
+    const nova402_signer_t *signer,
+    const nova402_hash_t *digests,
+    const nova402_hash_t *nonces,
+    size_t count,
+    nova402_signature_t *signatures,
+    uint8_t *ok
+);
+
+/* Build variants of the signing kernel, selected with the recovery kernel */
+size_t nova402_secp256k1_sign_batch_portable(
+    const nova402_signer_t *signer,
+    const nova402_hash_t *digests,
+    const nova402_hash_t *nonces,
+    size_t count,
+    nova402_signature_t *signatures,
+    uint8_t *ok
+);
+
+size_t nova402_secp256k1_sign_batch_bmi2(
+    const nova402_signer_t *signer,
+    const nova402_hash_t *digests,
+    const nova402_hash_t *nonces,
+    size_t count,
+    nova402_signature_t *signatures,
+    uint8_t *ok
+);
+
+#endif /* NOVA402_SECP256K1_H */
@@ -0,0 +1,20 @@
+/**
+ * Nova402 C Library - secp256k1 arithmetic, BMI2/ADX build
+ *
+ * Same code as secp256k1.c, compiled with BMI2 and ADX enabled for this
+ * file only so the 64x64 limb products use flag-free mulx. Selected at
+ * runtime by the dispatcher when the CPU reports both extensions.
+ *
+ * @file secp256k1_bmi2.c
+ */
+
+#include "internal.h"
+
+/* The exported wrappers live in secp256k1.c; most helpers are unused here */
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+
+#define NOVA402_SECP256K1_RECOVER nova402_secp256k1_recover_batch_bmi2
+#define NOVA402_SECP256K1_SIGN nova402_secp256k1_sign_batch_bmi2
+#include "secp256k1_impl.h"
@@ -0,0 +1,1587 @@
+/**
+ * Nova402 C Library - secp256k1 arithmetic template
+ *
+ * Portable 4x64-bit limb field/scalar arithmetic, Jacobian group operations
+ * and the batched public key recovery and signing kernels. Included by each build variant
+ * of the secp256k1 code after it defines:
+ *
+ *   NOVA402_SECP256K1_RECOVER   name of the generated batch recovery function
+ *   NOVA402_SECP256K1_SIGN      name of the generated batch signing function
+ *
+ * so the same source can be compiled once for the baseline ISA and once with
+ * BMI2/ADX enabled (mulx) and picked at runtime. Everything else is static.
+ *
+ * @file secp256k1_impl.h
+ */
+
+#include "secp256k1.h"
+
+#include <string.h>
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 nova402_u128_t;
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/* ============================================
+ * 64x64 -> 128 MULTIPLY
+ * ============================================ */
+
+static void mul64(uint64_t a, uint64_t b, uint64_t *lo, uint64_t *hi)
+{
+#if defined(__SIZEOF_INT128__)
+    nova402_u128_t p = (nova402_u128_t)a * b;
+    *lo = (uint64_t)p;
+    *hi = (uint64_t)(p >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *lo = _umul128(a, b, hi);
+#else
+    uint64_t a0 = a & 0xFFFFFFFFu, a1 = a >> 32;
+    uint64_t b0 = b & 0xFFFFFFFFu, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFFu) + (p10 & 0xFFFFFFFFu);
+    *lo = (mid << 32) | (p00 & 0xFFFFFFFFu);
+    *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+}
+
+#if defined(__SIZEOF_INT128__)
+
+/* Add a * b into the three-word column accumulator (c0, c1, c2) */
+#define MULADD(c0, c1, c2, a, b) do {                                 \
+        nova402_u128_t p_ = (nova402_u128_t)(a) * (b);                  \
+        nova402_u128_t s_ = (((nova402_u128_t)(c1) << 64) | (c0)) + p_; \
+        (c2) += (s_ < p_);                                              \
+        (c0) = (uint64_t)s_;                                            \
+        (c1) = (uint64_t)(s_ >> 64);                                    \
+    } while (0)
+
+/* Add 2 * a * b into the column accumulator */
+#define MULADD2(c0, c1, c2, a, b) do {                                \
+        MULADD(c0, c1, c2, a, b);                                       \
+        MULADD(c0, c1, c2, a, b);                                       \
+    } while (0)
+
+#else
+
+/* Add a * b into the three-word column accumulator (c0, c1, c2) */
+#define MULADD(c0, c1, c2, a, b) do {                                 \
+        uint64_t lo_, hi_;                                              \
+        mul64((a), (b), &lo_, &hi_);                                    \
+        (c0) += lo_;                                                    \
+        hi_ += ((c0) < lo_);                                            \
+        (c1) += hi_;                                                    \
+        (c2) += ((c1) < hi_);                                           \
+    } while (0)
+
+/* Add 2 * a * b into the column accumulator */
+#define MULADD2(c0, c1, c2, a, b) do {                                \
+        uint64_t lo_, hi_, top_, c_;                                    \
+        mul64((a), (b), &lo_, &hi_);                                    \
+        top_ = hi_ >> 63;                                               \
+        hi_ = (hi_ << 1) | (lo_ >> 63);                                 \
+        lo_ <<= 1;                                                      \
+        (c0) += lo_;                                                    \
+        c_ = ((c0) < lo_);                                              \
+        hi_ += c_;                                                      \
+        top_ += (hi_ < c_);                                             \
+        (c1) += hi_;                                                    \
+        top_ += ((c1) < hi_);                                           \
+        (c2) += top_;                                                   \
+    } while (0)
+
+#endif
+
+/* Shift the column accumulator down one word, emitting the low word */
+#define EXTRACT(out, c0, c1, c2) do {                 \
+        (out) = (c0);                                   \
+        (c0) = (c1);                                    \
+        (c1) = (c2);                                    \
+        (c2) = 0;                                       \
+    } while (0)
+
+/* t[0..7] = a[0..3] * b[0..3] (product scanning) */
+static void mul_256(uint64_t t[8], const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t c0 = 0, c1 = 0, c2 = 0;
+
+    MULADD(c0, c1, c2, a[0], b[0]);
+    EXTRACT(t[0], c0, c1, c2);
+    MULADD(c0, c1, c2, a[0], b[1]);
+    MULADD(c0, c1, c2, a[1], b[0]);
+    EXTRACT(t[1], c0, c1, c2);
+    MULADD(c0, c1, c2, a[0], b[2]);
+    MULADD(c0, c1, c2, a[1], b[1]);
+    MULADD(c0, c1, c2, a[2], b[0]);
+    EXTRACT(t[2], c0, c1, c2);
+    MULADD(c0, c1, c2, a[0], b[3]);
+    MULADD(c0, c1, c2, a[1], b[2]);
+    MULADD(c0, c1, c2, a[2], b[1]);
+    MULADD(c0, c1, c2, a[3], b[0]);
+    EXTRACT(t[3], c0, c1, c2);
+    MULADD(c0, c1, c2, a[1], b[3]);
+    MULADD(c0, c1, c2, a[2], b[2]);
+    MULADD(c0, c1, c2, a[3], b[1]);
+    EXTRACT(t[4], c0, c1, c2);
+    MULADD(c0, c1, c2, a[2], b[3]);
+    MULADD(c0, c1, c2, a[3], b[2]);
+    EXTRACT(t[5], c0, c1, c2);
+    MULADD(c0, c1, c2, a[3], b[3]);
+    EXTRACT(t[6], c0, c1, c2);
+    t[7] = c0;
+}
+
+/* t[0..7] = a[0..3]^2 */
+static void sqr_256(uint64_t t[8], const uint64_t a[4])
+{
+    uint64_t c0 = 0, c1 = 0, c2 = 0;
+
+    MULADD(c0, c1, c2, a[0], a[0]);
+    EXTRACT(t[0], c0, c1, c2);
+    MULADD2(c0, c1, c2, a[0], a[1]);
+    EXTRACT(t[1], c0, c1, c2);
+    MULADD2(c0, c1, c2, a[0], a[2]);
+    MULADD(c0, c1, c2, a[1], a[1]);
+    EXTRACT(t[2], c0, c1, c2);
+    MULADD2(c0, c1, c2, a[0], a[3]);
+    MULADD2(c0, c1, c2, a[1], a[2]);
+    EXTRACT(t[3], c0, c1, c2);
+    MULADD2(c0, c1, c2, a[1], a[3]);
+    MULADD(c0, c1, c2, a[2], a[2]);
+    EXTRACT(t[4], c0, c1, c2);
+    MULADD2(c0, c1, c2, a[2], a[3]);
+    EXTRACT(t[5], c0, c1, c2);
+    MULADD(c0, c1, c2, a[3], a[3]);
+    EXTRACT(t[6], c0, c1, c2);
+    t[7] = c0;
+}
+
+/* r = a + k over four limbs, returns the carry out */
+static uint64_t add_small(uint64_t r[4], const uint64_t a[4], uint64_t k)
+{
+    int i;
+    uint64_t c = k;
+
+    for (i = 0; i < 4; i++) {
+        uint64_t s = a[i] + c;
+        c = (s < c);
+        r[i] = s;
+    }
+    return c;
+}
+
+/* r = a + b over four limbs, returns the carry out */
+static uint64_t add_256(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    int i;
+    uint64_t c = 0;
+
+    for (i = 0; i < 4; i++) {
+        uint64_t s = a[i] + c;
+        c = (s < c);
+        r[i] = s + b[i];
+        c += (r[i] < s);
+    }
+    return c;
+}
+
+/* r = a - b over four limbs, returns the borrow out */
+static uint64_t sub_256(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    int i;
+    uint64_t borrow = 0;
+
+    for (i = 0; i < 4; i++) {
+        uint64_t bi = b[i] + borrow;
+        uint64_t wrapped = (bi < borrow);
+        borrow = wrapped | (a[i] < bi);
+        r[i] = a[i] - bi;
+    }
+    return borrow;
+}
+
+/* r = mask ? a : b */
+static void select_256(uint64_t r[4], const uint64_t a[4], const uint64_t b[4], uint64_t mask)
+{
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        r[i] = (a[i] & mask) | (b[i] & ~mask);
+    }
+}
+
+static void load_be(uint64_t r[4], const uint8_t *bytes)
+{
+    int i, j;
+
+    for (i = 0; i < 4; i++) {
+        uint64_t v = 0;
+        for (j = 0; j < 8; j++) {
+            v = (v << 8) | bytes[(3 - i) * 8 + j];
+        }
+        r[i] = v;
+    }
+}
+
+static void store_be(uint8_t *bytes, const uint64_t a[4])
+{
+    int i, j;
+
+    for (i = 0; i < 4; i++) {
+        for (j = 0; j < 8; j++) {
+            bytes[(3 - i) * 8 + j] = (uint8_t)(a[i] >> (56 - 8 * j));
+        }
+    }
+}
+
+/* ============================================
+ * FIELD ARITHMETIC (mod p = 2^256 - 0x1000003D1)
+ * ============================================ */
+
+#define FE_C 0x1000003D1ULL
+
+static const uint64_t FE_P[4] = {
+    0xFFFFFFFEFFFFFC2FULL, 0xFFFFFFFFFFFFFFFFULL,
+    0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL
+};
+
+/* Reduce t (< 2^256 + carry * 2^256) into [0, p) */
+static void fe_finalize(nova402_fe_t *r, const uint64_t t[4], uint64_t carry)
+{
+    /* t >= p iff the top three limbs are all ones and the low limb reaches p's */
+    uint64_t high_ones = (t[1] & t[2] & t[3]) == 0xFFFFFFFFFFFFFFFFULL;
+    uint64_t ge = high_ones & (t[0] >= FE_P[0]);
+    add_small(r->n, t, (0 - (carry | ge)) & FE_C);
+}
+
+static void fe_reduce(nova402_fe_t *r, const uint64_t t[8])
+{
+    uint64_t s[4], c;
+#if defined(__SIZEOF_INT128__)
+    nova402_u128_t acc;
+    int i;
+
+    /* s + c * 2^256 = t_lo + t_hi * C */
+    acc = 0;
+    for (i = 0; i < 4; i++) {
+        acc += (nova402_u128_t)t[4 + i] * FE_C + t[i];
+        s[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+
+    /* Fold the remaining ~34 bits */
+    acc = (nova402_u128_t)(uint64_t)acc * FE_C + s[0];
+    s[0] = (uint64_t)acc;
+    acc >>= 64;
+    for (i = 1; i < 4; i++) {
+        acc += s[i];
+        s[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    c = (uint64_t)acc;
+#else
+    uint64_t lo, hi;
+    int i;
+
+    /* s + c * 2^256 = t_lo + t_hi * C */
+    c = 0;
+    for (i = 0; i < 4; i++) {
+        mul64(t[4 + i], FE_C, &lo, &hi);
+        lo += c;
+        hi += (lo < c);
+        s[i] = t[i] + lo;
+        hi += (s[i] < lo);
+        c = hi;
+    }
+
+    /* Fold the remaining ~34 bits */
+    mul64(c, FE_C, &lo, &hi);
+    s[0] += lo;
+    hi += (s[0] < lo);
+    s[1] += hi;
+    c = (s[1] < hi);
+    s[2] += c;
+    c = (s[2] < c);
+    s[3] += c;
+    c = (s[3] < c);
+#endif
+
+    /* On wrap-around s is tiny, so adding C once more cannot carry */
+    add_small(s, s, c * FE_C);
+    fe_finalize(r, s, 0);
+}
+
+static int fe_set_b32(nova402_fe_t *r, const uint8_t *bytes)
+{
+    uint64_t t[4], u[4];
+    uint64_t borrow;
+
+    load_be(t, bytes);
+    borrow = sub_256(u, t, FE_P);
+    select_256(r->n, t, u, 0 - borrow);
+    return (int)borrow;
+}
+
+static void fe_get_b32(uint8_t *bytes, const nova402_fe_t *a)
+{
+    store_be(bytes, a->n);
+}
+
+static void fe_set_int(nova402_fe_t *r, uint64_t v)
+{
+    r->n[0] = v;
+    r->n[1] = 0;
+    r->n[2] = 0;
+    r->n[3] = 0;
+}
+
+static int fe_is_zero(const nova402_fe_t *a)
+{
+    return (a->n[0] | a->n[1] | a->n[2] | a->n[3]) == 0;
+}
+
+static int fe_is_odd(const nova402_fe_t *a)
+{
+    return (int)(a->n[0] & 1);
+}
+
+static int fe_equal(const nova402_fe_t *a, const nova402_fe_t *b)
+{
+    return ((a->n[0] ^ b->n[0]) | (a->n[1] ^ b->n[1]) |
+            (a->n[2] ^ b->n[2]) | (a->n[3] ^ b->n[3])) == 0;
+}
+
+static void fe_add(nova402_fe_t *r, const nova402_fe_t *a, const nova402_fe_t *b)
+{
+    uint64_t t[4];
+    uint64_t carry = add_256(t, a->n, b->n);
+    fe_finalize(r, t, carry);
+}
+
+static void fe_sub(nova402_fe_t *r, const nova402_fe_t *a, const nova402_fe_t *b)
+{
+    uint64_t t[4];
+    uint64_t borrow = sub_256(t, a->n, b->n);
+    int i;
+
+    /* On borrow add p, i.e. subtract 2^256 - p modulo 2^256 */
+    borrow = (0 - borrow) & FE_C;
+    for (i = 0; i < 4; i++) {
+        uint64_t d = t[i] - borrow;
+        borrow = (t[i] < borrow);
+        r->n[i] = d;
+    }
+}
+
+static void fe_neg(nova402_fe_t *r, const nova402_fe_t *a)
+{
+    nova402_fe_t zero;
+    fe_set_int(&zero, 0);
+    fe_sub(r, &zero, a);
+}
+
+static void fe_mul(nova402_fe_t *r, const nova402_fe_t *a, const nova402_fe_t *b)
+{
+    uint64_t t[8];
+    mul_256(t, a->n, b->n);
+    fe_reduce(r, t);
+}
+
+static void fe_sqr(nova402_fe_t *r, const nova402_fe_t *a)
+{
+    uint64_t t[8];
+    sqr_256(t, a->n);
+    fe_reduce(r, t);
+}
+
+static void fe_sqr_n(nova402_fe_t *r, const nova402_fe_t *a, int n)
+{
+    int i;
+
+    *r = *a;
+    for (i = 0; i < n; i++) {
+        fe_sqr(r, r);
+    }
+}
+
+/* Shared prefix of the inversion and square root addition chains */
+static void fe_pow_x223(nova402_fe_t *x2, nova402_fe_t *x3, nova402_fe_t *x22,
+                        nova402_fe_t *x223, const nova402_fe_t *a)
+{
+    nova402_fe_t x6, x9, x11, x44, x88, x176, x220, t;
+
+    fe_sqr(x2, a);
+    fe_mul(x2, x2, a);
+    fe_sqr(x3, x2);
+    fe_mul(x3, x3, a);
+    fe_sqr_n(&t, x3, 3);
+    fe_mul(&x6, &t, x3);
+    fe_sqr_n(&t, &x6, 3);
+    fe_mul(&x9, &t, x3);
+    fe_sqr_n(&t, &x9, 2);
+    fe_mul(&x11, &t, x2);
+    fe_sqr_n(&t, &x11, 11);
+    fe_mul(x22, &t, &x11);
+    fe_sqr_n(&t, x22, 22);
+    fe_mul(&x44, &t, x22);
+    fe_sqr_n(&t, &x44, 44);
+    fe_mul(&x88, &t, &x44);
+    fe_sqr_n(&t, &x88, 88);
+    fe_mul(&x176, &t, &x88);
+    fe_sqr_n(&t, &x176, 44);
+    fe_mul(&x220, &t, &x44);
+    fe_sqr_n(&t, &x220, 3);
+    fe_mul(x223, &t, x3);
+}
+
+static void fe_inv(nova402_fe_t *r, const nova402_fe_t *a)
+{
+    nova402_fe_t x2, x3, x22, x223, t;
+
+    /* a^(p-2) */
+    fe_pow_x223(&x2, &x3, &x22, &x223, a);
+    fe_sqr_n(&t, &x223, 23);
+    fe_mul(&t, &t, &x22);
+    fe_sqr_n(&t, &t, 5);
+    fe_mul(&t, &t, a);
+    fe_sqr_n(&t, &t, 3);
+    fe_mul(&t, &t, &x2);
+    fe_sqr_n(&t, &t, 2);
+    fe_mul(r, &t, a);
+}
+
+static int fe_sqrt(nova402_fe_t *r, const nova402_fe_t *a)
+{
+    nova402_fe_t x2, x3, x22, x223, t, check;
+
+    /* a^((p+1)/4), valid because p = 3 mod 4 */
+    fe_pow_x223(&x2, &x3, &x22, &x223, a);
+    fe_sqr_n(&t, &x223, 23);
+    fe_mul(&t, &t, &x22);
+    fe_sqr_n(&t, &t, 6);
+    fe_mul(&t, &t, &x2);
+    fe_sqr_n(&t, &t, 2);
+
+    fe_sqr(&check, &t);
+    *r = t;
+    return fe_equal(&check, a);
+}
+
+static void fe_inv_batch(nova402_fe_t *r, const nova402_fe_t *a, size_t n)
+{
+    nova402_fe_t u, t;
+    size_t i;
+
+    if (n == 0) {
+        return;
+    }
+
+    r[0] = a[0];
+    for (i = 1; i < n; i++) {
+        fe_mul(&r[i], &r[i - 1], &a[i]);
+    }
+
+    fe_inv(&u, &r[n - 1]);
+
+    for (i = n - 1; i > 0; i--) {
+        fe_mul(&t, &u, &r[i - 1]);
+        fe_mul(&u, &u, &a[i]);
+        r[i] = t;
+    }
+    r[0] = u;
+}
+
+/* ============================================
+ * SCALAR ARITHMETIC (mod n)
+ * ============================================ */
+
+static const uint64_t SC_N[4] = {
+    0xBFD25E8CD0364141ULL, 0xBAAEDCE6AF48A03BULL,
+    0xFFFFFFFFFFFFFFFEULL, 0xFFFFFFFFFFFFFFFFULL
+};
+
+/* 2^256 - n */
+static const uint64_t SC_NC[3] = {
+    0x402DA1732FC9BEBFULL, 0x4551231950B75FC4ULL, 0x1ULL
+};
+
+/* n / 2 */
+static const uint64_t SC_HALF_N[4] = {
+    0xDFE92F46681B20A0ULL, 0x5D576E7357A4501DULL,
+    0xFFFFFFFFFFFFFFFFULL, 0x7FFFFFFFFFFFFFFFULL
+};
+
+/* Reduce t (< 2^256 + carry * 2^256) into [0, n) */
+static void sc_finalize(nova402_scalar_t *r, const uint64_t t[4], uint64_t carry)
+{
+    uint64_t u[4];
+    uint64_t nc[4] = { SC_NC[0], SC_NC[1], SC_NC[2], 0 };
+    uint64_t c2 = add_256(u, t, nc);
+    select_256(r->n, u, t, 0 - (carry | c2));
+}
+
+/* t = t_lo + t_hi * (2^256 - n), in place */
+static void sc_fold(uint64_t t[8])
+{
+    uint64_t m[8];
+    int i, j;
+
+    for (i = 0; i < 4; i++) {
+        m[i] = t[i];
+        m[i + 4] = 0;
+    }
+    for (i = 0; i < 4; i++) {
+        uint64_t carry = 0;
+        for (j = 0; j < 3; j++) {
+            uint64_t lo, hi;
+            mul64(t[4 + i], SC_NC[j], &lo, &hi);
+            lo += m[i + j];
+            hi += (lo < m[i + j]);
+            lo += carry;
+            hi += (lo < carry);
+            m[i + j] = lo;
+            carry = hi;
+        }
+        for (j = i + 3; j < 8; j++) {
+            m[j] += carry;
+            carry = (m[j] < carry);
+        }
+    }
+    for (i = 0; i < 8; i++) {
+        t[i] = m[i];
+    }
+}
+
+static void sc_reduce(nova402_scalar_t *r, uint64_t t[8])
+{
+    /*
+     * Each fold shrinks the excess over 2^256 by ~127 bits:
+     * 2^512 -> 2^385 -> 2^258 -> 2^133 -> < 2^256.
+     */
+    sc_fold(t);
+    sc_fold(t);
+    sc_fold(t);
+    sc_fold(t);
+    sc_finalize(r, t, 0);
+}
+
+static int scalar_set_b32(nova402_scalar_t *r, const uint8_t *bytes)
+{
+    uint64_t t[4], u[4];
+    uint64_t borrow;
+
+    load_be(t, bytes);
+    borrow = sub_256(u, t, SC_N);
+    select_256(r->n, t, u, 0 - borrow);
+    return (int)borrow;
+}
+
+static void scalar_get_b32(uint8_t *bytes, const nova402_scalar_t *a)
+{
+    store_be(bytes, a->n);
+}
+
+static void scalar_set_int(nova402_scalar_t *r, uint64_t v)
+{
+    r->n[0] = v;
+    r->n[1] = 0;
+    r->n[2] = 0;
+    r->n[3] = 0;
+}
+
+static int scalar_is_zero(const nova402_scalar_t *a)
+{
+    return (a->n[0] | a->n[1] | a->n[2] | a->n[3]) == 0;
+}
+
+static int scalar_is_high(const nova402_scalar_t *a)
+{
+    uint64_t t[4];
+    return (int)sub_256(t, SC_HALF_N, a->n);
+}
+
+static void scalar_add(nova402_scalar_t *r, const nova402_scalar_t *a, const nova402_scalar_t *b)
+{
+    uint64_t t[4];
+    uint64_t carry = add_256(t, a->n, b->n);
+    sc_finalize(r, t, carry);
+}
+
+static void scalar_neg(nova402_scalar_t *r, const nova402_scalar_t *a)
+{
+    uint64_t t[4];
+    uint64_t mask = 0 - (uint64_t)(scalar_is_zero(a) == 0);
+    int i;
+
+    sub_256(t, SC_N, a->n);
+    for (i = 0; i < 4; i++) {
+        r->n[i] = t[i] & mask;
+    }
+}
+
+static void scalar_mul(nova402_scalar_t *r, const nova402_scalar_t *a, const nova402_scalar_t *b)
+{
+    uint64_t t[8];
+    mul_256(t, a->n, b->n);
+    sc_reduce(r, t);
+}
+
+static void scalar_inv(nova402_scalar_t *r, const nova402_scalar_t *a)
+{
+    /* a^(n-2), fixed 4-bit window over the public exponent */
+    static const uint64_t exp[4] = {
+        0xBFD25E8CD036413FULL, 0xBAAEDCE6AF48A03BULL,
+        0xFFFFFFFFFFFFFFFEULL, 0xFFFFFFFFFFFFFFFFULL
+    };
+    nova402_scalar_t table[16], acc;
+    int i, limb, nibble;
+
+    scalar_set_int(&table[0], 1);
+    table[1] = *a;
+    for (i = 2; i < 16; i++) {
+        scalar_mul(&table[i], &table[i - 1], a);
+    }
+
+    scalar_set_int(&acc, 1);
+    for (limb = 3; limb >= 0; limb--) {
+        for (nibble = 15; nibble >= 0; nibble--) {
+            for (i = 0; i < 4; i++) {
+                scalar_mul(&acc, &acc, &acc);
+            }
+            scalar_mul(&acc, &acc, &table[(exp[limb] >> (4 * nibble)) & 0xF]);
+        }
+    }
+    *r = acc;
+}
+
+static void scalar_inv_batch(nova402_scalar_t *r, const nova402_scalar_t *a, size_t n)
+{
+    nova402_scalar_t u, t;
+    size_t i;
+
+    if (n == 0) {
+        return;
+    }
+
+    r[0] = a[0];
+    for (i = 1; i < n; i++) {
+        scalar_mul(&r[i], &r[i - 1], &a[i]);
+    }
+
+    scalar_inv(&u, &r[n - 1]);
+
+    for (i = n - 1; i > 0; i--) {
+        scalar_mul(&t, &u, &r[i - 1]);
+        scalar_mul(&u, &u, &a[i]);
+        r[i] = t;
+    }
+    r[0] = u;
+}
+
+static unsigned int scalar_get_bits(const nova402_scalar_t *a, int offset, int count)
+{
+    unsigned int limb = (unsigned int)offset >> 6;
+    unsigned int shift = (unsigned int)offset & 63;
+    uint64_t v;
+
+    if (limb >= 4) {
+        return 0;
+    }
+    v = a->n[limb] >> shift;
+    if (shift + (unsigned int)count > 64 && limb + 1 < 4) {
+        v |= a->n[limb + 1] << (64 - shift);
+    }
+    return (unsigned int)(v & ((1u << count) - 1));
+}
+
+/* ============================================
+ * GLV ENDOMORPHISM
+ * ============================================ */
+
+/*
+ * lambda is a cube root of unity mod n and beta one mod p, with
+ * lambda * (x, y) = (beta * x, y) for every point on the curve.
+ */
+static const nova402_scalar_t SC_LAMBDA = {{
+    0xDF02967C1B23BD72ULL, 0x122E22EA20816678ULL,
+    0xA5261C028812645AULL, 0x5363AD4CC05C30E0ULL
+}};
+
+static const nova402_fe_t FE_BETA = {{
+    0xC1396C28719501EEULL, 0x9CF0497512F58995ULL,
+    0x6E64479EAC3434E9ULL, 0x7AE96A2B657C0710ULL
+}};
+
+/*
+ * Reduced lattice basis {(a1, b1), (a2, b2)} of the kernel of
+ * (k1, k2) -> k1 + k2 * lambda, stored as -b1 and -b2 mod n, and
+ * g1 = round(2^384 * b2 / n), g2 = round(2^384 * -b1 / n).
+ */
+static const nova402_scalar_t SC_MINUS_B1 = {{
+    0x6F547FA90ABFE4C3ULL, 0xE4437ED6010E8828ULL, 0, 0
+}};
+
+static const nova402_scalar_t SC_MINUS_B2 = {{
+    0xD765CDA83DB1562CULL, 0x8A280AC50774346DULL,
+    0xFFFFFFFFFFFFFFFEULL, 0xFFFFFFFFFFFFFFFFULL
+}};
+
+static const uint64_t SC_G1[4] = {
+    0xE893209A45DBB031ULL, 0x3DAA8A1471E8CA7FULL,
+    0xE86C90E49284EB15ULL, 0x3086D221A7D46BCDULL
+};
+
+static const uint64_t SC_G2[4] = {
+    0x1571B4AE8AC47F71ULL, 0x221208AC9DF506C6ULL,
+    0x6F547FA90ABFE4C4ULL, 0xE4437ED6010E8828ULL
+};
+
+/* r = round(a * g / 2^384), which is below 2^128 */
+static void scalar_mul_shift_384(nova402_scalar_t *r, const nova402_scalar_t *a, const uint64_t g[4])
+{
+    uint64_t t[8];
+    uint64_t round;
+
+    mul_256(t, a->n, g);
+    round = t[5] >> 63;
+    r->n[0] = t[6] + round;
+    r->n[1] = t[7] + (r->n[0] < round);
+    r->n[2] = 0;
+    r->n[3] = 0;
+}
+
+/*
+ * Split k into k1 + k2 * lambda (mod n) with |k1|, |k2| < 2^128; negative
+ * halves come out as n - |k|, which ecmult_wnaf() folds back into the sign.
+ */
+static void scalar_split_lambda(nova402_scalar_t *k1, nova402_scalar_t *k2, const nova402_scalar_t *k)
+{
+    nova402_scalar_t c1, c2, t;
+
+    scalar_mul_shift_384(&c1, k, SC_G1);
+    scalar_mul_shift_384(&c2, k, SC_G2);
+    scalar_mul(&c1, &c1, &SC_MINUS_B1);
+    scalar_mul(&c2, &c2, &SC_MINUS_B2);
+    scalar_add(k2, &c1, &c2);
+    scalar_mul(&t, k2, &SC_LAMBDA);
+    scalar_neg(&t, &t);
+    scalar_add(k1, &t, k);
+}
+
+/* Split k into its low and high 128 bits: k = k1 + k2 * 2^128 */
+static void scalar_split_128(nova402_scalar_t *k1, nova402_scalar_t *k2, const nova402_scalar_t *k)
+{
+    k1->n[0] = k->n[0];
+    k1->n[1] = k->n[1];
+    k1->n[2] = 0;
+    k1->n[3] = 0;
+    k2->n[0] = k->n[2];
+    k2->n[1] = k->n[3];
+    k2->n[2] = 0;
+    k2->n[3] = 0;
+}
+
+/* ============================================
+ * GROUP ARITHMETIC (y^2 = x^3 + 7, Jacobian)
+ * ============================================ */
+
+static void gej_set_ge(nova402_gej_t *r, const nova402_ge_t *a)
+{
+    r->x = a->x;
+    r->y = a->y;
+    fe_set_int(&r->z, 1);
+    r->infinity = a->infinity;
+}
+
+static void gej_double(nova402_gej_t *r, const nova402_gej_t *a)
+{
+    nova402_fe_t a2, b, c, d, e, f, t, x3, y3, z3;
+
+    if (a->infinity) {
+        r->infinity = 1;
+        return;
+    }
+
+    /* dbl-2009-l */
+    fe_sqr(&a2, &a->x);
+    fe_sqr(&b, &a->y);
+    fe_sqr(&c, &b);
+    fe_add(&t, &a->x, &b);
+    fe_sqr(&t, &t);
+    fe_sub(&t, &t, &a2);
+    fe_sub(&t, &t, &c);
+    fe_add(&d, &t, &t);
+    fe_add(&e, &a2, &a2);
+    fe_add(&e, &e, &a2);
+    fe_sqr(&f, &e);
+    fe_sub(&x3, &f, &d);
+    fe_sub(&x3, &x3, &d);
+    fe_sub(&t, &d, &x3);
+    fe_mul(&y3, &e, &t);
+    fe_add(&c, &c, &c);
+    fe_add(&c, &c, &c);
+    fe_add(&c, &c, &c);
+    fe_sub(&y3, &y3, &c);
+    fe_mul(&z3, &a->y, &a->z);
+    fe_add(&z3, &z3, &z3);
+
+    r->x = x3;
+    r->y = y3;
+    r->z = z3;
+    r->infinity = 0;
+}
+
+static void gej_add(nova402_gej_t *r, const nova402_gej_t *a, const nova402_gej_t *b)
+{
+    nova402_fe_t z1z1, z2z2, u1, u2, s1, s2, h, rr, hh, hhh, v, t, x3, y3, z3;
+
+    if (a->infinity) {
+        *r = *b;
+        return;
+    }
+    if (b->infinity) {
+        *r = *a;
+        return;
+    }
+
+    fe_sqr(&z1z1, &a->z);
+    fe_sqr(&z2z2, &b->z);
+    fe_mul(&u1, &a->x, &z2z2);
+    fe_mul(&u2, &b->x, &z1z1);
+    fe_mul(&s1, &a->y, &b->z);
+    fe_mul(&s1, &s1, &z2z2);
+    fe_mul(&s2, &b->y, &a->z);
+    fe_mul(&s2, &s2, &z1z1);
+    fe_sub(&h, &u2, &u1);
+    fe_sub(&rr, &s2, &s1);
+
+    if (fe_is_zero(&h)) {
+        if (fe_is_zero(&rr)) {
+            gej_double(r, a);
+        } else {
+            r->infinity = 1;
+        }
+        return;
+    }
+
+    fe_sqr(&hh, &h);
+    fe_mul(&hhh, &h, &hh);
+    fe_mul(&v, &u1, &hh);
+    fe_sqr(&x3, &rr);
+    fe_sub(&x3, &x3, &hhh);
+    fe_sub(&x3, &x3, &v);
+    fe_sub(&x3, &x3, &v);
+    fe_sub(&t, &v, &x3);
+    fe_mul(&y3, &rr, &t);
+    fe_mul(&t, &s1, &hhh);
+    fe_sub(&y3, &y3, &t);
+    fe_mul(&z3, &a->z, &b->z);
+    fe_mul(&z3, &z3, &h);
+
+    r->x = x3;
+    r->y = y3;
+    r->z = z3;
+    r->infinity = 0;
+}
+
+static void gej_add_ge(nova402_gej_t *r, const nova402_gej_t *a, const nova402_ge_t *b)
+{
+    nova402_fe_t z1z1, u2, s2, h, rr, hh, hhh, v, t, x3, y3, z3;
+
+    if (a->infinity) {
+        gej_set_ge(r, b);
+        return;
+    }
+    if (b->infinity) {
+        *r = *a;
+        return;
+    }
+
+    fe_sqr(&z1z1, &a->z);
+    fe_mul(&u2, &b->x, &z1z1);
+    fe_mul(&s2, &b->y, &a->z);
+    fe_mul(&s2, &s2, &z1z1);
+    fe_sub(&h, &u2, &a->x);
+    fe_sub(&rr, &s2, &a->y);
+
+    if (fe_is_zero(&h)) {
+        if (fe_is_zero(&rr)) {
+            gej_double(r, a);
+        } else {
+            r->infinity = 1;
+        }
+        return;
+    }
+
+    fe_sqr(&hh, &h);
+    fe_mul(&hhh, &h, &hh);
+    fe_mul(&v, &a->x, &hh);
+    fe_sqr(&x3, &rr);
+    fe_sub(&x3, &x3, &hhh);
+    fe_sub(&x3, &x3, &v);
+    fe_sub(&x3, &x3, &v);
+    fe_sub(&t, &v, &x3);
+    fe_mul(&y3, &rr, &t);
+    fe_mul(&t, &a->y, &hhh);
+    fe_sub(&y3, &y3, &t);
+    fe_mul(&z3, &a->z, &h);
+
+    r->x = x3;
+    r->y = y3;
+    r->z = z3;
+    r->infinity = 0;
+}
+
+static int ge_set_xo(nova402_ge_t *r, const nova402_fe_t *x, int odd)
+{
+    nova402_fe_t x3, seven, y2, y;
+
+    fe_sqr(&x3, x);
+    fe_mul(&x3, &x3, x);
+    fe_set_int(&seven, 7);
+    fe_add(&y2, &x3, &seven);
+    if (!fe_sqrt(&y, &y2)) {
+        return 0;
+    }
+    if (fe_is_odd(&y) != (odd & 1)) {
+        fe_neg(&y, &y);
+    }
+    r->x = *x;
+    r->y = y;
+    r->infinity = 0;
+    return 1;
+}
+
+/* ============================================
+ * DOUBLE-SCALAR MULTIPLICATION
+ * ============================================ */
+
+#define WINDOW_A 5
+#define WINDOW_G 7
+#define TABLE_SIZE(w) (1 << ((w) - 2))
+#define WNAF_BITS_HALF 129
+
+/* Odd multiples 1G, 3G, ..., 63G */
+static const nova402_ge_storage_t g_odd_multiples[TABLE_SIZE(WINDOW_G)] = {
+    {{{0x59F2815B16F81798ULL, 0x029BFCDB2DCE28D9ULL,
+       0x55A06295CE870B07ULL, 0x79BE667EF9DCBBACULL}},
+     {{0x9C47D08FFB10D4B8ULL, 0xFD17B448A6855419ULL,
+       0x5DA4FBFC0E1108A8ULL, 0x483ADA7726A3C465ULL}}},
+    {{{0x8601F113BCE036F9ULL, 0xB531C845836F99B0ULL,
+       0x49344F85F89D5229ULL, 0xF9308A019258C310ULL}},
+     {{0x6CB9FD7584B8E672ULL, 0x6500A99934C2231BULL,
+       0x0FE337E62A37F356ULL, 0x388F7B0F632DE814ULL}}},
+    {{{0xCBA8D569B240EFE4ULL, 0xE88B84BDDC619AB7ULL,
+       0x55B4A7250A5C5128ULL, 0x2F8BDE4D1A072093ULL}},
+     {{0xDCA87D3AA6AC62D6ULL, 0xF788271BAB0D6840ULL,
+       0xD4DBA9DDA6C9C426ULL, 0xD8AC222636E5E3D6ULL}}},
+    {{{0xE92BDDEDCAC4F9BCULL, 0x3D419B7E0330E39CULL,
+       0xA398F365F2EA7A0EULL, 0x5CBDF0646E5DB4EAULL}},
+     {{0xA5082628087264DAULL, 0xA813D0B813FDE7B5ULL,
+       0xA3178D6D861A54DBULL, 0x6AEBCA40BA255960ULL}}},
+    {{{0xC35F110DFC27CCBEULL, 0xE09796974C57E714ULL,
+       0x09AD178A9F559ABDULL, 0xACD484E2F0C7F653ULL}},
+     {{0x05CC262AC64F9C37ULL, 0xADD888A4375F8E0FULL,
+       0x64380971763B61E9ULL, 0xCC338921B0A7D9FDULL}}},
+    {{{0xBBEC17895DA008CBULL, 0x5649980BE5C17891ULL,
+       0x5EF4246B70C65AACULL, 0x774AE7F858A9411EULL}},
+     {{0x301D74C9C953C61BULL, 0x372DB1E2DFF9D6A8ULL,
+       0x0243DD56D7B7B365ULL, 0xD984A032EB6B5E19ULL}}},
+    {{{0xDEEDDF8F19405AA8ULL, 0xB075FBC6610E58CDULL,
+       0xC7D1D205C3748651ULL, 0xF28773C2D975288BULL}},
+     {{0x29B5CB52DB03ED81ULL, 0x3A1A06DA521FA91FULL,
+       0x758212EB65CDAF47ULL, 0x0AB0902E8D880A89ULL}}},
+    {{{0x44ADBCF8E27E080EULL, 0x31E5946F3C85F79EULL,
+       0x5A465AE3095FF411ULL, 0xD7924D4F7D43EA96ULL}},
+     {{0xC504DC9FF6A26B58ULL, 0xEA40AF2BD896D3A5ULL,
+       0x83842EC228CC6DEFULL, 0x581E2872A86C72A6ULL}}},
+    {{{0x66E4FAA04A2D4A34ULL, 0xEB9898AE79B97687ULL,
+       0xA420FEE807EACF21ULL, 0xDEFDEA4CDB677750ULL}},
+     {{0xCFB199F69E56EB77ULL, 0xCED1F4A04A95C0F6ULL,
+       0xE997B0EAD2A93DAEULL, 0x4211AB0694635168ULL}}},
+    {{{0x7475656138385B6CULL, 0xF06ACFEBD7E86D27ULL,
+       0x93EF5CFF444F4979ULL, 0x2B4EA0A797A443D2ULL}},
+     {{0xB570C854E5C09B7AULL, 0x1A01F60C50269763ULL,
+       0xB343083B5A1C8613ULL, 0x85E89BC037945D93ULL}}},
+    {{{0x81340AEF25BE59D5ULL, 0x1D9AD40271F81071ULL,
+       0x4F93FA332CE33330ULL, 0x352BBF4A4CDD1256ULL}},
+     {{0x67BD3D8BCF81998CULL, 0x4A1B3B2E71B1039CULL,
+       0xD59C18259DDA3E1FULL, 0x321EB4075348F534ULL}}},
+    {{{0xDC9CDADD4ECACC3FULL, 0xE42AB8DFEFF5FF29ULL,
+       0x0230010559879124ULL, 0x2FA2104D6B38D11BULL}},
+     {{0x423BA76B532B7D67ULL, 0x181D70ECFC882648ULL,
+       0xB64569335BD5DD80ULL, 0x02DE1068295DD865ULL}}},
+    {{{0x69CA0CD7F5453714ULL, 0x263C3D84E09572E2ULL,
+       0xAB21A9B066EDDA83ULL, 0x9248279B09B4D68DULL}},
+     {{0xE54A32CE97CB3402ULL, 0x3FC0DE2A887912FFULL,
+       0x5D1AA71BDEA2B1FFULL, 0x73016F7BF234AADEULL}}},
+    {{{0x7E996D443DEE8729ULL, 0x2F570E144BF615C0ULL,
+       0x8E70132FB0BEB752ULL, 0xDAED4F2BE3A8BF27ULL}},
+     {{0xAB40E52290BE1C55ULL, 0x3F83C230F3AFA726ULL,
+       0xD4A1ACA87EF8D700ULL, 0xA69DCE4A7D6C98E8ULL}}},
+    {{{0xE6A3B5E87D22E7DBULL, 0x11ECD9E9FDF281B0ULL,
+       0x8ACF28D7CBB19F90ULL, 0xC44D12C7065D812EULL}},
+     {{0xA039063F0E0E6482ULL, 0x0E106E861EDF61C5ULL,
+       0x76C45926C982FDACULL, 0x2119A460CE326CDCULL}}},
+    {{{0xB61C65CBD269E6B4ULL, 0x152B695336C28063ULL,
+       0xC89A20CFDED60853ULL, 0x6A245BF6DC698504ULL}},
+     {{0xFD5E6348100D8A82ULL, 0x8B33BA48D0423B6EULL,
+       0x8B3F5126F16A24ADULL, 0xE022CF42C2BD4A70ULL}}},
+    {{{0xF95AE57F0D0BD6A5ULL, 0xCE13300B0BEC1146ULL,
+       0xC077E3D2FE541084ULL, 0x1697FFA6FD9DE627ULL}},
+     {{0xADEE9D63D01B2396ULL, 0xA2CF15009E498AE7ULL,
+       0x27561506E4557433ULL, 0xB9C398F186806F5DULL}}},
+    {{{0xF982345EF27A7479ULL, 0x9DEB8360FFB7F61DULL,
+       0x986D0F07E834CB0DULL, 0x605BDB019981718BULL}},
+     {{0x3B01E1E9056B8C49ULL, 0xC26BFAE84FB14DB4ULL,
+       0x81A78D93EC96FE23ULL, 0x02972D2DE4F8D206ULL}}},
+    {{{0xFE31C7E9D87FF33DULL, 0xDCB01C354959B10CULL,
+       0x7402FDC45A215E10ULL, 0x62D14DAB4150BF49ULL}},
+     {{0x35F5642483B25EAFULL, 0x01AA132967AB4722ULL,
+       0x98088A1950EED0DBULL, 0x80FC06BD8CC5B010ULL}}},
+    {{{0x5E555C2F86308B6FULL, 0x2C50E9F56B9B8B42ULL,
+       0xDE5B4B06C408E56BULL, 0x80C60AD0040F27DAULL}},
+     {{0x1AA01F56430BD57AULL, 0xA65EED4CBE7024EBULL,
+       0x26E66BAD7FE72F70ULL, 0x1C38303F1CC5C30FULL}}},
+    {{{0x9D5EABB0FA03C8FBULL, 0x4CC5DC9487D84704ULL,
+       0xAA74C6348CC54D34ULL, 0x7A9375AD6167AD54ULL}},
+     {{0x02D499EC224DC7F7ULL, 0xBDC59EA10C70CE2BULL,
+       0x09559E0D79269046ULL, 0x0D0E3FA9ECA87269ULL}}},
+    {{{0x4BB51F459BC3FFC9ULL, 0xBB408EC39B68DF50ULL,
+       0x907A9ED045447A79ULL, 0xD528ECD9B696B54CULL}},
+     {{0x063465B521409933ULL, 0xBC4345405C520DBCULL,
+       0x9966F21881FD656EULL, 0xEECF41253136E5F9ULL}}},
+    {{{0x87231808F8B45963ULL, 0x5266115E4A7ECB13ULL,
+       0xEA25F514E8ECDAD0ULL, 0x049370A4B5F43412ULL}},
+     {{0xB653052A12949C9AULL, 0x54C3F3AFBB5B6764ULL,
+       0x8B3081B0512FD62AULL, 0x758F3F41AFD6ED42ULL}}},
+    {{{0xF1C13EB1FC345D74ULL, 0x881D811E0E1498E2ULL,
+       0xD73DF930D64702EFULL, 0x77F230936EE88CBBULL}},
+     {{0xBE8EB3C7671C60D6ULL, 0x96C95330D97077CBULL,
+       0x0A08266E9BA1B378ULL, 0x958EF42A7886B640ULL}}},
+    {{{0xEB28531B7739F530ULL, 0x58C80074AB9D4DBAULL,
+       0xEA44887E5C7C0BCEULL, 0xF2DAC991CC4CE4B9ULL}},
+     {{0x1A117DBA703A3C37ULL, 0x9EB5FBEB0598E4FDULL,
+       0x4DA1F32DEC2531DFULL, 0xE0DEDC9B3B2F8DADULL}}},
+    {{{0xBCBA4850C690D45BULL, 0x5A216CDFC9DAE3DEULL,
+       0x1B4BE8FBBE252012ULL, 0x463B3D9F662621FBULL}},
+     {{0x1CB377B01AF7307EULL, 0xC622E27C970A1DE3ULL,
+       0x43114306DD8622D7ULL, 0x5ED430D78C296C35ULL}}},
+    {{{0xA32496B49998F247ULL, 0x6B98FAC14328A2D1ULL,
+       0x09232D4AFF3B5997ULL, 0xF16F804244E46E2AULL}},
+     {{0xD6579962C4E31DF6ULL, 0x2A6C53C26E5CCE26ULL,
+       0x13D206FCDF4E33D9ULL, 0xCEDABD9B82203F7EULL}}},
+    {{{0x369E15F7151D41D1ULL, 0x5D245315ACE27C65ULL,
+       0xB0352B7A14311AF5ULL, 0xCAF754272DC84563ULL}},
+     {{0xC32F908318A04476ULL, 0x5F4FA9B7962232A5ULL,
+       0xA41B643FA5E46057ULL, 0xCB474660EF35F5F2ULL}}},
+    {{{0x24497BC86F082120ULL, 0x44A09C07CB86D7C1ULL,
+       0xF85D0F1709979D8BULL, 0x2600CA4B282CB986ULL}},
+     {{0x4B0BE9475A7E4B40ULL, 0x5AC6BE74AB5F0EF4ULL,
+       0xA693B03FCDDBB45DULL, 0x4119B88753C15BD6ULL}}},
+    {{{0xC602A7746998E435ULL, 0x01C48685E24F7DC8ULL,
+       0x338EC53CD12220BCULL, 0x7635CA72D7E8432CULL}},
+     {{0xD9E76F302C5B9C61ULL, 0x4ECFC061D57048BAULL,
+       0x3D1D5E590F78E6D7ULL, 0x091B649609489D61ULL}}},
+    {{{0xC1A50743BF56CC18ULL, 0xB7F2B33479D468FBULL,
+       0xDBBF4A87DEEE8A66ULL, 0x754E3239F325570CULL}},
+     {{0x0C5D98093C536683ULL, 0x23EE33D0197A695DULL,
+       0xB3CD0ED304EA49A0ULL, 0x0673FB86E5BDA30FULL}}},
+    {{{0x9FE2694691D9B9E8ULL, 0x330800661D1C952FULL,
+       0xFF57859C82D570F0ULL, 0xE3E6BD1071A1E96AULL}},
+     {{0x67002AF4920E37F5ULL, 0xA5A2283993E90C41ULL,
+       0x40C0AA58379A3CB6ULL, 0x59C9E0BBA394E76FULL}}}
+};
+
+/* Width-w NAF of a; returns the number of digits used */
+static int ecmult_wnaf(int *wnaf, int len, const nova402_scalar_t *a, int w)
+{
+    nova402_scalar_t s = *a;
+    int last_set_bit = -1;
+    int bit = 0;
+    int sign = 1;
+    int carry = 0;
+
+    memset(wnaf, 0, (size_t)len * sizeof(wnaf[0]));
+
+    /* Keep s below 2^255 so the final carry always fits */
+    if (scalar_get_bits(&s, 255, 1)) {
+        scalar_neg(&s, &s);
+        sign = -1;
+    }
+
+    while (bit < len) {
+        int now, word;
+
+        if (scalar_get_bits(&s, bit, 1) == (unsigned int)carry) {
+            bit++;
+            continue;
+        }
+
+        now = w;
+        if (now > len - bit) {
+            now = len - bit;
+        }
+
+        word = (int)scalar_get_bits(&s, bit, now) + carry;
+        carry = (word >> (w - 1)) & 1;
+        word -= carry << w;
+
+        wnaf[bit] = sign * word;
+        last_set_bit = bit;
+        bit += now;
+    }
+
+    return last_set_bit + 1;
+}
+
+/* Entry for a non-zero wNAF digit, optionally mapped through the endomorphism */
+static void ge_from_table(nova402_ge_t *r, const nova402_ge_storage_t *table, int digit,
+                          int lambda)
+{
+    const nova402_ge_storage_t *e = &table[((digit > 0 ? digit : -digit) - 1) / 2];
+
+    r->x = e->x;
+    r->y = e->y;
+    r->infinity = 0;
+    if (lambda) {
+        fe_mul(&r->x, &r->x, &FE_BETA);
+    }
+    if (digit < 0) {
+        fe_neg(&r->y, &r->y);
+    }
+}
+
+/*
+ * r = na * A + ng * G, with pre_a holding the affine odd multiples of A.
+ *
+ * Every scalar is split into two 128-bit halves so the loop needs only
+ * 128 doublings: na by the GLV endomorphism, ng likewise when no context
+ * is given, or as low/high halves against the context's G and 2^128 G
+ * tables otherwise.
+ */
+static void ecmult_double(nova402_gej_t *r, const nova402_ge_storage_t *pre_a,
+                          const nova402_scalar_t *na, const nova402_scalar_t *ng,
+                          const nova402_secp256k1_ctx_t *ctx)
+{
+    int wnaf_a1[WNAF_BITS_HALF], wnaf_a2[WNAF_BITS_HALF];
+    int wnaf_g1[WNAF_BITS_HALF], wnaf_g2[WNAF_BITS_HALF];
+    int bits, i;
+    nova402_scalar_t a1, a2, g1, g2;
+    const nova402_ge_storage_t *table_g1, *table_g2;
+    int window_g, lambda_g2;
+    nova402_ge_t t;
+
+    scalar_split_lambda(&a1, &a2, na);
+
+    if (ctx) {
+        scalar_split_128(&g1, &g2, ng);
+        table_g1 = ctx->g;
+        table_g2 = ctx->g128;
+        window_g = ctx->window;
+        lambda_g2 = 0;
+    } else {
+        scalar_split_lambda(&g1, &g2, ng);
+        table_g1 = g_odd_multiples;
+        table_g2 = g_odd_multiples;
+        window_g = WINDOW_G;
+        lambda_g2 = 1;
+    }
+
+    bits = ecmult_wnaf(wnaf_a1, WNAF_BITS_HALF, &a1, WINDOW_A);
+    i = ecmult_wnaf(wnaf_a2, WNAF_BITS_HALF, &a2, WINDOW_A);
+    bits = i > bits ? i : bits;
+    i = ecmult_wnaf(wnaf_g1, WNAF_BITS_HALF, &g1, window_g);
+    bits = i > bits ? i : bits;
+    i = ecmult_wnaf(wnaf_g2, WNAF_BITS_HALF, &g2, window_g);
+    bits = i > bits ? i : bits;
+
+    r->infinity = 1;
+    for (i = bits - 1; i >= 0; i--) {
+        gej_double(r, r);
+        if (wnaf_a1[i] != 0) {
+            ge_from_table(&t, pre_a, wnaf_a1[i], 0);
+            gej_add_ge(r, r, &t);
+        }
+        if (wnaf_a2[i] != 0) {
+            ge_from_table(&t, pre_a, wnaf_a2[i], 1);
+            gej_add_ge(r, r, &t);
+        }
+        if (wnaf_g1[i] != 0) {
+            ge_from_table(&t, table_g1, wnaf_g1[i], 0);
+            gej_add_ge(r, r, &t);
+        }
+        if (wnaf_g2[i] != 0) {
+            ge_from_table(&t, table_g2, wnaf_g2[i], lambda_g2);
+            gej_add_ge(r, r, &t);
+        }
+    }
+}
+
+/* ============================================
+ * BATCH RECOVERY
+ * ============================================ */
+
+static int parse_signature(const nova402_signature_t *sig, nova402_scalar_t *r,
+                           nova402_scalar_t *s, nova402_ge_t *rpoint)
+{
+    nova402_fe_t rx;
+    int recid;
+
+    if (sig->v >= 27) {
+        recid = sig->v - 27;
+    } else {
+        recid = sig->v;
+    }
+    if (recid != 0 && recid != 1) {
+        return 0;
+    }
+
+    if (!scalar_set_b32(r, sig->r) || scalar_is_zero(r)) {
+        return 0;
+    }
+    if (!scalar_set_b32(s, sig->s) || scalar_is_zero(s)) {
+        return 0;
+    }
+
+    /* EIP-2: only the low-s form is accepted on chain */
+    if (scalar_is_high(s)) {
+        return 0;
+    }
+
+    /* r < n < p, so r is always a valid field element */
+    fe_set_b32(&rx, sig->r);
+    return ge_set_xo(rpoint, &rx, recid);
+}
+
+static size_t recover_chunk(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t n,
+    nova402_address_t *signers,
+    uint8_t *ok)
+{
+    nova402_scalar_t r[NOVA402_BATCH_CHUNK], s[NOVA402_BATCH_CHUNK];
+    nova402_scalar_t rinv[NOVA402_BATCH_CHUNK];
+    nova402_ge_t rpoint[NOVA402_BATCH_CHUNK];
+    nova402_gej_t q[NOVA402_BATCH_CHUNK];
+    nova402_gej_t prej[TABLE_SIZE(WINDOW_A)];
+    nova402_ge_storage_t pre[NOVA402_BATCH_CHUNK][TABLE_SIZE(WINDOW_A)];
+    nova402_fe_t zs[NOVA402_BATCH_CHUNK * TABLE_SIZE(WINDOW_A)];
+    nova402_fe_t zinv[NOVA402_BATCH_CHUNK * TABLE_SIZE(WINDOW_A)];
+    uint8_t pubkeys[NOVA402_BATCH_CHUNK][64];
+    const uint8_t *inputs[NOVA402_BATCH_CHUNK];
+    size_t lengths[NOVA402_BATCH_CHUNK];
+    size_t index[NOVA402_BATCH_CHUNK];
+    nova402_hash_t hashes[NOVA402_BATCH_CHUNK];
+    size_t i, count = 0;
+    int k;
+
+    for (i = 0; i < n; i++) {
+        ok[i] = (uint8_t)parse_signature(&signatures[i], &r[i], &s[i], &rpoint[i]);
+        if (!ok[i]) {
+            scalar_set_int(&r[i], 1);
+        }
+    }
+
+    /* One shared inversion for every r^-1 in the chunk */
+    scalar_inv_batch(rinv, r, n);
+
+    /* Odd multiples of each R in Jacobian form, collecting the Z coordinates */
+    for (i = 0; i < n; i++) {
+        nova402_gej_t d;
+
+        if (!ok[i]) {
+            for (k = 0; k < TABLE_SIZE(WINDOW_A); k++) {
+                fe_set_int(&zs[i * TABLE_SIZE(WINDOW_A) + k], 1);
+            }
+            continue;
+        }
+
+        gej_set_ge(&prej[0], &rpoint[i]);
+        gej_double(&d, &prej[0]);
+        for (k = 1; k < TABLE_SIZE(WINDOW_A); k++) {
+            gej_add(&prej[k], &prej[k - 1], &d);
+        }
+        for (k = 0; k < TABLE_SIZE(WINDOW_A); k++) {
+            pre[i][k].x = prej[k].x;
+            pre[i][k].y = prej[k].y;
+            zs[i * TABLE_SIZE(WINDOW_A) + k] = prej[k].z;
+        }
+    }
+
+    /* One shared inversion to bring every table to affine form */
+    fe_inv_batch(zinv, zs, n * TABLE_SIZE(WINDOW_A));
+
+    for (i = 0; i < n; i++) {
+        nova402_scalar_t e, u1, u2;
+
+        if (!ok[i]) {
+            continue;
+        }
+
+        for (k = 0; k < TABLE_SIZE(WINDOW_A); k++) {
+            const nova402_fe_t *zi = &zinv[i * TABLE_SIZE(WINDOW_A) + k];
+            nova402_fe_t zi2, zi3;
+            fe_sqr(&zi2, zi);
+            fe_mul(&zi3, &zi2, zi);
+            fe_mul(&pre[i][k].x, &pre[i][k].x, &zi2);
+            fe_mul(&pre[i][k].y, &pre[i][k].y, &zi3);
+        }
+
+        /* Q = r^-1 (s R - e G) */
+        scalar_set_b32(&e, messages[i].bytes);
+        scalar_mul(&u1, &e, &rinv[i]);
+        scalar_neg(&u1, &u1);
+        scalar_mul(&u2, &s[i], &rinv[i]);
+
+        ecmult_double(&q[i], pre[i], &u2, &u1, ctx);
+        if (q[i].infinity) {
+            ok[i] = 0;
+        }
+    }
+
+    /* One shared inversion to bring every public key to affine form */
+    for (i = 0; i < n; i++) {
+        if (ok[i]) {
+            zs[i] = q[i].z;
+        } else {
+            fe_set_int(&zs[i], 1);
+        }
+    }
+    fe_inv_batch(zinv, zs, n);
+
+    for (i = 0; i < n; i++) {
+        nova402_fe_t zi2, zi3, x, y;
+
+        if (!ok[i]) {
+            continue;
+        }
+
+        fe_sqr(&zi2, &zinv[i]);
+        fe_mul(&zi3, &zi2, &zinv[i]);
+        fe_mul(&x, &q[i].x, &zi2);
+        fe_mul(&y, &q[i].y, &zi3);
+        fe_get_b32(pubkeys[count], &x);
+        fe_get_b32(pubkeys[count] + 32, &y);
+        inputs[count] = pubkeys[count];
+        lengths[count] = sizeof(pubkeys[count]);
+        index[count] = i;
+        count++;
+    }
+
+    /* Addresses: hash all recovered keys through the multi-buffer kernel */
+    if (nova402_keccak256_many(inputs, lengths, count, hashes) != NOVA402_SUCCESS) {
+        memset(ok, 0, n);
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        memcpy(signers[index[i]].bytes, hashes[i].bytes + 12, NOVA402_ADDRESS_SIZE);
+    }
+
+    return count;
+}
+
+size_t NOVA402_SECP256K1_RECOVER(
+    const nova402_secp256k1_ctx_t *ctx,
+    const nova402_hash_t *messages,
+    const nova402_signature_t *signatures,
+    size_t count,
+    nova402_address_t *signers,
+    uint8_t *ok)
+{
+    size_t offset, recovered = 0;
+
+    for (offset = 0; offset < count; offset += NOVA402_BATCH_CHUNK) {
+        size_t n = count - offset;
+        if (n > NOVA402_BATCH_CHUNK) {
+            n = NOVA402_BATCH_CHUNK;
+        }
+        recovered += recover_chunk(ctx, messages + offset, signatures + offset, n,
+                                   signers + offset, ok + offset);
+    }
+
+    return recovered;
+}
+
+/* ============================================
+ * FIXED-BASE COMB
+ * ============================================ */
+
+/* (2^COMB_BITS - 1) mod n and 1/2 mod n, for the signed-digit recoding */
+static const nova402_scalar_t SC_COMB_OFFSET = {{
+    0x2DA1732FC9BEBEFFULL, 0x51231950B75FC440ULL, 0x0000000000000145ULL, 0
+}};
+static const nova402_scalar_t SC_INV2 = {{
+    0xDFE92F46681B20A1ULL, 0x5D576E7357A4501DULL, 0xFFFFFFFFFFFFFFFFULL, 0x7FFFFFFFFFFFFFFFULL
+}};
+
+/*
+ * Block `block` entry for the tooth bits `bits`, read by scanning the whole
+ * block so the access pattern does not depend on the secret. The entries
+ * only cover a set top tooth; a clear one selects the complement, negated.
+ */
+static void comb_lookup(nova402_ge_t *r, int block, unsigned int bits)
+{
+    const nova402_ge_storage_t *table = nova402_secp256k1_comb[block];
+    uint64_t negate = (uint64_t)((bits >> (NOVA402_COMB_TEETH - 1)) & 1) - 1;
+    unsigned int index = (bits ^ (unsigned int)negate) & (NOVA402_COMB_POINTS - 1);
+    nova402_fe_t neg_y;
+    int i;
+
+    memset(r, 0, sizeof(*r));
+    for (i = 0; i < NOVA402_COMB_POINTS; i++) {
+        uint64_t mask = 0 - (uint64_t)(((unsigned int)i ^ index) == 0);
+        select_256(r->x.n, table[i].x.n, r->x.n, mask);
+        select_256(r->y.n, table[i].y.n, r->y.n, mask);
+    }
+    fe_neg(&neg_y, &r->y);
+    select_256(r->y.n, neg_y.n, r->y.n, negate);
+}
+
+/*
+ * r = k G, computed as (k - blind) G + blind_point when blind is given.
+ *
+ * The COMB_BITS digits of d = (k - blind + 2^COMB_BITS - 1) / 2 are read
+ * as +1/-1, so every block adds a point and the sequence of group
+ * operations is the same for every scalar. With a random blind the
+ * additions never meet the doubling or infinity cases in practice.
+ */
+static void ecmult_gen(nova402_gej_t *r, const nova402_scalar_t *k, const nova402_scalar_t *blind,
+                       const nova402_ge_storage_t *blind_point)
+{
+    nova402_scalar_t d, t;
+    nova402_ge_t p;
+    int s, block, tooth;
+
+    d = *k;
+    if (blind) {
+        scalar_neg(&t, blind);
+        scalar_add(&d, &d, &t);
+    }
+    scalar_add(&d, &d, &SC_COMB_OFFSET);
+    scalar_mul(&d, &d, &SC_INV2);
+
+    for (s = NOVA402_COMB_SPACING - 1; s >= 0; s--) {
+        if (s != NOVA402_COMB_SPACING - 1) {
+            gej_double(r, r);
+        }
+        for (block = 0; block < NOVA402_COMB_BLOCKS; block++) {
+            unsigned int bits = 0;
+
+            for (tooth = 0; tooth < NOVA402_COMB_TEETH; tooth++) {
+                int bit = (block * NOVA402_COMB_TEETH + tooth) * NOVA402_COMB_SPACING + s;
+                bits |= scalar_get_bits(&d, bit, 1) << tooth;
+            }
+            comb_lookup(&p, block, bits);
+            if (s == NOVA402_COMB_SPACING - 1 && block == 0) {
+                gej_set_ge(r, &p);
+            } else {
+                gej_add_ge(r, r, &p);
+            }
+        }
+    }
+
+    if (blind) {
+        p.x = blind_point->x;
+        p.y = blind_point->y;
+        p.infinity = 0;
+        gej_add_ge(r, r, &p);
+    }
+
+    nova402_memzero(&d, sizeof(d));
+    nova402_memzero(&t, sizeof(t));
+}
+
+/* ============================================
+ * BATCH SIGNING
+ * ============================================ */
+
+static size_t sign_chunk(
+    const nova402_signer_t *signer,
+    const nova402_hash_t *digests,
+    const nova402_hash_t *nonces,
+    size_t n,
+    nova402_signature_t *signatures,
+    uint8_t *ok)
+{
+    nova402_scalar_t k[NOVA402_BATCH_CHUNK], kinv[NOVA402_BATCH_CHUNK];
+    nova402_gej_t rj[NOVA402_BATCH_CHUNK];
+    nova402_fe_t zs[NOVA402_BATCH_CHUNK], zinv[NOVA402_BATCH_CHUNK];
+    size_t i, count = 0;
+
+    for (i = 0; i < n; i++) {
+        scalar_set_b32(&k[i], nonces[i].bytes);
+        ecmult_gen(&rj[i], &k[i], &signer->blind, &signer->blind_point);
+        zs[i] = rj[i].z;
+    }
+
+    /* One shared inversion for the affine R of the chunk, one for k^-1 */
+    fe_inv_batch(zinv, zs, n);
+    scalar_inv_batch(kinv, k, n);
+
+    for (i = 0; i < n; i++) {
+        nova402_scalar_t r, s, e, neg_s;
+        nova402_fe_t zi2, zi3, x, y;
+        uint8_t xb[32];
+        int valid, high, recid;
+
+        fe_sqr(&zi2, &zinv[i]);
+        fe_mul(&zi3, &zi2, &zinv[i]);
+        fe_mul(&x, &rj[i].x, &zi2);
+        fe_mul(&y, &rj[i].y, &zi3);
+        fe_get_b32(xb, &x);
+
+        /* r = x mod n; x >= n would need recovery id 2 or 3, so retry */
+        valid = scalar_set_b32(&r, xb);
+        recid = fe_is_odd(&y);
+
+        /* s = k^-1 (e + r d), then the low-s form of EIP-2 */
+        scalar_set_b32(&e, digests[i].bytes);
+        scalar_mul(&s, &r, &signer->key);
+        scalar_add(&s, &s, &e);
+        scalar_mul(&s, &s, &kinv[i]);
+        high = scalar_is_high(&s);
+        scalar_neg(&neg_s, &s);
+        select_256(s.n, neg_s.n, s.n, 0 - (uint64_t)high);
+        recid ^= high;
+
+        valid &= !scalar_is_zero(&r) & !scalar_is_zero(&s);
+        scalar_get_b32(signatures[i].r, &r);
+        scalar_get_b32(signatures[i].s, &s);
+        signatures[i].v = (uint8_t)(27 + recid);
+        ok[i] = (uint8_t)valid;
+        count += (size_t)valid;
+
+        nova402_memzero(&s, sizeof(s));
+        nova402_memzero(&neg_s, sizeof(neg_s));
+    }
+
+    nova402_memzero(k, n * sizeof(k[0]));
+    nova402_memzero(kinv, n * sizeof(kinv[0]));
+    return count;
+}
+
+size_t NOVA402_SECP256K1_SIGN(
+    const nova402_signer_t *signer,
+    const nova402_hash_t *digests,
+    const nova402_hash_t *nonces,
+    size_t count,
+    nova402_signature_t *signatures,
+    uint8_t *ok)
+{
+    size_t offset, signed_count = 0;
+
+    for (offset = 0; offset < count; offset += NOVA402_BATCH_CHUNK) {
+        size_t n = count - offset;
+        if (n > NOVA402_BATCH_CHUNK) {
+            n = NOVA402_BATCH_CHUNK;
+        }
+        signed_count += sign_chunk(signer, digests + offset, nonces + offset, n,
+                                   signatures + offset, ok + offset);
+    }
+
+    return signed_count;
+}
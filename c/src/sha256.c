@@ -0,0 +1,179 @@
+/**
+ * Nova402 C Library - SHA-256
+ *
+ * Portable FIPS 180-4 block function, the fallback entry of the SHA-256
+ * slot in the runtime dispatch table, and the incremental SHA-256 API
+ * that drives whichever kernel is selected.
+ *
+ * @file sha256.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+const uint32_t nova402_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define BSIG0(x) (ROR32((x), 2) ^ ROR32((x), 13) ^ ROR32((x), 22))
+#define BSIG1(x) (ROR32((x), 6) ^ ROR32((x), 11) ^ ROR32((x), 25))
+#define SSIG0(x) (ROR32((x), 7) ^ ROR32((x), 18) ^ ((x) >> 3))
+#define SSIG1(x) (ROR32((x), 17) ^ ROR32((x), 19) ^ ((x) >> 10))
+#define CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+
+static uint32_t load_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+void nova402_sha256_compress_portable(uint32_t state[8], const uint8_t *blocks, size_t count)
+{
+    uint32_t w[64];
+    size_t block;
+    int i;
+
+    for (block = 0; block < count; block++) {
+        const uint8_t *p = blocks + block * NOVA402_SHA256_BLOCK_SIZE;
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (i = 0; i < 16; i++) {
+            w[i] = load_be32(p + 4 * i);
+        }
+        for (i = 16; i < 64; i++) {
+            w[i] = SSIG1(w[i - 2]) + w[i - 7] + SSIG0(w[i - 15]) + w[i - 16];
+        }
+
+        for (i = 0; i < 64; i++) {
+            uint32_t t1 = h + BSIG1(e) + CH(e, f, g) + nova402_sha256_k[i] + w[i];
+            uint32_t t2 = BSIG0(a) + MAJ(a, b, c);
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+const uint32_t nova402_sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+int nova402_sha256_init(nova402_sha256_ctx_t *ctx)
+{
+    if (!ctx) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    memcpy(ctx->state, nova402_sha256_iv, sizeof(ctx->state));
+    ctx->length = 0;
+    ctx->used = 0;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_sha256_update(nova402_sha256_ctx_t *ctx, const uint8_t *data, size_t length)
+{
+    nova402_sha256_compress_fn compress;
+    size_t blocks;
+
+    if (!ctx || (!data && length > 0) || ctx->used >= NOVA402_SHA256_BLOCK_SIZE) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (length == 0) {
+        return NOVA402_SUCCESS;
+    }
+    compress = nova402_dispatch()->sha256_compress;
+    ctx->length += length;
+
+    if (ctx->used > 0) {
+        size_t take = NOVA402_SHA256_BLOCK_SIZE - ctx->used;
+
+        if (take > length) {
+            take = length;
+        }
+        memcpy(ctx->buffer + ctx->used, data, take);
+        ctx->used += take;
+        data += take;
+        length -= take;
+        if (ctx->used < NOVA402_SHA256_BLOCK_SIZE) {
+            return NOVA402_SUCCESS;
+        }
+        compress(ctx->state, ctx->buffer, 1);
+        ctx->used = 0;
+    }
+
+    blocks = length / NOVA402_SHA256_BLOCK_SIZE;
+    if (blocks > 0) {
+        compress(ctx->state, data, blocks);
+        data += blocks * NOVA402_SHA256_BLOCK_SIZE;
+        length -= blocks * NOVA402_SHA256_BLOCK_SIZE;
+    }
+    memcpy(ctx->buffer, data, length);
+    ctx->used = length;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_sha256_final(nova402_sha256_ctx_t *ctx, nova402_hash_t *hash)
+{
+    nova402_sha256_compress_fn compress;
+    uint64_t bits;
+    int i;
+
+    if (!ctx || !hash || ctx->used >= NOVA402_SHA256_BLOCK_SIZE) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    compress = nova402_dispatch()->sha256_compress;
+    bits = ctx->length * 8;
+
+    ctx->buffer[ctx->used++] = 0x80;
+    if (ctx->used > NOVA402_SHA256_BLOCK_SIZE - 8) {
+        memset(ctx->buffer + ctx->used, 0, NOVA402_SHA256_BLOCK_SIZE - ctx->used);
+        compress(ctx->state, ctx->buffer, 1);
+        ctx->used = 0;
+    }
+    memset(ctx->buffer + ctx->used, 0, NOVA402_SHA256_BLOCK_SIZE - 8 - ctx->used);
+    for (i = 0; i < 8; i++) {
+        ctx->buffer[NOVA402_SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    compress(ctx->state, ctx->buffer, 1);
+
+    for (i = 0; i < 8; i++) {
+        hash->bytes[4 * i] = (uint8_t)(ctx->state[i] >> 24);
+        hash->bytes[4 * i + 1] = (uint8_t)(ctx->state[i] >> 16);
+        hash->bytes[4 * i + 2] = (uint8_t)(ctx->state[i] >> 8);
+        hash->bytes[4 * i + 3] = (uint8_t)ctx->state[i];
+    }
+    ctx->used = NOVA402_SHA256_BLOCK_SIZE;  /* finalized */
+    return NOVA402_SUCCESS;
+}
+
+int nova402_sha256_clone(nova402_sha256_ctx_t *dst, const nova402_sha256_ctx_t *src)
+{
+    if (!dst || !src) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    *dst = *src;
+    return NOVA402_SUCCESS;
+}
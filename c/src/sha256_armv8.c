@@ -0,0 +1,49 @@
+/**
+ * Nova402 C Library - SHA-256 compression with the ARMv8 SHA-2 instructions
+ *
+ * Built with the crypto extension enabled for this file only; called
+ * through the runtime dispatcher when HWCAP reports SHA-2. SHA256H/H2 run
+ * four rounds on the ABCD/EFGH halves, SHA256SU0/SU1 extend the schedule.
+ *
+ * @file sha256_armv8.c
+ */
+
+#include "internal.h"
+
+#include <arm_neon.h>
+
+void nova402_sha256_compress_armv8(uint32_t state[8], const uint8_t *blocks, size_t count)
+{
+    uint32x4_t abcd = vld1q_u32(&state[0]);
+    uint32x4_t efgh = vld1q_u32(&state[4]);
+
+    for (; count > 0; count--, blocks += NOVA402_SHA256_BLOCK_SIZE) {
+        const uint32x4_t abcd_in = abcd, efgh_in = efgh;
+        uint32x4_t msg[4];
+        int i;
+
+        for (i = 0; i < 4; i++) {
+            msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 16 * i)));
+        }
+
+        /* Four rounds per step; msg[i & 3] holds W[4i..4i+3] */
+        for (i = 0; i < 16; i++) {
+            uint32x4_t wk = vaddq_u32(msg[i & 3], vld1q_u32(&nova402_sha256_k[4 * i]));
+            uint32x4_t abcd_prev = abcd;
+
+            abcd = vsha256hq_u32(abcd, efgh, wk);
+            efgh = vsha256h2q_u32(efgh, abcd_prev, wk);
+
+            if (i < 12) {
+                msg[i & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[i & 3], msg[(i + 1) & 3]),
+                                             msg[(i + 2) & 3], msg[(i + 3) & 3]);
+            }
+        }
+
+        abcd = vaddq_u32(abcd, abcd_in);
+        efgh = vaddq_u32(efgh, efgh_in);
+    }
+
+    vst1q_u32(&state[0], abcd);
+    vst1q_u32(&state[4], efgh);
+}
@@ -0,0 +1,96 @@
+/**
+ * Nova402 C Library - 8-way AVX2 SHA-256 compression
+ *
+ * Built with AVX2 enabled for this file only; called through the runtime
+ * dispatcher. Each 32-bit lane of a ymm register carries one message, so
+ * eight independent blocks go through the 64 rounds together.
+ *
+ * @file sha256_avx2.c
+ */
+
+#include "internal.h"
+
+#include <immintrin.h>
+
+#define ROR(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define BSIG0(x) _mm256_xor_si256(_mm256_xor_si256(ROR((x), 2), ROR((x), 13)), ROR((x), 22))
+#define BSIG1(x) _mm256_xor_si256(_mm256_xor_si256(ROR((x), 6), ROR((x), 11)), ROR((x), 25))
+#define SSIG0(x) _mm256_xor_si256(_mm256_xor_si256(ROR((x), 7), ROR((x), 18)), _mm256_srli_epi32((x), 3))
+#define SSIG1(x) _mm256_xor_si256(_mm256_xor_si256(ROR((x), 17), ROR((x), 19)), _mm256_srli_epi32((x), 10))
+#define CH(x, y, z) _mm256_xor_si256(_mm256_and_si256((x), (y)), _mm256_andnot_si256((x), (z)))
+#define MAJ(x, y, z) _mm256_or_si256(_mm256_and_si256((x), (y)), _mm256_and_si256((z), _mm256_or_si256((x), (y))))
+
+/* Rows r[j] = 8 words of lane j -> columns r[i] = word i of every lane */
+static void transpose8(__m256i r[8])
+{
+    __m256i t[8], u[8];
+    int i;
+
+    for (i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+    for (i = 0; i < 8; i += 4) {
+        u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (i = 0; i < 4; i++) {
+        r[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+void nova402_sha256_compress_x8_avx2(uint32_t *state, const uint8_t *const blocks[8])
+{
+    const __m256i swap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                         12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    __m256i w[16], s[8], v[8];
+    int i, j;
+
+    /* Message words 0-7 and 8-15 of each lane, transposed and made big-endian */
+    for (j = 0; j < 2; j++) {
+        for (i = 0; i < 8; i++) {
+            w[8 * j + i] = _mm256_loadu_si256((const __m256i *)(const void *)(blocks[i] + 32 * j));
+        }
+        transpose8(&w[8 * j]);
+        for (i = 0; i < 8; i++) {
+            w[8 * j + i] = _mm256_shuffle_epi8(w[8 * j + i], swap);
+        }
+    }
+
+    for (i = 0; i < 8; i++) {
+        s[i] = _mm256_loadu_si256((const __m256i *)(const void *)&state[8 * i]);
+        v[i] = s[i];
+    }
+
+    for (i = 0; i < 64; i++) {
+        __m256i t1, t2, wi;
+
+        if (i < 16) {
+            wi = w[i];
+        } else {
+            wi = _mm256_add_epi32(_mm256_add_epi32(SSIG1(w[(i - 2) & 15]), w[(i - 7) & 15]),
+                                  _mm256_add_epi32(SSIG0(w[(i - 15) & 15]), w[i & 15]));
+            w[i & 15] = wi;
+        }
+
+        t1 = _mm256_add_epi32(_mm256_add_epi32(v[7], BSIG1(v[4])),
+                              _mm256_add_epi32(CH(v[4], v[5], v[6]),
+                                               _mm256_add_epi32(_mm256_set1_epi32((int)nova402_sha256_k[i]), wi)));
+        t2 = _mm256_add_epi32(BSIG0(v[0]), MAJ(v[0], v[1], v[2]));
+        v[7] = v[6];
+        v[6] = v[5];
+        v[5] = v[4];
+        v[4] = _mm256_add_epi32(v[3], t1);
+        v[3] = v[2];
+        v[2] = v[1];
+        v[1] = v[0];
+        v[0] = _mm256_add_epi32(t1, t2);
+    }
+
+    for (i = 0; i < 8; i++) {
+        _mm256_storeu_si256((__m256i *)(void *)&state[8 * i], _mm256_add_epi32(s[i], v[i]));
+    }
+}
@@ -0,0 +1,143 @@
+/**
+ * Nova402 C Library - multi-buffer SHA-256
+ *
+ * Hashes independent messages in lock-step, one SHA-256 state per SIMD
+ * lane, when the dispatcher has a multi-buffer kernel; otherwise each
+ * message goes through the single-buffer kernel in turn.
+ *
+ * @file sha256_many.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+/* Blocks of a message after padding: data, 0x80, zeros, 64-bit length */
+static size_t padded_blocks(size_t length)
+{
+    return (length + 9 + NOVA402_SHA256_BLOCK_SIZE - 1) / NOVA402_SHA256_BLOCK_SIZE;
+}
+
+/* Write the padded final one or two blocks of a message into tail */
+static void pad_tail(uint8_t tail[2 * NOVA402_SHA256_BLOCK_SIZE], const uint8_t *data, size_t length)
+{
+    size_t full = length / NOVA402_SHA256_BLOCK_SIZE * NOVA402_SHA256_BLOCK_SIZE;
+    size_t rest = length - full;
+    size_t end = (padded_blocks(length) - full / NOVA402_SHA256_BLOCK_SIZE) * NOVA402_SHA256_BLOCK_SIZE;
+    uint64_t bits = (uint64_t)length * 8;
+    int i;
+
+    memset(tail, 0, 2 * NOVA402_SHA256_BLOCK_SIZE);
+    if (rest > 0) {
+        memcpy(tail, data + full, rest);
+    }
+    tail[rest] = 0x80;
+    for (i = 0; i < 8; i++) {
+        tail[end - 1 - (size_t)i] = (uint8_t)(bits >> (8 * i));
+    }
+}
+
+static void store_digest(const uint32_t *state, size_t width, size_t lane, nova402_hash_t *hash)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        uint32_t word = state[(size_t)i * width + lane];
+
+        hash->bytes[4 * i] = (uint8_t)(word >> 24);
+        hash->bytes[4 * i + 1] = (uint8_t)(word >> 16);
+        hash->bytes[4 * i + 2] = (uint8_t)(word >> 8);
+        hash->bytes[4 * i + 3] = (uint8_t)word;
+    }
+}
+
+/* Hash up to kernel->sha256_width messages together */
+static void hash_group(const nova402_dispatch_t *kernel, const uint8_t *const *data,
+                       const size_t *lengths, size_t n, nova402_hash_t *hashes)
+{
+    uint32_t state[8 * NOVA402_SHA256_MAX_LANES];
+    uint8_t tail[NOVA402_SHA256_MAX_LANES][2 * NOVA402_SHA256_BLOCK_SIZE];
+    const uint8_t *block[NOVA402_SHA256_MAX_LANES];
+    size_t blocks[NOVA402_SHA256_MAX_LANES], full[NOVA402_SHA256_MAX_LANES];
+    size_t width = kernel->sha256_width, max_blocks = 0, b, lane;
+    int i;
+
+    for (lane = 0; lane < width; lane++) {
+        for (i = 0; i < 8; i++) {
+            state[(size_t)i * width + lane] = nova402_sha256_iv[i];
+        }
+        block[lane] = tail[0];  /* idle lanes compress a dummy block */
+    }
+
+    for (lane = 0; lane < n; lane++) {
+        blocks[lane] = padded_blocks(lengths[lane]);
+        full[lane] = lengths[lane] / NOVA402_SHA256_BLOCK_SIZE;
+        pad_tail(tail[lane], data[lane], lengths[lane]);
+        if (blocks[lane] > max_blocks) {
+            max_blocks = blocks[lane];
+        }
+    }
+
+    for (b = 0; b < max_blocks; b++) {
+        for (lane = 0; lane < n; lane++) {
+            if (b < full[lane]) {
+                block[lane] = data[lane] + b * NOVA402_SHA256_BLOCK_SIZE;
+            } else if (b < blocks[lane]) {
+                block[lane] = tail[lane] + (b - full[lane]) * NOVA402_SHA256_BLOCK_SIZE;
+            }
+        }
+
+        kernel->sha256_compress_many(state, block);
+
+        for (lane = 0; lane < n; lane++) {
+            if (b + 1 == blocks[lane]) {
+                store_digest(state, width, lane, &hashes[lane]);
+            }
+        }
+    }
+}
+
+int nova402_sha256_many(
+    const uint8_t *const *data,
+    const size_t *lengths,
+    size_t count,
+    nova402_hash_t *hashes)
+{
+    const nova402_dispatch_t *kernel;
+    size_t offset, i;
+
+    if (count == 0) {
+        return NOVA402_SUCCESS;
+    }
+    if (!data || !lengths || !hashes) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    for (i = 0; i < count; i++) {
+        if (!data[i] && lengths[i] != 0) {
+            return NOVA402_ERROR_INVALID_INPUT;
+        }
+    }
+
+    kernel = nova402_dispatch();
+
+    if (!kernel->sha256_compress_many) {
+        for (i = 0; i < count; i++) {
+            nova402_sha256_ctx_t ctx;
+
+            nova402_sha256_init(&ctx);
+            nova402_sha256_update(&ctx, data[i], lengths[i]);
+            nova402_sha256_final(&ctx, &hashes[i]);
+        }
+        return NOVA402_SUCCESS;
+    }
+
+    for (offset = 0; offset < count; offset += kernel->sha256_width) {
+        size_t n = count - offset;
+        if (n > kernel->sha256_width) {
+            n = kernel->sha256_width;
+        }
+        hash_group(kernel, data + offset, lengths + offset, n, hashes + offset);
+    }
+
+    return NOVA402_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/**
+ * Nova402 C Library - SHA-256 compression with the x86 SHA extensions
+ *
+ * Built with SHA and SSE4.1 enabled for this file only; called through the
+ * runtime dispatcher. SHA256RNDS2 runs two rounds on the state split into
+ * ABEF/CDGH halves, SHA256MSG1/MSG2 extend the message schedule.
+ *
+ * @file sha256_shani.c
+ */
+
+#include "internal.h"
+
+#include <immintrin.h>
+
+void nova402_sha256_compress_shani(uint32_t state[8], const uint8_t *blocks, size_t count)
+{
+    const __m128i swap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m128i abef, cdgh, tmp;
+
+    /* ABCD, EFGH -> ABEF, CDGH */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)&state[0]), 0xb1);
+    cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)&state[4]), 0x1b);
+    abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+
+    for (; count > 0; count--, blocks += NOVA402_SHA256_BLOCK_SIZE) {
+        const __m128i abef_in = abef, cdgh_in = cdgh;
+        __m128i msg[4];
+        int i;
+
+        for (i = 0; i < 4; i++) {
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)(blocks + 16 * i)), swap);
+        }
+
+        /* Four rounds per step; msg[i & 3] holds W[4i..4i+3] */
+        for (i = 0; i < 16; i++) {
+            __m128i wk = _mm_add_epi32(msg[i & 3],
+                                       _mm_loadu_si128((const __m128i *)(const void *)&nova402_sha256_k[4 * i]));
+
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));
+
+            if (i < 12) {
+                __m128i w = _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+
+                w = _mm_add_epi32(w, _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4));
+                msg[i & 3] = _mm_sha256msg2_epu32(w, msg[(i + 3) & 3]);
+            }
+        }
+
+        abef = _mm_add_epi32(abef, abef_in);
+        cdgh = _mm_add_epi32(cdgh, cdgh_in);
+    }
+
+    /* ABEF, CDGH -> ABCD, EFGH */
+    tmp = _mm_shuffle_epi32(abef, 0x1b);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128((__m128i *)(void *)&state[0], _mm_blend_epi16(tmp, cdgh, 0xf0));
+    _mm_storeu_si128((__m128i *)(void *)&state[4], _mm_alignr_epi8(cdgh, tmp, 8));
+}
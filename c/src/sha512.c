@@ -0,0 +1,172 @@
+/**
+ * Nova402 C Library - SHA-512
+ *
+ * Portable FIPS 180-4 SHA-512, used for the Ed25519 challenge hash.
+ *
+ * @file sha512.c
+ */
+
+#include "internal.h"
+
+#include <string.h>
+
+static const uint64_t SHA512_K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+#define ROR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+#define BSIG0(x) (ROR64((x), 28) ^ ROR64((x), 34) ^ ROR64((x), 39))
+#define BSIG1(x) (ROR64((x), 14) ^ ROR64((x), 18) ^ ROR64((x), 41))
+#define SSIG0(x) (ROR64((x), 1) ^ ROR64((x), 8) ^ ((x) >> 7))
+#define SSIG1(x) (ROR64((x), 19) ^ ROR64((x), 61) ^ ((x) >> 6))
+#define CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+
+static uint64_t load_be64(const uint8_t *p)
+{
+    uint64_t w = 0;
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        w = (w << 8) | p[i];
+    }
+    return w;
+}
+
+static void store_be64(uint8_t *p, uint64_t v)
+{
+    int i;
+
+    for (i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+static void sha512_compress(uint64_t state[8], const uint8_t *blocks, size_t count)
+{
+    uint64_t w[80];
+    size_t block;
+    int i;
+
+    for (block = 0; block < count; block++) {
+        const uint8_t *p = blocks + block * NOVA402_SHA512_BLOCK_SIZE;
+        uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (i = 0; i < 16; i++) {
+            w[i] = load_be64(p + 8 * i);
+        }
+        for (i = 16; i < 80; i++) {
+            w[i] = SSIG1(w[i - 2]) + w[i - 7] + SSIG0(w[i - 15]) + w[i - 16];
+        }
+
+        for (i = 0; i < 80; i++) {
+            uint64_t t1 = h + BSIG1(e) + CH(e, f, g) + SHA512_K[i] + w[i];
+            uint64_t t2 = BSIG0(a) + MAJ(a, b, c);
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+void nova402_sha512_init(nova402_sha512_ctx_t *ctx)
+{
+    static const uint64_t iv[8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+    };
+
+    memcpy(ctx->state, iv, sizeof(iv));
+    ctx->length = 0;
+    ctx->used = 0;
+}
+
+void nova402_sha512_update(nova402_sha512_ctx_t *ctx, const uint8_t *data, size_t length)
+{
+    ctx->length += length;
+
+    if (ctx->used > 0) {
+        size_t n = NOVA402_SHA512_BLOCK_SIZE - ctx->used;
+
+        if (n > length) {
+            n = length;
+        }
+        memcpy(ctx->buffer + ctx->used, data, n);
+        ctx->used += n;
+        data += n;
+        length -= n;
+        if (ctx->used < NOVA402_SHA512_BLOCK_SIZE) {
+            return;
+        }
+        sha512_compress(ctx->state, ctx->buffer, 1);
+        ctx->used = 0;
+    }
+
+    if (length >= NOVA402_SHA512_BLOCK_SIZE) {
+        size_t blocks = length / NOVA402_SHA512_BLOCK_SIZE;
+
+        sha512_compress(ctx->state, data, blocks);
+        data += blocks * NOVA402_SHA512_BLOCK_SIZE;
+        length -= blocks * NOVA402_SHA512_BLOCK_SIZE;
+    }
+
+    memcpy(ctx->buffer, data, length);
+    ctx->used = length;
+}
+
+void nova402_sha512_final(nova402_sha512_ctx_t *ctx, uint8_t digest[64])
+{
+    uint64_t bits = ctx->length << 3;
+    int i;
+
+    ctx->buffer[ctx->used++] = 0x80;
+    if (ctx->used > NOVA402_SHA512_BLOCK_SIZE - 16) {
+        memset(ctx->buffer + ctx->used, 0, NOVA402_SHA512_BLOCK_SIZE - ctx->used);
+        sha512_compress(ctx->state, ctx->buffer, 1);
+        ctx->used = 0;
+    }
+    /* 128-bit big-endian bit length; the high word is (length >> 61) */
+    memset(ctx->buffer + ctx->used, 0, NOVA402_SHA512_BLOCK_SIZE - 8 - ctx->used);
+    ctx->buffer[NOVA402_SHA512_BLOCK_SIZE - 9] = (uint8_t)(ctx->length >> 61);
+    store_be64(ctx->buffer + NOVA402_SHA512_BLOCK_SIZE - 8, bits);
+    sha512_compress(ctx->state, ctx->buffer, 1);
+
+    for (i = 0; i < 8; i++) {
+        store_be64(digest + 8 * i, ctx->state[i]);
+    }
+}
@@ -0,0 +1,367 @@
+/**
+ * Nova402 C Library - precomputed-key signer
+ *
+ * A nova402_signer_t holds a parsed private key, its public key and
+ * address, and a blinding pair (b, b G) for the comb multiplication in
+ * secp256k1_impl.h. Nonces are RFC 6979 HMAC-SHA256 over the key and the
+ * digest, so a signature only depends on the key and the message and
+ * matches any other RFC 6979 signer. Nothing here allocates after
+ * nova402_signer_create().
+ *
+ * @file signer.c
+ */
+
+#include "internal.h"
+#include "secp256k1.h"
+#include "stats.h"
+
+#include <limits.h>
+#include <string.h>
+
+static const uint8_t BLIND_TAG[] = "nova402 signer blind";
+
+/* RFC 6979 HMAC_DRBG state for one (key, digest) pair */
+typedef struct {
+    uint8_t k[32];
+    uint8_t v[32];
+} rfc6979_t;
+
+/* HMAC-SHA256 under a 32-byte key over the concatenation of parts */
+static void hmac_sha256(const uint8_t *key, const uint8_t *const *parts, const size_t *lengths,
+                        size_t count, uint8_t *out)
+{
+    uint8_t pad[NOVA402_SHA256_BLOCK_SIZE];
+    nova402_sha256_ctx_t ctx;
+    nova402_hash_t inner, outer;
+    size_t i;
+
+    memset(pad, 0x36, sizeof(pad));
+    for (i = 0; i < 32; i++) {
+        pad[i] ^= key[i];
+    }
+    nova402_sha256_init(&ctx);
+    nova402_sha256_update(&ctx, pad, sizeof(pad));
+    for (i = 0; i < count; i++) {
+        nova402_sha256_update(&ctx, parts[i], lengths[i]);
+    }
+    nova402_sha256_final(&ctx, &inner);
+
+    for (i = 0; i < sizeof(pad); i++) {
+        pad[i] ^= 0x36 ^ 0x5C;
+    }
+    nova402_sha256_init(&ctx);
+    nova402_sha256_update(&ctx, pad, sizeof(pad));
+    nova402_sha256_update(&ctx, inner.bytes, sizeof(inner.bytes));
+    nova402_sha256_final(&ctx, &outer);
+    memcpy(out, outer.bytes, 32);
+
+    nova402_memzero(pad, sizeof(pad));
+    nova402_memzero(&ctx, sizeof(ctx));
+    nova402_memzero(&inner, sizeof(inner));
+    nova402_memzero(&outer, sizeof(outer));
+}
+
+/* V = HMAC_K(V) */
+static void rfc6979_step(rfc6979_t *drbg)
+{
+    const uint8_t *parts[1] = { drbg->v };
+    const size_t lengths[1] = { 32 };
+
+    hmac_sha256(drbg->k, parts, lengths, 1, drbg->v);
+}
+
+/* K = HMAC_K(V || sep [|| x || h]), V = HMAC_K(V) */
+static void rfc6979_update(rfc6979_t *drbg, uint8_t sep, const uint8_t *key, const uint8_t *h)
+{
+    const uint8_t *parts[4] = { drbg->v, &sep, key, h };
+    const size_t lengths[4] = { 32, 1, 32, 32 };
+
+    hmac_sha256(drbg->k, parts, lengths, key ? 4 : 2, drbg->k);
+    rfc6979_step(drbg);
+}
+
+/* Section 3.2 steps b-f, with h1 reduced mod n (bits2octets) */
+static void rfc6979_init(rfc6979_t *drbg, const uint8_t *key, const nova402_hash_t *digest)
+{
+    nova402_scalar_t e;
+    uint8_t h[32];
+
+    nova402_scalar_set_b32(&e, digest->bytes);
+    nova402_scalar_get_b32(h, &e);
+
+    memset(drbg->v, 0x01, sizeof(drbg->v));
+    memset(drbg->k, 0x00, sizeof(drbg->k));
+    rfc6979_update(drbg, 0x00, key, h);
+    rfc6979_update(drbg, 0x01, key, h);
+}
+
+/* Next candidate in [1, n); step h retries when V is out of range */
+static void rfc6979_generate(rfc6979_t *drbg, nova402_hash_t *nonce)
+{
+    nova402_scalar_t k;
+
+    for (;;) {
+        rfc6979_step(drbg);
+        if (nova402_scalar_set_b32(&k, drbg->v) && !nova402_scalar_is_zero(&k)) {
+            break;
+        }
+        rfc6979_update(drbg, 0x00, NULL, NULL);
+    }
+    memcpy(nonce->bytes, drbg->v, sizeof(nonce->bytes));
+    nova402_memzero(&k, sizeof(k));
+}
+
+/* Candidate after one the signing kernel could not use */
+static void rfc6979_retry(rfc6979_t *drbg, nova402_hash_t *nonce)
+{
+    rfc6979_update(drbg, 0x00, NULL, NULL);
+    rfc6979_generate(drbg, nonce);
+}
+
+/* Sign up to NOVA402_BATCH_CHUNK digests */
+static void sign_digests(const nova402_signer_t *signer, const nova402_hash_t *digests, size_t n,
+                         nova402_signature_t *signatures)
+{
+    rfc6979_t drbg[NOVA402_BATCH_CHUNK];
+    nova402_hash_t nonces[NOVA402_BATCH_CHUNK];
+    uint8_t ok[NOVA402_BATCH_CHUNK];
+    uint8_t key[32];
+    size_t i;
+
+    nova402_scalar_get_b32(key, &signer->key);
+    for (i = 0; i < n; i++) {
+        rfc6979_init(&drbg[i], key, &digests[i]);
+        rfc6979_generate(&drbg[i], &nonces[i]);
+    }
+
+    if (nova402_secp256k1_sign_batch(signer, digests, nonces, n, signatures, ok) != n) {
+        /* Probability about 2^-127 per item */
+        for (i = 0; i < n; i++) {
+            while (!ok[i]) {
+                rfc6979_retry(&drbg[i], &nonces[i]);
+                nova402_secp256k1_sign_batch(signer, &digests[i], &nonces[i], 1, &signatures[i],
+                                             &ok[i]);
+            }
+        }
+    }
+
+    nova402_memzero(key, sizeof(key));
+    nova402_memzero(drbg, n * sizeof(drbg[0]));
+    nova402_memzero(nonces, n * sizeof(nonces[0]));
+}
+
+/* Affine x || y of a point known not to be infinity */
+static void gej_to_storage(nova402_ge_storage_t *r, const nova402_gej_t *a)
+{
+    nova402_fe_t zinv, zi2, zi3;
+
+    nova402_fe_inv(&zinv, &a->z);
+    nova402_fe_sqr(&zi2, &zinv);
+    nova402_fe_mul(&zi3, &zi2, &zinv);
+    nova402_fe_mul(&r->x, &a->x, &zi2);
+    nova402_fe_mul(&r->y, &a->y, &zi3);
+}
+
+/* blind = HMAC(seed or key, tag || key || counter), the first one in [1, n) */
+static void derive_blind(nova402_signer_t *signer, const uint8_t *private_key, const uint8_t *seed)
+{
+    uint8_t counter = 0;
+    uint8_t out[32];
+    const uint8_t *parts[3] = { BLIND_TAG, private_key, &counter };
+    const size_t lengths[3] = { sizeof(BLIND_TAG) - 1, 32, 1 };
+
+    for (;;) {
+        hmac_sha256(seed ? seed : private_key, parts, lengths, 3, out);
+        if (nova402_scalar_set_b32(&signer->blind, out) && !nova402_scalar_is_zero(&signer->blind)) {
+            break;
+        }
+        counter++;
+    }
+    nova402_memzero(out, sizeof(out));
+}
+
+nova402_signer_t *nova402_signer_create(const uint8_t *private_key, const uint8_t *seed)
+{
+    nova402_signer_t *signer;
+    nova402_ge_storage_t q;
+    nova402_gej_t p;
+    nova402_hash_t hash;
+
+    if (!private_key || !nova402_secp256k1_comb_init()) {
+        return NULL;
+    }
+
+    signer = nova402_malloc(sizeof(*signer));
+    if (!signer) {
+        return NULL;
+    }
+    if (!nova402_scalar_set_b32(&signer->key, private_key) || nova402_scalar_is_zero(&signer->key)) {
+        nova402_signer_destroy(signer);
+        return NULL;
+    }
+
+    derive_blind(signer, private_key, seed);
+    nova402_ecmult_gen(&p, &signer->blind, NULL, NULL);
+    gej_to_storage(&signer->blind_point, &p);
+
+    nova402_ecmult_gen(&p, &signer->key, &signer->blind, &signer->blind_point);
+    gej_to_storage(&q, &p);
+    nova402_fe_get_b32(signer->public_key, &q.x);
+    nova402_fe_get_b32(signer->public_key + 32, &q.y);
+
+    nova402_keccak256(signer->public_key, sizeof(signer->public_key), &hash);
+    memcpy(signer->address.bytes, hash.bytes + 12, NOVA402_ADDRESS_SIZE);
+
+    nova402_memzero(&p, sizeof(p));
+    return signer;
+}
+
+void nova402_signer_destroy(nova402_signer_t *signer)
+{
+    if (!signer) {
+        return;
+    }
+    nova402_memzero(signer, sizeof(*signer));
+    nova402_free(signer);
+}
+
+int nova402_signer_address(const nova402_signer_t *signer, nova402_address_t *address)
+{
+    if (!signer || !address) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    *address = signer->address;
+    return NOVA402_SUCCESS;
+}
+
+int nova402_signer_public_key(const nova402_signer_t *signer, uint8_t *public_key)
+{
+    if (!signer || !public_key) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    memcpy(public_key, signer->public_key, sizeof(signer->public_key));
+    return NOVA402_SUCCESS;
+}
+
+int nova402_signer_sign_digest(
+    const nova402_signer_t *signer,
+    const nova402_hash_t *digest,
+    nova402_signature_t *signature)
+{
+    NOVA402_STATS_BEGIN(NOVA402_STAT_SIGN);
+
+    if (!signer || !digest || !signature) {
+        NOVA402_STATS_END(1, 1);
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    sign_digests(signer, digest, 1, signature);
+    NOVA402_STATS_END(1, 0);
+    return NOVA402_SUCCESS;
+}
+
+static int sign_payment(
+    const nova402_signer_t *signer,
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    nova402_signature_t *signature)
+{
+    nova402_eip712_domain_t default_domain;
+    nova402_hash_t digest;
+
+    if (!signer || !payment || !signature) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    if (!domain) {
+        nova402_eip712_default_domain(&default_domain);
+        domain = &default_domain;
+    }
+
+    if (nova402_eip712_hash_payment(domain, payment, &digest) != NOVA402_SUCCESS) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    sign_digests(signer, &digest, 1, signature);
+    return NOVA402_SUCCESS;
+}
+
+int nova402_signer_sign_payment(
+    const nova402_signer_t *signer,
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    nova402_signature_t *signature)
+{
+    int rc;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_SIGN);
+
+    rc = sign_payment(signer, domain, payment, signature);
+    NOVA402_STATS_END(1, rc != NOVA402_SUCCESS);
+    return rc;
+}
+
+static int sign_payments(
+    const nova402_signer_t *signer,
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payments,
+    size_t count,
+    nova402_signature_t *signatures)
+{
+    nova402_eip712_domain_t default_domain;
+    uint8_t encoded[NOVA402_BATCH_CHUNK][NOVA402_EIP712_STRUCT_SIZE];
+    const uint8_t *inputs[NOVA402_BATCH_CHUNK];
+    size_t lengths[NOVA402_BATCH_CHUNK];
+    nova402_hash_t struct_hashes[NOVA402_BATCH_CHUNK];
+    nova402_hash_t digests[NOVA402_BATCH_CHUNK];
+    size_t offset, i;
+
+    if (count == 0) {
+        return 0;
+    }
+    if (!signer || !payments || !signatures || count > INT_MAX) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    if (!domain) {
+        nova402_eip712_default_domain(&default_domain);
+        domain = &default_domain;
+    }
+
+    for (offset = 0; offset < count; offset += NOVA402_BATCH_CHUNK) {
+        size_t n = count - offset;
+        if (n > NOVA402_BATCH_CHUNK) {
+            n = NOVA402_BATCH_CHUNK;
+        }
+
+        /* Struct hashes, then digests, through the multi-buffer kernel */
+        for (i = 0; i < n; i++) {
+            nova402_eip712_encode_struct(&payments[offset + i], encoded[i]);
+            inputs[i] = encoded[i];
+            lengths[i] = NOVA402_EIP712_STRUCT_SIZE;
+        }
+        nova402_keccak256_many(inputs, lengths, n, struct_hashes);
+
+        for (i = 0; i < n; i++) {
+            nova402_eip712_encode_digest(&domain->separator, &struct_hashes[i], encoded[i]);
+            lengths[i] = NOVA402_EIP712_DIGEST_INPUT_SIZE;
+        }
+        nova402_keccak256_many(inputs, lengths, n, digests);
+
+        sign_digests(signer, digests, n, signatures + offset);
+    }
+
+    return (int)count;
+}
+
+int nova402_sign_payments_batch(
+    const nova402_signer_t *signer,
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payments,
+    size_t count,
+    nova402_signature_t *signatures)
+{
+    int signed_count;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_SIGN_PAYMENTS_BATCH);
+
+    signed_count = sign_payments(signer, domain, payments, count, signatures);
+    NOVA402_STATS_END(count, signed_count < 0);
+    return signed_count;
+}
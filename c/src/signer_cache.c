@@ -0,0 +1,435 @@
+/**
+ * Nova402 C Library - recovered-signer cache
+ *
+ * Fixed-capacity LRU keyed by (message hash, signature). The key space is
+ * split into stripes, each with its own lock, LRU list and chained hash
+ * index over a preallocated entry array. Recovery on a miss runs outside
+ * the lock.
+ *
+ * @file signer_cache.c
+ */
+
+#include "internal.h"
+#include "secp256k1.h"
+#include "stats.h"
+#include "sync.h"
+
+#include <string.h>
+
+#define DEFAULT_STRIPES 16
+#define NIL UINT32_MAX
+
+typedef struct {
+    uint64_t hash;
+    nova402_hash_t message;
+    nova402_signature_t signature;
+    nova402_address_t signer;
+    int32_t rc;
+    uint32_t prev;   /* LRU neighbours, most recent at head */
+    uint32_t next;
+    uint32_t chain;  /* next entry in the same bucket */
+} cache_entry_t;
+
+typedef struct {
+    nova402_mutex_t lock;
+    cache_entry_t *entries;
+    uint32_t *buckets;
+    uint32_t bucket_mask;
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t head;
+    uint32_t tail;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} cache_stripe_t;
+
+/* Stripes start on their own cache lines so their locks do not false-share */
+#define STRIPE_STRIDE ((sizeof(cache_stripe_t) + NOVA402_CACHE_LINE - 1) & ~(size_t)(NOVA402_CACHE_LINE - 1))
+
+struct nova402_signer_cache {
+    uint64_t seed;
+    size_t capacity;
+    size_t memory_bytes;
+    size_t stripe_count;
+    uint8_t *stripes;   /* stripe_count strides, cache-line aligned */
+    void *stripe_block; /* allocation behind stripes */
+};
+
+static cache_stripe_t *stripe_at(const nova402_signer_cache_t *cache, size_t i)
+{
+    return (cache_stripe_t *)(void *)(cache->stripes + i * STRIPE_STRIDE);
+}
+
+static uint64_t load_le64(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ULL;
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ULL;
+    x ^= x >> 32;
+    return x;
+}
+
+/* Seeded so that chosen inputs cannot pile into one bucket */
+static uint64_t key_hash(uint64_t seed, const nova402_hash_t *message,
+                         const nova402_signature_t *signature)
+{
+    uint64_t h = seed;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        h = mix64(h ^ load_le64(message->bytes + 8 * i));
+        h = mix64(h ^ load_le64(signature->r + 8 * i));
+        h = mix64(h ^ load_le64(signature->s + 8 * i));
+    }
+    return mix64(h ^ signature->v);
+}
+
+static uint32_t stripe_find(const cache_stripe_t *stripe, uint64_t hash,
+                            const nova402_hash_t *message, const nova402_signature_t *signature)
+{
+    uint32_t i = stripe->buckets[hash & stripe->bucket_mask];
+
+    while (i != NIL) {
+        const cache_entry_t *e = &stripe->entries[i];
+        if (e->hash == hash &&
+            memcmp(e->message.bytes, message->bytes, NOVA402_HASH_SIZE) == 0 &&
+            memcmp(&e->signature, signature, sizeof(*signature)) == 0) {
+            return i;
+        }
+        i = e->chain;
+    }
+    return NIL;
+}
+
+static void lru_unlink(cache_stripe_t *stripe, uint32_t i)
+{
+    cache_entry_t *e = &stripe->entries[i];
+
+    if (e->prev != NIL) {
+        stripe->entries[e->prev].next = e->next;
+    } else {
+        stripe->head = e->next;
+    }
+    if (e->next != NIL) {
+        stripe->entries[e->next].prev = e->prev;
+    } else {
+        stripe->tail = e->prev;
+    }
+}
+
+static void lru_push_head(cache_stripe_t *stripe, uint32_t i)
+{
+    cache_entry_t *e = &stripe->entries[i];
+
+    e->prev = NIL;
+    e->next = stripe->head;
+    if (stripe->head != NIL) {
+        stripe->entries[stripe->head].prev = i;
+    } else {
+        stripe->tail = i;
+    }
+    stripe->head = i;
+}
+
+static void bucket_remove(cache_stripe_t *stripe, uint32_t i)
+{
+    uint32_t *link = &stripe->buckets[stripe->entries[i].hash & stripe->bucket_mask];
+
+    while (*link != i) {
+        link = &stripe->entries[*link].chain;
+    }
+    *link = stripe->entries[i].chain;
+}
+
+static void stripe_insert(cache_stripe_t *stripe, uint64_t hash, const nova402_hash_t *message,
+                          const nova402_signature_t *signature, const nova402_address_t *signer,
+                          int rc)
+{
+    cache_entry_t *e;
+    uint32_t i, *bucket;
+
+    if (stripe->used < stripe->capacity) {
+        i = stripe->used++;
+    } else {
+        i = stripe->tail;
+        lru_unlink(stripe, i);
+        bucket_remove(stripe, i);
+        stripe->evictions++;
+    }
+
+    e = &stripe->entries[i];
+    e->hash = hash;
+    e->message = *message;
+    e->signature = *signature;
+    e->signer = *signer;
+    e->rc = rc;
+
+    bucket = &stripe->buckets[hash & stripe->bucket_mask];
+    e->chain = *bucket;
+    *bucket = i;
+    lru_push_head(stripe, i);
+}
+
+static void stripe_reset(cache_stripe_t *stripe)
+{
+    uint32_t b;
+
+    for (b = 0; b <= stripe->bucket_mask; b++) {
+        stripe->buckets[b] = NIL;
+    }
+    stripe->used = 0;
+    stripe->head = NIL;
+    stripe->tail = NIL;
+    stripe->hits = 0;
+    stripe->misses = 0;
+    stripe->evictions = 0;
+}
+
+nova402_signer_cache_t *nova402_signer_cache_create(size_t capacity, size_t stripes)
+{
+    nova402_signer_cache_t *cache;
+    uint8_t seed[NOVA402_NONCE_SIZE];
+    size_t per_stripe, buckets, i;
+
+    if (capacity == 0) {
+        return NULL;
+    }
+    if (stripes == 0) {
+        stripes = DEFAULT_STRIPES;
+    }
+    if (stripes > capacity) {
+        stripes = capacity;
+    }
+
+    per_stripe = (capacity + stripes - 1) / stripes;
+    if (per_stripe > (NIL >> 1)) {
+        return NULL;
+    }
+    for (buckets = 1; buckets < per_stripe; buckets <<= 1) {
+    }
+
+    cache = nova402_calloc(1, sizeof(*cache));
+    if (!cache) {
+        return NULL;
+    }
+    cache->stripe_block = nova402_calloc(1, stripes * STRIPE_STRIDE + NOVA402_CACHE_LINE - 1);
+    if (!cache->stripe_block) {
+        nova402_free(cache);
+        return NULL;
+    }
+    cache->stripes = (uint8_t *)(((uintptr_t)cache->stripe_block + NOVA402_CACHE_LINE - 1) &
+                                 ~(uintptr_t)(NOVA402_CACHE_LINE - 1));
+    cache->stripe_count = stripes;
+    cache->capacity = per_stripe * stripes;
+    cache->memory_bytes = sizeof(*cache) + stripes * STRIPE_STRIDE + NOVA402_CACHE_LINE - 1;
+
+    for (i = 0; i < stripes; i++) {
+        cache_stripe_t *stripe = stripe_at(cache, i);
+
+        stripe->entries = nova402_malloc(per_stripe * sizeof(*stripe->entries));
+        stripe->buckets = nova402_malloc(buckets * sizeof(*stripe->buckets));
+        if (!stripe->entries || !stripe->buckets || nova402_mutex_init(&stripe->lock) != 0) {
+            nova402_free(stripe->entries);
+            nova402_free(stripe->buckets);
+            stripe->entries = NULL;
+            cache->stripe_count = i;
+            nova402_signer_cache_destroy(cache);
+            return NULL;
+        }
+
+        stripe->capacity = (uint32_t)per_stripe;
+        stripe->bucket_mask = (uint32_t)(buckets - 1);
+        stripe_reset(stripe);
+        cache->memory_bytes += per_stripe * sizeof(*stripe->entries) +
+                               buckets * sizeof(*stripe->buckets);
+    }
+
+    if (nova402_generate_nonce(seed) == NOVA402_SUCCESS) {
+        cache->seed = load_le64(seed);
+    } else {
+        cache->seed = mix64((uint64_t)(uintptr_t)cache ^ nova402_timestamp());
+    }
+
+    return cache;
+}
+
+void nova402_signer_cache_destroy(nova402_signer_cache_t *cache)
+{
+    size_t i;
+
+    if (!cache) {
+        return;
+    }
+    for (i = 0; i < cache->stripe_count; i++) {
+        cache_stripe_t *stripe = stripe_at(cache, i);
+
+        nova402_mutex_destroy(&stripe->lock);
+        nova402_free(stripe->entries);
+        nova402_free(stripe->buckets);
+    }
+    nova402_free(cache->stripe_block);
+    nova402_free(cache);
+}
+
+void nova402_signer_cache_clear(nova402_signer_cache_t *cache)
+{
+    size_t i;
+
+    if (!cache) {
+        return;
+    }
+    for (i = 0; i < cache->stripe_count; i++) {
+        cache_stripe_t *stripe = stripe_at(cache, i);
+
+        nova402_mutex_lock(&stripe->lock);
+        stripe_reset(stripe);
+        nova402_mutex_unlock(&stripe->lock);
+    }
+}
+
+int nova402_signer_cache_stats(nova402_signer_cache_t *cache, nova402_signer_cache_stats_t *stats)
+{
+    size_t i;
+
+    if (!cache || !stats) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    for (i = 0; i < cache->stripe_count; i++) {
+        cache_stripe_t *stripe = stripe_at(cache, i);
+
+        nova402_mutex_lock(&stripe->lock);
+        stats->hits += stripe->hits;
+        stats->misses += stripe->misses;
+        stats->evictions += stripe->evictions;
+        stats->entries += stripe->used;
+        nova402_mutex_unlock(&stripe->lock);
+    }
+    stats->capacity = cache->capacity;
+    stats->memory_bytes = cache->memory_bytes;
+
+    return NOVA402_SUCCESS;
+}
+
+static int recover_signer_cached(
+    nova402_signer_cache_t *cache,
+    const nova402_hash_t *message,
+    const nova402_signature_t *signature,
+    nova402_address_t *signer)
+{
+    cache_stripe_t *stripe;
+    uint64_t hash;
+    uint32_t i;
+    uint8_t ok;
+    int rc;
+
+    if (!cache || !message || !signature || !signer) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+
+    hash = key_hash(cache->seed, message, signature);
+    stripe = stripe_at(cache, (hash >> 32) % cache->stripe_count);
+
+    nova402_mutex_lock(&stripe->lock);
+    i = stripe_find(stripe, hash, message, signature);
+    if (i != NIL) {
+        *signer = stripe->entries[i].signer;
+        rc = stripe->entries[i].rc;
+        lru_unlink(stripe, i);
+        lru_push_head(stripe, i);
+        stripe->hits++;
+        nova402_mutex_unlock(&stripe->lock);
+        NOVA402_STATS_COUNT(NOVA402_COUNTER_SIGNER_CACHE_HITS, 1);
+        return rc;
+    }
+    stripe->misses++;
+    nova402_mutex_unlock(&stripe->lock);
+    NOVA402_STATS_COUNT(NOVA402_COUNTER_SIGNER_CACHE_MISSES, 1);
+
+    nova402_secp256k1_recover_batch(NULL, message, signature, 1, signer, &ok);
+    if (ok) {
+        rc = NOVA402_SUCCESS;
+    } else {
+        memset(signer->bytes, 0, NOVA402_ADDRESS_SIZE);
+        rc = NOVA402_ERROR_INVALID_SIGNATURE;
+    }
+
+    /* A concurrent miss on the same key may have filled it meanwhile */
+    nova402_mutex_lock(&stripe->lock);
+    if (stripe_find(stripe, hash, message, signature) == NIL) {
+        stripe_insert(stripe, hash, message, signature, signer, rc);
+    }
+    nova402_mutex_unlock(&stripe->lock);
+
+    return rc;
+}
+
+int nova402_recover_signer_cached(
+    nova402_signer_cache_t *cache,
+    const nova402_hash_t *message,
+    const nova402_signature_t *signature,
+    nova402_address_t *signer)
+{
+    int rc;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_RECOVER_SIGNER);
+
+    rc = recover_signer_cached(cache, message, signature, signer);
+    NOVA402_STATS_END(1, rc != NOVA402_SUCCESS);
+    return rc;
+}
+
+static bool verify_signature_cached(
+    nova402_signer_cache_t *cache,
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    const nova402_signature_t *signature,
+    const nova402_address_t *expected_signer)
+{
+    nova402_eip712_domain_t default_domain;
+    nova402_hash_t digest;
+    nova402_address_t signer;
+
+    if (!cache || !payment || !signature || !expected_signer) {
+        return false;
+    }
+
+    if (!domain) {
+        nova402_eip712_default_domain(&default_domain);
+        domain = &default_domain;
+    }
+
+    if (nova402_eip712_hash_payment(domain, payment, &digest) != NOVA402_SUCCESS) {
+        return false;
+    }
+    /* The unrecorded body, so the call counts once, as a verification */
+    if (recover_signer_cached(cache, &digest, signature, &signer) != NOVA402_SUCCESS) {
+        return false;
+    }
+
+    return memcmp(signer.bytes, expected_signer->bytes, NOVA402_ADDRESS_SIZE) == 0;
+}
+
+bool nova402_verify_signature_cached(
+    nova402_signer_cache_t *cache,
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    const nova402_signature_t *signature,
+    const nova402_address_t *expected_signer)
+{
+    bool valid;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_VERIFY_SIGNATURE);
+
+    valid = verify_signature_cached(cache, domain, payment, signature, expected_signer);
+    NOVA402_STATS_END(1, !valid);
+    return valid;
+}
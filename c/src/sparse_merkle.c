@@ -0,0 +1,1085 @@
+/**
+ * Nova402 C Library - sharded sparse Merkle tree
+ *
+ * A binary trie over the 256 key bits, most significant first, in which
+ * a subtree holding one key is stored as that key's leaf and an empty
+ * subtree hashes to zero, so n random keys sit about log2(n) levels deep
+ * instead of 256:
+ *
+ *   empty     32 zero bytes
+ *   leaf      keccak256(0x00 || key || value)
+ *   internal  keccak256(0x01 || left || right)
+ *
+ * The first shard_bits levels form a complete tree of summaries over
+ * 2^shard_bits shards. Each shard owns the subtree of one key prefix and
+ * its own node arenas, so shards update on separate cores without locks.
+ *
+ * An update runs in two passes per shard. The first partitions the
+ * shard's keys bit by bit along the paths they touch and counts the nodes
+ * the second will need, so arenas grow before anything changes and a
+ * failed allocation leaves the tree as it was. The second rebuilds the
+ * touched paths top-down, changing structure only, and then hashes every
+ * touched node once, deepest level first, with the multi-buffer kernel.
+ *
+ * @file sparse_merkle.c
+ */
+
+#include "internal.h"
+#include "stats.h"
+
+#include <string.h>
+
+#define KEY_BITS 256
+
+/* Message of one node hash: domain byte and two 32-byte fields */
+#define MESSAGE_SIZE (1 + 2 * NOVA402_HASH_SIZE)
+
+/*
+ * Nodes per arena chunk. A shard's first chunk starts at FIRST_CHUNK_NODES
+ * and doubles until full, so wide trees of small shards stay small; later
+ * chunks are allocated full and never move.
+ */
+#define CHUNK_BITS 10
+#define CHUNK_NODES ((size_t)1 << CHUNK_BITS)
+#define FIRST_CHUNK_NODES 16
+
+/* Nodes per arena, leaving room for the type bit of a reference */
+#define MAX_NODES (((size_t)1 << 31) - CHUNK_NODES)
+
+/* Nodes hashed per nova402_keccak256_many() call */
+#define HASH_BATCH 64
+
+/* Largest dirty list a shard keeps between updates */
+#define DIRTY_KEEP 4096
+
+/* Smallest update spread over several threads */
+#define MIN_PARALLEL_UPDATES (1u << 12)
+
+/* Node references: 0 is the empty subtree, otherwise (index + 1) << 1 | is_leaf */
+#define REF_EMPTY 0u
+#define REF_IS_LEAF(ref) ((ref) & 1u)
+#define REF_INDEX(ref) (((ref) >> 1) - 1)
+#define REF_MAKE(index, leaf) ((((uint32_t)(index) + 1) << 1) | (uint32_t)(leaf))
+
+/* Stand-ins returned by the counting pass, which allocates nothing */
+#define REF_NEW_INTERNAL REF_MAKE(0, 0)
+#define REF_NEW_LEAF REF_MAKE(0, 1)
+
+/* Summary kinds of the top levels */
+#define KIND_EMPTY 0
+#define KIND_LEAF 1
+#define KIND_INTERNAL 2
+
+typedef struct {
+    nova402_hash_t hash;
+    uint32_t child[2];
+} smt_internal_t;
+
+typedef struct {
+    uint8_t key[NOVA402_NONCE_SIZE];
+    nova402_hash_t value;
+} smt_leaf_t;
+
+/* Node arena of one shard */
+typedef struct {
+    uint8_t **chunks;
+    size_t chunk_count;
+    size_t chunk_capacity;
+    size_t node_size;
+    size_t last_nodes;  /* nodes allocated in the last chunk */
+    size_t used;        /* nodes ever handed out from the chunks */
+    size_t free_count;
+    uint32_t free_head; /* index + 1 of the first free node, 0 if none */
+} smt_pool_t;
+
+typedef struct {
+    uint8_t key[NOVA402_NONCE_SIZE];
+    size_t index;       /* position in the batch; the last update of a key wins */
+} smt_update_t;
+
+typedef struct {
+    uint32_t root;      /* subtree at depth shard_bits */
+    size_t count;
+    smt_pool_t leaves;
+    smt_pool_t internals;
+
+    /* State of the update in progress */
+    int counting;
+    int failed;
+    size_t new_leaves;
+    size_t new_internals;
+    size_t dirty_needed;
+    uint32_t *dirty;    /* internal nodes to rehash, in visiting order */
+    uint32_t *order;    /* the same, deepest first */
+    uint16_t *depth;
+    size_t dirty_count;
+    size_t dirty_capacity;
+} smt_shard_t;
+
+typedef struct {
+    nova402_hash_t hash;
+    uint32_t leaf;      /* leaf reference of a KIND_LEAF subtree */
+    uint32_t shard;     /* shard holding that leaf */
+    uint32_t kind;
+} smt_summary_t;
+
+/*
+ * top[1] is the root and top[i] has children top[2i] and top[2i + 1];
+ * top[shard_count + s] summarizes shard s.
+ */
+struct nova402_sparse_merkle {
+    unsigned shard_bits;
+    size_t shard_count;
+    smt_shard_t *shards;
+    smt_summary_t *top;
+};
+
+typedef struct {
+    nova402_sparse_merkle_t *tree;
+    smt_update_t *updates;
+    const size_t *offsets;  /* shard s owns updates[offsets[s], offsets[s + 1]) */
+    const nova402_hash_t *values;
+} smt_job_t;
+
+static unsigned key_bit(const uint8_t *key, unsigned depth)
+{
+    return (key[depth >> 3] >> (7 - (depth & 7))) & 1u;
+}
+
+static int is_zero(const nova402_hash_t *hash)
+{
+    uint8_t acc = 0;
+    size_t i;
+
+    for (i = 0; i < NOVA402_HASH_SIZE; i++) {
+        acc |= hash->bytes[i];
+    }
+    return acc == 0;
+}
+
+static size_t shard_of(const nova402_sparse_merkle_t *tree, const uint8_t *key)
+{
+    return (((size_t)key[0] << 8) | key[1]) >> (16 - tree->shard_bits);
+}
+
+static void leaf_message(uint8_t *m, const uint8_t *key, const nova402_hash_t *value)
+{
+    m[0] = 0x00;
+    memcpy(m + 1, key, NOVA402_NONCE_SIZE);
+    memcpy(m + 1 + NOVA402_HASH_SIZE, value->bytes, NOVA402_HASH_SIZE);
+}
+
+static void hash_leaf(const uint8_t *key, const nova402_hash_t *value, nova402_hash_t *hash)
+{
+    uint8_t m[MESSAGE_SIZE];
+
+    leaf_message(m, key, value);
+    nova402_keccak256(m, sizeof(m), hash);
+}
+
+static void hash_internal(const nova402_hash_t *left, const nova402_hash_t *right, nova402_hash_t *hash)
+{
+    uint8_t m[MESSAGE_SIZE];
+
+    m[0] = 0x01;
+    memcpy(m + 1, left->bytes, NOVA402_HASH_SIZE);
+    memcpy(m + 1 + NOVA402_HASH_SIZE, right->bytes, NOVA402_HASH_SIZE);
+    nova402_keccak256(m, sizeof(m), hash);
+}
+
+/* ============================================
+ * NODE ARENAS
+ * ============================================ */
+
+static void *pool_node(const smt_pool_t *pool, uint32_t index)
+{
+    return pool->chunks[index >> CHUNK_BITS] + (size_t)(index & (CHUNK_NODES - 1)) * pool->node_size;
+}
+
+static size_t pool_capacity(const smt_pool_t *pool)
+{
+    return pool->chunk_count == 0 ? 0 : (pool->chunk_count - 1) * CHUNK_NODES + pool->last_nodes;
+}
+
+/* Grow the partial last chunk; nothing points into it during a reserve */
+static int pool_grow_last(smt_pool_t *pool, size_t needed)
+{
+    size_t nodes = pool->last_nodes;
+    uint8_t *chunk;
+
+    while (nodes < needed && nodes < CHUNK_NODES) {
+        nodes *= 2;
+    }
+    chunk = nova402_malloc(nodes * pool->node_size);
+    if (!chunk) {
+        return -1;
+    }
+    memcpy(chunk, pool->chunks[pool->chunk_count - 1], pool->last_nodes * pool->node_size);
+    nova402_free(pool->chunks[pool->chunk_count - 1]);
+    pool->chunks[pool->chunk_count - 1] = chunk;
+    pool->last_nodes = nodes;
+    return 0;
+}
+
+/* Make sure count more nodes can be handed out without allocating */
+static int pool_reserve(smt_pool_t *pool, size_t count)
+{
+    size_t available = pool->free_count + pool_capacity(pool) - pool->used;
+
+    if (available >= count) {
+        return 0;
+    }
+    if (pool->chunk_count > 0 && pool->last_nodes < CHUNK_NODES) {
+        size_t grown = pool->last_nodes;
+
+        if (pool_grow_last(pool, pool->last_nodes + (count - available)) != 0) {
+            return -1;
+        }
+        available += pool->last_nodes - grown;
+    }
+
+    while (available < count) {
+        size_t nodes = CHUNK_NODES;
+        uint8_t *chunk;
+
+        if (pool->chunk_count * CHUNK_NODES >= MAX_NODES) {
+            return -1;
+        }
+        if (pool->chunk_count == pool->chunk_capacity) {
+            size_t capacity = pool->chunk_capacity ? 2 * pool->chunk_capacity : 16;
+            uint8_t **chunks = nova402_malloc(capacity * sizeof(*chunks));
+
+            if (!chunks) {
+                return -1;
+            }
+            if (pool->chunk_count > 0) {
+                memcpy(chunks, pool->chunks, pool->chunk_count * sizeof(*chunks));
+            }
+            nova402_free(pool->chunks);
+            pool->chunks = chunks;
+            pool->chunk_capacity = capacity;
+        }
+        if (pool->chunk_count == 0) {
+            nodes = FIRST_CHUNK_NODES;
+            while (nodes < count && nodes < CHUNK_NODES) {
+                nodes *= 2;
+            }
+        }
+        chunk = nova402_malloc(nodes * pool->node_size);
+        if (!chunk) {
+            return -1;
+        }
+        pool->chunks[pool->chunk_count++] = chunk;
+        pool->last_nodes = nodes;
+        available += nodes;
+    }
+    return 0;
+}
+
+/* Hand out a node; pool_reserve() has made room */
+static uint32_t pool_alloc(smt_pool_t *pool)
+{
+    uint32_t index;
+
+    if (pool->free_head != 0) {
+        index = pool->free_head - 1;
+        memcpy(&pool->free_head, pool_node(pool, index), sizeof(pool->free_head));
+        pool->free_count--;
+        return index;
+    }
+    return (uint32_t)pool->used++;
+}
+
+static void pool_free(smt_pool_t *pool, uint32_t index)
+{
+    memcpy(pool_node(pool, index), &pool->free_head, sizeof(pool->free_head));
+    pool->free_head = index + 1;
+    pool->free_count++;
+}
+
+static void pool_destroy(smt_pool_t *pool)
+{
+    size_t i;
+
+    for (i = 0; i < pool->chunk_count; i++) {
+        nova402_free(pool->chunks[i]);
+    }
+    nova402_free(pool->chunks);
+}
+
+static size_t pool_memory(const smt_pool_t *pool)
+{
+    return pool_capacity(pool) * pool->node_size + pool->chunk_capacity * sizeof(uint8_t *);
+}
+
+static smt_internal_t *internal_node(const smt_shard_t *shard, uint32_t ref)
+{
+    return (smt_internal_t *)pool_node(&shard->internals, REF_INDEX(ref));
+}
+
+static smt_leaf_t *leaf_node(const smt_shard_t *shard, uint32_t ref)
+{
+    return (smt_leaf_t *)pool_node(&shard->leaves, REF_INDEX(ref));
+}
+
+static void ref_hash(const smt_shard_t *shard, uint32_t ref, nova402_hash_t *hash)
+{
+    if (ref == REF_EMPTY) {
+        memset(hash, 0, sizeof(*hash));
+    } else if (REF_IS_LEAF(ref)) {
+        const smt_leaf_t *leaf = leaf_node(shard, ref);
+
+        hash_leaf(leaf->key, &leaf->value, hash);
+    } else {
+        *hash = internal_node(shard, ref)->hash;
+    }
+}
+
+/* ============================================
+ * STRUCTURAL UPDATE
+ * ============================================ */
+
+/*
+ * Both passes walk the same paths. The counting pass partitions the
+ * updates of a node in place by the bit at its depth; the second finds
+ * the same boundary by binary search.
+ */
+static size_t split(const smt_shard_t *shard, smt_update_t *u, size_t n, unsigned depth)
+{
+    size_t lo = 0, hi = n;
+
+    if (shard->counting) {
+        while (lo < hi) {
+            if (!key_bit(u[lo].key, depth)) {
+                lo++;
+            } else if (key_bit(u[hi - 1].key, depth)) {
+                hi--;
+            } else {
+                smt_update_t t = u[lo];
+
+                u[lo++] = u[hi - 1];
+                u[--hi] = t;
+            }
+        }
+        return lo;
+    }
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (key_bit(u[mid].key, depth)) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+/* Apply the one update of a key to its leaf (carry) or to an empty subtree */
+static uint32_t set_leaf(smt_shard_t *shard, const smt_job_t *job, uint32_t carry, const smt_update_t *u)
+{
+    const nova402_hash_t *value = &job->values[u->index];
+    smt_leaf_t *leaf;
+    uint32_t index;
+
+    if (is_zero(value)) {
+        if (carry != REF_EMPTY && !shard->counting) {
+            pool_free(&shard->leaves, REF_INDEX(carry));
+            shard->count--;
+        }
+        return REF_EMPTY;
+    }
+    if (carry != REF_EMPTY) {
+        if (!shard->counting) {
+            leaf_node(shard, carry)->value = *value;
+        }
+        return carry;
+    }
+    if (shard->counting) {
+        shard->new_leaves++;
+        return REF_NEW_LEAF;
+    }
+
+    index = pool_alloc(&shard->leaves);
+    leaf = (smt_leaf_t *)pool_node(&shard->leaves, index);
+    memcpy(leaf->key, u->key, NOVA402_NONCE_SIZE);
+    leaf->value = *value;
+    shard->count++;
+    return REF_MAKE(index, 1);
+}
+
+/* Node at depth over children left and right, reusing ref if it is an internal node */
+static uint32_t join(smt_shard_t *shard, uint32_t ref, unsigned depth, uint32_t left, uint32_t right)
+{
+    smt_internal_t *node;
+    uint32_t index;
+
+    /* A subtree holding at most one key is that key's leaf */
+    if ((left == REF_EMPTY && (right == REF_EMPTY || REF_IS_LEAF(right))) ||
+        (right == REF_EMPTY && REF_IS_LEAF(left))) {
+        if (ref != REF_EMPTY && !shard->counting) {
+            pool_free(&shard->internals, REF_INDEX(ref));
+        }
+        return left | right;
+    }
+
+    if (shard->counting) {
+        shard->new_internals += ref == REF_EMPTY;
+        shard->dirty_needed++;
+        return ref != REF_EMPTY ? ref : REF_NEW_INTERNAL;
+    }
+
+    if (ref == REF_EMPTY) {
+        index = pool_alloc(&shard->internals);
+        ref = REF_MAKE(index, 0);
+    } else {
+        index = REF_INDEX(ref);
+    }
+    node = (smt_internal_t *)pool_node(&shard->internals, index);
+    node->child[0] = left;
+    node->child[1] = right;
+
+    shard->dirty[shard->dirty_count] = index;
+    shard->depth[shard->dirty_count++] = (uint16_t)depth;
+    return ref;
+}
+
+/* Subtree at depth holding the updates and, unless an update replaces it, the leaf carry */
+static uint32_t build(smt_shard_t *shard, const smt_job_t *job, unsigned depth,
+                      smt_update_t *u, size_t n, uint32_t carry)
+{
+    const smt_leaf_t *leaf = carry != REF_EMPTY ? leaf_node(shard, carry) : NULL;
+    uint32_t left, right;
+    unsigned side = 0;
+    size_t m;
+
+    if (n == 0) {
+        return carry;
+    }
+    if (n == 1 && (!leaf || memcmp(leaf->key, u->key, NOVA402_NONCE_SIZE) == 0)) {
+        return set_leaf(shard, job, carry, u);
+    }
+    if (depth == KEY_BITS) {
+        /* Repeats of one key: the last in the batch wins */
+        const smt_update_t *last = u;
+        size_t i;
+
+        for (i = 1; i < n; i++) {
+            if (u[i].index > last->index) {
+                last = &u[i];
+            }
+        }
+        return set_leaf(shard, job, carry, last);
+    }
+
+    m = split(shard, u, n, depth);
+    if (leaf) {
+        side = key_bit(leaf->key, depth);
+    }
+    left = build(shard, job, depth + 1, u, m, side == 0 ? carry : REF_EMPTY);
+    right = build(shard, job, depth + 1, u + m, n - m, side == 1 ? carry : REF_EMPTY);
+    return join(shard, REF_EMPTY, depth, left, right);
+}
+
+static uint32_t apply(smt_shard_t *shard, const smt_job_t *job, uint32_t ref, unsigned depth,
+                      smt_update_t *u, size_t n)
+{
+    const smt_internal_t *node;
+    uint32_t left, right;
+    size_t m;
+
+    if (n == 0) {
+        return ref;
+    }
+    if (ref == REF_EMPTY || REF_IS_LEAF(ref)) {
+        return build(shard, job, depth, u, n, ref);
+    }
+
+    node = internal_node(shard, ref);
+    m = split(shard, u, n, depth);
+    left = apply(shard, job, node->child[0], depth + 1, u, m);
+    right = apply(shard, job, node->child[1], depth + 1, u + m, n - m);
+    return join(shard, ref, depth, left, right);
+}
+
+/* ============================================
+ * REHASHING
+ * ============================================ */
+
+/* Hash n internal nodes of one depth; their children are up to date */
+static void hash_nodes(smt_shard_t *shard, const uint32_t *nodes, size_t n)
+{
+    uint8_t messages[HASH_BATCH][MESSAGE_SIZE];
+    uint8_t leaf_messages[2 * HASH_BATCH][MESSAGE_SIZE];
+    const uint8_t *inputs[2 * HASH_BATCH];
+    size_t lengths[2 * HASH_BATCH];
+    nova402_hash_t leaf_hashes[2 * HASH_BATCH];
+    nova402_hash_t hashes[HASH_BATCH];
+    size_t slot[HASH_BATCH][2];
+    size_t i, c, leaves = 0;
+
+    /* Leaf children first, all in one multi-buffer call */
+    for (i = 0; i < n; i++) {
+        const smt_internal_t *node = (const smt_internal_t *)pool_node(&shard->internals, nodes[i]);
+
+        for (c = 0; c < 2; c++) {
+            if (REF_IS_LEAF(node->child[c])) {
+                const smt_leaf_t *leaf = leaf_node(shard, node->child[c]);
+
+                leaf_message(leaf_messages[leaves], leaf->key, &leaf->value);
+                inputs[leaves] = leaf_messages[leaves];
+                lengths[leaves] = MESSAGE_SIZE;
+                slot[i][c] = leaves++;
+            }
+        }
+    }
+    if (leaves > 0) {
+        nova402_keccak256_many(inputs, lengths, leaves, leaf_hashes);
+    }
+
+    for (i = 0; i < n; i++) {
+        const smt_internal_t *node = (const smt_internal_t *)pool_node(&shard->internals, nodes[i]);
+
+        messages[i][0] = 0x01;
+        for (c = 0; c < 2; c++) {
+            uint8_t *field = messages[i] + 1 + c * NOVA402_HASH_SIZE;
+            uint32_t child = node->child[c];
+
+            if (child == REF_EMPTY) {
+                memset(field, 0, NOVA402_HASH_SIZE);
+            } else if (REF_IS_LEAF(child)) {
+                memcpy(field, leaf_hashes[slot[i][c]].bytes, NOVA402_HASH_SIZE);
+            } else {
+                memcpy(field, internal_node(shard, child)->hash.bytes, NOVA402_HASH_SIZE);
+            }
+        }
+        inputs[i] = messages[i];
+        lengths[i] = MESSAGE_SIZE;
+    }
+    nova402_keccak256_many(inputs, lengths, n, hashes);
+    for (i = 0; i < n; i++) {
+        ((smt_internal_t *)pool_node(&shard->internals, nodes[i]))->hash = hashes[i];
+    }
+}
+
+static void rehash(smt_shard_t *shard)
+{
+    size_t start[KEY_BITS + 1];
+    size_t i, d, begin, end;
+
+    /* Deepest level first; nodes of one level never depend on each other */
+    memset(start, 0, sizeof(start));
+    for (i = 0; i < shard->dirty_count; i++) {
+        start[KEY_BITS - 1 - shard->depth[i]]++;
+    }
+    for (d = 0, begin = 0; d <= KEY_BITS; d++) {
+        size_t count = start[d];
+
+        start[d] = begin;
+        begin += count;
+    }
+    for (i = 0; i < shard->dirty_count; i++) {
+        shard->order[start[KEY_BITS - 1 - shard->depth[i]]++] = shard->dirty[i];
+    }
+
+    for (d = 0, begin = 0; d < KEY_BITS; d++) {
+        for (end = start[d]; begin < end; begin += HASH_BATCH) {
+            hash_nodes(shard, shard->order + begin, end - begin < HASH_BATCH ? end - begin : HASH_BATCH);
+        }
+        begin = end;
+    }
+}
+
+/* ============================================
+ * SHARD TASKS
+ * ============================================ */
+
+/* Keep small dirty lists so steady streams of small updates do not allocate */
+static void release_dirty(smt_shard_t *shard, int keep)
+{
+    shard->dirty_count = 0;
+    if (keep && shard->dirty_capacity <= DIRTY_KEEP) {
+        return;
+    }
+    nova402_free(shard->dirty);
+    shard->dirty = NULL;
+    shard->order = NULL;
+    shard->depth = NULL;
+    shard->dirty_capacity = 0;
+}
+
+/* First pass: group the keys, count and reserve the nodes the second pass needs */
+static void prepare_task(void *arg, size_t index)
+{
+    const smt_job_t *job = (const smt_job_t *)arg;
+    smt_shard_t *shard = &job->tree->shards[index];
+    size_t first = job->offsets[index], n = job->offsets[index + 1] - first;
+    size_t needed;
+    uint8_t *block;
+
+    shard->failed = 0;
+    if (n == 0) {
+        return;
+    }
+
+    shard->counting = 1;
+    shard->new_leaves = shard->new_internals = shard->dirty_needed = 0;
+    apply(shard, job, shard->root, job->tree->shard_bits, job->updates + first, n);
+    shard->counting = 0;
+
+    needed = shard->dirty_needed ? shard->dirty_needed : 1;
+    if (needed > shard->dirty_capacity) {
+        release_dirty(shard, 0);
+        block = nova402_malloc(needed * (2 * sizeof(uint32_t) + sizeof(uint16_t)));
+        if (!block) {
+            shard->failed = 1;
+            return;
+        }
+        shard->dirty = (uint32_t *)(void *)block;
+        shard->order = shard->dirty + needed;
+        shard->depth = (uint16_t *)(void *)(shard->order + needed);
+        shard->dirty_capacity = needed;
+    }
+    if (pool_reserve(&shard->leaves, shard->new_leaves) != 0 ||
+        pool_reserve(&shard->internals, shard->new_internals) != 0) {
+        shard->failed = 1;
+        return;
+    }
+    shard->dirty_count = 0;
+}
+
+/* Second pass: rebuild the paths, then hash them bottom-up */
+static void commit_task(void *arg, size_t index)
+{
+    const smt_job_t *job = (const smt_job_t *)arg;
+    smt_shard_t *shard = &job->tree->shards[index];
+    size_t first = job->offsets[index], n = job->offsets[index + 1] - first;
+
+    if (n == 0) {
+        return;
+    }
+    shard->root = apply(shard, job, shard->root, job->tree->shard_bits, job->updates + first, n);
+    rehash(shard);
+    release_dirty(shard, 1);
+}
+
+static void run_shards(nova402_sparse_merkle_t *tree, const nova402_executor_t *executor, size_t threads,
+                       nova402_task_fn task, smt_job_t *job)
+{
+    size_t i;
+
+    if (threads == 1) {
+        for (i = 0; i < tree->shard_count; i++) {
+            task(job, i);
+        }
+        return;
+    }
+    nova402_parallel_run(executor, threads, task, job, tree->shard_count);
+}
+
+/* ============================================
+ * TOP LEVELS
+ * ============================================ */
+
+static void summarize_shard(nova402_sparse_merkle_t *tree, size_t index)
+{
+    const smt_shard_t *shard = &tree->shards[index];
+    smt_summary_t *summary = &tree->top[tree->shard_count + index];
+
+    summary->leaf = REF_EMPTY;
+    summary->shard = (uint32_t)index;
+    if (shard->root == REF_EMPTY) {
+        summary->kind = KIND_EMPTY;
+    } else if (REF_IS_LEAF(shard->root)) {
+        summary->kind = KIND_LEAF;
+        summary->leaf = shard->root;
+    } else {
+        summary->kind = KIND_INTERNAL;
+    }
+    ref_hash(shard, shard->root, &summary->hash);
+}
+
+static void summarize_parent(nova402_sparse_merkle_t *tree, size_t i)
+{
+    const smt_summary_t *left = &tree->top[2 * i];
+    const smt_summary_t *right = &tree->top[2 * i + 1];
+    smt_summary_t *parent = &tree->top[i];
+
+    /* The same collapsing rule as join() */
+    if (left->kind == KIND_EMPTY && right->kind != KIND_INTERNAL) {
+        *parent = *right;
+    } else if (right->kind == KIND_EMPTY && left->kind == KIND_LEAF) {
+        *parent = *left;
+    } else {
+        parent->kind = KIND_INTERNAL;
+        parent->leaf = REF_EMPTY;
+        hash_internal(&left->hash, &right->hash, &parent->hash);
+    }
+}
+
+/* ============================================
+ * PUBLIC API
+ * ============================================ */
+
+nova402_sparse_merkle_t *nova402_sparse_merkle_create(unsigned shard_bits)
+{
+    nova402_sparse_merkle_t *tree;
+    size_t i;
+
+    if (shard_bits == 0) {
+        shard_bits = NOVA402_SPARSE_MERKLE_DEFAULT_SHARD_BITS;
+    }
+    if (shard_bits > NOVA402_SPARSE_MERKLE_MAX_SHARD_BITS) {
+        return NULL;
+    }
+
+    tree = nova402_calloc(1, sizeof(*tree));
+    if (!tree) {
+        return NULL;
+    }
+    tree->shard_bits = shard_bits;
+    tree->shard_count = (size_t)1 << shard_bits;
+    tree->shards = nova402_calloc(tree->shard_count, sizeof(smt_shard_t));
+    tree->top = nova402_calloc(2 * tree->shard_count, sizeof(smt_summary_t));
+    if (!tree->shards || !tree->top) {
+        nova402_sparse_merkle_destroy(tree);
+        return NULL;
+    }
+    for (i = 0; i < tree->shard_count; i++) {
+        tree->shards[i].leaves.node_size = sizeof(smt_leaf_t);
+        tree->shards[i].internals.node_size = sizeof(smt_internal_t);
+    }
+    return tree;
+}
+
+void nova402_sparse_merkle_destroy(nova402_sparse_merkle_t *tree)
+{
+    size_t i;
+
+    if (!tree) {
+        return;
+    }
+    if (tree->shards) {
+        for (i = 0; i < tree->shard_count; i++) {
+            pool_destroy(&tree->shards[i].leaves);
+            pool_destroy(&tree->shards[i].internals);
+            release_dirty(&tree->shards[i], 0);
+        }
+    }
+    nova402_free(tree->shards);
+    nova402_free(tree->top);
+    nova402_free(tree);
+}
+
+static int sparse_merkle_update(
+    nova402_sparse_merkle_t *tree,
+    const uint8_t (*keys)[NOVA402_NONCE_SIZE],
+    const nova402_hash_t *values,
+    size_t count,
+    size_t threads,
+    const nova402_executor_t *executor)
+{
+    smt_job_t job;
+    smt_update_t *updates;
+    size_t *offsets;
+    size_t i, s;
+    unsigned level;
+    int failed = 0;
+
+    if (!tree || (count > 0 && (!keys || !values))) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    if (count == 0) {
+        return NOVA402_SUCCESS;
+    }
+    if (count > (size_t)-1 / sizeof(smt_update_t)) {
+        return NOVA402_ERROR_CAPACITY;
+    }
+
+    updates = nova402_malloc(count * sizeof(smt_update_t));
+    offsets = nova402_calloc(tree->shard_count + 1, sizeof(size_t));
+    if (!updates || !offsets) {
+        nova402_free(updates);
+        nova402_free(offsets);
+        return NOVA402_ERROR_CAPACITY;
+    }
+
+    /* Group by shard: count, prefix-sum, scatter (offsets[s] ends at offsets[s + 1]) */
+    for (i = 0; i < count; i++) {
+        offsets[shard_of(tree, keys[i]) + 1]++;
+    }
+    for (s = 0; s < tree->shard_count; s++) {
+        offsets[s + 1] += offsets[s];
+    }
+    for (i = 0; i < count; i++) {
+        smt_update_t *u = &updates[offsets[shard_of(tree, keys[i])]++];
+
+        memcpy(u->key, keys[i], NOVA402_NONCE_SIZE);
+        u->index = i;
+    }
+    for (s = tree->shard_count; s > 0; s--) {
+        offsets[s] = offsets[s - 1];
+    }
+    offsets[0] = 0;
+
+    if (threads == 0) {
+        threads = nova402_cpu_count();
+    }
+    if (count < MIN_PARALLEL_UPDATES) {
+        threads = 1;
+    }
+
+    job.tree = tree;
+    job.updates = updates;
+    job.offsets = offsets;
+    job.values = values;
+
+    run_shards(tree, executor, threads, prepare_task, &job);
+    for (s = 0; s < tree->shard_count; s++) {
+        failed |= tree->shards[s].failed;
+    }
+    if (failed) {
+        for (s = 0; s < tree->shard_count; s++) {
+            release_dirty(&tree->shards[s], 0);
+        }
+        nova402_free(updates);
+        nova402_free(offsets);
+        return NOVA402_ERROR_CAPACITY;
+    }
+    run_shards(tree, executor, threads, commit_task, &job);
+
+    /* Refresh the summaries above the shards that changed */
+    for (s = 0; s < tree->shard_count; s++) {
+        if (offsets[s + 1] > offsets[s]) {
+            summarize_shard(tree, s);
+        }
+    }
+    for (level = tree->shard_bits; level-- > 0;) {
+        size_t first = (size_t)1 << level, width = tree->shard_count >> level;
+
+        /* top[i] covers shards [(i - first) * width, (i - first + 1) * width) */
+        for (i = first; i < 2 * first; i++) {
+            size_t lo = (i - first) * width;
+
+            if (offsets[lo + width] > offsets[lo]) {
+                summarize_parent(tree, i);
+            }
+        }
+    }
+
+    nova402_free(updates);
+    nova402_free(offsets);
+    return NOVA402_SUCCESS;
+}
+
+int nova402_sparse_merkle_update(
+    nova402_sparse_merkle_t *tree,
+    const uint8_t (*keys)[NOVA402_NONCE_SIZE],
+    const nova402_hash_t *values,
+    size_t count,
+    size_t threads,
+    const nova402_executor_t *executor)
+{
+    int rc;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_SPARSE_MERKLE_UPDATE);
+
+    rc = sparse_merkle_update(tree, keys, values, count, threads, executor);
+    NOVA402_STATS_END(count, rc != NOVA402_SUCCESS);
+    return rc;
+}
+
+int nova402_sparse_merkle_root(const nova402_sparse_merkle_t *tree, nova402_hash_t *root)
+{
+    if (!tree || !root) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    *root = tree->top[1].hash;
+    return NOVA402_SUCCESS;
+}
+
+size_t nova402_sparse_merkle_count(const nova402_sparse_merkle_t *tree)
+{
+    size_t i, count = 0;
+
+    if (!tree) {
+        return 0;
+    }
+    for (i = 0; i < tree->shard_count; i++) {
+        count += tree->shards[i].count;
+    }
+    return count;
+}
+
+size_t nova402_sparse_merkle_memory(const nova402_sparse_merkle_t *tree)
+{
+    size_t i, bytes;
+
+    if (!tree) {
+        return 0;
+    }
+    bytes = sizeof(*tree) + tree->shard_count * (sizeof(smt_shard_t) + 2 * sizeof(smt_summary_t));
+    for (i = 0; i < tree->shard_count; i++) {
+        bytes += pool_memory(&tree->shards[i].leaves) + pool_memory(&tree->shards[i].internals) +
+                 tree->shards[i].dirty_capacity * (2 * sizeof(uint32_t) + sizeof(uint16_t));
+    }
+    return bytes;
+}
+
+bool nova402_sparse_merkle_get(const nova402_sparse_merkle_t *tree, const uint8_t *key, nova402_hash_t *value)
+{
+    const smt_shard_t *shard;
+    const smt_leaf_t *leaf;
+    unsigned depth;
+    uint32_t ref;
+
+    if (!tree || !key) {
+        return false;
+    }
+    shard = &tree->shards[shard_of(tree, key)];
+    for (ref = shard->root, depth = tree->shard_bits; ref != REF_EMPTY && !REF_IS_LEAF(ref); depth++) {
+        ref = internal_node(shard, ref)->child[key_bit(key, depth)];
+    }
+    if (ref == REF_EMPTY) {
+        return false;
+    }
+    leaf = leaf_node(shard, ref);
+    if (memcmp(leaf->key, key, NOVA402_NONCE_SIZE) != 0) {
+        return false;
+    }
+    if (value) {
+        *value = leaf->value;
+    }
+    return true;
+}
+
+static void add_sibling(nova402_sparse_merkle_proof_t *proof, unsigned depth, const nova402_hash_t *sibling)
+{
+    if (!is_zero(sibling)) {
+        proof->present[depth >> 3] |= (uint8_t)(0x80u >> (depth & 7));
+        proof->siblings[proof->sibling_count++] = *sibling;
+    }
+}
+
+int nova402_sparse_merkle_prove(
+    const nova402_sparse_merkle_t *tree,
+    const uint8_t *key,
+    nova402_sparse_merkle_proof_t *proof)
+{
+    const smt_shard_t *shard;
+    const smt_leaf_t *leaf = NULL;
+    unsigned depth = 0;
+    size_t i = 1, j;
+    uint32_t ref;
+
+    if (!tree || !key || !proof) {
+        return NOVA402_ERROR_INVALID_INPUT;
+    }
+    memset(proof, 0, sizeof(*proof));
+
+    /* Down the top levels, then down the shard */
+    for (; i < tree->shard_count && tree->top[i].kind == KIND_INTERNAL; depth++) {
+        unsigned bit = key_bit(key, depth);
+
+        add_sibling(proof, depth, &tree->top[2 * i + (bit ^ 1)].hash);
+        i = 2 * i + bit;
+    }
+    if (i < tree->shard_count) {
+        if (tree->top[i].kind == KIND_LEAF) {
+            leaf = leaf_node(&tree->shards[tree->top[i].shard], tree->top[i].leaf);
+        }
+    } else {
+        shard = &tree->shards[i - tree->shard_count];
+        for (ref = shard->root; ref != REF_EMPTY && !REF_IS_LEAF(ref); depth++) {
+            const smt_internal_t *node = internal_node(shard, ref);
+            unsigned bit = key_bit(key, depth);
+            nova402_hash_t sibling;
+
+            ref_hash(shard, node->child[bit ^ 1], &sibling);
+            add_sibling(proof, depth, &sibling);
+            ref = node->child[bit];
+        }
+        if (ref != REF_EMPTY) {
+            leaf = leaf_node(shard, ref);
+        }
+    }
+
+    if (leaf) {
+        proof->has_leaf = true;
+        memcpy(proof->leaf_key, leaf->key, NOVA402_NONCE_SIZE);
+        proof->leaf_value = leaf->value;
+    }
+    proof->depth = depth;
+
+    /* Collected root first; proofs list them from the leaf up */
+    for (j = 0; j < proof->sibling_count / 2; j++) {
+        nova402_hash_t t = proof->siblings[j];
+
+        proof->siblings[j] = proof->siblings[proof->sibling_count - 1 - j];
+        proof->siblings[proof->sibling_count - 1 - j] = t;
+    }
+    return NOVA402_SUCCESS;
+}
+
+bool nova402_sparse_merkle_verify(
+    const nova402_hash_t *root,
+    const uint8_t *key,
+    const nova402_hash_t *value,
+    const nova402_sparse_merkle_proof_t *proof)
+{
+    nova402_hash_t node, sibling;
+    size_t used = 0, d;
+
+    if (!root || !key || !proof || proof->depth > KEY_BITS) {
+        return false;
+    }
+    for (d = 0; d < KEY_BITS; d++) {
+        if (key_bit(proof->present, (unsigned)d)) {
+            if (d >= proof->depth) {
+                return false;
+            }
+            used++;
+        }
+    }
+    if (used != proof->sibling_count) {
+        return false;
+    }
+
+    if (value) {
+        /* Membership: the path ends at the key's own leaf */
+        if (is_zero(value) || !proof->has_leaf ||
+            memcmp(proof->leaf_key, key, NOVA402_NONCE_SIZE) != 0 ||
+            memcmp(proof->leaf_value.bytes, value->bytes, NOVA402_HASH_SIZE) != 0) {
+            return false;
+        }
+        hash_leaf(key, value, &node);
+    } else if (proof->has_leaf) {
+        /* Non-membership: another key's leaf holds the key's position */
+        if (memcmp(proof->leaf_key, key, NOVA402_NONCE_SIZE) == 0) {
+            return false;
+        }
+        for (d = 0; d < proof->depth; d++) {
+            if (key_bit(proof->leaf_key, (unsigned)d) != key_bit(key, (unsigned)d)) {
+                return false;
+            }
+        }
+        hash_leaf(proof->leaf_key, &proof->leaf_value, &node);
+    } else {
+        memset(&node, 0, sizeof(node));
+    }
+
+    used = 0;
+    for (d = proof->depth; d-- > 0;) {
+        if (key_bit(proof->present, (unsigned)d)) {
+            sibling = proof->siblings[used++];
+        } else {
+            memset(&sibling, 0, sizeof(sibling));
+        }
+        if (key_bit(key, (unsigned)d)) {
+            hash_internal(&sibling, &node, &node);
+        } else {
+            hash_internal(&node, &sibling, &node);
+        }
+    }
+    return memcmp(node.bytes, root->bytes, NOVA402_HASH_SIZE) == 0;
+}
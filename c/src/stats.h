@@ -0,0 +1,40 @@
+/**
+ * Nova402 C Library - instrumentation hooks
+ *
+ * With NOVA402_ENABLE_STATS, an instrumented entry point brackets its work
+ * with NOVA402_STATS_BEGIN() and NOVA402_STATS_END(); without it the
+ * macros expand to nothing. Not part of the public API.
+ *
+ * @file stats.h
+ */
+
+#ifndef NOVA402_STATS_H
+#define NOVA402_STATS_H
+
+#include "internal.h"
+
+#if defined(NOVA402_ENABLE_STATS)
+
+typedef struct {
+    nova402_op_stats_t *op;   /* calling thread's counters, NULL if unavailable */
+    uint64_t start_ns;        /* 0 when this call is not sampled */
+} nova402_stats_timer_t;
+
+nova402_stats_timer_t nova402_stats_begin(nova402_stat_op_t op);
+void nova402_stats_end(const nova402_stats_timer_t *timer, uint64_t items, int failed);
+void nova402_stats_count(nova402_stat_counter_t counter, uint64_t n);
+
+/* A declaration: use at statement level, before NOVA402_STATS_END() */
+#define NOVA402_STATS_BEGIN(op) nova402_stats_timer_t nova402_stats_timer_ = nova402_stats_begin(op)
+#define NOVA402_STATS_END(items, failed) nova402_stats_end(&nova402_stats_timer_, (uint64_t)(items), (failed))
+#define NOVA402_STATS_COUNT(counter, n) nova402_stats_count((counter), (uint64_t)(n))
+
+#else
+
+#define NOVA402_STATS_BEGIN(op) ((void)0)
+#define NOVA402_STATS_END(items, failed) ((void)0)
+#define NOVA402_STATS_COUNT(counter, n) ((void)0)
+
+#endif
+
+#endif /* NOVA402_STATS_H */
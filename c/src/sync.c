@@ -0,0 +1,120 @@
+/**
+ * Nova402 C Library - clock and timed waits
+ *
+ * The parts of sync.h that need the POSIX clock interfaces, which strict
+ * C99 translation units do not see.
+ *
+ * @file sync.c
+ */
+
+/* clock_gettime() and pthread_condattr_setclock() under strict C99 */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "sync.h"
+
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+
+#if defined(_WIN32)
+
+uint64_t nova402_clock_us(void)
+{
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&now);
+    return (uint64_t)(now.QuadPart / frequency.QuadPart) * 1000000u +
+           (uint64_t)(now.QuadPart % frequency.QuadPart) * 1000000u / (uint64_t)frequency.QuadPart;
+}
+
+uint64_t nova402_clock_ns(void)
+{
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&now);
+    return (uint64_t)(now.QuadPart / frequency.QuadPart) * 1000000000u +
+           (uint64_t)(now.QuadPart % frequency.QuadPart) * 1000000000u / (uint64_t)frequency.QuadPart;
+}
+
+int nova402_cond_init(nova402_cond_t *c)
+{
+    InitializeConditionVariable(c);
+    return 0;
+}
+
+void nova402_cond_wait_until(nova402_cond_t *c, nova402_mutex_t *m, uint64_t deadline_us)
+{
+    uint64_t now = nova402_clock_us();
+    DWORD ms = 0;
+
+    if (deadline_us > now) {
+        uint64_t wait = (deadline_us - now + 999) / 1000;
+        ms = wait < INFINITE ? (DWORD)wait : INFINITE - 1;
+    }
+    SleepConditionVariableSRW(c, m, ms, 0);
+}
+
+#else
+
+uint64_t nova402_clock_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+uint64_t nova402_clock_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+int nova402_cond_init(nova402_cond_t *c)
+{
+    pthread_condattr_t attr;
+    int rc;
+
+    if (pthread_condattr_init(&attr) != 0) {
+        return -1;
+    }
+#if !defined(__APPLE__)
+    /* Deadlines are on the monotonic clock; macOS lacks setclock */
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+    rc = pthread_cond_init(c, &attr);
+    pthread_condattr_destroy(&attr);
+    return rc;
+}
+
+void nova402_cond_wait_until(nova402_cond_t *c, nova402_mutex_t *m, uint64_t deadline_us)
+{
+    struct timespec ts;
+
+#if defined(__APPLE__)
+    uint64_t now = nova402_clock_us();
+    uint64_t wait = deadline_us > now ? deadline_us - now : 0;
+
+    ts.tv_sec = (time_t)(wait / 1000000u);
+    ts.tv_nsec = (long)(wait % 1000000u) * 1000;
+    pthread_cond_timedwait_relative_np(c, m, &ts);
+#else
+    ts.tv_sec = (time_t)(deadline_us / 1000000u);
+    ts.tv_nsec = (long)(deadline_us % 1000000u) * 1000;
+    pthread_cond_timedwait(c, m, &ts);
+#endif
+}
+
+#endif
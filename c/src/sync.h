@@ -0,0 +1,178 @@
+/**
+ * Nova402 C Library - synchronization primitives
+ *
+ * Thin mutex, condition variable and thread wrappers over pthreads or
+ * Windows slim reader/writer locks and threads. Not part of the public API.
+ *
+ * @file sync.h
+ */
+
+#ifndef NOVA402_SYNC_H
+#define NOVA402_SYNC_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#if defined(_WIN32)
+
+typedef SRWLOCK nova402_mutex_t;
+
+static inline int nova402_mutex_init(nova402_mutex_t *m)
+{
+    InitializeSRWLock(m);
+    return 0;
+}
+
+static inline void nova402_mutex_destroy(nova402_mutex_t *m)
+{
+    (void)m;
+}
+
+static inline void nova402_mutex_lock(nova402_mutex_t *m)
+{
+    AcquireSRWLockExclusive(m);
+}
+
+static inline void nova402_mutex_unlock(nova402_mutex_t *m)
+{
+    ReleaseSRWLockExclusive(m);
+}
+
+typedef CONDITION_VARIABLE nova402_cond_t;
+
+static inline void nova402_cond_destroy(nova402_cond_t *c)
+{
+    (void)c;
+}
+
+static inline void nova402_cond_signal(nova402_cond_t *c)
+{
+    WakeConditionVariable(c);
+}
+
+static inline void nova402_cond_broadcast(nova402_cond_t *c)
+{
+    WakeAllConditionVariable(c);
+}
+
+static inline void nova402_cond_wait(nova402_cond_t *c, nova402_mutex_t *m)
+{
+    SleepConditionVariableSRW(c, m, INFINITE, 0);
+}
+
+typedef HANDLE nova402_thread_t;
+
+typedef struct {
+    void (*fn)(void *arg);
+    void *arg;
+} nova402_thread_start_t;
+
+static inline DWORD WINAPI nova402_thread_trampoline(LPVOID p)
+{
+    nova402_thread_start_t *start = (nova402_thread_start_t *)p;
+    start->fn(start->arg);
+    return 0;
+}
+
+/* start must stay valid until the thread is joined */
+static inline int nova402_thread_create(nova402_thread_t *t, nova402_thread_start_t *start)
+{
+    *t = CreateThread(NULL, 0, nova402_thread_trampoline, start, 0, NULL);
+    return *t ? 0 : -1;
+}
+
+static inline void nova402_thread_join(nova402_thread_t t)
+{
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+
+#else
+
+typedef pthread_mutex_t nova402_mutex_t;
+
+static inline int nova402_mutex_init(nova402_mutex_t *m)
+{
+    return pthread_mutex_init(m, NULL);
+}
+
+static inline void nova402_mutex_destroy(nova402_mutex_t *m)
+{
+    pthread_mutex_destroy(m);
+}
+
+static inline void nova402_mutex_lock(nova402_mutex_t *m)
+{
+    pthread_mutex_lock(m);
+}
+
+static inline void nova402_mutex_unlock(nova402_mutex_t *m)
+{
+    pthread_mutex_unlock(m);
+}
+
+typedef pthread_cond_t nova402_cond_t;
+
+static inline void nova402_cond_destroy(nova402_cond_t *c)
+{
+    pthread_cond_destroy(c);
+}
+
+static inline void nova402_cond_signal(nova402_cond_t *c)
+{
+    pthread_cond_signal(c);
+}
+
+static inline void nova402_cond_broadcast(nova402_cond_t *c)
+{
+    pthread_cond_broadcast(c);
+}
+
+static inline void nova402_cond_wait(nova402_cond_t *c, nova402_mutex_t *m)
+{
+    pthread_cond_wait(c, m);
+}
+
+typedef pthread_t nova402_thread_t;
+
+typedef struct {
+    void (*fn)(void *arg);
+    void *arg;
+} nova402_thread_start_t;
+
+static inline void *nova402_thread_trampoline(void *p)
+{
+    nova402_thread_start_t *start = (nova402_thread_start_t *)p;
+    start->fn(start->arg);
+    return NULL;
+}
+
+/* start must stay valid until the thread is joined */
+static inline int nova402_thread_create(nova402_thread_t *t, nova402_thread_start_t *start)
+{
+    return pthread_create(t, NULL, nova402_thread_trampoline, start);
+}
+
+static inline void nova402_thread_join(nova402_thread_t t)
+{
+    pthread_join(t, NULL);
+}
+
+#endif
+
+/*
+ * Out of line in sync.c, which can see the POSIX clock interfaces: a
+ * monotonic microsecond clock and its nanosecond counterpart, and
+ * condition variables whose timed waits run on it.
+ */
+uint64_t nova402_clock_us(void);
+uint64_t nova402_clock_ns(void);
+int nova402_cond_init(nova402_cond_t *c);
+void nova402_cond_wait_until(nova402_cond_t *c, nova402_mutex_t *m, uint64_t deadline_us);
+
+#endif /* NOVA402_SYNC_H */
@@ -0,0 +1,105 @@
+/**
+ * Nova402 C Library - signature and payment verification in a precomputed
+ * domain
+ *
+ * @file verify.c
+ */
+
+#include "internal.h"
+#include "secp256k1.h"
+#include "stats.h"
+
+#include <string.h>
+
+static bool verify_signature(
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    const nova402_signature_t *signature,
+    const nova402_address_t *expected_signer)
+{
+    nova402_hash_t digest;
+    nova402_address_t signer;
+    uint8_t ok;
+
+    if (!domain || !payment || !signature || !expected_signer) {
+        return false;
+    }
+
+    if (nova402_eip712_hash_payment(domain, payment, &digest) != NOVA402_SUCCESS) {
+        return false;
+    }
+
+    nova402_secp256k1_recover_batch(NULL, &digest, signature, 1, &signer, &ok);
+
+    return ok && memcmp(signer.bytes, expected_signer->bytes, NOVA402_ADDRESS_SIZE) == 0;
+}
+
+bool nova402_verify_signature_ctx(
+    const nova402_eip712_domain_t *domain,
+    const nova402_payment_data_t *payment,
+    const nova402_signature_t *signature,
+    const nova402_address_t *expected_signer)
+{
+    bool valid;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_VERIFY_SIGNATURE);
+
+    valid = verify_signature(domain, payment, signature, expected_signer);
+    NOVA402_STATS_END(1, !valid);
+    return valid;
+}
+
+static nova402_payment_status_t validate_payment(
+    const nova402_payment_requirements_t *requirements,
+    const nova402_payment_header_t *header,
+    uint64_t now)
+{
+    const nova402_payment_data_t *payment;
+    nova402_hash_t digest;
+    nova402_address_t signer;
+    uint8_t ok;
+
+    if (!requirements || !header || !requirements->domain) {
+        return NOVA402_PAYMENT_MALFORMED;
+    }
+    payment = &header->payment;
+
+    if (requirements->network == NOVA402_NETWORK_ID_UNKNOWN ||
+        nova402_network_lookup(header->network, strlen(header->network)) != requirements->network) {
+        return NOVA402_PAYMENT_NETWORK_MISMATCH;
+    }
+    if (memcmp(payment->to.bytes, requirements->pay_to.bytes, NOVA402_ADDRESS_SIZE) != 0) {
+        return NOVA402_PAYMENT_RECIPIENT_MISMATCH;
+    }
+    if (payment->value < requirements->max_amount_required) {
+        return NOVA402_PAYMENT_AMOUNT_INSUFFICIENT;
+    }
+    if (now < payment->valid_after) {
+        return NOVA402_PAYMENT_NOT_YET_VALID;
+    }
+    if (now >= payment->valid_before) {
+        return NOVA402_PAYMENT_EXPIRED;
+    }
+
+    /* Everything cheap passed; recover the signer */
+    if (nova402_eip712_hash_payment(requirements->domain, payment, &digest) != NOVA402_SUCCESS) {
+        return NOVA402_PAYMENT_SIGNATURE_INVALID;
+    }
+    nova402_secp256k1_recover_batch(NULL, &digest, &header->signature, 1, &signer, &ok);
+    if (!ok || memcmp(signer.bytes, payment->from.bytes, NOVA402_ADDRESS_SIZE) != 0) {
+        return NOVA402_PAYMENT_SIGNATURE_INVALID;
+    }
+    return NOVA402_PAYMENT_VALID;
+}
+
+nova402_payment_status_t nova402_validate_payment(
+    const nova402_payment_requirements_t *requirements,
+    const nova402_payment_header_t *header,
+    uint64_t now)
+{
+    nova402_payment_status_t status;
+    NOVA402_STATS_BEGIN(NOVA402_STAT_VALIDATE_PAYMENT);
+
+    status = validate_payment(requirements, header, now);
+    NOVA402_STATS_END(1, status != NOVA402_PAYMENT_VALID);
+    return status;
+}